@@ -0,0 +1,199 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file aggregatedstatistics.h
+ **************************************************************************************************/
+#ifndef AGGREGATEDSTATISTICS_H
+#define AGGREGATEDSTATISTICS_H
+
+#include "cancellationtoken.h"
+#include "eyetrackingdata.h"
+#include "settings.h"
+#include "settingssnapshot.h"
+#include "statisticstable.h"
+#include <functional>
+#include <QMap>
+#include <QStringList>
+#include <vector>
+
+/***********************************************************************************************//**
+ * This class computes aggregated statistics for participants/test conditions and writes them to
+ * csv files without any user interaction. It is used by StatisticsExport and the batch
+ * processing.
+ *
+ * data types:
+ * if not directionalData:
+ *     0: #Raw Data Samples in Trials
+ *     1: Duration of Trials [s]
+ *     2: #Fixations in Trials
+ *     3: #Fixations with Microsaccades in Trials
+ *     4: Fixations containing Microsaccades [%]
+ *     5: Fixation Duration [s]
+ *     6: Fixation (with Microsaccades) Duration [s]
+ *     7: #Microsaccades in Trials
+ *     8: #Microsaccades per Fixation
+ *     9: #Microsaccades per Fixation with Microsaccades
+ *     10: #Microsaccades per Second (for Trials)
+ *     11: #Microsaccades per Second in Fixations (for Trials)
+ *     12: Microsaccade Amplitude [°]
+ *     13: Inter-saccadic Interval [ms]
+ *     14: Microsaccade Duration [ms]
+ *     15: Microsaccade Peak Velocity [°/s]
+ * else:
+ *     0: DirectionFromView
+ *     1: DirectionTowardsNextFixation
+ *     2: DirectionTowardsPreviousFixation
+ *
+ * value types:
+ * if not directionalData:
+ *     0: min, 1: max, 2: mean, 3: median, 4: sum, 5: single values
+ * else:
+ *     0: mean, 1: single values
+ *
+ * The used settings (test conditions, gaze type, microsaccade settings) are copied when the
+ * object is created (SettingsSnapshot), later changes of the global settings do not influence
+ * the results.
+ **************************************************************************************************/
+class AggregatedStatistics
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Constructor.
+     *
+     * @param eyeTrackingData eye tracking data
+     * @param settings        global settings, a snapshot is taken (can be nullptr if no data is
+     *                        exported)
+     * @param directionalData if directional data or other data will be exported
+     **********************************************************************************************/
+    AggregatedStatistics(EyeTrackingData* eyeTrackingData, Settings* settings,
+                         bool directionalData);
+
+    /*******************************************************************************************//**
+     * Destructor.
+     **********************************************************************************************/
+    ~AggregatedStatistics();
+
+    /*******************************************************************************************//**
+     * Returns the names of all data types, see above.
+     **********************************************************************************************/
+    QStringList dataTypes() const;
+
+    /*******************************************************************************************//**
+     * Returns the names of all value types, see above.
+     **********************************************************************************************/
+    QStringList valueTypes() const;
+
+    /*******************************************************************************************//**
+     * Returns the value type which is selected by default (mean).
+     **********************************************************************************************/
+    int defaultValueType() const;
+
+    /*******************************************************************************************//**
+     * Returns if the value type can be determined for the data type; sum is not available for
+     * all data types.
+     *
+     * @param dataType  data type, see above
+     * @param valueType value type, see above
+     **********************************************************************************************/
+    bool isAvailable(int dataType, int valueType) const;
+
+    /*******************************************************************************************//**
+     * Creates a new sub directory path for all exports.
+     *
+     * @param path existing directory path.
+     **********************************************************************************************/
+    static QString subDirPath(const QString path);
+
+    /*******************************************************************************************//**
+     * Creates export files with aggregated data for participants/test conditions in the given
+     * directory. Each row of a file contains the values of a participant and each column
+     * represents a test condition.
+     *
+     * The values of the participants are computed in parallel in blocks of participants; each
+     * block is written to all files in participant order as soon as it is computed.
+     *
+     * @param dirName      existing directory
+     * @param dataTypes    data types for which files are created, see above
+     * @param valueType    value type, see above
+     * @param cancellation checked for each block of participants; all files of this export are
+     *                     removed if canceled
+     * @param progress     called after each written block with the number of written and of all
+     *                     participants
+     * @param failedFiles  result (optional): files which can not be written; the other files are
+     *                     still exported
+     * @return false if canceled or if a file can not be written
+     **********************************************************************************************/
+    bool exportToDirectory(const QString& dirName, const std::vector<int>& dataTypes,
+                           int valueType,
+                           const CancellationToken& cancellation = CancellationToken(),
+                           const std::function<void(size_t, size_t)>& progress =
+                               std::function<void(size_t, size_t)>(),
+                           QStringList* failedFiles = nullptr);
+
+private:
+
+    /*******************************************************************************************//**
+     * Returns a file name depending on the data type.
+     *
+     * @param dataType data type, see above
+     * @param dir      existing directory
+     **********************************************************************************************/
+    QString getFileName(int dataType, const QString dir);
+
+    /*******************************************************************************************//**
+     * Returns the rows of the participant for all given data types: the values for all test
+     * conditions separated by commas. Only reads the trials, so that participants can be
+     * computed in parallel.
+     *
+     * @param p         current participant
+     * @param dataTypes available data types, see above
+     * @param valueType value type, see above
+     * @return one row for each data type
+     **********************************************************************************************/
+    QStringList participantRows(Participant* p, const std::vector<int>& dataTypes,
+                                int valueType);
+
+    /*******************************************************************************************//**
+     * Returns a list of datat samples for the given participant, test condition and the data type.
+     *
+     * @param p             current participant
+     * @param table         statistics table of the participant (not directional data)
+     * @param groups        group of the table for each test condition
+     * @param testCondition current test condition
+     * @param dataType      data type, see above
+     * @param dataCount     value which has to be used to determine mean value
+     * @return list of datat samples for the given participant, test condition and the data type
+     **********************************************************************************************/
+    std::vector<qreal> getDataSamples(Participant* p, const StatisticsTable& table,
+                                      const QMap<QString, int>& groups,
+                                      const QString testCondition, int dataType, int& dataCount);
+
+    /*******************************************************************************************//**
+     * Returns the value for the given value type and data samples.
+     *
+     * @param dataSamples list of data samples
+     * @param valueType   value type, representing for example min, max, sum, ...
+     * @param dataCount   element/samples count
+     * @return value as string
+     **********************************************************************************************/
+    QString getValue(std::vector<qreal> dataSamples, int valueType, int dataCount = -1);
+
+    /// Eye tracking data.
+    EyeTrackingData* m_eyeTrackingData;
+
+    /// Snapshot of the settings when this object was created.
+    const SettingsSnapshot* m_settings;
+
+    /// Directional or other data will be exported
+    bool m_directionalData;
+
+    /// Data and value types.
+    QStringList m_dataTypes;
+    QStringList m_valueTypes;
+
+    /// Indices of m_dataTypes for which sum can not be determined.
+    std::vector<size_t> m_sumNotAvailable;
+};
+
+#endif // AGGREGATEDSTATISTICS_H
@@ -0,0 +1,115 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file arrowdatawriter.h
+ **************************************************************************************************/
+#ifndef ARROWDATAWRITER_H
+#define ARROWDATAWRITER_H
+
+#include "arrowtable.h"
+#include "participant.h"
+#include "trial.h"
+#include <QString>
+
+/***********************************************************************************************//**
+ * This class writes the detection results of trials as columnar Apache Arrow files (ArrowTable)
+ * for the analysis with other tools: one file each for fixations, microsaccades, saccades and,
+ * optionally, raw samples of all gaze types (fixations.arrow, microsaccades.arrow, ...).
+ *
+ * Every row contains the participant, trial, test condition and gaze type, so that the files of
+ * a whole study can be loaded as single tables. Trials are written in one pass as one record
+ * batch per trial and file. It is used by EyeDataExport and the batch processing.
+ **************************************************************************************************/
+class ArrowDataWriter
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Constructor.
+     *
+     * @param writeSamples if the raw samples are written as well
+     **********************************************************************************************/
+    ArrowDataWriter(bool writeSamples);
+
+    /*******************************************************************************************//**
+     * Creates the files in the given directory, existing files are replaced.
+     *
+     * @param dir existing directory
+     * @return false if a file can not be written
+     **********************************************************************************************/
+    bool open(const QString& dir);
+
+    /*******************************************************************************************//**
+     * Writes fixations, microsaccades, saccades (and samples) of all gaze types of the trial.
+     *
+     * @param trial data of this trial will be written
+     **********************************************************************************************/
+    void writeTrial(Trial& trial);
+
+    /*******************************************************************************************//**
+     * Writes all trials of the given participant.
+     *
+     * @param participant data of this participant will be written
+     **********************************************************************************************/
+    void writeParticipant(Participant& participant);
+
+    /*******************************************************************************************//**
+     * Writes the footers and closes all files.
+     *
+     * @return false if a file could not be written
+     **********************************************************************************************/
+    bool close();
+
+private:
+
+    /*******************************************************************************************//**
+     * Adds the columns participant, trial, test condition and gaze type to the table.
+     *
+     * @param table table without columns
+     **********************************************************************************************/
+    static void addKeyColumns(ArrowTable& table);
+
+    /*******************************************************************************************//**
+     * Adds the columns of a saccade (see appendSaccade) to the table.
+     *
+     * @param table table
+     **********************************************************************************************/
+    static void addSaccadeColumns(ArrowTable& table);
+
+    /*******************************************************************************************//**
+     * Appends one row of the key columns (see addKeyColumns) to the table.
+     *
+     * @param table    table
+     * @param trial    trial of the row
+     * @param gazeType name of the gaze type
+     * @return index of the first column after the key columns
+     **********************************************************************************************/
+    static int appendKeys(ArrowTable& table, Trial& trial, const QString& gazeType);
+
+    /*******************************************************************************************//**
+     * Appends the values of the saccade columns (see addSaccadeColumns) to the table.
+     *
+     * @param table   table
+     * @param column  index of the first saccade column
+     * @param trial   trial of the saccade
+     * @param saccade saccade or microsaccade
+     **********************************************************************************************/
+    static void appendSaccade(ArrowTable& table, int column, Trial& trial, Saccade& saccade);
+
+    /// If the raw samples are written.
+    bool m_writeSamples;
+
+    /// Table of all fixations.
+    ArrowTable m_fixations;
+
+    /// Table of all microsaccades.
+    ArrowTable m_microsaccades;
+
+    /// Table of all saccades.
+    ArrowTable m_saccades;
+
+    /// Table of all raw samples.
+    ArrowTable m_samples;
+};
+
+#endif // ARROWDATAWRITER_H
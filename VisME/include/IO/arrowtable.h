@@ -0,0 +1,179 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file arrowtable.h
+ **************************************************************************************************/
+#ifndef ARROWTABLE_H
+#define ARROWTABLE_H
+
+#include <fstream>
+#include <QString>
+#include <QtGlobal>
+#include <string>
+#include <vector>
+
+class FlatBufferBuilder;
+
+/***********************************************************************************************//**
+ * This class writes one table to a file in the Apache Arrow IPC file format (.arrow, also known
+ * as Feather V2), which can be read, e.g., with pyarrow.feather.read_table in Python or
+ * arrow::read_feather in R.
+ *
+ * The columns are defined before the file is opened. Rows are appended column wise and written
+ * as one record batch with writeBatch, so that only the rows of one batch (e.g., one trial) are
+ * kept in memory. The footer with the positions of all record batches is written by close.
+ *
+ * Only non-nullable 32 bit integer, 64 bit floating point and UTF-8 string columns are
+ * supported; the flatbuffers metadata is encoded directly without the Arrow library.
+ **************************************************************************************************/
+class ArrowTable
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Data type of a column.
+     **********************************************************************************************/
+    enum ColumnType
+    {
+        CT_Int32,
+        CT_Float64,
+        CT_String
+    };
+
+    /*******************************************************************************************//**
+     * Constructor.
+     **********************************************************************************************/
+    ArrowTable();
+
+    /*******************************************************************************************//**
+     * Destructor, closes the file if it is still open.
+     **********************************************************************************************/
+    ~ArrowTable();
+
+    /*******************************************************************************************//**
+     * Adds a column, only before the file is opened.
+     *
+     * @param name name of the column
+     * @param type data type of the column
+     * @return index of the column
+     **********************************************************************************************/
+    int addColumn(const QString& name, ColumnType type);
+
+    /*******************************************************************************************//**
+     * Creates the file and writes the schema of all columns.
+     *
+     * @param fileName file name
+     * @return false if the file can not be written
+     **********************************************************************************************/
+    bool open(const QString& fileName);
+
+    /*******************************************************************************************//**
+     * Appends a value to an integer column.
+     *
+     * @param column index of a CT_Int32 column
+     * @param value  value
+     **********************************************************************************************/
+    void appendInt(int column, int value);
+
+    /*******************************************************************************************//**
+     * Appends a value to a floating point column.
+     *
+     * @param column index of a CT_Float64 column
+     * @param value  value
+     **********************************************************************************************/
+    void appendReal(int column, qreal value);
+
+    /*******************************************************************************************//**
+     * Appends a value to a string column.
+     *
+     * @param column index of a CT_String column
+     * @param value  value
+     **********************************************************************************************/
+    void appendString(int column, const QString& value);
+
+    /*******************************************************************************************//**
+     * Returns the number of appended rows which are not written yet (values of the first column).
+     **********************************************************************************************/
+    size_t rowCount() const;
+
+    /*******************************************************************************************//**
+     * Writes all appended rows as one record batch and removes them. All columns must have the
+     * same number of values. Nothing is written if there are no rows.
+     **********************************************************************************************/
+    void writeBatch();
+
+    /*******************************************************************************************//**
+     * Writes the remaining rows and the footer and closes the file.
+     *
+     * @return false if the file could not be written
+     **********************************************************************************************/
+    bool close();
+
+private:
+
+    // Values of one column until they are written.
+    struct Column
+    {
+        // Name of the column.
+        std::string m_name;
+
+        // Data type of the column.
+        ColumnType m_type;
+
+        // Values of integer columns.
+        std::vector<qint32> m_ints;
+
+        // Values of floating point columns.
+        std::vector<double> m_reals;
+
+        // End offsets of the values of string columns in m_chars.
+        std::vector<qint32> m_offsets;
+
+        // Concatenated UTF-8 values of string columns.
+        std::string m_chars;
+    };
+
+    // Position and size of a record batch in the file (Block of the Arrow footer).
+    struct Block
+    {
+        // Position of the message.
+        qint64 m_offset;
+
+        // Size of the message metadata including the prefix.
+        qint32 m_metaDataLength;
+
+        // Size of the message body.
+        qint64 m_bodyLength;
+    };
+
+    /*******************************************************************************************//**
+     * Creates the Arrow schema of all columns.
+     *
+     * @param builder flatbuffers builder of the message or footer
+     * @return offset of the schema table
+     **********************************************************************************************/
+    quint32 createSchema(FlatBufferBuilder& builder) const;
+
+    /*******************************************************************************************//**
+     * Writes a message (metadata and body) with the encapsulation of the IPC format.
+     *
+     * @param metadata flatbuffer of the message
+     * @param body     body of the message, size is a multiple of 8
+     * @return position and sizes of the message
+     **********************************************************************************************/
+    Block writeMessage(const std::string& metadata, const std::string& body);
+
+    /// Columns of the table.
+    std::vector<Column> m_columns;
+
+    /// Record batches written to the file.
+    std::vector<Block> m_batches;
+
+    /// Output file.
+    std::ofstream m_out;
+
+    /// Number of bytes written to the file.
+    qint64 m_position;
+};
+
+#endif // ARROWTABLE_H
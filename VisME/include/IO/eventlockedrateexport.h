@@ -0,0 +1,109 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file eventlockedrateexport.h
+ **************************************************************************************************/
+#ifndef EVENTLOCKEDRATEEXPORT_H
+#define EVENTLOCKEDRATEEXPORT_H
+
+#include "eventlockedrate.h"
+#include "eyetrackingdata.h"
+#include "settings.h"
+#include <QComboBox>
+#include <QDialog>
+#include <QObject>
+#include <QSharedPointer>
+#include <QWidget>
+
+class DiagramLegend;
+class EventRatePlot;
+
+/***********************************************************************************************//**
+ * This class is responsible for the event-locked microsaccade rate analysis (EventLockedRate):
+ * it asks for the event and the time range, shows the rates of the test conditions for all or
+ * single participants in a window (EventRatePlot) and exports all groups as table to a text file.
+ **************************************************************************************************/
+class EventLockedRateExport : public QObject
+{
+
+    Q_OBJECT
+
+public:
+
+    /*******************************************************************************************//**
+     * Constructor.
+     *
+     * @param parent          parent widget
+     * @param eyeTrackingData eye tracking data
+     * @param settings        global settings
+     **********************************************************************************************/
+    EventLockedRateExport(QWidget* parent, EyeTrackingData* eyeTrackingData, Settings* settings);
+
+public slots:
+
+    /*******************************************************************************************//**
+     * Asks for the event name, the time range, the bin size and the sliding window, aligns the
+     * microsaccades of the trials to the events and shows the results.
+     *
+     * In multi trial mode the selected trials are used, otherwise all trials of all participants.
+     **********************************************************************************************/
+    void showEventLockedRate();
+
+    /*******************************************************************************************//**
+     * Writes the results of all groups to a csv file.
+     **********************************************************************************************/
+    void exportEventLockedRate();
+
+private slots:
+
+    /*******************************************************************************************//**
+     * Shows the groups of the participant which is selected in the combo box (all participants
+     * for the first entry).
+     *
+     * @param index index of the combo box entry
+     **********************************************************************************************/
+    void selectParticipant(int index);
+
+private:
+
+    /*******************************************************************************************//**
+     * Asks for the parameters of the analysis.
+     *
+     * @param eventNames names of all events
+     * @return false if the dialog was canceled
+     **********************************************************************************************/
+    bool askForParameters(const QStringList& eventNames);
+
+    /*******************************************************************************************//**
+     * Creates the window which shows the results.
+     **********************************************************************************************/
+    void createResultDialog();
+
+    /// Main window.
+    QWidget* m_parent;
+
+    /// Eye tracking data.
+    EyeTrackingData* m_eyeTrackingData;
+
+    /// Settings.
+    Settings* m_settings;
+
+    /// Last used parameters [ms].
+    QString m_eventName;
+    int m_timeBefore;
+    int m_timeAfter;
+    int m_binSize;
+    int m_windowSize;
+    int m_windowStep;
+
+    /// Last analysis and its results.
+    QSharedPointer<EventLockedRate> m_analysis;
+    std::vector<EventLockedRateGroup> m_groups;
+
+    /// Window showing the results.
+    QDialog* m_resultDialog;
+    QComboBox* m_participantComboBox;
+    EventRatePlot* m_plot;
+    DiagramLegend* m_legend;
+};
+
+#endif // EVENTLOCKEDRATEEXPORT_H
@@ -42,27 +42,38 @@ public slots:
     void exportCurrentParticipantDataToFile();
 
     /*******************************************************************************************//**
-     * Export data of all participants to files.
+     * Export data of all participants to files (one file for each participant), written in
+     * parallel with a progress dialog.
      **********************************************************************************************/
     void exportAllParticipantDataToFile();
 
-private:
+    /*******************************************************************************************//**
+     * Export fixations, microsaccades and saccades of all participants to Apache Arrow files.
+     **********************************************************************************************/
+    void exportAllParticipantDataToArrow();
 
     /*******************************************************************************************//**
-     * Writes all data of the given trial to out.
-     *
-     * @param participant data of this participant will be written
-     * @param out         text stream element to which data will be written
+     * Export fixations, microsaccades, saccades and raw samples of all participants to Apache
+     * Arrow files.
      **********************************************************************************************/
-    void writeHeader(Participant& participant, std::ofstream& out);
+    void exportAllParticipantDataWithSamplesToArrow();
+
+    /*******************************************************************************************//**
+     * Saves all participants, test conditions and detection results with their settings to a
+     * session file (see SessionFile), so that the analysis can be continued without importing
+     * and detecting again.
+     **********************************************************************************************/
+    void exportSession();
+
+private:
 
     /*******************************************************************************************//**
-     * Writes all data of the given trial to out.
+     * Help function to export data of all participants to Apache Arrow files in a directory
+     * selected by the user, see ArrowDataWriter.
      *
-     * @param trial data of this trial will be written
-     * @param out   text stream element to which data will be written
+     * @param writeSamples if the raw samples are exported as well
      **********************************************************************************************/
-    void writeTrial(Trial& trial, std::ofstream& out);
+    void exportArrowData(bool writeSamples);
 
     /*******************************************************************************************//**
      * Help function to export data of a participant to a file.
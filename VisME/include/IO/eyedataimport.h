@@ -41,6 +41,15 @@ public:
      **********************************************************************************************/
     void readCSV(const QString& fileName);
 
+    /*******************************************************************************************//**
+     * Opens a session file (see SessionFile) and replaces all loaded participants and test
+     * conditions with the ones of the session. The loaded data is kept if the file can not be
+     * read.
+     *
+     * @param fileName file name of the session file
+     **********************************************************************************************/
+    void openSession(const QString& fileName);
+
 signals:
 
     /*******************************************************************************************//**
@@ -0,0 +1,49 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file eyedatareader.h
+ **************************************************************************************************/
+#ifndef EYEDATAREADER_H
+#define EYEDATAREADER_H
+
+#include "enums.h"
+#include "eyetrackingdata.h"
+#include "settings.h"
+#include <QString>
+#include <set>
+
+/***********************************************************************************************//**
+ * This class reads eye tracking data (.maf) and test condition (.csv) files without any user
+ * interaction. It is used by EyeDataImport and the batch processing.
+ **************************************************************************************************/
+class EyeDataReader
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Reads a .maf file with all trials of a participant.
+     *
+     * @param filePath    file that should be read
+     * @param settings    global settings
+     * @param participant result: new participant if the file was read successfully
+     * @param errorString result: error description if the file can not be opened
+     * @return if the file was read, could not be opened or contains invalid data
+     **********************************************************************************************/
+    static ImportResult readParticipant(const QString& filePath, Settings* settings,
+                                        Participant*& participant, QString& errorString);
+
+    /*******************************************************************************************//**
+     * Reads a csv file with test condition specifications (participant,trial,condition) and
+     * updates the test condition of the specified trials.
+     *
+     * @param fileName       file name of the test condition file
+     * @param data           eye tracking data with the participants
+     * @param testConditions result: all test conditions of the file
+     * @param errorString    result: error description if the file can not be opened
+     * @return false if the file can not be opened
+     **********************************************************************************************/
+    static bool readTestConditions(const QString& fileName, EyeTrackingData* data,
+                                   std::set<QString>& testConditions, QString& errorString);
+};
+
+#endif // EYEDATAREADER_H
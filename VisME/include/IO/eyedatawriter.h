@@ -0,0 +1,83 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file eyedatawriter.h
+ **************************************************************************************************/
+#ifndef EYEDATAWRITER_H
+#define EYEDATAWRITER_H
+
+#include "eyetrackingdata.h"
+#include "participant.h"
+#include "trial.h"
+#include <fstream>
+#include <QPair>
+#include <QString>
+#include <vector>
+
+/***********************************************************************************************//**
+ * This class writes participants and trials in the .maf file format without any user
+ * interaction. It is used by EyeDataExport and the batch processing.
+ **************************************************************************************************/
+class EyeDataWriter
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Writes the header (participant name, conversion factor) of the given participant to out.
+     *
+     * @param participant data of this participant will be written
+     * @param out         text stream element to which data will be written
+     **********************************************************************************************/
+    static void writeHeader(Participant& participant, std::ofstream& out);
+
+    /*******************************************************************************************//**
+     * Writes all data of the given trial to out. The text is collected in large blocks
+     * (OutputBuffer) instead of formatting and flushing each line.
+     *
+     * @param trial data of this trial will be written
+     * @param out   text stream element to which data will be written
+     **********************************************************************************************/
+    static void writeTrial(Trial& trial, std::ofstream& out);
+
+    /*******************************************************************************************//**
+     * Writes all data of the given trial to out like writeTrial, but formats each value with the
+     * stream and flushes each line (previous implementation, see BatchProcessor::benchmarkExport).
+     *
+     * @param trial data of this trial will be written
+     * @param out   text stream element to which data will be written
+     **********************************************************************************************/
+    static void writeTrialStream(Trial& trial, std::ofstream& out);
+
+    /*******************************************************************************************//**
+     * Writes the header and all trials of the given participant to out.
+     *
+     * @param participant data of this participant will be written
+     * @param out         text stream element to which data will be written
+     **********************************************************************************************/
+    static void writeParticipant(Participant& participant, std::ofstream& out);
+
+    /*******************************************************************************************//**
+     * Writes the given participant to a new .maf file, see writeParticipant.
+     *
+     * @param participant data of this participant will be written
+     * @param fileName    file name, an existing file is replaced
+     * @return false if the file can not be written
+     **********************************************************************************************/
+    static bool writeParticipantFile(Participant& participant, const QString& fileName);
+
+    /*******************************************************************************************//**
+     * Returns the .maf files of all participants in the given directory (file names are the
+     * modified participant names), e.g., to write them in parallel with writeParticipantFile.
+     *
+     * If several participants lead to the same file name, only the last one is returned, so that
+     * the files are the same as if all participants were written one after another.
+     *
+     * @param data eye tracking data
+     * @param dir  directory
+     * @return participants and their file names in the order of the participants
+     **********************************************************************************************/
+    static std::vector<QPair<Participant*, QString> > participantFiles(EyeTrackingData& data,
+                                                                        const QString& dir);
+};
+
+#endif // EYEDATAWRITER_H
@@ -0,0 +1,93 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file outputbuffer.h
+ **************************************************************************************************/
+#ifndef OUTPUTBUFFER_H
+#define OUTPUTBUFFER_H
+
+#include <ostream>
+#include <QtGlobal>
+#include <string>
+
+/***********************************************************************************************//**
+ * This class collects formatted text in a large block and writes it to a stream at once, e.g.,
+ * for the gaze samples of .maf files (EyeDataWriter).
+ *
+ * Numbers are formatted directly into the block without temporary strings. The text is the same
+ * as with the default formatting of std::ostream in the classic locale: integers in decimal
+ * notation, floating point values like printf("%g") with 6 significant digits and a decimal point
+ * independent of LC_NUMERIC.
+ **************************************************************************************************/
+class OutputBuffer
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Constructor.
+     *
+     * @param out      stream to which the text is written
+     * @param capacity size of the block in bytes which is collected before it is written
+     **********************************************************************************************/
+    OutputBuffer(std::ostream& out, size_t capacity = 1 << 20);
+
+    /*******************************************************************************************//**
+     * Destructor, writes the remaining text.
+     **********************************************************************************************/
+    ~OutputBuffer();
+
+    /*******************************************************************************************//**
+     * Appends text.
+     *
+     * @param text text
+     * @return this buffer
+     **********************************************************************************************/
+    OutputBuffer& operator<<(const char* text);
+
+    /*******************************************************************************************//**
+     * Appends text.
+     *
+     * @param text text
+     * @return this buffer
+     **********************************************************************************************/
+    OutputBuffer& operator<<(const std::string& text);
+
+    /*******************************************************************************************//**
+     * Appends an integer in decimal notation.
+     *
+     * @param value value
+     * @return this buffer
+     **********************************************************************************************/
+    OutputBuffer& operator<<(int value);
+
+    /*******************************************************************************************//**
+     * Appends a floating point value with 6 significant digits like printf("%g").
+     *
+     * @param value value
+     * @return this buffer
+     **********************************************************************************************/
+    OutputBuffer& operator<<(qreal value);
+
+    /*******************************************************************************************//**
+     * Writes the collected text to the stream.
+     **********************************************************************************************/
+    void flush();
+
+private:
+
+    /*******************************************************************************************//**
+     * Writes the collected text if the block is full.
+     **********************************************************************************************/
+    void flushIfFull();
+
+    /// Stream to which the text is written.
+    std::ostream& m_out;
+
+    /// Size of the block.
+    size_t m_capacity;
+
+    /// Collected text.
+    std::string m_buffer;
+};
+
+#endif // OUTPUTBUFFER_H
@@ -0,0 +1,83 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file parametersweepexport.h
+ **************************************************************************************************/
+#ifndef PARAMETERSWEEPEXPORT_H
+#define PARAMETERSWEEPEXPORT_H
+
+#include "cancellationtoken.h"
+#include "eyetrackingdata.h"
+#include "settings.h"
+#include <QObject>
+#include <QWidget>
+
+/***********************************************************************************************//**
+ * This class is responsible for running a microsaccade parameter sweep and exporting the results
+ * as table to a text file.
+ **************************************************************************************************/
+class ParameterSweepExport : public QObject
+{
+
+    Q_OBJECT
+
+public:
+
+    /*******************************************************************************************//**
+     * Constructor.
+     *
+     * @param parent          parent widget
+     * @param eyeTrackingData eye tracking data
+     * @param settings        global settings
+     **********************************************************************************************/
+    ParameterSweepExport(QWidget* parent, EyeTrackingData* eyeTrackingData, Settings* settings);
+
+public slots:
+
+    /*******************************************************************************************//**
+     * Asks for lists of velocity thresholds and minimum durations, evaluates microsaccade
+     * detection for all combinations and writes the results to a csv file.
+     *
+     * In multi trial mode the selected trials are used, otherwise all trials of all participants.
+     * All other parameters are taken from the current microsaccade settings. The sweep runs in
+     * the background with a progress dialog and can be canceled; no file is written then.
+     **********************************************************************************************/
+    void exportParameterSweep();
+
+signals:
+
+    /*******************************************************************************************//**
+     * Emitted from the worker threads of the sweep after each evaluated trial.
+     *
+     * @param evaluated number of evaluated trials
+     **********************************************************************************************/
+    void trialsEvaluated(int evaluated);
+
+private:
+
+    /*******************************************************************************************//**
+     * Parses a comma separated list of numbers.
+     *
+     * @param text   input text
+     * @param values result values
+     * @return false if the list is empty or contains invalid numbers
+     **********************************************************************************************/
+    bool parseValues(const QString& text, std::vector<qreal>& values) const;
+
+    /// Main window.
+    QWidget* m_parent;
+
+    /// Eye tracking data.
+    EyeTrackingData* m_eyeTrackingData;
+
+    /// Settings.
+    Settings* m_settings;
+
+    /// Creates the cancellation tokens of the sweeps.
+    CancellationSource m_cancellation;
+
+    /// Last used parameter lists.
+    QString m_velocityThresholds;
+    QString m_minDurations;
+};
+
+#endif // PARAMETERSWEEPEXPORT_H
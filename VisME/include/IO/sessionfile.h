@@ -0,0 +1,59 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file sessionfile.h
+ **************************************************************************************************/
+#ifndef SESSIONFILE_H
+#define SESSIONFILE_H
+
+#include "enums.h"
+#include "eyetrackingdata.h"
+#include "settings.h"
+#include <QString>
+#include <QStringList>
+#include <set>
+#include <vector>
+
+/***********************************************************************************************//**
+ * This class writes and reads study session files (.vms) without any user interaction. A session
+ * contains the complete analysis state: all participants with their source files, the test
+ * conditions and, for each trial, the gaze data, the fixations and microsaccades from the input
+ * file, the calculated fixations, saccades and microsaccades and the detection settings
+ * (SaccadeFilterSettings) which were used for the trial.
+ *
+ * The data is stored in binary form with QDataStream, so that a session is restored without
+ * parsing text and without running the detection again. Detection candidates and other caches
+ * of the trials are not stored; they are computed again when needed.
+ **************************************************************************************************/
+class SessionFile
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Writes all participants and the test conditions to a session file.
+     *
+     * @param fileName       file name, an existing file is replaced
+     * @param data           eye tracking data with the participants
+     * @param testConditions names of all test conditions
+     * @param errorString    result: error description if the file can not be written
+     * @return false if the file can not be written
+     **********************************************************************************************/
+    static bool write(const QString& fileName, EyeTrackingData& data,
+                      const QStringList& testConditions, QString& errorString);
+
+    /*******************************************************************************************//**
+     * Reads a session file.
+     *
+     * @param fileName       file that should be read
+     * @param settings       global settings
+     * @param participants   result: new participants if the file was read successfully
+     * @param testConditions result: names of all test conditions of the session
+     * @param errorString    result: error description if the file can not be opened
+     * @return if the file was read, could not be opened or contains invalid data
+     **********************************************************************************************/
+    static ImportResult read(const QString& fileName, Settings* settings,
+                             std::vector<Participant*>& participants,
+                             std::set<QString>& testConditions, QString& errorString);
+};
+
+#endif // SESSIONFILE_H
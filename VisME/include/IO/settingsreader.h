@@ -0,0 +1,90 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file settingsreader.h
+ **************************************************************************************************/
+#ifndef SETTINGSREADER_H
+#define SETTINGSREADER_H
+
+#include "saccadefiltersettings.h"
+#include <QList>
+#include <QPair>
+#include <QString>
+
+/***********************************************************************************************//**
+ * This class reads microsaccade (.mpf) and fixation (.fpf) parameter files without any user
+ * interface. Keys are the same as in SettingsImport; values are limited to the ranges of the
+ * corresponding spin boxes so that the resulting settings are the same as after importing the
+ * file in the user interface.
+ **************************************************************************************************/
+class SettingsReader
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Reads all key=value lines of a parameter file.
+     *
+     * @param fileName    parameter file
+     * @param values      result: key value pairs in the order of the file
+     * @param errorString result: error description if the file can not be opened
+     * @return false if the file can not be opened
+     **********************************************************************************************/
+    static bool readSettingsFile(const QString& fileName, QList<QPair<QString, QString> >& values,
+                                 QString& errorString);
+
+    /*******************************************************************************************//**
+     * Reads a microsaccade parameter file; parameters which are not in the file are not changed.
+     *
+     * @param fileName    parameter file
+     * @param settings    microsaccade settings which are updated
+     * @param errorString result: error description if the file can not be opened
+     * @return false if the file can not be opened
+     **********************************************************************************************/
+    static bool readMicrosaccadeSettings(const QString& fileName, SaccadeFilterSettings& settings,
+                                         QString& errorString);
+
+    /*******************************************************************************************//**
+     * Reads a fixation parameter file; parameters which are not in the file are not changed.
+     *
+     * @param fileName    parameter file
+     * @param settings    fixation settings which are updated
+     * @param errorString result: error description if the file can not be opened
+     * @return false if the file can not be opened
+     **********************************************************************************************/
+    static bool readFixationSettings(const QString& fileName, SaccadeFilterSettings& settings,
+                                     QString& errorString);
+
+private:
+
+    /*******************************************************************************************//**
+     * Sets the parameters of the given key value pairs.
+     *
+     * @param values       key value pairs
+     * @param settings     settings which are updated
+     * @param microsaccade if the keys of a microsaccade or fixation parameter file are used
+     **********************************************************************************************/
+    static void applySettings(const QList<QPair<QString, QString> >& values,
+                              SaccadeFilterSettings& settings, bool microsaccade);
+
+    /*******************************************************************************************//**
+     * Converts a value like an integer spin box.
+     *
+     * @param value   value from the file
+     * @param minimum minimum of the spin box
+     * @param maximum maximum of the spin box
+     * @return value within the range
+     **********************************************************************************************/
+    static int toInt(const QString& value, int minimum, int maximum);
+
+    /*******************************************************************************************//**
+     * Converts a value like a double spin box (two decimals).
+     *
+     * @param value   value from the file
+     * @param minimum minimum of the spin box
+     * @param maximum maximum of the spin box
+     * @return value within the range
+     **********************************************************************************************/
+    static qreal toDouble(const QString& value, qreal minimum, qreal maximum);
+};
+
+#endif // SETTINGSREADER_H
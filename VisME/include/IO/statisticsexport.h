@@ -22,29 +22,7 @@ public:
      * Constructor.
      * Initializes values.
      *
-     * Values used in this class:
-     * data types:
-     * if exportDirectionalData:
-     *     0: #Raw Data Samples in Trials
-     *     1: Duration of Trials [s]
-     *     2: #Fixations in Trials
-     *     3: #Fixations with Microsaccades in Trials
-     *     4: Fixations containing Microsaccades [%]
-     *     5: Fixation Duration [s]
-     *     6: Fixation (with Microsaccades) Duration [s]
-     *     7: #Microsaccades in Trials
-     *     8: #Microsaccades per Fixation
-     *     9: #Microsaccades per Fixation with Microsaccades
-     *     10: #Microsaccades per Second (for Trials)
-     *     11: #Microsaccades per Second in Fixations (for Trials)
-     *     12: Microsaccade Amplitude [°]
-     *     13: Inter-saccadic Interval [ms]
-     *     14: Microsaccade Duration [ms]
-     *     15: Microsaccade Peak Velocity [°/s]
-     * else:
-     *     0: DirectionFromView
-     *     1: DirectionTowardsNextFixation
-     *     2: DirectionTowardsPreviousFixation
+     * Data and value types are described in AggregatedStatistics.
      *
      * @param parent          parent widget
      * @param eyeTrackingData eye tracking data
@@ -85,48 +63,6 @@ private slots:
 
 private:
 
-    /*******************************************************************************************//**
-     * Creates a new sub directory for all exports.
-     *
-     * @param path existing directory path.
-     **********************************************************************************************/
-    QString subDirPath(const QString path);
-
-    /*******************************************************************************************//**
-     * Returns a file nime depending on the data type.
-     *
-     * @param dataType data type, see above
-     * @param dir      existing directory
-     **********************************************************************************************/
-    QString getFileName(int dataType, const QString dir);
-
-    /*******************************************************************************************//**
-     * Returns a list of datat samples for the given participant, test condition and the data type.
-     *
-     * @param p             current participant
-     * @param testCondition current test condition
-     * @param dataType      data type, see above
-     * @param dataCount     value which has to be used to determine mean value
-     * @return list of datat samples for the given participant, test condition and the data type
-     **********************************************************************************************/
-    std::vector<qreal> getDataSamples(Participant* p, const QString testCondition, int dataType,
-                                      int& dataCount);
-
-    /*******************************************************************************************//**
-     * Returns the value for the given value type and data samples.
-     *
-     * if exportDirectionalData:
-     *     valueType: 0: min, 1: max, 2: mean, 3: median, 4: sum, 5: single values
-     * else:
-     *     valueType: 0: mean, 1: single values
-     *
-     * @param dataSamples list of data samples
-     * @param valueType   value type, representing for example min, max, sum, ...
-     * @param dataCount   element/samples count
-     * @return value as string
-     **********************************************************************************************/
-    QString getValue(std::vector<qreal> dataSamples, int valueType, int dataCount = -1);
-
     /// Main window.
     QWidget* m_parent;
 
@@ -147,9 +83,6 @@ private:
     QStringList m_exportData;
     QStringList m_exportValueTypes;
 
-    /// Indices of m_exportData for which sum can not be determined.
-    std::vector<size_t> m_sumNotAvailable;
-
     /// Directional or other data will be exported
     bool exportDirectionalData;
 };
@@ -0,0 +1,220 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file batchprocessor.h
+ **************************************************************************************************/
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include "eyetrackingdata.h"
+#include "settings.h"
+#include "settingssnapshot.h"
+#include <ostream>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+/***********************************************************************************************//**
+ * This class processes eye tracking data without user interface (visme-batch): it loads .maf
+ * files, detects fixations and microsaccades for all trials in parallel, and writes the results
+ * like the export functions of the user interface (EyeDataExport, StatisticsExport).
+ *
+ * Detection of a trial is the same as applying the fixation and microsaccade settings to all
+ * participants in the user interface.
+ **************************************************************************************************/
+class BatchProcessor
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Constructor.
+     *
+     * @param settings global settings with the fixation and microsaccade settings
+     **********************************************************************************************/
+    BatchProcessor(Settings* settings);
+
+    /*******************************************************************************************//**
+     * Loads the given .maf files, files which can not be read are skipped.
+     *
+     * @param fileNames .maf files
+     * @return number of files which could not be read
+     **********************************************************************************************/
+    int loadFiles(const QStringList& fileNames);
+
+    /*******************************************************************************************//**
+     * Adds a participant with synthetic trials, see DetectionRegression.
+     *
+     * @param trialCount number of trials
+     **********************************************************************************************/
+    void addSyntheticTrials(int trialCount);
+
+    /*******************************************************************************************//**
+     * Loads test conditions from a csv file and sets them in the settings.
+     *
+     * @param fileName test condition file
+     * @return false if the file can not be opened
+     **********************************************************************************************/
+    bool loadTestConditions(const QString& fileName);
+
+    /*******************************************************************************************//**
+     * Resamples all trials with a different sampling rate to the given rate in parallel (see
+     * Resampler), so that settings in ms map to the same number of samples for all trials.
+     *
+     * @param frequency common sampling rate [Hz]
+     * @return number of trials which could not be resampled (non-integer rates)
+     **********************************************************************************************/
+    int resample(int frequency);
+
+    /*******************************************************************************************//**
+     * Detects fixations and microsaccades for all trials in parallel with a snapshot of the
+     * settings (SettingsSnapshot).
+     **********************************************************************************************/
+    void detect();
+
+    /*******************************************************************************************//**
+     * Runs all microsaccade detection algorithms on the same prepared data of all trials (gaze
+     * type and microsaccade settings of the global settings) and writes counts and run times as
+     * csv, see AlgorithmComparison. The trials are not changed.
+     *
+     * @param out output stream
+     **********************************************************************************************/
+    void compareAlgorithms(std::ostream& out);
+
+    /*******************************************************************************************//**
+     * Replays the gaze data of all trials sample by sample through the streaming microsaccade
+     * detector and compares the results with the batch detection using the same settings (see
+     * StreamingSaccadeDetector::compareWithBatch). The agreement (matched microsaccades divided
+     * by the larger count) is written as csv for each trial. The trials are not changed.
+     *
+     * The streaming detector estimates the threshold on a sliding window instead of the whole
+     * section, so small differences are expected; 1 requires identical microsaccade counts.
+     *
+     * @param minAgreement minimum agreement of each trial (0 to 1)
+     * @param out          output stream
+     * @return false if the agreement of a trial is below minAgreement
+     **********************************************************************************************/
+    bool compareStreaming(qreal minAgreement, std::ostream& out);
+
+    /*******************************************************************************************//**
+     * Computes the velocity values of all microsaccade sections of all trials with the generic
+     * and the specialized kernels (VelocityKernels) for the window sizes 3 to 11, checks that the
+     * results are identical and writes the run times as csv.
+     *
+     * @param out output stream
+     * @return false if the kernels lead to different results
+     **********************************************************************************************/
+    bool benchmarkVelocityKernels(std::ostream& out);
+
+    /*******************************************************************************************//**
+     * Writes all participants to a .maf file in the given directory with the buffered
+     * (EyeDataWriter::writeTrial) and the stream based writer (EyeDataWriter::writeTrialStream),
+     * checks that both files are identical, removes them and writes the throughput as csv.
+     *
+     * @param dir existing directory for the temporary files
+     * @param out output stream
+     * @return false if the files differ or can not be written
+     **********************************************************************************************/
+    bool benchmarkExport(const QString& dir, std::ostream& out);
+
+    /*******************************************************************************************//**
+     * Formats floating point values (boundaries of all notations of OutputBuffer and the gaze
+     * positions of all trials) with OutputBuffer while LC_NUMERIC is set to the given locale,
+     * e.g., de_DE with a decimal comma, and checks that the text is identical to std::ostream in
+     * the classic locale like the stream based .maf writer. Writes the result as csv.
+     *
+     * @param localeName name of the locale, e.g., de_DE.UTF-8
+     * @param out        output stream
+     * @return false if the texts differ or the locale is not available
+     **********************************************************************************************/
+    bool checkNumberFormat(const QString& localeName, std::ostream& out);
+
+    /*******************************************************************************************//**
+     * Runs the microsaccade and saccade detection for all trials with 1, 2 and the ideal number
+     * of threads, checks that all results are identical and equal to the golden file and writes
+     * the throughput as csv, see DetectionRegression.
+     *
+     * @param goldenFile  golden file
+     * @param writeGolden if the golden file is written instead of compared
+     * @param out         output stream
+     * @return false if results differ or the golden file can not be read or written
+     **********************************************************************************************/
+    bool runRegression(const QString& goldenFile, bool writeGolden, std::ostream& out);
+
+    /*******************************************************************************************//**
+     * Writes one .maf file for each participant to the given directory in parallel (file names
+     * like in EyeDataExport::exportAllParticipantDataToFile, see EyeDataWriter::participantFiles).
+     *
+     * @param dir existing directory
+     * @return number of files which could not be written
+     **********************************************************************************************/
+    int writeEyeData(const QString& dir);
+
+    /*******************************************************************************************//**
+     * Writes fixations, microsaccades, saccades and optionally raw samples of all participants as
+     * Apache Arrow files to the given directory, see ArrowDataWriter.
+     *
+     * @param dir          existing directory
+     * @param writeSamples if the raw samples are written as well
+     * @return false if a file can not be written
+     **********************************************************************************************/
+    bool writeArrowData(const QString& dir, bool writeSamples);
+
+    /*******************************************************************************************//**
+     * Writes all participants, test conditions and detection results as study session
+     * (session.vms) to the given directory, which can be opened in the user interface, see
+     * SessionFile.
+     *
+     * @param dir existing directory
+     * @return false if the file can not be written
+     **********************************************************************************************/
+    bool writeSession(const QString& dir);
+
+    /*******************************************************************************************//**
+     * Writes the event-locked microsaccade rates of all participants and test conditions for the
+     * given event (eventLockedRate.csv) to the given directory, see EventLockedRate.
+     *
+     * @param dir       existing directory
+     * @param eventName name of the events the microsaccades are aligned to
+     * @return false if the file can not be written
+     **********************************************************************************************/
+    bool writeEventLockedRate(const QString& dir, const QString& eventName);
+
+    /*******************************************************************************************//**
+     * Writes aggregated statistics for all data types to a new sub directory of the given
+     * directory (like StatisticsExport).
+     *
+     * @param dir             existing directory
+     * @param valueType       value type, see AggregatedStatistics
+     * @param directionalData if directional data or other data will be exported
+     * @return created sub directory; empty if the directory or a file can not be written
+     **********************************************************************************************/
+    QString writeStatistics(const QString& dir, int valueType, bool directionalData);
+
+    /*******************************************************************************************//**
+     * Returns the loaded eye tracking data.
+     **********************************************************************************************/
+    EyeTrackingData* data();
+
+    /*******************************************************************************************//**
+     * Returns all trials of all participants.
+     **********************************************************************************************/
+    std::vector<Trial*> trials();
+
+private:
+
+    /*******************************************************************************************//**
+     * Detects fixations and microsaccades for one trial, see MainWindow::updateFixationsDetection.
+     *
+     * @param trial    current trial
+     * @param settings settings snapshot shared by all trials
+     **********************************************************************************************/
+    void detectTrial(Trial* trial, const SettingsSnapshot& settings);
+
+    /// Global settings.
+    Settings* m_settings;
+
+    /// Eye tracking data containing all participant data.
+    EyeTrackingData m_data;
+};
+
+#endif // BATCHPROCESSOR_H
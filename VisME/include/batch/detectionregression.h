@@ -0,0 +1,139 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file detectionregression.h
+ **************************************************************************************************/
+#ifndef DETECTIONREGRESSION_H
+#define DETECTIONREGRESSION_H
+
+#include "participant.h"
+#include "settings.h"
+#include "settingssnapshot.h"
+#include <ostream>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+class Trial;
+
+/***********************************************************************************************//**
+ * struct DetectionRegressionResult
+ *
+ * Result of one run of the regression check with a given number of threads.
+ **************************************************************************************************/
+struct DetectionRegressionResult
+{
+    DetectionRegressionResult():
+        m_threadCount(0),
+        m_samples(0),
+        m_elapsedNs(0)
+    {}
+
+    int m_threadCount;
+
+    // Number of gaze samples of all gaze types of all trials.
+    size_t m_samples;
+
+    // Run time of the detection [ns].
+    qint64 m_elapsedNs;
+
+    // One line per (micro)saccade, see DetectionRegression::trialLines.
+    QStringList m_lines;
+};
+
+/***********************************************************************************************//**
+ * This class checks that the parallel detection does not depend on the number of threads or the
+ * scheduling: SaccadeDetector::determineMicrosaccades and SaccadeDetector::determineRegularSaccades
+ * are run for all trials with different numbers of threads and the onset/end indices, peak
+ * velocities and amplitudes are compared bit for bit with each other and with a golden file.
+ *
+ * Values are written with 17 significant digits so that the text representation of the golden
+ * file is exact.
+ **************************************************************************************************/
+class DetectionRegression
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Constructor.
+     *
+     * @param settings global settings with the fixation and microsaccade settings
+     **********************************************************************************************/
+    DetectionRegression(Settings* settings);
+
+    /*******************************************************************************************//**
+     * Creates a participant with synthetic trials (noise, drift, (micro)saccades and missing
+     * data), the data only depends on the trial index.
+     *
+     * @param trialCount number of trials
+     * @return new participant; the caller takes ownership
+     **********************************************************************************************/
+    Participant* createSyntheticParticipant(int trialCount);
+
+    /*******************************************************************************************//**
+     * Runs the detection for all trials once for each number of threads. Cached candidates of
+     * the trials are removed before each run.
+     *
+     * @param trials       trials, processed in parallel
+     * @param threadCounts numbers of threads
+     * @return one result for each number of threads
+     **********************************************************************************************/
+    std::vector<DetectionRegressionResult> run(const std::vector<Trial*>& trials,
+                                               const std::vector<int>& threadCounts);
+
+    /*******************************************************************************************//**
+     * Compares the lines of two results.
+     *
+     * @param expected    expected lines (e.g., golden file)
+     * @param actual      actual lines
+     * @param errorString result: description of the first difference
+     * @return true if both are identical
+     **********************************************************************************************/
+    static bool compare(const QStringList& expected, const QStringList& actual,
+                        QString& errorString);
+
+    /*******************************************************************************************//**
+     * Reads a golden file.
+     *
+     * @param fileName    golden file
+     * @param lines       result: lines of the file
+     * @param errorString result: error description if the file can not be opened
+     * @return false if the file can not be opened
+     **********************************************************************************************/
+    static bool readGoldenFile(const QString& fileName, QStringList& lines, QString& errorString);
+
+    /*******************************************************************************************//**
+     * Writes a golden file.
+     *
+     * @param fileName golden file
+     * @param lines    lines of a result
+     * @return false if the file can not be written
+     **********************************************************************************************/
+    static bool writeGoldenFile(const QString& fileName, const QStringList& lines);
+
+    /*******************************************************************************************//**
+     * Writes the throughput of all results as csv.
+     *
+     * @param results results of run()
+     * @param out     output stream
+     **********************************************************************************************/
+    static void writeCsv(const std::vector<DetectionRegressionResult>& results, std::ostream& out);
+
+private:
+
+    /*******************************************************************************************//**
+     * Runs the detection for one trial and returns one line per (micro)saccade:
+     * participant, trial, type (MS/S), gaze type, onset, end, peak velocity, horizontal and
+     * vertical amplitude.
+     *
+     * @param trial    current trial
+     * @param settings settings snapshot
+     * @return lines of the trial
+     **********************************************************************************************/
+    QStringList trialLines(Trial* trial, const SettingsSnapshot& settings);
+
+    /// Global settings.
+    Settings* m_settings;
+};
+
+#endif // DETECTIONREGRESSION_H
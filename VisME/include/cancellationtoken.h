@@ -0,0 +1,86 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file cancellationtoken.h
+ **************************************************************************************************/
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+#include <QAtomicInt>
+
+class CancellationSource;
+
+/**********************************************************************************************//**
+ * class CancellationToken
+ *
+ * Passed to long running computations (detection, statistics) which check it at trial or
+ * section granularity and stop early if it is canceled. A default constructed token is never
+ * canceled. Tokens are created by a CancellationSource and are canceled as soon as the source
+ * starts a new job or is canceled; they can be checked from any thread.
+ **************************************************************************************************/
+class CancellationToken
+{
+
+public:
+
+    CancellationToken() :
+        m_generation(nullptr),
+        m_value(0)
+    {}
+
+    // Returns if the job of this token was canceled.
+    bool isCanceled() const
+    {
+        return m_generation != nullptr && m_generation->loadAcquire() != m_value;
+    }
+
+private:
+
+    friend class CancellationSource;
+
+    CancellationToken(const QAtomicInt* generation, int value) :
+        m_generation(generation),
+        m_value(value)
+    {}
+
+    // Job counter of the source, nullptr if the token is never canceled.
+    const QAtomicInt* m_generation;
+
+    // Value of the counter when the job was started.
+    int m_value;
+};
+
+/**********************************************************************************************//**
+ * class CancellationSource
+ *
+ * Creates the tokens for one kind of job (e.g., detection for all trials): starting a new job
+ * cancels the previous one, so that stale work stops and the new job can start immediately. The
+ * source must exist as long as its tokens are used.
+ **************************************************************************************************/
+class CancellationSource
+{
+
+public:
+
+    CancellationSource() :
+        m_generation(0)
+    {}
+
+    // Cancels the running job and returns the token of a new job.
+    CancellationToken start()
+    {
+        return CancellationToken(&m_generation, m_generation.fetchAndAddOrdered(1) + 1);
+    }
+
+    // Cancels the running job.
+    void cancel()
+    {
+        m_generation.fetchAndAddOrdered(1);
+    }
+
+private:
+
+    // Job counter, incremented for each new job and cancellation.
+    QAtomicInt m_generation;
+};
+
+#endif // CANCELLATIONTOKEN_H
@@ -104,4 +104,68 @@ enum PlotAggregation
     PA_ForParticipants
 };
 
+/***********************************************************************************************//**
+ * Result of reading an eye tracking data file.
+ **************************************************************************************************/
+enum ImportResult
+{
+    IR_Success,
+    IR_OpenFailed,
+    IR_InvalidData
+};
+
+/***********************************************************************************************//**
+ * Algorithms to detect (micro)saccade candidates from the velocity values of a section.
+ **************************************************************************************************/
+enum DetectionAlgorithm
+{
+    DA_EngbertKliegl,
+    DA_AdaptiveThreshold
+};
+
+/***********************************************************************************************//**
+ * Filters to smooth the gaze positions before the velocity computation.
+ **************************************************************************************************/
+enum PreFilterType
+{
+    PFT_None,
+    PFT_SavitzkyGolay,
+    PFT_RunningMedian
+};
+
+/***********************************************************************************************//**
+ * Interpolation of short gaps of missing data before the detection.
+ **************************************************************************************************/
+enum GapInterpolationType
+{
+    GIT_None,
+    GIT_Linear,
+    GIT_Cubic
+};
+
+/***********************************************************************************************//**
+ * Metrics of the statistics table, in the same order as the data types of the aggregated
+ * statistics (AggregatedStatistics).
+ **************************************************************************************************/
+enum StatisticsMetric
+{
+    SM_RawDataSamples, // per trial
+    SM_TrialDuration,
+    SM_FixationCount,
+    SM_FixationWithMSCount,
+    SM_FixationWithMSPercentage,
+    SM_FixationDuration, // per fixation
+    SM_FixationWithMSDuration,
+    SM_MSCount, // per trial
+    SM_MSPerFixation, // per fixation
+    SM_MSPerFixationWithMS,
+    SM_MSPerSecond, // per trial
+    SM_MSPerSecondInFixations,
+    SM_MSAmplitude, // per microsaccade
+    SM_IntersaccadicInterval,
+    SM_MSDuration,
+    SM_MSPeakVelocity,
+    SM_Count
+};
+
 #endif // ENUMS_H
@@ -6,11 +6,8 @@
 #define FIXATION_H
 
 #include "saccade.h"
-#include "settings.h"
 #include <vector>
 
-struct Settings;
-
 /***********************************************************************************************//**
  * This class contains all information of a fixation.
  **************************************************************************************************/
@@ -22,7 +19,7 @@ public:
     /*******************************************************************************************//**
      * Constructor
      **********************************************************************************************/
-    Fixation(Settings* settings);
+    Fixation();
 
     /*******************************************************************************************//**
      * Returns the x position.
@@ -156,9 +153,6 @@ public:
 
 private:
 
-    /// Current settings for visualizations.
-    Settings* m_settings;
-
     /// x position (center of fixation).
     qreal m_xPosition;
 
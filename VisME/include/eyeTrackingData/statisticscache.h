@@ -0,0 +1,67 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file statisticscache.h
+ **************************************************************************************************/
+#ifndef STATISTICSCACHE_H
+#define STATISTICSCACHE_H
+
+#include "cancellationtoken.h"
+#include "settingssnapshot.h"
+#include "statisticstable.h"
+#include "trial.h"
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <vector>
+
+/***********************************************************************************************//**
+ * This class caches the statistics metrics (StatisticsTable) of single trials, so that the
+ * statistics of many trials only recompute the trials whose data (Trial::revision) or relevant
+ * settings (gaze type, time range) changed since the last computation.
+ *
+ * The cache is used by the statistics dock widget which computes the statistics in a background
+ * job; it can be used from any thread, but the trials must not be changed during a computation.
+ **************************************************************************************************/
+class StatisticsCache
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Returns the statistics metrics of the trials in one group, the metrics of trials which are
+     * not cached (or outdated) are computed and cached.
+     *
+     * @param trials         trials with detected fixations and microsaccades
+     * @param settings       settings snapshot, see StatisticsTable
+     * @param limitTimeRange if the time range of the settings is applied (if activated)
+     * @param cancellation   token of the computation, checked for each trial
+     * @return table with one group or a null pointer if canceled
+     **********************************************************************************************/
+    QSharedPointer<StatisticsTable> table(const std::vector<Trial*>& trials,
+                                          const SettingsSnapshot& settings, bool limitTimeRange,
+                                          const CancellationToken& cancellation);
+
+    /*******************************************************************************************//**
+     * Removes all cached trials, e.g., before the trials are deleted.
+     **********************************************************************************************/
+    void clear();
+
+private:
+
+    /*******************************************************************************************//**
+     * Metrics of a trial and the revision of the trial for which they were computed.
+     **********************************************************************************************/
+    struct TrialStatistics
+    {
+        int m_revision;
+        QSharedPointer<const StatisticsTable> m_table;
+    };
+
+    /// Cached metrics for each trial.
+    QHash<Trial*, TrialStatistics> m_trials;
+
+    /// Protects the cached metrics.
+    QMutex m_mutex;
+};
+
+#endif // STATISTICSCACHE_H
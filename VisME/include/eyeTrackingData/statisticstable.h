@@ -0,0 +1,133 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file statisticstable.h
+ **************************************************************************************************/
+#ifndef STATISTICSTABLE_H
+#define STATISTICSTABLE_H
+
+#include "enums.h"
+#include "quantilesketch.h"
+#include "settingssnapshot.h"
+#include "trial.h"
+#include <vector>
+
+/***********************************************************************************************//**
+ * This class computes all statistics metrics (StatisticsMetric) of trials in one pass over their
+ * fixations and microsaccades and stores them column wise: one column of values for each group
+ * of trials (e.g., participant and test condition) and metric. Values are ordered like the
+ * trials, fixations and microsaccades which were added.
+ *
+ * The table is used by the aggregated statistics (AggregatedStatistics) and the statistics dock
+ * widget, which only aggregate the columns. If approximate quantiles are activated in the
+ * settings, the table additionally keeps a quantile sketch (QuantileSketch) for each group and
+ * metric, which is merged with the values of other tables instead of sorting all values.
+ **************************************************************************************************/
+class StatisticsTable
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Constructor.
+     *
+     * @param settings       settings snapshot with the gaze type, the microsaccade settings and
+     *                       the time range
+     * @param limitTimeRange if the time range of the settings is applied (if activated), i.e.,
+     *                       only samples and fixations inside the time range are used
+     **********************************************************************************************/
+    StatisticsTable(const SettingsSnapshot& settings, bool limitTimeRange);
+
+    /*******************************************************************************************//**
+     * Adds a new empty group.
+     *
+     * @return index of the group
+     **********************************************************************************************/
+    int addGroup();
+
+    /*******************************************************************************************//**
+     * Computes the metrics of the trial and appends them to the columns of the group.
+     *
+     * @param trial trial with detected fixations and microsaccades
+     * @param group index of an existing group
+     **********************************************************************************************/
+    void addTrial(Trial* trial, int group);
+
+    /*******************************************************************************************//**
+     * Appends the values and trials of a group of another table with the same settings (see
+     * computesSameValues) to the group, e.g., cached values of single trials.
+     *
+     * @param group      index of an existing group
+     * @param other      other table
+     * @param otherGroup index of an existing group of the other table
+     **********************************************************************************************/
+    void addValues(int group, const StatisticsTable& other, int otherGroup);
+
+    /*******************************************************************************************//**
+     * Returns if this table computes the same values for a trial as a table with the given
+     * settings, i.e., gaze type, microsaccades from the input file, time range and approximate
+     * quantiles are equal.
+     *
+     * @param settings       settings snapshot
+     * @param limitTimeRange if the time range of the settings is applied (if activated)
+     **********************************************************************************************/
+    bool computesSameValues(const SettingsSnapshot& settings, bool limitTimeRange) const;
+
+    /*******************************************************************************************//**
+     * Returns the number of groups.
+     **********************************************************************************************/
+    int numberOfGroups() const;
+
+    /*******************************************************************************************//**
+     * Returns the number of trials added to the group.
+     *
+     * @param group index of an existing group
+     **********************************************************************************************/
+    size_t trialCount(int group) const;
+
+    /*******************************************************************************************//**
+     * Returns the values of the metric for all trials, fixations or microsaccades of the group.
+     *
+     * @param group  index of an existing group
+     * @param metric metric
+     * @return column of values
+     **********************************************************************************************/
+    const std::vector<qreal>& values(int group, StatisticsMetric metric) const;
+
+    /*******************************************************************************************//**
+     * Returns the p-quantile of the values of the metric (see QuantileSketch::quantile), estimated
+     * with the quantile sketch if approximate quantiles are activated and exact otherwise.
+     *
+     * @param group  index of an existing group
+     * @param metric metric
+     * @param p      quantile in [0, 1], e.g., 0.5 for the median
+     * @return value and rank error (0 if exact)
+     **********************************************************************************************/
+    QuantileSketch::Estimate quantile(int group, StatisticsMetric metric, qreal p) const;
+
+    /*******************************************************************************************//**
+     * Returns the largest rank error of the quantiles of all metrics of the group.
+     *
+     * @param group index of an existing group
+     * @return normalized rank error, 0 if all quantiles are exact
+     **********************************************************************************************/
+    qreal rankError(int group) const;
+
+private:
+
+    /// Snapshot of the settings when this object was created.
+    const SettingsSnapshot m_settings;
+
+    /// If the time range of the settings is applied.
+    bool m_limitTimeRange;
+
+    /// Columns for each group and metric.
+    std::vector<std::vector<std::vector<qreal> > > m_columns;
+
+    /// Number of trials for each group.
+    std::vector<size_t> m_trialCounts;
+
+    /// Quantile sketches for each group and metric, only with approximate quantiles.
+    std::vector<std::vector<QuantileSketch> > m_sketches;
+};
+
+#endif // STATISTICSTABLE_H
@@ -0,0 +1,52 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file timelimit.h
+ **************************************************************************************************/
+#ifndef TIMELIMIT_H
+#define TIMELIMIT_H
+
+#include "gazedata.h"
+#include <QMap>
+
+/***********************************************************************************************//**
+ * Sample bounds of the time range of the settings (limit time range) for one trial.
+ *
+ * The bounds are resolved once per trial (Trial::timeLimit) instead of converting the time range
+ * for each sample or fixation; samples inside the range are found by binary search on the sorted
+ * sample indices (QMap::lowerBound, QMap::upperBound).
+ **************************************************************************************************/
+struct TimeLimit
+{
+    TimeLimit():
+        m_active(false),
+        m_start(0),
+        m_end(0)
+    {}
+
+    // Returns if start and end indices are outside the time range if it is activated.
+    bool outside(int start, int end) const
+    {
+        return m_active && (start < m_start || end > m_end);
+    }
+
+    // Returns the first sample inside the time range (or the first sample if not activated).
+    QMap<int, GazeData>::const_iterator begin(const QMap<int, GazeData>& gazeData) const
+    {
+        return m_active ? gazeData.lowerBound(m_start) : gazeData.constBegin();
+    }
+
+    // Returns the sample after the last one inside the time range (or the end).
+    QMap<int, GazeData>::const_iterator end(const QMap<int, GazeData>& gazeData) const
+    {
+        return m_active ? gazeData.upperBound(m_end) : gazeData.constEnd();
+    }
+
+    // If the time range is activated.
+    bool m_active;
+
+    // First and last sample index inside the time range.
+    int m_start;
+    int m_end;
+};
+
+#endif // TIMELIMIT_H
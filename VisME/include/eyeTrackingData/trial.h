@@ -8,9 +8,13 @@
 #include "event.h"
 #include "fixation.h"
 #include "gazedata.h"
+#include "gazeruns.h"
 #include "participant.h"
 #include "saccade.h"
+#include "saccadecandidates.h"
 #include "settings.h"
+#include "timelimit.h"
+#include <deque>
 #include <iostream>
 #include <QMap>
 #include <set>
@@ -20,6 +24,7 @@ class Fixation;
 class Participant;
 struct SaccadeFilterSettings;
 struct Settings;
+struct SettingsSnapshot;
 
 /***********************************************************************************************//**
  * This class contains information on a trialof an eye tracking study.
@@ -164,6 +169,16 @@ public:
      **********************************************************************************************/
     std::vector<Fixation>* fixations(GazeType gazeType = GazeType::GT_Unset);
 
+    /*******************************************************************************************//**
+     * Returns the list of fixations from the input file or the calculated fixations, independent
+     * of useFixationsFromInput.
+     *
+     * @param gazeType  gaze type of the eye values
+     * @param fromInput if the fixations from the input file are returned
+     * @return list of fixations
+     **********************************************************************************************/
+    std::vector<Fixation>* fixations(GazeType gazeType, bool fromInput);
+
     /*******************************************************************************************//**
      * Returns the list of pointers to fixations.
      *
@@ -280,6 +295,18 @@ public:
     void setMicrosaccadesForFixations(std::vector<Saccade>* microsaccades,
                                       GazeType gazeType = GazeType::GT_Unset);
 
+    /*******************************************************************************************//**
+     * Sets the given microsaccades for the fixations to which they belong using the given
+     * microsaccade settings instead of the global settings. Expects that list of microsaccades is
+     * sorted!
+     *
+     * @param microsaccades list of microsaccades
+     * @param gazeType      gaze type of the eye values (not unset)
+     * @param settings      microsaccade settings (ignored time at start/end of fixations)
+     **********************************************************************************************/
+    void setMicrosaccadesForFixations(std::vector<Saccade>* microsaccades, GazeType gazeType,
+                                      const SaccadeFilterSettings& settings);
+
     /*******************************************************************************************//**
      * Returns the microsaccade for the givenfixation and microsaccades index.
      *
@@ -303,11 +330,25 @@ public:
      **********************************************************************************************/
     void updateMicrosaccadesSettings();
 
+    /*******************************************************************************************//**
+     * Updates the current microsaccade detection settings from the given settings.
+     *
+     * @param settings microsaccade settings, e.g., of a SettingsSnapshot
+     **********************************************************************************************/
+    void updateMicrosaccadesSettings(const SaccadeFilterSettings& settings);
+
     /*******************************************************************************************//**
      * Updates the current fixation detection settings from the given settings.
      **********************************************************************************************/
     void updateFixationSettings();
 
+    /*******************************************************************************************//**
+     * Updates the current fixation detection settings from the given settings.
+     *
+     * @param settings fixation settings, e.g., of a SettingsSnapshot
+     **********************************************************************************************/
+    void updateFixationSettings(const SaccadeFilterSettings& settings);
+
     /*******************************************************************************************//**
      * Returns if the visible microsaccades were defined in the input file.
      *
@@ -336,6 +377,58 @@ public:
      **********************************************************************************************/
     SaccadeFilterSettings* getFixationFilterSettings() const;
 
+    /*******************************************************************************************//**
+     * Returns the cached microsaccade candidates of this trial.
+     *
+     * @return microsaccade candidates
+     **********************************************************************************************/
+    SaccadeCandidates* microsaccadeCandidates();
+
+    /*******************************************************************************************//**
+     * Returns the cached saccade candidates of this trial used for the fixation detection.
+     *
+     * @return saccade candidates
+     **********************************************************************************************/
+    SaccadeCandidates* saccadeCandidates();
+
+    /*******************************************************************************************//**
+     * Returns the gaze data of the given gaze type in columns (positions in degree) together with
+     * the runs of consecutive sample indices. They are computed on first use and kept until the
+     * gaze data changes; views (GazeSection) on them are valid as long as the gaze data is not
+     * changed.
+     *
+     * @param gazeType gaze type (right, left, average)
+     * @return columns and runs of the gaze data
+     **********************************************************************************************/
+    const GazeRuns* gazeRuns(GazeType gazeType = GazeType::GT_Unset);
+
+    /*******************************************************************************************//**
+     * Returns the gaze runs used for the detection with the given settings: the gaze runs (see
+     * gazeRuns) with short gaps filled according to the gap interpolation settings
+     * (GapInterpolation). They are computed on first use for each interpolation and maximum gap
+     * length; the runs of the last GazeRuns::maxCachedSettings settings are kept, so views on
+     * runs of older settings become invalid.
+     *
+     * @param gazeType gaze type (right, left, average)
+     * @param settings detection settings
+     * @return columns and runs of the gaze data with filled gaps
+     **********************************************************************************************/
+    const GazeRuns* gazeRuns(GazeType gazeType, const SaccadeFilterSettings& settings);
+
+    /*******************************************************************************************//**
+     * Returns the positions of the gaze runs used for the detection (see gazeRuns) after the
+     * pre-filter of the settings was applied to each run (PreFilter). They are computed on first
+     * use for each filter and window size; the positions of the last GazeRuns::maxCachedSettings
+     * filters are kept, so that repeated detections with the microsaccade and the fixation
+     * settings do not filter again while memory stays bounded.
+     *
+     * @param gazeType gaze type (right, left, average)
+     * @param settings detection settings
+     * @return filtered positions in the order of the gaze run columns
+     **********************************************************************************************/
+    const FilteredGazeColumns* filteredGazeColumns(GazeType gazeType,
+                                                   const SaccadeFilterSettings& settings);
+
     /*******************************************************************************************//**
      * Returns all indeces of the gaze data list which belong to microsaccades.
      *
@@ -429,10 +522,11 @@ public:
     /*******************************************************************************************//**
      * Transforms the time value to the sample in the trial considering the frequency.
      *
-     * @param time in ms
+     * @param time     in ms
+     * @param gazeType gaze type of the eye values
      * @return corresponding sample
      **********************************************************************************************/
-    int timeToSampleInTrial(qreal time);
+    int timeToSampleInTrial(qreal time, GazeType gazeType = GazeType::GT_Unset);
 
     /*******************************************************************************************//**
      * Checks if start and end indices are outside the time range if time limit is activated.
@@ -443,8 +537,72 @@ public:
      **********************************************************************************************/
     bool outsideTimeLimitIfActivated(int start, int end);
 
+    /*******************************************************************************************//**
+     * Checks if start and end indices are outside the time range of the given settings if time
+     * limit is activated there.
+     *
+     * @param start    start index
+     * @param end      end index
+     * @param settings settings snapshot with time range and gaze type
+     * @return if start and end indices are within the time range if it is activated
+     **********************************************************************************************/
+    bool outsideTimeLimitIfActivated(int start, int end, const SettingsSnapshot& settings);
+
+    /*******************************************************************************************//**
+     * Returns the sample bounds of the time range of the settings for this trial, so that loops
+     * over samples or fixations do not convert the time range for each element.
+     *
+     * @return bounds, not active if the time limit is not activated
+     **********************************************************************************************/
+    TimeLimit timeLimit();
+
+    /*******************************************************************************************//**
+     * Returns the sample bounds of the time range of the given settings for this trial.
+     *
+     * @param settings settings snapshot with time range and gaze type
+     * @return bounds, not active if the time limit is not activated there
+     **********************************************************************************************/
+    TimeLimit timeLimit(const SettingsSnapshot& settings);
+
+    /*******************************************************************************************//**
+     * Returns the revision of the data of this trial: it changes whenever gaze data, fixations,
+     * microsaccades or the frequency rate are set, so that results computed from the trial (e.g.,
+     * by StatisticsCache) can be reused as long as it is unchanged. Revisions are unique for all
+     * trials.
+     *
+     * @return revision
+     **********************************************************************************************/
+    int revision() const;
+
 private:
 
+    /*******************************************************************************************//**
+     * Returns the (modifiable) gaze runs of the given gaze type, see gazeRuns.
+     *
+     * @param gazeType gaze type (right, left, average)
+     * @return columns and runs of the gaze data
+     **********************************************************************************************/
+    GazeRuns* updatedGazeRuns(GazeType gazeType);
+
+    /*******************************************************************************************//**
+     * Returns the (modifiable) gaze runs used for the detection, see gazeRuns.
+     *
+     * @param gazeType gaze type (right, left, average)
+     * @param settings detection settings
+     * @return columns and runs of the gaze data with filled gaps
+     **********************************************************************************************/
+    GazeRuns* detectionGazeRuns(GazeType gazeType, const SaccadeFilterSettings& settings);
+
+    /*******************************************************************************************//**
+     * Returns the sample bounds of the given time range for this trial.
+     *
+     * @param active    if the time range is activated
+     * @param startTime start of the time range in ms
+     * @param endTime   end of the time range in ms
+     * @param gazeType  gaze type of the eye values
+     **********************************************************************************************/
+    TimeLimit timeLimit(bool active, qreal startTime, qreal endTime, GazeType gazeType);
+
     /// Name of participant/file.
     QString m_name;
 
@@ -500,6 +658,26 @@ private:
     /// Settings for the microsaccade detection algorithm.
     SaccadeFilterSettings* m_fixationSettings;
 
+    /// Microsaccade candidates from the last detection.
+    SaccadeCandidates m_microsaccadeCandidates;
+
+    /// Saccade candidates from the last fixation detection.
+    SaccadeCandidates m_saccadeCandidates;
+
+    /// Gaze data in columns with runs of consecutive indices for each gaze type.
+    GazeRuns m_gazeRunsRight;
+    GazeRuns m_gazeRunsLeft;
+    GazeRuns m_gazeRunsAverage;
+
+    /// Gaze runs with filled gaps for each gaze type, one entry for each of the last
+    /// GazeRuns::maxCachedSettings interpolation settings.
+    std::deque<GazeRuns> m_interpolatedGazeRunsRight;
+    std::deque<GazeRuns> m_interpolatedGazeRunsLeft;
+    std::deque<GazeRuns> m_interpolatedGazeRunsAverage;
+
+    /// Revision of the gaze data, fixations and microsaccades, see revision.
+    int m_revision;
+
     /// Screen dimensions of trial.
     qreal m_minX = 0;
     qreal m_minY = 0;
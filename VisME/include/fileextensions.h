@@ -18,4 +18,16 @@ const QString FixationParameterFileDescription = "VISEME Fixation Parameter File
 const QString ColorSettingsFile = "csf";
 const QString ColorSettingsFileDescription = "VISEME Color Settings File";
 
+const QString ParameterSweepFile = "csv";
+const QString ParameterSweepFileDescription = "VISEME Parameter Sweep Results";
+
+const QString EventLockedRateFile = "csv";
+const QString EventLockedRateFileDescription = "VISEME Event-Locked Microsaccade Rates";
+
+const QString ArrowDataFile = "arrow";
+const QString ArrowDataFileDescription = "Apache Arrow IPC File";
+
+const QString studySessionFile = "vms";
+const QString studySessionFileDescription = "VISEME Study Session File";
+
 #endif // FILEEXTENSIONS_H
@@ -5,17 +5,23 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include "cancellationtoken.h"
 #include "eyedataimport.h"
 #include "eyetrackingdata.h"
 #include "mainscene.h"
 #include "participant.h"
+#include "settingssnapshot.h"
 #include "settingsimport.h"
+#include "statisticscache.h"
 #include "timelinescene.h"
 #include "timelineview.h"
 #include "timelinevisualization.h"
 #include "userinterface.h"
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
 #include <QMainWindow>
+#include <QSharedPointer>
 #include <set>
 
 class MainScene;
@@ -52,6 +58,14 @@ public:
      **********************************************************************************************/
     void openFiles(const QStringList& fileNames, bool add = false);
 
+    /*******************************************************************************************//**
+     * Opens a session file and replaces all participants with the ones of the session, including
+     * their detection results and settings.
+     *
+     * @param fileName file name of the session file
+     **********************************************************************************************/
+    void openSession(const QString& fileName);
+
     /*******************************************************************************************//**
      * Shows the data for the given participant and trial indices in the view.
      *
@@ -68,18 +82,77 @@ private:
     void newScenes();
 
     /*******************************************************************************************//**
-     * Determines microsaccades for the given trial using the parameters specified in the UI.
+     * Cancels the running statistics job and waits until it is finished; must be called before
+     * trials are changed or deleted.
+     **********************************************************************************************/
+    void cancelStatisticsJob();
+
+    /*******************************************************************************************//**
+     * Shows the statistics computed by the finished statistics job in the dock widget, results
+     * of canceled jobs are ignored.
+     **********************************************************************************************/
+    void showStatisticsInfo();
+
+    /*******************************************************************************************//**
+     * Cancels the running detection job and waits until it is finished; must be called before
+     * trials are changed or deleted and is called for every change of the detection settings.
+     **********************************************************************************************/
+    void cancelDetectionJob();
+
+    /*******************************************************************************************//**
+     * Waits until the running detection job is finished, e.g., before other trials are shown.
+     **********************************************************************************************/
+    void waitForDetectionJob();
+
+    /*******************************************************************************************//**
+     * Starts a detection job for the given trials with the settings specified in the UI, which
+     * are read once for the whole job, and cancels a running one.
+     *
+     * The currently shown trials are updated directly, so that the views never show a trial
+     * which is changed by the job; all other trials are updated in the background. The actions
+     * which read all trials are disabled until the job is finished, see detectionJobFinished.
+     *
+     * @param trials    trials which will be updated
+     * @param fixations if fixations and microsaccades are detected, otherwise microsaccades only
+     **********************************************************************************************/
+    void startDetectionJob(const std::vector<Trial*>& trials, bool fixations);
+
+    /*******************************************************************************************//**
+     * Enables the actions again which were disabled while the detection job was running.
+     **********************************************************************************************/
+    void detectionJobFinished();
+
+    /*******************************************************************************************//**
+     * Reads the microsaccade detection settings from the UI.
+     **********************************************************************************************/
+    void readMicrosaccadeSettings();
+
+    /*******************************************************************************************//**
+     * Reads the fixation detection settings from the UI.
+     **********************************************************************************************/
+    void readFixationSettings();
+
+    /*******************************************************************************************//**
+     * Determines microsaccades for the given trial. Independent of the user interface, can be run
+     * on any thread.
      *
-     * @param trial trial which will be used for the calculation
+     * @param trial        trial which will be used for the calculation
+     * @param settings     settings snapshot of the detection job
+     * @param cancellation token of the detection job, the trial is not changed if canceled
      **********************************************************************************************/
-    void updateMicrosaccadesDetection(Trial* trial);
+    static void updateMicrosaccadesDetection(Trial* trial, const SettingsSnapshot& settings,
+                                             const CancellationToken& cancellation);
 
     /*******************************************************************************************//**
-     * Determines fixations for the given trial.
+     * Determines fixations and afterwards microsaccades for the given trial. Independent of the
+     * user interface, can be run on any thread.
      *
-     * @param trial trial for which fixations are determined
+     * @param trial        trial for which fixations are determined
+     * @param settings     settings snapshot of the detection job
+     * @param cancellation token of the detection job, the trial is not changed if canceled
      **********************************************************************************************/
-    void updateFixationsDetection(Trial* trial);
+    static void updateFixationsDetection(Trial* trial, const SettingsSnapshot& settings,
+                                         const CancellationToken& cancellation);
 
     /*******************************************************************************************//**
      * Updates the general infos in the dock widget.
@@ -89,7 +162,9 @@ private:
     void updateGeneralInfo(std::vector<Trial*> currentTrials);
 
     /*******************************************************************************************//**
-     * Updates the statistics in the dock widget.
+     * Updates the statistics in the dock widget: starts a background job which computes the
+     * statistics of the trials (cached for unchanged trials, see StatisticsCache) and cancels a
+     * running one. The labels are updated when the job is finished, see showStatisticsInfo.
      *
      * @param currentTrials currently visible trial
      **********************************************************************************************/
@@ -339,6 +414,11 @@ private slots:
      **********************************************************************************************/
     void openCSV();
 
+    /*******************************************************************************************//**
+     * Shows an open file dialog and calls the method openSession for processing.
+     **********************************************************************************************/
+    void loadSession();
+
     /*******************************************************************************************//**
      * Loads a microsaccade detection settings file and updates the values in the UI.
      **********************************************************************************************/
@@ -552,6 +632,14 @@ private slots:
      **********************************************************************************************/
     void showSaccadeDirections(bool show);
 
+    /*******************************************************************************************//**
+     * Updates the settings to estimate the medians in the statistics dock widget with quantile
+     * sketches (QuantileSketch) and updates the statistics.
+     *
+     * @param approximate if medians are estimated instead of computed exactly
+     **********************************************************************************************/
+    void approximateMedians(bool approximate);
+
     /*******************************************************************************************//**
      * Updates the settings to show/hide the scan path with fixations and saccades in the main
      * view and updates the view.
@@ -740,6 +828,33 @@ private:
     /// Contains all eye tracking data.
     EyeTrackingData* m_eyeTrackingData;
 
+    /// Cancels a running fixation or microsaccade detection when a new one is started.
+    CancellationSource m_detectionCancellation;
+
+    /// Token of the last started detection job.
+    CancellationToken m_detectionJob;
+
+    /// Trials which are updated by the running detection job.
+    std::vector<Trial*> m_detectionTrials;
+
+    /// Watches the detection job and enables the actions again when it is finished.
+    QFutureWatcher<void> m_detectionWatcher;
+
+    /// Run time of the detection job.
+    QElapsedTimer m_detectionTimer;
+
+    /// Cached statistics of single trials for the statistics dock widget.
+    StatisticsCache m_statisticsCache;
+
+    /// Cancels a running statistics job when a new one is started or trials are changed.
+    CancellationSource m_statisticsCancellation;
+
+    /// Token of the last started statistics job.
+    CancellationToken m_statisticsJob;
+
+    /// Watches the statistics job and shows its results when it is finished.
+    QFutureWatcher<QSharedPointer<StatisticsTable> > m_statisticsWatcher;
+
     /// This object is responsible for the main visualization.
     MainVisualization* m_mainVisualization;
 
@@ -0,0 +1,88 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file eventrateplot.h
+ **************************************************************************************************/
+#ifndef EVENTRATEPLOT_H
+#define EVENTRATEPLOT_H
+
+#include "cartesianplot.h"
+#include "eventlockedrate.h"
+#include "settings.h"
+#include <QPainter>
+#include <vector>
+
+/***********************************************************************************************//**
+ * This class is responsible for visualizing event-locked microsaccade rates (EventLockedRate):
+ * the peri-event histogram is drawn as bars and the sliding window rate as line for each group,
+ * colored by the test condition of the group. The event start is marked by a vertical line.
+ **************************************************************************************************/
+class EventRatePlot : public CartesianPlot
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Constructor
+     *
+     * @param settings global settings (colors of the test conditions)
+     **********************************************************************************************/
+    EventRatePlot(Settings* settings);
+
+    /*******************************************************************************************//**
+     * Updates the plot for the given results.
+     *
+     * @param analysis analysis which computed the results (bins and windows)
+     * @param groups   groups which shall be plotted
+     **********************************************************************************************/
+    void updatePlot(const EventLockedRate& analysis,
+                    const std::vector<EventLockedRateGroup>& groups);
+
+protected:
+
+    /*******************************************************************************************//**
+     * Draw function for the plot.
+     *
+     * @param painter painter for drawing
+     **********************************************************************************************/
+    void draw(QPainter& painter);
+
+private:
+
+    /*******************************************************************************************//**
+     * Returns the position in the visualization for a time relative to the event start and a
+     * rate; the maximum rate is at the top of the plot.
+     *
+     * @param time time [ms]
+     * @param rate microsaccades per second
+     **********************************************************************************************/
+    QPointF getTimePointInVis(qreal time, qreal rate);
+
+    /*******************************************************************************************//**
+     * Returns the color of the test condition or the plot color if the test condition has none.
+     *
+     * @param testCondition name of the test condition
+     **********************************************************************************************/
+    QColor getColor(const QString& testCondition) const;
+
+    /// Contains settings for the plot.
+    Settings* m_settings;
+
+    /// Name of the events.
+    QString m_eventName;
+
+    /// Time range around the event start [ms].
+    int m_timeBefore;
+    int m_timeAfter;
+
+    /// Start/end time [ms] of the bins and center time [ms] of the sliding windows.
+    std::vector<QPair<int, int> > m_bins;
+    std::vector<int> m_windowCenters;
+
+    /// Plotted groups.
+    std::vector<EventLockedRateGroup> m_groups;
+
+    /// Maximum rate of all bins and windows.
+    qreal m_maxRate;
+};
+
+#endif // EVENTRATEPLOT_H
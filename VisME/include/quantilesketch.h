@@ -0,0 +1,135 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file quantilesketch.h
+ **************************************************************************************************/
+#ifndef QUANTILESKETCH_H
+#define QUANTILESKETCH_H
+
+#include <QtGlobal>
+#include <random>
+#include <vector>
+
+/***********************************************************************************************//**
+ * This class estimates quantiles (e.g., the median) of a stream of values with a KLL sketch
+ * (Karnin, Lang and Liberty, "Optimal Quantile Approximation in Streams", 2016): values are
+ * stored in levels of compactors, a full level is sorted and every other value is moved to the
+ * next level with twice the weight. The memory is bounded by about 3 k values independent of the
+ * number of values, and sketches of trials can be merged to sketches of participants or groups.
+ *
+ * Error bound: as long as at most k values were added (or merged), the sketch stores all values
+ * and the quantiles are exact (rank error 0). Afterwards the normalized rank error, i.e., the
+ * difference between the rank of the estimated value and the requested rank divided by the
+ * number of values, is below 2.296 / k^0.9723 with 99% confidence (about 1.3% for the default
+ * k = 200, empirical bound of the Apache DataSketches KLL implementation).
+ **************************************************************************************************/
+class QuantileSketch
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Estimated quantile and its error bound.
+     **********************************************************************************************/
+    struct Estimate
+    {
+        // Estimated value, 0 if no values were added.
+        qreal m_value;
+
+        // Normalized rank error (99% confidence), 0 if the value is exact.
+        qreal m_rankError;
+    };
+
+    /*******************************************************************************************//**
+     * Constructor.
+     *
+     * @param k size of the largest compactor, i.e., accuracy of the sketch
+     **********************************************************************************************/
+    QuantileSketch(int k = 200);
+
+    /*******************************************************************************************//**
+     * Adds a value.
+     *
+     * @param value value
+     **********************************************************************************************/
+    void add(qreal value);
+
+    /*******************************************************************************************//**
+     * Adds all values of another sketch (with the same k).
+     *
+     * @param other other sketch
+     **********************************************************************************************/
+    void merge(const QuantileSketch& other);
+
+    /*******************************************************************************************//**
+     * Returns the number of added values.
+     **********************************************************************************************/
+    size_t count() const;
+
+    /*******************************************************************************************//**
+     * Returns if all added values are stored, i.e., quantiles are exact.
+     **********************************************************************************************/
+    bool isExact() const;
+
+    /*******************************************************************************************//**
+     * Returns the normalized rank error of the quantiles (99% confidence), 0 if they are exact.
+     **********************************************************************************************/
+    qreal rankError() const;
+
+    /*******************************************************************************************//**
+     * Returns the p-quantile: the smallest value with a rank of at least p times the number of
+     * values, e.g., the lower median for p = 0.5 like MathHelpFunctions::median.
+     *
+     * @param p quantile in [0, 1]
+     * @return estimated value and error bound
+     **********************************************************************************************/
+    Estimate quantile(qreal p) const;
+
+    /*******************************************************************************************//**
+     * Returns the exact p-quantile of the values (same definition as quantile), 0 if the values
+     * are empty. Only selects the value (std::nth_element) instead of sorting all values.
+     *
+     * @param values values
+     * @param p      quantile in [0, 1]
+     **********************************************************************************************/
+    static qreal exactQuantile(std::vector<qreal> values, qreal p);
+
+private:
+
+    /*******************************************************************************************//**
+     * Returns the number of values at which the level is compacted; lower levels are smaller.
+     *
+     * @param level level index
+     **********************************************************************************************/
+    size_t capacity(size_t level) const;
+
+    /*******************************************************************************************//**
+     * Adds a new top level.
+     **********************************************************************************************/
+    void grow();
+
+    /*******************************************************************************************//**
+     * Compacts the lowest full level: half of its values are moved to the next level.
+     **********************************************************************************************/
+    void compress();
+
+    /// Size of the largest compactor.
+    int m_k;
+
+    /// Stored values for each level, a value of level h represents 2^h added values.
+    std::vector<std::vector<qreal> > m_levels;
+
+    /// Number of added values.
+    size_t m_count;
+
+    /// Number of stored values.
+    size_t m_size;
+
+    /// Maximum number of stored values before a level is compacted.
+    size_t m_maxSize;
+
+    /// Chooses if the even or odd values of a compacted level are kept (fixed seed, so that
+    /// results can be reproduced).
+    std::minstd_rand m_random;
+};
+
+#endif // QUANTILESKETCH_H
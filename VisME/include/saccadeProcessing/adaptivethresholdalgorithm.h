@@ -0,0 +1,76 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file adaptivethresholdalgorithm.h
+ **************************************************************************************************/
+#ifndef ADAPTIVETHRESHOLDALGORITHM_H
+#define ADAPTIVETHRESHOLDALGORITHM_H
+
+#include "saccadedetectionalgorithm.h"
+
+/***********************************************************************************************//**
+ * Adaptive, iterative velocity threshold on the absolute velocity (speed) of a section.
+ *
+ * Method described in
+ * Marcus Nyström and Kenneth Holmqvist: An adaptive algorithm for fixation, saccade, and glissade
+ * detection in eyetracking data.
+ *
+ * The peak threshold is iteratively set to mean + λ * standard deviation of all velocity values
+ * below the current threshold until it changes less than a convergence threshold. Saccades are
+ * parts above the peak threshold, extended backwards to the onset (below mean + λ/2 * standard
+ * deviation and local minimum) and forwards to the offset (below a mix of the onset threshold and
+ * the local noise before the saccade, and local minimum). λ is the relative velocity threshold of
+ * the settings.
+ *
+ * Different from the original method, the initial peak threshold is the maximum velocity of the
+ * section instead of a fixed value so that the algorithm can also be used for microsaccades;
+ * glissades are not detected.
+ **************************************************************************************************/
+class AdaptiveThresholdAlgorithm : public SaccadeDetectionAlgorithm
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Determines saccade candidates with the adaptive velocity threshold.
+     *
+     * @param x        input gaze data: x and y position and gaze sample index
+     * @param v        velocity values for x
+     * @param settings filter settings
+     * @param trial    current trial
+     * @return list of saccade candidates with their properties
+     **********************************************************************************************/
+    std::vector<Saccade> detect(const GazeSection& x, const GazeVelocity& v,
+                                const SaccadeFilterSettings* settings, Trial* trial) override;
+
+    /*******************************************************************************************//**
+     * Returns the name of the algorithm.
+     **********************************************************************************************/
+    QString name() const override;
+
+private:
+
+    /*******************************************************************************************//**
+     * Computes mean and standard deviation of all velocity values below the given threshold.
+     *
+     * @param speed     absolute velocity values
+     * @param threshold only values below the threshold are used
+     * @param meanStd   result: mean and standard deviation
+     * @return false if less than two values are below the threshold
+     **********************************************************************************************/
+    bool statisticsBelow(const std::vector<qreal>& speed, qreal threshold,
+                         QPair<qreal, qreal>& meanStd) const;
+
+    /*******************************************************************************************//**
+     * Computes mean and standard deviation of the velocity values in [begin, end).
+     *
+     * @param speed   absolute velocity values
+     * @param begin   first index
+     * @param end     index after the last value
+     * @param meanStd result: mean and standard deviation
+     * @return false if the range contains less than two values
+     **********************************************************************************************/
+    bool statistics(const std::vector<qreal>& speed, size_t begin, size_t end,
+                    QPair<qreal, qreal>& meanStd) const;
+};
+
+#endif // ADAPTIVETHRESHOLDALGORITHM_H
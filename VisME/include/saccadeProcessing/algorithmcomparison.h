@@ -0,0 +1,119 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file algorithmcomparison.h
+ **************************************************************************************************/
+#ifndef ALGORITHMCOMPARISON_H
+#define ALGORITHMCOMPARISON_H
+
+#include "enums.h"
+#include "gazeruns.h"
+#include "saccadefiltersettings.h"
+#include <ostream>
+#include <QString>
+#include <vector>
+
+class Trial;
+
+/***********************************************************************************************//**
+ * struct AlgorithmComparisonResult
+ *
+ * Detection result and run time of one algorithm for all trials.
+ **************************************************************************************************/
+struct AlgorithmComparisonResult
+{
+    AlgorithmComparisonResult():
+        m_algorithm(DA_EngbertKliegl),
+        m_candidateCount(0),
+        m_microsaccadeCount(0),
+        m_elapsedNs(0)
+    {}
+
+    DetectionAlgorithm m_algorithm;
+    QString m_name;
+
+    // Candidates before and after the validity criteria are applied.
+    size_t m_candidateCount;
+    size_t m_microsaccadeCount;
+
+    // Run time of the detection without computing the velocity values [ns].
+    qint64 m_elapsedNs;
+};
+
+/***********************************************************************************************//**
+ * This class compares detection algorithms (SaccadeDetectionAlgorithm) on the same data.
+ *
+ * Sections and velocity values of all trials are prepared once (in parallel) and shared by all
+ * algorithms, so that the run times only contain the detection itself. Algorithms are run one
+ * after another on a single thread to get comparable times.
+ **************************************************************************************************/
+class AlgorithmComparison
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Constructor.
+     *
+     * @param settings microsaccade filter settings; the algorithm is replaced, all other
+     *                 parameters are used as given
+     * @param gazeType gaze type (right, left, average) for which microsaccades are detected
+     **********************************************************************************************/
+    AlgorithmComparison(const SaccadeFilterSettings& settings, GazeType gazeType);
+
+    /*******************************************************************************************//**
+     * Runs all given algorithms on the given trials.
+     *
+     * @param trials     trials used for the comparison; they must not be modified during the
+     *                   comparison
+     * @param algorithms algorithms to compare
+     * @return one result for each algorithm in the given order
+     **********************************************************************************************/
+    std::vector<AlgorithmComparisonResult> run(const std::vector<Trial*>& trials,
+                                               const std::vector<DetectionAlgorithm>& algorithms);
+
+    /*******************************************************************************************//**
+     * Returns the time to prepare sections and velocity values in the last run [ns].
+     **********************************************************************************************/
+    qint64 preparationNs() const;
+
+    /*******************************************************************************************//**
+     * Writes the results as csv: one line per algorithm.
+     *
+     * @param results results of run()
+     * @param out     output stream
+     **********************************************************************************************/
+    void writeCsv(const std::vector<AlgorithmComparisonResult>& results, std::ostream& out) const;
+
+private:
+
+    /*******************************************************************************************//**
+     * struct PreparedSection
+     *
+     * Prepared buffers of one section.
+     **********************************************************************************************/
+    struct PreparedSection
+    {
+        Trial* m_trial;
+        GazeSection m_section;
+        GazeVelocity m_velocity;
+    };
+
+    /*******************************************************************************************//**
+     * Determines sections and velocity values of one trial.
+     *
+     * @param trial current trial
+     * @return sections with velocity values; sections without velocity values are skipped
+     **********************************************************************************************/
+    std::vector<PreparedSection> prepareTrial(Trial* trial);
+
+    /// Microsaccade filter settings.
+    SaccadeFilterSettings m_settings;
+
+    /// Gaze type used for the detection.
+    GazeType m_gazeType;
+
+    /// Time to prepare sections and velocity values in the last run [ns].
+    qint64 m_preparationNs;
+};
+
+#endif // ALGORITHMCOMPARISON_H
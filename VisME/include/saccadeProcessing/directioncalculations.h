@@ -32,12 +32,14 @@ public:
      * @param dataPlotData      type of data
      * @param anglesForTrial    angles will be appended to this list
      * @param fixations         list of fixations
+     * @param gazeType          gaze type of the fixations
      **********************************************************************************************/
     void getAngularDataForTrial(Trial* trial,
                                 PlotDirection dataPlotDirection,
                                 PlotData dataPlotData,
                                 std::vector<qreal>& anglesForTrial,
-                                std::vector<Fixation*> fixations);
+                                std::vector<Fixation*> fixations,
+                                GazeType gazeType = GazeType::GT_Unset);
 };
 
 #endif // DIRECTIONCALCULATIONS_H
@@ -0,0 +1,41 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file engbertklieglalgorithm.h
+ **************************************************************************************************/
+#ifndef ENGBERTKLIEGLALGORITHM_H
+#define ENGBERTKLIEGLALGORITHM_H
+
+#include "saccadedetectionalgorithm.h"
+
+/***********************************************************************************************//**
+ * Elliptic velocity threshold based on the median based standard deviation of the velocity
+ * components (SaccadeDetector::velocityStatistics, SaccadeDetector::determineSaccadeCandidates).
+ *
+ * Method described in
+ * Ralf Engbert and Reinhold Kliegl: Microsaccades uncover the orientation of covert attention.
+ **************************************************************************************************/
+class EngbertKlieglAlgorithm : public SaccadeDetectionAlgorithm
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Determines saccade candidates with the elliptic threshold (velocity threshold as multiple of
+     * the median based standard deviation).
+     *
+     * @param x        input gaze data: x and y position and gaze sample index
+     * @param v        velocity values for x
+     * @param settings filter settings
+     * @param trial    current trial
+     * @return list of saccade candidates with their properties
+     **********************************************************************************************/
+    std::vector<Saccade> detect(const GazeSection& x, const GazeVelocity& v,
+                                const SaccadeFilterSettings* settings, Trial* trial) override;
+
+    /*******************************************************************************************//**
+     * Returns the name of the algorithm.
+     **********************************************************************************************/
+    QString name() const override;
+};
+
+#endif // ENGBERTKLIEGLALGORITHM_H
@@ -0,0 +1,190 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file eventlockedrate.h
+ **************************************************************************************************/
+#ifndef EVENTLOCKEDRATE_H
+#define EVENTLOCKEDRATE_H
+
+#include "enums.h"
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+class Trial;
+
+/***********************************************************************************************//**
+ * struct EventLockedRateGroup
+ *
+ * Microsaccade onsets aligned to the events of all trials of one participant and test condition.
+ **************************************************************************************************/
+struct EventLockedRateGroup
+{
+    EventLockedRateGroup():
+        m_trialCount(0),
+        m_eventCount(0)
+    {}
+
+    // Participant name, empty for the groups of all participants.
+    QString m_participant;
+
+    // Test condition of the trials.
+    QString m_testCondition;
+
+    // Number of trials containing the event and number of aligned events.
+    size_t m_trialCount;
+    size_t m_eventCount;
+
+    // Microsaccade onsets and time with gaze data [s] summed over all events for each bin of the
+    // peri-event histogram.
+    std::vector<size_t> m_binCounts;
+    std::vector<qreal> m_binExposure;
+
+    // Microsaccade onsets and time with gaze data [s] summed over all events for each position of
+    // the sliding window.
+    std::vector<size_t> m_windowCounts;
+    std::vector<qreal> m_windowExposure;
+};
+
+/***********************************************************************************************//**
+ * This class computes event-locked microsaccade rates: microsaccade onsets of all trials are
+ * aligned to the start of each event with the given name and counted in a peri-event histogram
+ * (fixed bins) and in a sliding window, both from timeBefore ms before until timeAfter ms after
+ * the event start. Rates are the counts divided by the time with gaze data in the bins/windows,
+ * so that missing data and events close to the start/end of a trial do not reduce the rate.
+ *
+ * For each trial the number of microsaccade onsets and gaze samples up to each sample index are
+ * determined once (prefix sums); every bin and window of every event is then evaluated with two
+ * lookups independent of its length. Trials are processed in parallel, the results are combined
+ * in the order of the trials and are independent of the number of threads.
+ *
+ * The results are aggregated for each participant and test condition as well as for each test
+ * condition over all participants. Microsaccades are taken from the current fixations of the
+ * trials (input file or calculated, like in the other views).
+ **************************************************************************************************/
+class EventLockedRate
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Constructor.
+     *
+     * @param eventName  name of the events the microsaccades are aligned to
+     * @param timeBefore time before the event start [ms]
+     * @param timeAfter  time after the event start [ms]
+     * @param binSize    bin size of the peri-event histogram [ms]
+     * @param windowSize size of the sliding window [ms]
+     * @param windowStep distance between two positions of the sliding window [ms]
+     * @param gazeType   gaze type (right, left, average) for which microsaccades are evaluated
+     **********************************************************************************************/
+    EventLockedRate(const QString& eventName, int timeBefore, int timeAfter, int binSize,
+                    int windowSize, int windowStep, GazeType gazeType);
+
+    /*******************************************************************************************//**
+     * Aligns the microsaccades of the given trials to the events and aggregates them.
+     *
+     * @param trials trials used for the analysis; they must not be modified during the analysis
+     * @return one group for each participant and test condition (in the order of the trials)
+     *         followed by one group for each test condition over all participants
+     **********************************************************************************************/
+    std::vector<EventLockedRateGroup> run(const std::vector<Trial*>& trials) const;
+
+    /*******************************************************************************************//**
+     * Returns the sorted names of all events of the given trials.
+     *
+     * @param trials list of trials
+     **********************************************************************************************/
+    static QStringList eventNames(const std::vector<Trial*>& trials);
+
+    /*******************************************************************************************//**
+     * Returns the rate of microsaccades per second (0 without any gaze data).
+     *
+     * @param count    number of microsaccade onsets
+     * @param exposure time with gaze data [s]
+     **********************************************************************************************/
+    static qreal rate(size_t count, qreal exposure);
+
+    /*******************************************************************************************//**
+     * Returns the name of the events the microsaccades are aligned to.
+     **********************************************************************************************/
+    QString eventName() const;
+
+    /*******************************************************************************************//**
+     * Returns the time before/after the event start [ms].
+     **********************************************************************************************/
+    int timeBefore() const;
+    int timeAfter() const;
+
+    /*******************************************************************************************//**
+     * Returns the number of bins of the peri-event histogram.
+     **********************************************************************************************/
+    size_t binCount() const;
+
+    /*******************************************************************************************//**
+     * Returns the start/end time [ms] of a bin relative to the event start.
+     *
+     * @param bin index of the bin
+     **********************************************************************************************/
+    int binStart(size_t bin) const;
+    int binEnd(size_t bin) const;
+
+    /*******************************************************************************************//**
+     * Returns the number of positions of the sliding window.
+     **********************************************************************************************/
+    size_t windowCount() const;
+
+    /*******************************************************************************************//**
+     * Returns the center time [ms] of the sliding window at the given position relative to the
+     * event start.
+     *
+     * @param window position of the sliding window
+     **********************************************************************************************/
+    int windowCenter(size_t window) const;
+
+    /*******************************************************************************************//**
+     * Writes the results as table to a csv file (one row for each group and bin/window).
+     *
+     * @param groups   results of run
+     * @param fileName name of the file
+     * @return false if the file could not be written
+     **********************************************************************************************/
+    bool writeCsv(const std::vector<EventLockedRateGroup>& groups, const QString& fileName) const;
+
+private:
+
+    /*******************************************************************************************//**
+     * Aligns the microsaccades of one trial to its events.
+     *
+     * @param trial current trial
+     * @return group containing only the given trial (no trial/events if the trial contains no
+     *         event with the name)
+     **********************************************************************************************/
+    EventLockedRateGroup evaluateTrial(Trial* trial) const;
+
+    /*******************************************************************************************//**
+     * Adds counts and exposure of a group to another one.
+     *
+     * @param group  group that is extended
+     * @param source added group
+     **********************************************************************************************/
+    static void addToGroup(EventLockedRateGroup& group, const EventLockedRateGroup& source);
+
+    /// Name of the events.
+    QString m_eventName;
+
+    /// Time range around the event start [ms].
+    int m_timeBefore;
+    int m_timeAfter;
+
+    /// Bin size of the histogram [ms].
+    int m_binSize;
+
+    /// Size and step of the sliding window [ms].
+    int m_windowSize;
+    int m_windowStep;
+
+    /// Evaluated gaze type.
+    GazeType m_gazeType;
+};
+
+#endif // EVENTLOCKEDRATE_H
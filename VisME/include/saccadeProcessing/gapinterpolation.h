@@ -0,0 +1,63 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file gapinterpolation.h
+ **************************************************************************************************/
+#ifndef GAPINTERPOLATION_H
+#define GAPINTERPOLATION_H
+
+#include "enums.h"
+#include "gazeruns.h"
+#include <QStringList>
+
+/***********************************************************************************************//**
+ * This namespace fills short gaps of missing data in the gaze runs before the detection so that
+ * short dropouts do not split a trial into many small sections: each section gets its own
+ * threshold and loses half a velocity window at both borders.
+ *
+ * Only the columns of the gaze runs are filled; the gaze data of the trial is not changed and
+ * filled samples are flagged (GazeRuns::m_interpolated) so that visualizations can mark them.
+ **************************************************************************************************/
+namespace GapInterpolation
+{
+
+    /*******************************************************************************************//**
+     * Interpolates the positions of the missing samples between the last sample of one run and
+     * the first sample of the next run.
+     *
+     * Linear interpolation connects both samples; cubic interpolation (Hermite) additionally
+     * continues the slopes at both borders, estimated from the neighbouring sample in each run.
+     *
+     * @param x             positions of all samples
+     * @param last          column of the last sample before the gap
+     * @param first         column of the first sample after the gap
+     * @param lastRunBegin  first column of the run before the gap
+     * @param firstRunEnd   end column of the run after the gap
+     * @param gap           number of missing samples
+     * @param interpolation linear or cubic
+     * @param values        result: gap positions are appended
+     **********************************************************************************************/
+    void interpolate(const std::vector<qreal>& x, size_t last, size_t first, size_t lastRunBegin,
+                     size_t firstRunEnd, int gap, GapInterpolationType interpolation,
+                     std::vector<qreal>& values);
+
+    /*******************************************************************************************//**
+     * Fills all gaps with at most maxGapSamples missing samples in one pass over the runs and
+     * merges the runs on both sides of each filled gap.
+     *
+     * @param runs          gaze runs of one gaze type
+     * @param interpolation interpolation, GIT_None copies the runs
+     * @param maxGapSamples maximum number of missing samples of a filled gap
+     * @param filled        result: gaze runs with filled gaps
+     **********************************************************************************************/
+    void apply(const GazeRuns& runs, GapInterpolationType interpolation, size_t maxGapSamples,
+               GazeRuns& filled);
+
+    /*******************************************************************************************//**
+     * Returns the names of all interpolations in the order of GapInterpolationType.
+     *
+     * @return interpolation names
+     **********************************************************************************************/
+    QStringList interpolationNames();
+}
+
+#endif // GAPINTERPOLATION_H
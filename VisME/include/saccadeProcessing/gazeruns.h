@@ -0,0 +1,166 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file gazeruns.h
+ **************************************************************************************************/
+#ifndef GAZERUNS_H
+#define GAZERUNS_H
+
+#include "enums.h"
+#include <deque>
+#include <QPair>
+#include <QtGlobal>
+#include <vector>
+
+/***********************************************************************************************//**
+ * View on consecutive gaze samples without missing data (no copy of the values).
+ **************************************************************************************************/
+struct GazeSection
+{
+    GazeSection():
+        m_x(nullptr),
+        m_y(nullptr),
+        m_index(nullptr),
+        m_size(0)
+    {}
+
+    // Positions in degree.
+    const qreal* m_x;
+    const qreal* m_y;
+
+    // Indices of the gaze samples.
+    const int* m_index;
+
+    // Number of samples.
+    size_t m_size;
+};
+
+/***********************************************************************************************//**
+ * Velocity components of the samples of a section.
+ **************************************************************************************************/
+struct GazeVelocity
+{
+    std::vector<qreal> m_x;
+    std::vector<qreal> m_y;
+};
+
+/***********************************************************************************************//**
+ * Positions of all samples of the gaze runs after a pre-filter was applied to each run.
+ **************************************************************************************************/
+struct FilteredGazeColumns
+{
+    FilteredGazeColumns():
+        m_filter(PFT_None),
+        m_windowSize(0)
+    {}
+
+    // Filter and window size [samples] used for the positions.
+    PreFilterType m_filter;
+    size_t m_windowSize;
+
+    // Filtered positions in degree; same order as the columns of the gaze runs.
+    std::vector<qreal> m_x;
+    std::vector<qreal> m_y;
+};
+
+/***********************************************************************************************//**
+ * Gaze data of one gaze type of a trial in columns together with the runs of consecutive indices,
+ * i.e., the parts between missing data.
+ *
+ * The runs are determined once per trial; the detection only trims them according to the ignore
+ * before/after missing data settings and works on views (GazeSection) of the columns. With gap
+ * interpolation, short gaps are filled and the runs on both sides are merged.
+ **************************************************************************************************/
+struct GazeRuns
+{
+    // Maximum number of cached filtered columns (and of interpolated runs in Trial): usually one
+    // setting for the microsaccades and one for the fixations; older entries are removed.
+    static const size_t maxCachedSettings = 2;
+
+    GazeRuns():
+        m_isSet(false),
+        m_pixelsPerDegree(0),
+        m_gapInterpolation(GIT_None),
+        m_maxGapSamples(0)
+    {}
+
+    // Returns if the columns were computed with the given conversion factor.
+    bool isUpToDate(qreal pixelsPerDegree) const
+    {
+        return m_isSet && m_pixelsPerDegree == pixelsPerDegree;
+    }
+
+    // Invalidates the runs, e.g., when the gaze data of the trial changes.
+    void clear()
+    {
+        m_x.clear();
+        m_y.clear();
+        m_index.clear();
+        m_runs.clear();
+        m_interpolated.clear();
+        m_filtered.clear();
+        m_isSet = false;
+    }
+
+    // Returns the cached filtered positions for the given filter or nullptr.
+    const FilteredGazeColumns* filtered(PreFilterType filter, size_t windowSize) const
+    {
+        for (size_t i = 0; i < m_filtered.size(); ++i)
+        {
+            if (m_filtered[i].m_filter == filter && m_filtered[i].m_windowSize == windowSize)
+            {
+                return &m_filtered[i];
+            }
+        }
+        return nullptr;
+    }
+
+    // Returns the view on the samples [begin, end) of the columns.
+    GazeSection section(size_t begin, size_t end) const
+    {
+        GazeSection section;
+        section.m_x = m_x.data() + begin;
+        section.m_y = m_y.data() + begin;
+        section.m_index = m_index.data() + begin;
+        section.m_size = end - begin;
+        return section;
+    }
+
+    // Returns the view on the samples [begin, end) with the given filtered positions.
+    GazeSection section(size_t begin, size_t end, const FilteredGazeColumns* filtered) const
+    {
+        GazeSection section = this->section(begin, end);
+        if (filtered != nullptr)
+        {
+            section.m_x = filtered->m_x.data() + begin;
+            section.m_y = filtered->m_y.data() + begin;
+        }
+        return section;
+    }
+
+    // If columns and runs were computed.
+    bool m_isSet;
+
+    // Conversion factor used for the positions.
+    qreal m_pixelsPerDegree;
+
+    // Positions in degree and indices of all gaze samples.
+    std::vector<qreal> m_x;
+    std::vector<qreal> m_y;
+    std::vector<int> m_index;
+
+    // Runs of consecutive indices as [begin, end) in the columns.
+    std::vector<QPair<size_t, size_t> > m_runs;
+
+    // Interpolation and maximum gap length [samples] used to fill gaps (GapInterpolation).
+    GapInterpolationType m_gapInterpolation;
+    size_t m_maxGapSamples;
+
+    // If a sample was interpolated; empty if no gap was filled.
+    std::vector<bool> m_interpolated;
+
+    // Filtered positions of the last maxCachedSettings pre-filters, oldest first; a deque keeps
+    // views on the other entries valid when a filter is added or the oldest one is removed.
+    std::deque<FilteredGazeColumns> m_filtered;
+};
+
+#endif // GAZERUNS_H
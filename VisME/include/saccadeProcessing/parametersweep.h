@@ -0,0 +1,140 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file parametersweep.h
+ **************************************************************************************************/
+#ifndef PARAMETERSWEEP_H
+#define PARAMETERSWEEP_H
+
+#include "cancellationtoken.h"
+#include "enums.h"
+#include "saccade.h"
+#include "saccadefiltersettings.h"
+#include <functional>
+#include <QString>
+#include <vector>
+
+class Trial;
+
+/***********************************************************************************************//**
+ * struct ParameterSweepResult
+ *
+ * Microsaccade statistics of all trials for one combination of velocity threshold and minimum
+ * duration.
+ **************************************************************************************************/
+struct ParameterSweepResult
+{
+    ParameterSweepResult():
+        m_velocityThreshold(0),
+        m_minDuration(0),
+        m_trialCount(0),
+        m_fixationCount(0),
+        m_microsaccadeCount(0),
+        m_duration(0)
+    {}
+
+    // Relative velocity threshold (multiple of the median based standard deviation).
+    qreal m_velocityThreshold;
+
+    // Minimum microsaccade duration [ms].
+    int m_minDuration;
+
+    size_t m_trialCount;
+    size_t m_fixationCount;
+    size_t m_microsaccadeCount;
+
+    // Summed duration of all trials [s].
+    qreal m_duration;
+
+    // Amplitudes [°] of all microsaccades.
+    std::vector<qreal> m_amplitudes;
+};
+
+/***********************************************************************************************//**
+ * This class evaluates microsaccade detection for all combinations of velocity thresholds and
+ * minimum durations (grid) across a list of trials.
+ *
+ * Velocity values and their median based standard deviations only depend on the gaze data and
+ * the velocity window size. They are computed once for each trial and shared by all grid points;
+ * only the thresholding and the following criteria are evaluated for each combination. Trials
+ * are processed in parallel, the results are independent of the number of threads.
+ *
+ * Microsaccades are assigned to the fixations of the trials in the same way as in the regular
+ * detection (ignore at fixation start/end, minimum inter-saccadic interval), so that counts and
+ * rates correspond to the values shown for the current settings.
+ **************************************************************************************************/
+class ParameterSweep
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Constructor.
+     *
+     * @param settings microsaccade filter settings; velocity threshold and minimum duration are
+     *                 replaced by the grid values, all other parameters are used as given
+     * @param gazeType gaze type (right, left, average) for which microsaccades are evaluated
+     **********************************************************************************************/
+    ParameterSweep(const SaccadeFilterSettings& settings, GazeType gazeType);
+
+    /*******************************************************************************************//**
+     * Evaluates all combinations of the given parameter values for the given trials.
+     *
+     * @param trials             trials used for the evaluation; they must not be modified during
+     *                           the sweep
+     * @param velocityThresholds list of relative velocity thresholds
+     * @param minDurations       list of minimum durations [ms]
+     * @param cancellation       checked for each trial; if canceled, the results are incomplete
+     * @param progress           called from the worker threads after each trial with the number
+     *                           of evaluated and of all trials
+     * @return one result for each combination; minimum duration varies fastest
+     **********************************************************************************************/
+    std::vector<ParameterSweepResult> run(const std::vector<Trial*>& trials,
+                                          const std::vector<qreal>& velocityThresholds,
+                                          const std::vector<int>& minDurations,
+                                          const CancellationToken& cancellation =
+                                              CancellationToken(),
+                                          const std::function<void(size_t, size_t)>& progress =
+                                              std::function<void(size_t, size_t)>()) const;
+
+    /*******************************************************************************************//**
+     * Writes the results as table to a csv file (one row for each combination).
+     *
+     * @param results  results of a sweep
+     * @param fileName name of the file
+     * @return false if the file could not be written
+     **********************************************************************************************/
+    static bool writeCsv(const std::vector<ParameterSweepResult>& results, const QString& fileName);
+
+private:
+
+    /*******************************************************************************************//**
+     * Evaluates all combinations for one trial.
+     *
+     * @param trial              current trial
+     * @param velocityThresholds list of relative velocity thresholds
+     * @param minDurations       list of minimum durations [ms]
+     * @return one result for each combination
+     **********************************************************************************************/
+    std::vector<ParameterSweepResult> evaluateTrial(Trial* trial,
+                                                    const std::vector<qreal>& velocityThresholds,
+                                                    const std::vector<int>& minDurations) const;
+
+    /*******************************************************************************************//**
+     * Assigns the microsaccades to the fixations of the trial and applies the fixation dependent
+     * criteria. Count and amplitudes of the remaining microsaccades are added to result.
+     *
+     * @param trial         current trial
+     * @param microsaccades detected microsaccades, temporally ordered
+     * @param result        result of the current combination
+     **********************************************************************************************/
+    void addMicrosaccadesInFixations(Trial* trial, const std::vector<Saccade>& microsaccades,
+                                     ParameterSweepResult& result) const;
+
+    /// Microsaccade filter settings.
+    SaccadeFilterSettings m_settings;
+
+    /// Evaluated gaze type.
+    GazeType m_gazeType;
+};
+
+#endif // PARAMETERSWEEP_H
@@ -0,0 +1,74 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file prefilter.h
+ **************************************************************************************************/
+#ifndef PREFILTER_H
+#define PREFILTER_H
+
+#include "enums.h"
+#include "gazeruns.h"
+#include <QStringList>
+#include <QtGlobal>
+#include <vector>
+
+/***********************************************************************************************//**
+ * This namespace provides the optional smoothing of the gaze positions before the velocity
+ * computation of SaccadeDetector::determineVelocity.
+ *
+ * Each run of consecutive samples (GazeRuns) is filtered separately so that missing data is never
+ * bridged. At the borders of a run the window shrinks symmetrically; the first and last sample of
+ * a run are not changed. All filters need a single pass over the position columns; the inner loop
+ * of the Savitzky-Golay filter uses fixed coefficients and can be vectorized by the compiler.
+ **************************************************************************************************/
+namespace PreFilter
+{
+
+    /*******************************************************************************************//**
+     * Returns the Savitzky-Golay smoothing coefficients (quadratic polynomial) for the half window
+     * size m, index k is the offset -m to m.
+     *
+     * @param m half window size
+     * @return 2m + 1 coefficients
+     **********************************************************************************************/
+    std::vector<qreal> savitzkyGolayCoefficients(int m);
+
+    /*******************************************************************************************//**
+     * Applies a quadratic Savitzky-Golay filter to the samples [0, N).
+     *
+     * @param x    positions of one run
+     * @param y    result: filtered positions
+     * @param N    number of samples
+     * @param size half window size
+     **********************************************************************************************/
+    void savitzkyGolay(const qreal* x, qreal* y, int N, int size);
+
+    /*******************************************************************************************//**
+     * Applies a running median to the samples [0, N).
+     *
+     * @param x    positions of one run
+     * @param y    result: filtered positions
+     * @param N    number of samples
+     * @param size half window size
+     **********************************************************************************************/
+    void runningMedian(const qreal* x, qreal* y, int N, int size);
+
+    /*******************************************************************************************//**
+     * Filters both position columns of all runs.
+     *
+     * @param runs       gaze runs of one gaze type
+     * @param filter     pre-filter, PFT_None copies the positions
+     * @param windowSize window size in samples (odd, even sizes are reduced by one)
+     * @param filtered   result: filtered positions
+     **********************************************************************************************/
+    void apply(const GazeRuns& runs, PreFilterType filter, size_t windowSize,
+               FilteredGazeColumns& filtered);
+
+    /*******************************************************************************************//**
+     * Returns the names of all pre-filters in the order of PreFilterType.
+     *
+     * @return pre-filter names
+     **********************************************************************************************/
+    QStringList filterNames();
+}
+
+#endif // PREFILTER_H
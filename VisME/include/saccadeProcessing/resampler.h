@@ -0,0 +1,122 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file resampler.h
+ **************************************************************************************************/
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include "gazedata.h"
+#include <QMap>
+#include <QtGlobal>
+#include <vector>
+
+class Trial;
+
+/***********************************************************************************************//**
+ * This class converts trials from their own sampling rate (FREQ) to a common rate so that studies
+ * with mixed rates (e.g. 500, 1000 and 2000 Hz) can be compared; afterwards all settings given in
+ * ms map to the same number of samples.
+ *
+ * The rate is changed by the rational factor up/down with a polyphase FIR filter (windowed sinc,
+ * Kaiser window) which removes frequencies above the lower of both Nyquist frequencies. Only the
+ * taps of one phase are used per output sample; they are stored in reverse order so that the
+ * inner loop is a dot product over contiguous memory which the compiler can vectorize.
+ *
+ * Each run of consecutive samples is resampled separately, missing data stays missing. Sample
+ * indices of events, fixations and microsaccades of the input file are mapped to the new rate.
+ * An object only reads its filter and can be shared by several threads.
+ **************************************************************************************************/
+class Resampler
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Constructor, designs the filter.
+     *
+     * @param sourceFrequency sampling rate of the trials [Hz], must be an integer
+     * @param targetFrequency new sampling rate [Hz], must be an integer
+     **********************************************************************************************/
+    Resampler(qreal sourceFrequency, qreal targetFrequency);
+
+    /*******************************************************************************************//**
+     * Returns if both rates are positive integers.
+     **********************************************************************************************/
+    bool isValid() const;
+
+    /*******************************************************************************************//**
+     * Returns if the rates differ, i.e., if samples are changed.
+     **********************************************************************************************/
+    bool changesRate() const;
+
+    /*******************************************************************************************//**
+     * Returns the index at the new rate of the sample closest in time to the given index.
+     *
+     * @param index sample index at the source rate
+     * @return sample index at the target rate
+     **********************************************************************************************/
+    int mapIndex(int index) const;
+
+    /*******************************************************************************************//**
+     * Resamples one run of consecutive samples.
+     *
+     * @param x      values of the run
+     * @param first  sample index of the first value
+     * @param N      number of values
+     * @param y      result: resampled values are appended
+     * @param index  result: sample indices of the resampled values are appended (target rate)
+     **********************************************************************************************/
+    void resampleRun(const qreal* x, int first, int N, std::vector<qreal>& y,
+                     std::vector<int>& index) const;
+
+    /*******************************************************************************************//**
+     * Resamples the gaze data of one gaze type.
+     *
+     * @param gazeData gaze data at the source rate
+     * @return gaze data at the target rate
+     **********************************************************************************************/
+    QMap<int, GazeData> resampleGazeData(const QMap<int, GazeData>& gazeData) const;
+
+    /*******************************************************************************************//**
+     * Resamples all gaze types of the trial, maps the indices of events and input fixations and
+     * microsaccades and sets the new rate. Detected fixations and microsaccades are removed, they
+     * have to be detected again.
+     *
+     * @param trial trial with the source rate
+     **********************************************************************************************/
+    void resampleTrial(Trial* trial) const;
+
+    /*******************************************************************************************//**
+     * Returns the number of filter taps.
+     **********************************************************************************************/
+    size_t filterLength() const;
+
+private:
+
+    /*******************************************************************************************//**
+     * Returns the modified Bessel function of the first kind of order zero (Kaiser window).
+     *
+     * @param x argument
+     * @return I0(x)
+     **********************************************************************************************/
+    static qreal besselI0(qreal x);
+
+    /// Rates [Hz].
+    int m_sourceFrequency;
+    int m_targetFrequency;
+
+    /// Up and down sampling factors (target / source reduced).
+    int m_up;
+    int m_down;
+
+    /// Half length of the filter at the up sampled rate.
+    int m_halfLength;
+
+    /// Number of taps of the filter.
+    size_t m_filterLength;
+
+    /// Taps of each phase in reverse order, all phases have the same length.
+    std::vector<std::vector<qreal> > m_phases;
+};
+
+#endif // RESAMPLER_H
@@ -0,0 +1,65 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file saccadecandidates.h
+ **************************************************************************************************/
+#ifndef SACCADECANDIDATES_H
+#define SACCADECANDIDATES_H
+
+#include "saccade.h"
+#include "saccadefiltersettings.h"
+#include <vector>
+
+/***********************************************************************************************//**
+ * Cache for the (micro)saccade candidates of one trial.
+ *
+ * Candidates are the result of the velocity and threshold computation including peak velocity,
+ * amplitude and duration but before the validity criteria (amplitude, peak velocity, duration)
+ * are applied. As long as only validity criteria change, the candidates can be reused.
+ **************************************************************************************************/
+struct SaccadeCandidates
+{
+    SaccadeCandidates():
+        m_isSet(false),
+        m_pixelsPerDegree(0)
+    {}
+
+    // Returns if the cached candidates were computed with parameters that lead to the same
+    // candidates as the given settings and conversion factor of the participant.
+    bool isUpToDate(const SaccadeFilterSettings& settings, qreal pixelsPerDegree) const
+    {
+        return m_isSet && m_pixelsPerDegree == pixelsPerDegree &&
+                m_settings.sameCandidateParameters(settings);
+    }
+
+    // Stores the candidates for all gaze types (right, left, average) together with the settings
+    // and the conversion factor used to compute them.
+    void set(const SaccadeFilterSettings& settings, qreal pixelsPerDegree,
+             const std::vector<std::vector<Saccade> >& candidates)
+    {
+        m_settings = settings;
+        m_pixelsPerDegree = pixelsPerDegree;
+        m_candidates = candidates;
+        m_isSet = true;
+    }
+
+    // Invalidates the candidates, e.g., when the gaze data of the trial changes.
+    void clear()
+    {
+        m_candidates.clear();
+        m_isSet = false;
+    }
+
+    // If candidates were computed.
+    bool m_isSet;
+
+    // Settings used for the computation of the candidates.
+    SaccadeFilterSettings m_settings;
+
+    // Conversion factor of the participant used for the positions and velocities in degree.
+    qreal m_pixelsPerDegree;
+
+    // List of candidates for each gaze type (right, left, average).
+    std::vector<std::vector<Saccade> > m_candidates;
+};
+
+#endif // SACCADECANDIDATES_H
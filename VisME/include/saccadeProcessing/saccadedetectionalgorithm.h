@@ -0,0 +1,68 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file saccadedetectionalgorithm.h
+ **************************************************************************************************/
+#ifndef SACCADEDETECTIONALGORITHM_H
+#define SACCADEDETECTIONALGORITHM_H
+
+#include "enums.h"
+#include "gazeruns.h"
+#include "saccade.h"
+#include "saccadefiltersettings.h"
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+class Trial;
+
+/***********************************************************************************************//**
+ * Interface for algorithms which detect (micro)saccade candidates in one section of gaze data.
+ *
+ * All algorithms work on the same prepared buffers: the positions of the section (views on the
+ * gaze runs of the trial) and the velocity values computed once by
+ * SaccadeDetector::determineVelocity. Therefore, different algorithms can be compared on the same
+ * data without converting the samples again.
+ **************************************************************************************************/
+class SaccadeDetectionAlgorithm
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Destructor.
+     **********************************************************************************************/
+    virtual ~SaccadeDetectionAlgorithm();
+
+    /*******************************************************************************************//**
+     * Determines saccade candidates of one section. The validity criteria (amplitude, peak
+     * velocity, maximum duration) are not applied.
+     *
+     * @param x        input gaze data: x and y position and gaze sample index
+     * @param v        velocity values for x
+     * @param settings filter settings (velocity threshold, minimum duration...)
+     * @param trial    current trial
+     * @return list of saccade candidates with their properties; indices of the raw data
+     **********************************************************************************************/
+    virtual std::vector<Saccade> detect(const GazeSection& x, const GazeVelocity& v,
+                                        const SaccadeFilterSettings* settings, Trial* trial) = 0;
+
+    /*******************************************************************************************//**
+     * Returns the name of the algorithm, e.g., for the user interface.
+     **********************************************************************************************/
+    virtual QString name() const = 0;
+
+    /*******************************************************************************************//**
+     * Creates the algorithm of the given type; the caller takes ownership.
+     *
+     * @param algorithm algorithm type
+     * @return new algorithm
+     **********************************************************************************************/
+    static SaccadeDetectionAlgorithm* create(DetectionAlgorithm algorithm);
+
+    /*******************************************************************************************//**
+     * Returns the names of all algorithms in the order of DetectionAlgorithm.
+     **********************************************************************************************/
+    static QStringList algorithmNames();
+};
+
+#endif // SACCADEDETECTIONALGORITHM_H
@@ -5,14 +5,28 @@
 #ifndef SACCADESDETECTOR_H
 #define SACCADESDETECTOR_H
 
+#include "cancellationtoken.h"
+#include "fixation.h"
 #include "gazedata.h"
-#include "settings.h"
+#include "gazeruns.h"
+#include "saccade.h"
+#include "settingssnapshot.h"
 #include <QPair>
 #include <vector>
 
-class Saccade;
+class SaccadeDetectionAlgorithm;
 class Trial;
-struct Settings;
+
+/***********************************************************************************************//**
+ * Regular saccades and fixations of all gaze types (right, left, average) before they are stored
+ * in the trial.
+ **************************************************************************************************/
+struct FixationDetectionResult
+{
+    std::vector<std::vector<Saccade> > m_saccades;
+    std::vector<std::vector<Fixation> > m_fixations;
+    size_t m_validCount = 0; ///< number of gaze types (in order) with valid fixations
+};
 
 /***********************************************************************************************//**
  * This class is responsible for detecting (micro)saccades.
@@ -30,67 +44,147 @@ public:
     /*******************************************************************************************//**
      * Determines microsaccades for the given trial and the given parameters.
      *
-     * @param trial    trial for which microsaccades are determined
-     * @param settings global settings
+     * @param trial        trial for which microsaccades are determined
+     * @param settings     settings snapshot
+     * @param cancellation checked for each section; if canceled, the lists are empty and the
+     *                     candidates of the trial are not changed
      * @return list of microsaccades
      **********************************************************************************************/
-    std::vector<std::vector<Saccade> > determineMicrosaccades(Trial* trial, Settings* settings);
+    std::vector<std::vector<Saccade> > determineMicrosaccades(
+            Trial* trial, const SettingsSnapshot& settings,
+            const CancellationToken& cancellation = CancellationToken());
 
     /*******************************************************************************************//**
      * Determines Saccades for the given trial and the given parameters.
      *
-     * @param trial    trial for which saccades are determined
-     * @param settings contains microsaccade settings
+     * @param trial        trial for which saccades are determined
+     * @param settings     settings snapshot with the fixation settings
+     * @param cancellation checked for each section; if canceled, the lists are empty and the
+     *                     candidates of the trial are not changed
      * @return list of saccades
      **********************************************************************************************/
-    std::vector<std::vector<Saccade> > determineRegularSaccades(Trial* trial, Settings* settings);
+    std::vector<std::vector<Saccade> > determineRegularSaccades(
+            Trial* trial, const SettingsSnapshot& settings,
+            const CancellationToken& cancellation = CancellationToken());
 
     /*******************************************************************************************//**
      * Removes microsaccades from the fixation which are inside the inter-saccadic interval
      *
      * @param trial    trial for which saccades are determined
-     * @param settings contains microsaccade settings
+     * @param settings settings snapshot with the microsaccade settings
      * @param fixation current fixation
      **********************************************************************************************/
-    void removeMicrosaccadesForIntersaccadicInterval(Trial* trial, Settings* settings, Fixation* fixation);
+    void removeMicrosaccadesForIntersaccadicInterval(Trial* trial, const SettingsSnapshot& settings,
+                                                     Fixation* fixation);
 
-private:
+    /*******************************************************************************************//**
+     * Determines regular saccades and fixations for all gaze types and stores them in the trial.
+     * Independent of the user interface.
+     *
+     * @param trial        trial for which fixations are determined
+     * @param settings     settings snapshot with the fixation settings
+     * @param cancellation checked for each section and fixation
+     * @return false if canceled (the trial is not changed) or if the ignored time at start/end of
+     *         the trial results in invalid indices (the trial is not changed for this and the
+     *         following gaze types)
+     **********************************************************************************************/
+    bool detectFixations(Trial* trial, const SettingsSnapshot& settings,
+                         const CancellationToken& cancellation = CancellationToken());
 
     /*******************************************************************************************//**
-     * Determines microsaccades for the given settings.
+     * Determines regular saccades and fixations for all gaze types without changing the trial
+     * (except for the cached candidates).
      *
-     * @param gazeData      raw eye tracking data
-     * @param indicesStart  start index in raw data that defines the range where the filter is used
-     * @param indicesEnd    end index for the range
-     * @param trial         trial for which microsaccades are determined
-     * @param settings      global settings
-     * @return list of microsaccades
+     * @param trial        trial for which fixations are determined
+     * @param settings     settings snapshot with the fixation settings
+     * @param result       resulting saccades and fixations
+     * @param cancellation checked for each section and fixation
+     * @return false if canceled (the result is incomplete) or if the ignored time at start/end of
+     *         the trial results in invalid indices for a gaze type
      **********************************************************************************************/
-    std::vector<Saccade> calculateMicrosaccades(const QMap<int, GazeData>& gazeData,
-                                                int indicesStart, int indicesEnd,
-                                                Trial* trial,
-                                                Settings* settings);
+    bool determineFixations(Trial* trial, const SettingsSnapshot& settings,
+                            FixationDetectionResult& result,
+                            const CancellationToken& cancellation = CancellationToken());
 
     /*******************************************************************************************//**
-     * Computes (micro)saccades.
+     * Stores the saccades and fixations of the valid gaze types in the trial; the fixations are
+     * set for the fixation source selected in the trial (Trial::useFixationsFromInput).
      *
-     * Method described in
-     * Ralf Engbert and Reinhold Kliegl: Microsaccades uncover the orientation of covert attention.
-     * Code in R is available at:
-     * http://read.psych.uni-potsdam.de/index.php?option=com_content&view=article&id=140:engbert-et-
-     * al-2015-microsaccade-toolbox-for-r&catid=26:publications&Itemid=34
+     * @param trial  trial in which the result is stored
+     * @param result saccades and fixations of determineFixations
+     **********************************************************************************************/
+    void setFixations(Trial* trial, const FixationDetectionResult& result);
+
+    /*******************************************************************************************//**
+     * Determines microsaccades for all gaze types, assigns them to the fixations of the trial and
+     * removes microsaccades inside the inter-saccadic interval if enabled. Independent of the user
+     * interface.
      *
-     * @param  x         input gaze data: matrix containing x and y position for one eye
-     *                       (matrix with two columns)
-     * @param newRadius parameters of elliptic threshold
-     * @param settings  filter settings
-     * @param trial     current trial
-     * @return list of saccades with their properties (index range, peak velocity, amplitude...)
+     * @param trial        trial for which microsaccades are determined
+     * @param settings     settings snapshot with the microsaccade settings
+     * @param cancellation checked for each section
+     * @return false if canceled, the trial is not changed then
      **********************************************************************************************/
-    std::vector<Saccade> saccadesFilter(std::vector<std::vector<qreal> >& x,
-                                        QPair<qreal, qreal>& newRadius,
-                                        SaccadeFilterSettings* settings,
-                                        Trial* trial);
+    bool detectMicrosaccades(Trial* trial, const SettingsSnapshot& settings,
+                             const CancellationToken& cancellation = CancellationToken());
+
+    /*******************************************************************************************//**
+     * Assigns microsaccades of all gaze types to the fixations of the trial and removes
+     * microsaccades inside the inter-saccadic interval if enabled.
+     *
+     * @param trial         trial in which the microsaccades are stored
+     * @param settings      settings snapshot with the microsaccade settings
+     * @param microsaccades microsaccades of determineMicrosaccades
+     **********************************************************************************************/
+    void setMicrosaccades(Trial* trial, const SettingsSnapshot& settings,
+                          std::vector<std::vector<Saccade> >& microsaccades);
+
+    /*******************************************************************************************//**
+     * Determines fixations between the given saccades: every part without saccades and without
+     * missing data is a fixation. Fixation positions are the mean gaze positions.
+     *
+     * @param trial        trial for which fixations are determined
+     * @param saccades     temporally ordered regular saccades of the gaze type
+     * @param gazeType     gaze type (right, left, average)
+     * @param settings     settings snapshot with the fixation settings
+     * @param fixations    resulting fixations
+     * @param cancellation checked for each fixation
+     * @return false if canceled or if the ignored time at start/end of the trial results in
+     *         invalid indices
+     **********************************************************************************************/
+    bool determineFixations(Trial* trial, const std::vector<Saccade>& saccades, GazeType gazeType,
+                            const SettingsSnapshot& settings, std::vector<Fixation>& fixations,
+                            const CancellationToken& cancellation = CancellationToken());
+
+    /*******************************************************************************************//**
+     * Determines the sections of the gaze data in which microsaccades are detected, i.e., parts
+     * without missing data, trimmed by the ignore before/after missing data settings. Sections
+     * are views on the gaze runs cached in the trial (Trial::gazeRuns); if a pre-filter is set,
+     * the positions are the filtered ones (Trial::filteredGazeColumns).
+     *
+     * @param trial    trial for which microsaccades are determined
+     * @param gazeType gaze type (right, left, average)
+     * @param settings filter settings
+     * @return list of sections
+     **********************************************************************************************/
+    std::vector<GazeSection> determineMicrosaccadeSections(Trial* trial, GazeType gazeType,
+                                                           const SaccadeFilterSettings* settings);
+
+    /*******************************************************************************************//**
+     * Determines the sections of the gaze data in which saccades for the fixation detection are
+     * detected. Sections are views on the gaze runs cached in the trial (Trial::gazeRuns); if a
+     * pre-filter is set, the positions are the filtered ones (Trial::filteredGazeColumns).
+     *
+     * Different from the microsaccade sections, the first sample after missing data and the last
+     * sample of the trial are not used.
+     *
+     * @param trial    trial for which saccades are determined
+     * @param gazeType gaze type (right, left, average)
+     * @param settings filter settings
+     * @return list of sections
+     **********************************************************************************************/
+    std::vector<GazeSection> determineRegularSaccadeSections(Trial* trial, GazeType gazeType,
+                                                             const SaccadeFilterSettings* settings);
 
     /*******************************************************************************************//**
      * Compute velocity times series from position data taking multiple position values into account
@@ -103,15 +197,88 @@ private:
      * http://read.psych.uni-potsdam.de/index.php?option=com_content&view=article&id=140:engbert-et-
      * al-2015-microsaccade-toolbox-for-r&catid=26:publications&Itemid=34
      *
-     * @param xValues    input gaze data: matrix containing x and y position for one eye
-     *                   (matrix with two columns)
+     * @param xValues    input gaze data: x and y position for one eye
      * @param frequency  sampling rate
      * @param windowSize window size for the velocity calculation
-     * @return matrix with velocity values
+     * @return velocity values
      **********************************************************************************************/
-    std::vector<std::vector<qreal> > determineVelocity(std::vector<std::vector<qreal> >& xValues,
-                                                       qreal frequency, size_t windowSize);
-                                                       //, int type = 2);
+    GazeVelocity determineVelocity(const GazeSection& xValues, qreal frequency, size_t windowSize);
+                                   //, int type = 2);
+
+    /*******************************************************************************************//**
+     * Computes the median based standard deviation of both velocity components which is scaled by
+     * the velocity threshold to get the elliptic threshold.
+     *
+     * @param v   velocity values
+     * @param msd result: median based standard deviation for x and y component
+     * @return false if the deviation is zero (no saccades can be determined)
+     **********************************************************************************************/
+    bool velocityStatistics(const GazeVelocity& v, QPair<qreal, qreal>& msd);
+
+    /*******************************************************************************************//**
+     * Determines saccade candidates from velocity values and their statistics. The validity
+     * criteria (amplitude, peak velocity, maximum duration) are not applied.
+     *
+     * @param x                 input gaze data: x and y position and gaze sample index
+     * @param v                 velocity values for x
+     * @param msd               median based standard deviation of the velocity components
+     * @param velocityThreshold relative velocity threshold (multiple of msd)
+     * @param minDuration       minimum duration in samples
+     * @param newRadius         result: parameters of elliptic threshold
+     * @return list of saccade candidates with their properties
+     **********************************************************************************************/
+    std::vector<Saccade> determineSaccadeCandidates(const GazeSection& x,
+                                                    const GazeVelocity& v,
+                                                    const QPair<qreal, qreal>& msd,
+                                                    qreal velocityThreshold,
+                                                    size_t minDuration,
+                                                    QPair<qreal, qreal>& newRadius);
+
+    /*******************************************************************************************//**
+     * Computes the properties of saccade candidates (peak velocity, components, amplitudes) and
+     * converts their section indices to indices of the raw data. Used by all detection algorithms.
+     *
+     * @param x        input gaze data: x and y position and gaze sample index
+     * @param v        velocity values for x
+     * @param saccades saccade candidates with onset and end index in the section
+     **********************************************************************************************/
+    void setSaccadeProperties(const GazeSection& x, const GazeVelocity& v,
+                              std::vector<Saccade>& saccades);
+
+    /*******************************************************************************************//**
+     * Determines microsaccade candidates for one gaze type, i.e., microsaccades before the
+     * validity criteria (amplitude, peak velocity, duration) are applied.
+     *
+     * @param trial        trial for which microsaccades are determined
+     * @param gazeType     gaze type (right, left, average)
+     * @param settings     filter settings
+     * @param cancellation checked for each section; if canceled, the list is incomplete
+     * @return list of microsaccade candidates
+     **********************************************************************************************/
+    std::vector<Saccade> determineMicrosaccadeCandidates(
+            Trial* trial, GazeType gazeType, const SaccadeFilterSettings* settings,
+            const CancellationToken& cancellation = CancellationToken());
+
+    /*******************************************************************************************//**
+     * Checks the validity criteria (amplitude, peak velocity, duration) for a saccade candidate.
+     *
+     * @param saccade     saccade candidate
+     * @param settings    filter settings
+     * @param maxDuration maximum duration in samples
+     * @return if the saccade fulfills all enabled criteria
+     **********************************************************************************************/
+    bool isValidSaccade(const Saccade& saccade, const SaccadeFilterSettings* settings,
+                        size_t maxDuration);
+
+    /*******************************************************************************************//**
+     * Removes all saccade candidates that do not fulfill the validity criteria.
+     *
+     * @param saccades saccade candidates, invalid ones are removed
+     * @param settings filter settings
+     * @param trial    current trial
+     **********************************************************************************************/
+    void removeInvalidSaccades(std::vector<Saccade>& saccades,
+                               const SaccadeFilterSettings* settings, Trial* trial);
 
     /*******************************************************************************************//**
      * Computes binocular microsaccades.
@@ -122,13 +289,59 @@ private:
      * http://read.psych.uni-potsdam.de/index.php?option=com_content&view=article&id=140:engbert-et-
      * al-2015-microsaccade-toolbox-for-r&catid=26:publications&Itemid=34
      *
+     * Overlapping saccades of both eyes are merged to clusters in a sweep over the saccades sorted
+     * by onset; for each cluster with saccades in both eyes, the saccade with the largest amplitude
+     * is used for each eye. Memory is proportional to the number of saccades.
+     *
      * @param leftEye saccades data for left eye
      * @param rightEye saccades data for right eye
      * @return list of saccades
      **********************************************************************************************/
     QPair<std::vector<Saccade>, std::vector<Saccade> > determineBinocularSaccades(
-            std::vector<Saccade> leftEye,
-            std::vector<Saccade> rightEye);
+            const std::vector<Saccade>& leftEye,
+            const std::vector<Saccade>& rightEye);
+
+private:
+
+    /*******************************************************************************************//**
+     * Determines microsaccade candidates for all gaze types (right, left, average), i.e.,
+     * microsaccades before the validity criteria (amplitude, peak velocity, duration) are applied.
+     *
+     * @param trial        trial for which microsaccades are determined
+     * @param settings     settings snapshot
+     * @param cancellation checked for each section; if canceled, the lists are incomplete
+     * @return list of microsaccade candidates for each gaze type
+     **********************************************************************************************/
+    std::vector<std::vector<Saccade> > determineMicrosaccadeCandidates(
+            Trial* trial, const SettingsSnapshot& settings, const CancellationToken& cancellation);
+
+    /*******************************************************************************************//**
+     * Determines saccade candidates for all gaze types (right, left, average), i.e., saccades
+     * before the validity criteria (amplitude, peak velocity, duration) are applied.
+     *
+     * @param trial        trial for which saccades are determined
+     * @param settings     settings snapshot
+     * @param cancellation checked for each section; if canceled, the lists are incomplete
+     * @return list of saccade candidates for each gaze type
+     **********************************************************************************************/
+    std::vector<std::vector<Saccade> > determineRegularSaccadeCandidates(
+            Trial* trial, const SettingsSnapshot& settings, const CancellationToken& cancellation);
+
+    /*******************************************************************************************//**
+     * Computes (micro)saccades: the velocity values of the section are computed once and passed
+     * to the detection algorithm selected in the settings (SaccadeDetectionAlgorithm).
+     *
+     * @param x         input gaze data: x and y position for one eye
+     * @param algorithm detection algorithm
+     * @param settings  filter settings
+     * @param trial     current trial
+     * @return list of saccade candidates with their properties (index range, peak velocity,
+     *         amplitude...); validity criteria are not applied
+     **********************************************************************************************/
+    std::vector<Saccade> saccadesFilter(const GazeSection& x,
+                                        SaccadeDetectionAlgorithm* algorithm,
+                                        const SaccadeFilterSettings* settings,
+                                        Trial* trial);
 };
 
 #endif // SACCADESDETECTOR_H
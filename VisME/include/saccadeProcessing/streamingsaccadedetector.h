@@ -0,0 +1,238 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file streamingsaccadedetector.h
+ **************************************************************************************************/
+#ifndef STREAMINGSACCADEDETECTOR_H
+#define STREAMINGSACCADEDETECTOR_H
+
+#include "enums.h"
+#include "gazedata.h"
+#include "saccade.h"
+#include "saccadefiltersettings.h"
+#include <QPair>
+#include <deque>
+#include <vector>
+
+class Trial;
+
+/***********************************************************************************************//**
+ * struct StreamingComparison
+ *
+ * Agreement between microsaccades of the streaming detector and the batch detection.
+ **************************************************************************************************/
+struct StreamingComparison
+{
+    StreamingComparison():
+        m_streamedCount(0),
+        m_batchCount(0),
+        m_matchedCount(0)
+    {}
+
+    size_t m_streamedCount;
+    size_t m_batchCount;
+
+    // Number of streamed microsaccades which overlap with a batch microsaccade (one to one).
+    size_t m_matchedCount;
+};
+
+/***********************************************************************************************//**
+ * This class detects microsaccades online for one gaze type while gaze samples arrive.
+ *
+ * It uses the same velocity computation and elliptic threshold as SaccadeDetector, but the
+ * median based standard deviation of the velocity is estimated on a sliding window of the most
+ * recent samples instead of the whole section. Positions for the velocity window are kept in a
+ * ring buffer. A microsaccade is reported as soon as its velocity drops below the threshold, i.e.,
+ * (velocityWindowSize - 1) / 2 samples plus the samples ignored before missing data after its end.
+ * A run above the threshold is rejected as soon as it exceeds the maximum duration (if used).
+ * Otherwise, runs are ended at the length of the threshold window, so that the latency and the
+ * memory are bounded also for long runs.
+ *
+ * Missing data (gaps in the sample indices) and the ignore before/after missing data settings are
+ * handled like in the batch detection.
+ **************************************************************************************************/
+class StreamingSaccadeDetector
+{
+
+public:
+
+    /*******************************************************************************************//**
+     * Constructor.
+     *
+     * @param settings        microsaccade filter settings
+     * @param frequency       sampling rate
+     * @param pixelsPerDegree conversion factor from pixel to degree
+     * @param thresholdWindow duration [ms] of the window used for the threshold estimation
+     **********************************************************************************************/
+    StreamingSaccadeDetector(const SaccadeFilterSettings& settings, qreal frequency,
+                             qreal pixelsPerDegree, int thresholdWindow = 5000);
+
+    /*******************************************************************************************//**
+     * Adds the next gaze sample. Sample indices have to be increasing; missing indices are
+     * treated as missing data.
+     *
+     * @param index    sample index
+     * @param gazeData gaze position
+     * @return microsaccades completed with this sample
+     **********************************************************************************************/
+    std::vector<Saccade> addSample(int index, const GazeData& gazeData);
+
+    /*******************************************************************************************//**
+     * Ends the stream and processes all remaining samples.
+     *
+     * @return microsaccades completed with the remaining samples
+     **********************************************************************************************/
+    std::vector<Saccade> finish();
+
+    /*******************************************************************************************//**
+     * Removes all samples and the threshold estimate.
+     **********************************************************************************************/
+    void reset();
+
+    /*******************************************************************************************//**
+     * Replays the gaze data of a trial sample by sample.
+     *
+     * @param trial           trial, e.g., imported from a .maf file
+     * @param gazeType        gaze type (right, left, average)
+     * @param settings        microsaccade filter settings
+     * @param thresholdWindow duration [ms] of the window used for the threshold estimation
+     * @return detected microsaccades
+     **********************************************************************************************/
+    static std::vector<Saccade> replay(Trial* trial, GazeType gazeType,
+                                       const SaccadeFilterSettings& settings,
+                                       int thresholdWindow = 5000);
+
+    /*******************************************************************************************//**
+     * Replays the gaze data of a trial and compares the result with the monocular batch detection
+     * using the same settings. The streaming detector only supports the Engbert-Kliegl algorithm
+     * without pre-filter and gap interpolation, therefore the batch detection ignores the
+     * algorithm, pre-filter and gap interpolation of the settings.
+     *
+     * @param trial           trial, e.g., imported from a .maf file
+     * @param gazeType        gaze type (right, left, average)
+     * @param settings        microsaccade filter settings
+     * @param thresholdWindow duration [ms] of the window used for the threshold estimation
+     * @return agreement of both detections
+     **********************************************************************************************/
+    static StreamingComparison compareWithBatch(Trial* trial, GazeType gazeType,
+                                                const SaccadeFilterSettings& settings,
+                                                int thresholdWindow = 5000);
+
+private:
+
+    /*******************************************************************************************//**
+     * struct Sample
+     *
+     * Gaze sample within the detector: position in degree and velocity.
+     **********************************************************************************************/
+    struct Sample
+    {
+        int m_index;
+        qreal m_x;
+        qreal m_y;
+        qreal m_vx;
+        qreal m_vy;
+    };
+
+    /*******************************************************************************************//**
+     * Adds a sample to the current section (after ignoring samples around missing data).
+     *
+     * @param sample new sample
+     * @param result completed microsaccades are appended
+     **********************************************************************************************/
+    void addToSection(const Sample& sample, std::vector<Saccade>& result);
+
+    /*******************************************************************************************//**
+     * Ends the current section: velocities of the last samples are determined and a running
+     * microsaccade is completed.
+     *
+     * @param result completed microsaccades are appended
+     **********************************************************************************************/
+    void endSection(std::vector<Saccade>& result);
+
+    /*******************************************************************************************//**
+     * Computes the velocity of the given row of the current section (same values as
+     * SaccadeDetector::determineVelocity) and checks the threshold. Only used for sections with
+     * at least velocityWindowSize samples.
+     *
+     * @param row             row in the current section
+     * @param sectionComplete if the section ended
+     * @param result          completed microsaccades are appended
+     **********************************************************************************************/
+    void processRow(size_t row, bool sectionComplete, std::vector<Saccade>& result);
+
+    /*******************************************************************************************//**
+     * Completes the running microsaccade candidate and applies the validity criteria.
+     *
+     * @param result completed microsaccades are appended
+     **********************************************************************************************/
+    void endRun(std::vector<Saccade>& result);
+
+    /*******************************************************************************************//**
+     * Updates the median based standard deviation of the velocity on the threshold window.
+     **********************************************************************************************/
+    void updateThreshold();
+
+    /*******************************************************************************************//**
+     * Converts a duration to the number of samples (see Trial::timeToSamples).
+     *
+     * @param time duration [ms]
+     * @return number of samples
+     **********************************************************************************************/
+    size_t timeToSamples(qreal time) const;
+
+    /// Microsaccade filter settings.
+    SaccadeFilterSettings m_settings;
+
+    /// Sampling rate.
+    qreal m_frequency;
+
+    /// Conversion factor from pixel to degree.
+    qreal m_pixelsPerDegree;
+
+    /// Parameters in samples.
+    size_t m_windowSize;
+    size_t m_halfWindow;
+    size_t m_maxDuration;
+    size_t m_minDuration;
+    int m_ignoreBeforeMissingData;
+    int m_ignoreAfterMissingData;
+
+    /// Index of the last added sample, samples with smaller indices are ignored after missing data.
+    int m_lastIndex;
+    int m_ignoreUntilIndex;
+
+    /// Samples which are kept back until it is clear that no missing data follows.
+    std::deque<Sample> m_pending;
+
+    /// Ring buffer with the last samples of the current section (size of the velocity window).
+    std::vector<Sample> m_ringBuffer;
+
+    /// Number of samples and processed rows in the current section.
+    size_t m_sectionSize;
+    size_t m_processedRows;
+
+    /// Velocity values in the threshold window.
+    std::deque<qreal> m_velocityX;
+    std::deque<qreal> m_velocityY;
+    size_t m_thresholdWindow;
+    size_t m_rowsSinceUpdate;
+
+    /// Number of velocity values needed before the first threshold estimate (at most 1 s).
+    size_t m_warmUp;
+
+    /// Current median based standard deviation of the velocity components.
+    QPair<qreal, qreal> m_msd;
+    bool m_thresholdValid;
+
+    /// Samples of the running microsaccade candidate.
+    std::vector<Sample> m_run;
+
+    /// Maximum number of samples of a run if no maximum duration is used (threshold window size).
+    size_t m_maxRunSize;
+
+    /// If the samples above the threshold are skipped because the run exceeded the maximum
+    /// duration or size (until the velocity drops below the threshold).
+    bool m_skipRun;
+};
+
+#endif // STREAMINGSACCADEDETECTOR_H
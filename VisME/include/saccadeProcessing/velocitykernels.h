@@ -0,0 +1,81 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file velocitykernels.h
+ **************************************************************************************************/
+#ifndef VELOCITYKERNELS_H
+#define VELOCITYKERNELS_H
+
+#include <QtGlobal>
+
+/***********************************************************************************************//**
+ * This namespace provides the moving window velocity computation of
+ * SaccadeDetector::determineVelocity for one position column.
+ *
+ * The window size is a runtime parameter; for the common odd window sizes (3 to 11) kernels with
+ * the half window size as template parameter are used so that the compiler can unroll the window
+ * loop. All kernels add the values in the same order as the generic kernel, therefore the results
+ * are identical.
+ **************************************************************************************************/
+namespace VelocityKernels
+{
+
+    /*******************************************************************************************//**
+     * Signature of all kernels.
+     *
+     * @param x      positions of the section
+     * @param v      result: velocity values, only [size, N - size) are set
+     * @param N      number of samples
+     * @param size   half window size ((window size - 1) / 2)
+     * @param factor frequency / 6
+     **********************************************************************************************/
+    typedef void (*Kernel)(const qreal* x, qreal* v, int N, int size, qreal factor);
+
+    /*******************************************************************************************//**
+     * Computes the velocity for a window size given at runtime.
+     *
+     * @param x      positions of the section
+     * @param v      result: velocity values, only [size, N - size) are set
+     * @param N      number of samples
+     * @param size   half window size
+     * @param factor frequency / 6
+     **********************************************************************************************/
+    void genericKernel(const qreal* x, qreal* v, int N, int size, qreal factor);
+
+    /*******************************************************************************************//**
+     * Computes the velocity for the half window size S known at compile time.
+     *
+     * @param x      positions of the section
+     * @param v      result: velocity values, only [S, N - S) are set
+     * @param N      number of samples
+     * @param size   not used, same as S
+     * @param factor frequency / 6
+     **********************************************************************************************/
+    template<int S>
+    void windowKernel(const qreal* x, qreal* v, int N, int /*size*/, qreal factor)
+    {
+        for (int j = S; j < N - S; ++j)
+        {
+            qreal windowValue = 0;
+            for (int k = -S; k < 0; ++k)
+            {
+                windowValue -= x[j + k];
+            }
+            for (int k = 1; k <= S; ++k)
+            {
+                windowValue += x[j + k];
+            }
+            v[j] = factor * windowValue;
+        }
+    }
+
+    /*******************************************************************************************//**
+     * Returns the kernel for the given window size: a specialized kernel for 3, 5, 7, 9 and 11,
+     * the generic kernel otherwise.
+     *
+     * @param windowSize window size in samples
+     * @return kernel
+     **********************************************************************************************/
+    Kernel kernel(size_t windowSize);
+}
+
+#endif // VELOCITYKERNELS_H
@@ -3,6 +3,7 @@
 
 #include "colors.h"
 #include "enums.h"
+#include "saccadefiltersettings.h"
 #include "trial.h"
 #include <QMap>
 #include <QObject>
@@ -10,148 +11,6 @@
 
 class Trial;
 
-/**********************************************************************************************//**
- * struct SaccadeFilterSettings
- **************************************************************************************************/
-struct SaccadeFilterSettings
-{
-    SaccadeFilterSettings():
-        m_fromInputFile(true),
-        m_velocityThreshold(5),
-        m_minDuration(6),
-        m_binocular(true),
-        m_maxDuration(100),
-        m_maxAmplitude(1),
-        m_minAmplitude(0),
-        m_minIntersaccInterval(20),
-        m_minVelocity(0),
-        m_maxVelocity(300),
-        m_ignoreAtStart(20),
-        m_ignoreAtEnd(0),
-        m_velocityWindowSize(5),
-        m_ignoreBeforeMissingData(200),
-        m_ignoreAfterMissingData(200),
-        m_useMaxDuration(false),
-        m_useMinAmplitude(false),
-        m_useMaxAmplitude(true),
-        m_useMinIntersaccInterval(true),
-        m_useMinVelocity(false),
-        m_useMaxVelocity(false),
-        m_useIgnoreAtStart(true),
-        m_useIgnoreAtEnd(false),
-        m_useIgnoreBeforeMissingData(false),
-        m_useIgnoreAfterMissingData(false)
-    {}
-
-    SaccadeFilterSettings(const SaccadeFilterSettings &m):
-        m_fromInputFile(m.m_fromInputFile),
-        m_velocityThreshold(m.m_velocityThreshold),
-        m_minDuration(m.m_minDuration),
-        m_binocular(m.m_binocular),
-        m_maxDuration(m.m_maxDuration),
-        m_maxAmplitude(m.m_maxAmplitude),
-        m_minAmplitude(m.m_minAmplitude),
-        m_minIntersaccInterval(m.m_minIntersaccInterval),
-        m_minVelocity(m.m_minVelocity),
-        m_maxVelocity(m.m_maxVelocity),
-        m_ignoreAtStart(m.m_ignoreAtStart),
-        m_ignoreAtEnd(m.m_ignoreAtEnd),
-        m_velocityWindowSize(m.m_velocityWindowSize),
-        m_ignoreBeforeMissingData(m.m_ignoreBeforeMissingData),
-        m_ignoreAfterMissingData(m.m_ignoreAfterMissingData),
-        m_useMaxDuration(m.m_useMaxDuration),
-        m_useMinAmplitude(m.m_useMinAmplitude),
-        m_useMaxAmplitude(m.m_useMaxAmplitude),
-        m_useMinIntersaccInterval(m.m_useMinIntersaccInterval),
-        m_useMinVelocity(m.m_useMinVelocity),
-        m_useMaxVelocity(m.m_useMaxVelocity),
-        m_useIgnoreAtStart(m.m_useIgnoreAtStart),
-        m_useIgnoreAtEnd(m.m_useIgnoreAtEnd),
-        m_useIgnoreBeforeMissingData(m.m_useIgnoreBeforeMissingData),
-        m_useIgnoreAfterMissingData(m.m_useIgnoreAfterMissingData)
-    {}
-
-    SaccadeFilterSettings(
-            bool fromInputFile,
-            qreal velocityThreshold,
-            int minMicrosaccadeDuration,
-            bool binocular,
-            int maxMicrosaccadeDuration,
-            qreal maxMicrosaccadeAmplitude,
-            qreal minMicrosaccadeAmplitude,
-            int minMicrosaccadeIntersaccInterval,
-            int minMicrosaccadeVelocity,
-            int maxMicrosaccadeVelocity,
-            int ignoreAtFixationStart,
-            int ignoreAtFixationEnd,
-            int velocityWindowSize,
-            int ignoreBeforeMissingData,
-            int ignoreAfterMissingData,
-            bool useMaxDuration,
-            bool useMinAmplitude,
-            bool useMaxAmplitude,
-            bool useMinIntersaccInterval,
-            bool useMinVelocity,
-            bool useMaxVelocity,
-            bool useIgnoreAtFixationStart,
-            bool useIgnoreAtFixationEnd,
-            bool useIgnoreBeforeMissingData,
-            bool useIgnoreAfterMissingData):
-        m_fromInputFile(fromInputFile),
-        m_velocityThreshold(velocityThreshold),
-        m_minDuration(minMicrosaccadeDuration),
-        m_binocular(binocular),
-        m_maxDuration(maxMicrosaccadeDuration),
-        m_maxAmplitude(maxMicrosaccadeAmplitude),
-        m_minAmplitude(minMicrosaccadeAmplitude),
-        m_minIntersaccInterval(minMicrosaccadeIntersaccInterval),
-        m_minVelocity(minMicrosaccadeVelocity),
-        m_maxVelocity(maxMicrosaccadeVelocity),
-        m_ignoreAtStart(ignoreAtFixationStart),
-        m_ignoreAtEnd(ignoreAtFixationEnd),
-        m_velocityWindowSize(velocityWindowSize),
-        m_ignoreBeforeMissingData(ignoreBeforeMissingData),
-        m_ignoreAfterMissingData(ignoreAfterMissingData),
-        m_useMaxDuration(useMaxDuration),
-        m_useMinAmplitude(useMinAmplitude),
-        m_useMaxAmplitude(useMaxAmplitude),
-        m_useMinIntersaccInterval(useMinIntersaccInterval),
-        m_useMinVelocity(useMinVelocity),
-        m_useMaxVelocity(useMaxVelocity),
-        m_useIgnoreAtStart(useIgnoreAtFixationStart),
-        m_useIgnoreAtEnd(useIgnoreAtFixationEnd),
-        m_useIgnoreBeforeMissingData(useIgnoreBeforeMissingData),
-        m_useIgnoreAfterMissingData(useIgnoreAfterMissingData)
-    {}
-
-    bool m_fromInputFile;
-    qreal m_velocityThreshold;
-    int m_minDuration;
-    bool m_binocular;
-    int m_maxDuration;
-    qreal m_maxAmplitude;
-    qreal m_minAmplitude;
-    int m_minIntersaccInterval;
-    qreal m_minVelocity;
-    qreal m_maxVelocity;
-    int m_ignoreAtStart;
-    int m_ignoreAtEnd;
-    size_t m_velocityWindowSize;
-    int m_ignoreBeforeMissingData;
-    int m_ignoreAfterMissingData;
-
-    bool m_useMaxDuration;
-    bool m_useMinAmplitude;
-    bool m_useMaxAmplitude;
-    bool m_useMinIntersaccInterval;
-    bool m_useMinVelocity;
-    bool m_useMaxVelocity;
-    bool m_useIgnoreAtStart;
-    bool m_useIgnoreAtEnd;
-    bool m_useIgnoreBeforeMissingData;
-    bool m_useIgnoreAfterMissingData;
-};
-
 /**********************************************************************************************//**
  * struct Settings
  **************************************************************************************************/
@@ -218,7 +77,8 @@ struct Settings
         m_gazeType(GT_Average),
         m_startTimeInMSec(0),
         m_endTimeInMSec(0),
-        m_limitTimeRange(false)
+        m_limitTimeRange(false),
+        m_approximateQuantiles(false)
     {}
 
     // ** Filter Settings **
@@ -318,6 +178,9 @@ struct Settings
     qreal m_startTimeInMSec;
     qreal m_endTimeInMSec;
     bool m_limitTimeRange;
+
+    // If medians of the statistics are estimated with quantile sketches (QuantileSketch)
+    bool m_approximateQuantiles;
 };
 
 #endif // SETTINGS_H
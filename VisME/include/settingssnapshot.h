@@ -0,0 +1,56 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file settingssnapshot.h
+ **************************************************************************************************/
+#ifndef SETTINGSSNAPSHOT_H
+#define SETTINGSSNAPSHOT_H
+
+#include "enums.h"
+#include "saccadefiltersettings.h"
+#include "settings.h"
+#include <QColor>
+#include <QMap>
+#include <QString>
+
+/**********************************************************************************************//**
+ * struct SettingsSnapshot
+ *
+ * Immutable copy of the settings which are used for computations (detection, statistics). It is
+ * taken once on the thread which owns the global Settings and then only read, so that background
+ * or parallel computations are not affected by changes in the user interface.
+ **************************************************************************************************/
+struct SettingsSnapshot
+{
+    explicit SettingsSnapshot(const Settings& settings):
+        m_gazeType(settings.m_gazeType),
+        m_microsaccadeSettings(*settings.m_microsaccadeSettings),
+        m_fixationSettings(*settings.m_fixationSettings),
+        m_limitTimeRange(settings.m_limitTimeRange),
+        m_startTimeInMSec(settings.m_startTimeInMSec),
+        m_endTimeInMSec(settings.m_endTimeInMSec),
+        m_approximateQuantiles(settings.m_approximateQuantiles),
+        m_testConditions(settings.m_testConditions)
+    {}
+
+    // Gaze type: left, right or average.
+    const GazeType m_gazeType;
+
+    // ** Saccade Detection Settings **
+    const SaccadeFilterSettings m_microsaccadeSettings;
+
+    // ** Fixation Detection Settings **
+    const SaccadeFilterSettings m_fixationSettings;
+
+    // Values to limit analysis to a time range
+    const bool m_limitTimeRange;
+    const qreal m_startTimeInMSec;
+    const qreal m_endTimeInMSec;
+
+    // If medians of the statistics are estimated with quantile sketches
+    const bool m_approximateQuantiles;
+
+    // Available test conditions (colors are only used for the visualizations)
+    const QMap<QString, QColor> m_testConditions;
+};
+
+#endif // SETTINGSSNAPSHOT_H
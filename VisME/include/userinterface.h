@@ -25,10 +25,12 @@
 #include <QSpinBox>
 #include <QTableWidget>
 
+class EventLockedRateExport;
 class EyeDataExport;
 class EyeHistogram;
 class EyeScatterplot;
 class MainWindow;
+class ParameterSweepExport;
 class SettingsExport;
 class StatisticsExport;
 
@@ -183,6 +185,14 @@ private:
       **********************************************************************************************/
      void updateFixationsSettings(Trial& trial);
 
+     /*******************************************************************************************//**
+      * Disables the actions which read all trials while a detection job is running and enables
+      * them again afterwards.
+      *
+      * @param running if a detection job is running
+      **********************************************************************************************/
+     void setDetectionRunning(bool running);
+
     /*******************************************************************************************//**
      * Returns a QHBoxLayout containing two buttons: "Check All" and "Uncheck All".
      *
@@ -244,10 +254,22 @@ private slots:
 
 private:
 
+    /*******************************************************************************************//**
+     * Cancels the running detection job for every change of the settings in the given widget.
+     *
+     * @param widget widget containing the detection settings
+     **********************************************************************************************/
+    void cancelDetectionOnChange(QWidget* widget);
+
+    /// Actions which read all trials, disabled while a detection job is running.
+    QList<QAction*> m_trialDataActions;
+
     /// Data exporter.
     EyeDataExport* m_dataExport;
     SettingsExport* m_settingsExport;
     StatisticsExport* m_statisticsExport;
+    ParameterSweepExport* m_parameterSweepExport;
+    EventLockedRateExport* m_eventLockedRateExport;
 
     /// Main window.
     MainWindow* m_window;
@@ -387,6 +409,12 @@ private:
     QLabel* m_microsaccadeVelocityLabelMean;
     QLabel* m_microsaccadeVelocityLabelMedian;
 
+    /// Header of the medians, shows if they are approximated.
+    QLabel* m_statisticsMedianHeaderLabel;
+
+    /// If medians are estimated with quantile sketches.
+    QCheckBox* m_approximateMediansCheckBox;
+
     QLabel* m_numberOfTrialsLabel;
 
     /// Microsaccade labels.
@@ -536,6 +564,11 @@ private:
     /// Parameters for microsaccade detection algorithm.
     QCheckBox* m_microsaccadesFromInputFileCheckbox;
     QDoubleSpinBox* m_msVelocityThresholdSpinBox;
+    QComboBox* m_msDetectionAlgorithmComboBox;
+    QComboBox* m_msPreFilterComboBox;
+    QSpinBox* m_msPreFilterWindowSizeSpinBox;
+    QComboBox* m_msGapInterpolationComboBox;
+    QSpinBox* m_msMaxGapDurationSpinBox;
     QSpinBox* m_msMinDurationSpinBox;
     QCheckBox* m_msBinocularCheckBox;
     QSpinBox* m_msVelocityWindowSizeSpinBox;
@@ -564,6 +597,11 @@ private:
     /// Parameters for saccade/fixation detection.
     QCheckBox* m_fixationsFromInputFileCheckbox;
     QDoubleSpinBox* m_fixVelocityThresholdSpinBox;
+    QComboBox* m_fixDetectionAlgorithmComboBox;
+    QComboBox* m_fixPreFilterComboBox;
+    QSpinBox* m_fixPreFilterWindowSizeSpinBox;
+    QComboBox* m_fixGapInterpolationComboBox;
+    QSpinBox* m_fixMaxGapDurationSpinBox;
     QSpinBox* m_fixMinSaccadeDurationSpinBox;
     QCheckBox* m_fixBinocularCheckBox;
     QSpinBox* m_fixMaxDurationSpinBox;
@@ -0,0 +1,466 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file aggregatedstatistics.cpp
+ **************************************************************************************************/
+#include "aggregatedstatistics.h"
+#include "directioncalculations.h"
+#include "mathhelpfunctions.h"
+#include "quantilesketch.h"
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMapIterator>
+#include <QPair>
+#include <QTextStream>
+#include <QThread>
+#include <QtConcurrent>
+#include <algorithm>
+#include <numeric>
+
+
+// participants per thread computed in parallel before they are written
+static const size_t participantsPerThread = 4;
+
+
+AggregatedStatistics::AggregatedStatistics(EyeTrackingData* eyeTrackingData, Settings* settings,
+                                           bool directionalData) :
+    m_eyeTrackingData(eyeTrackingData),
+    m_settings(settings == nullptr ? nullptr : new SettingsSnapshot(*settings)),
+    m_directionalData(directionalData)
+{
+    if (!m_directionalData)
+    {
+        m_dataTypes = QStringList({"#Raw Data Samples in Trials",
+                                   "Duration of Trials [s]",
+                                   "#Fixations in Trials",
+                                   "#Fixations with Microsaccades in Trials",
+                                   "Fixations containing Microsaccades [%]",
+                                   "Fixation Duration [s]",
+                                   "Fixation (with Microsaccades) Duration [s]",
+                                   "#Microsaccades in Trials",
+                                   "#Microsaccades per Fixation",
+                                   "#Microsaccades per Fixation with Microsaccades",
+                                   "#Microsaccades per Second (for Trials)",
+                                   "#Microsaccades per Second in Fixations (for Trials)",
+                                   "Microsaccade Amplitude [°]",
+                                   "Inter-saccadic Interval [ms]",
+                                   "Microsaccade Duration [ms]",
+                                   "Microsaccade Peak Velocity [°/s]"});
+
+        m_sumNotAvailable = {4, 10, 11, 12, 13, 14, 15};
+
+        m_valueTypes = QStringList({"min", "max", "mean", "median", "sum", "single values"});
+    }
+    else
+    {
+        m_dataTypes = QStringList({"Direction from Screen Coordinate System",
+                                   "Direction towards Next Fixation",
+                                   "Direction towards Previous Fixation"});
+
+        m_sumNotAvailable = {0, 1, 2};
+
+        m_valueTypes = QStringList({"mean", "single values"});
+    }
+}
+
+
+AggregatedStatistics::~AggregatedStatistics()
+{
+    delete m_settings;
+}
+
+
+QStringList AggregatedStatistics::dataTypes() const
+{
+    return m_dataTypes;
+}
+
+
+QStringList AggregatedStatistics::valueTypes() const
+{
+    return m_valueTypes;
+}
+
+
+int AggregatedStatistics::defaultValueType() const
+{
+    return m_directionalData ? 0 : 2;
+}
+
+
+bool AggregatedStatistics::isAvailable(int dataType, int valueType) const
+{
+    // skip sum for certain elements
+    return !(valueType == 4 && std::find(m_sumNotAvailable.begin(), m_sumNotAvailable.end(),
+                                         size_t(dataType)) != m_sumNotAvailable.end());
+}
+
+
+bool AggregatedStatistics::exportToDirectory(const QString& dirName,
+                                             const std::vector<int>& dataTypes, int valueType,
+                                             const CancellationToken& cancellation,
+                                             const std::function<void(size_t, size_t)>& progress,
+                                             QStringList* failedFiles)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // all files are written at the same time, one row for each participant
+    std::vector<int> exportedTypes;
+    std::vector<QFile*> files;
+    std::vector<QTextStream*> streams;
+    QStringList notWritten;
+    for (size_t i = 0; i < dataTypes.size(); ++i)
+    {
+        int dataType = dataTypes[i];
+        if (!isAvailable(dataType, valueType))
+        {
+            continue;
+        }
+
+        QFile* file = new QFile(getFileName(dataType, dirName));
+        if (!file->open(QIODevice::WriteOnly))
+        {
+            qWarning() << QString("File %1 can not be written: %2").arg(file->fileName(),
+                                                                        file->errorString());
+            notWritten.append(file->fileName());
+            delete file;
+            continue;
+        }
+
+        exportedTypes.push_back(dataType);
+        files.push_back(file);
+        streams.push_back(new QTextStream(file));
+    }
+
+    // blocks of participants are computed in parallel and written in participant order, so that
+    // the rows of a block are written while memory stays small for many participants
+    size_t participantCount = m_eyeTrackingData->numberOfParticipants();
+    size_t blockSize = size_t(std::max(1, QThread::idealThreadCount())) * participantsPerThread;
+    bool canceled = false;
+    for (size_t start = 0; start < participantCount && !exportedTypes.empty(); start += blockSize)
+    {
+        if (cancellation.isCanceled())
+        {
+            canceled = true;
+            break;
+        }
+
+        size_t end = std::min(start + blockSize, participantCount);
+        std::vector<QPair<Participant*, QStringList> > block;
+        for (size_t j = start; j < end; ++j)
+        {
+            block.push_back(QPair<Participant*, QStringList>(
+                                m_eyeTrackingData->participantAt(int(j)), QStringList()));
+        }
+
+        QtConcurrent::blockingMap(block, [this, &exportedTypes, valueType](
+                                  QPair<Participant*, QStringList>& rows)
+        {
+            rows.second = participantRows(rows.first, exportedTypes, valueType);
+        });
+
+        for (size_t j = 0; j < block.size(); ++j)
+        {
+            for (size_t k = 0; k < streams.size(); ++k)
+            {
+                *streams[k] << block[j].second[int(k)] << endl;
+            }
+        }
+
+        if (progress)
+        {
+            progress(end, participantCount);
+        }
+    }
+
+    for (size_t k = 0; k < files.size(); ++k)
+    {
+        delete streams[k];
+        files[k]->close();
+
+        // partly written files are not kept
+        if (canceled)
+        {
+            files[k]->remove();
+        }
+        delete files[k];
+    }
+
+    qint64 elapsed = std::max(qint64(1), timer.elapsed());
+    qDebug() << QString("Statistics export: %1 participants, %2 files: %3 ms (%4 participants/s)%5")
+                .arg(QString::number(participantCount), QString::number(files.size()),
+                     QString::number(elapsed),
+                     QString::number(participantCount * 1000.0 / elapsed, 'f', 1),
+                     canceled ? " canceled" : "");
+
+    if (failedFiles != nullptr)
+    {
+        *failedFiles = notWritten;
+    }
+
+    return !canceled && notWritten.isEmpty();
+}
+
+
+QStringList AggregatedStatistics::participantRows(Participant* p,
+                                                  const std::vector<int>& dataTypes,
+                                                  int valueType)
+{
+    // all metrics of the participant in one pass, one group for each test condition; all values
+    // of the gaze type of the snapshot without time range
+    StatisticsTable table(*m_settings, false);
+    QMap<QString, int> groups;
+    if (!m_directionalData)
+    {
+        for (size_t i = 0; i < p->numberOfTrials(); ++i)
+        {
+            Trial* trial = p->getTrialAt(int(i));
+            if (!groups.contains(trial->getTestConditionType()))
+            {
+                groups.insert(trial->getTestConditionType(), table.addGroup());
+            }
+            table.addTrial(trial, groups.value(trial->getTestConditionType()));
+        }
+    }
+
+    //export for each participants and each test condition...; if no test condition: for each part...
+    QStringList rows;
+    for (size_t i = 0; i < dataTypes.size(); ++i)
+    {
+        int dataType = dataTypes[i];
+        QString row;
+
+        QMapIterator<QString, QColor> it(m_settings->m_testConditions);
+        while (it.hasNext())
+        {
+            it.next();
+            QString testCondition = it.key();
+            int dataCount;
+            std::vector<qreal> dataSamples = getDataSamples(p, table, groups, testCondition,
+                                                            dataType, dataCount);
+            row += getValue(dataSamples, valueType, dataCount);
+            if (it.hasNext())
+            {
+                row += ",";
+            }
+        }
+
+        if (m_settings->m_testConditions.empty())
+        {
+            QString testCondition = "";
+            int dataCount;
+            std::vector<qreal> dataSamples = getDataSamples(p, table, groups, testCondition,
+                                                            dataType, dataCount);
+            row += getValue(dataSamples, valueType, dataCount);
+        }
+
+        rows.append(row);
+    }
+
+    return rows;
+}
+
+
+QString AggregatedStatistics::subDirPath(const QString path)
+{
+    QString dirName = "VisME_Statistics";
+
+    QString subPath = QDir::cleanPath(path + QDir::separator() + dirName);
+    int count = 1;
+    while (QDir(subPath).exists())
+    {
+        subPath = QDir::cleanPath(path + QDir::separator() + dirName + "_" + QString::number(count));
+        count++;
+    }
+    return subPath;
+}
+
+
+QString AggregatedStatistics::getFileName(int dataType, const QString dir)
+{
+    QStringList fileNames;
+
+    if (!m_directionalData)
+    {
+        fileNames = QStringList({
+            "NumberRawDataSamplesInTrials.csv",
+            "DurationOfTrials.csv",
+            "NumberFixationsInTrials.csv",
+            "NumberFixationsWithMicrosaccadesInTrial.csv",
+            "PercentageFixationsContainingMicrosaccades.csv",
+            "FixationDuration.csv",
+            "FixationWithMicrosaccadesDuration.csv",
+            "NumberMicrosaccadeInTrials.csv",
+            "NumberMicrosaccadesPerFixation.csv",
+            "NumberMicrosaccadesPerFixationWithMicrosaccades.csv",
+            "NumberMicrosaccadesPerSecond.csv",
+            "NumberMicrosaccadesPerSecondinFixations.csv",
+            "MicrosaccadeAmplitude.csv",
+            "IntersaccadicInterval.csv",
+            "MicrosaccadeDuration.csv",
+            "MicrosaccadePeakVelocity.csv"
+        });
+    }
+    else
+    {
+        fileNames = QStringList({
+            "DirectionFromView.csv",
+            "DirectionTowardsNextFixation.csv",
+            "DirectionTowardsPreviousFixation.csv"
+        });
+    }
+
+    return QDir::cleanPath(dir + QDir::separator() + fileNames[dataType]);
+}
+
+
+std::vector<qreal> AggregatedStatistics::getDataSamples(Participant* p,
+                                                        const StatisticsTable& table,
+                                                        const QMap<QString, int>& groups,
+                                                        const QString testCondition, int dataType,
+                                                        int& dataCount)
+{
+    std::vector<qreal> values;
+    dataCount = -1;
+
+    if (!m_directionalData)
+    {
+        if (groups.contains(testCondition))
+        {
+            values = table.values(groups.value(testCondition), StatisticsMetric(dataType));
+
+            // values of trials are averaged over all trials of the participant
+            bool trialValues = dataType <= SM_FixationWithMSCount || dataType == SM_MSCount ||
+                    dataType == SM_MSPerSecond;
+            dataCount = trialValues ? int(p->numberOfTrials()) : int(values.size());
+        }
+
+        return values;
+    }
+
+    // all values of the gaze type of the snapshot, independent of later changes in the interface
+    GazeType gazeType = m_settings->m_gazeType;
+
+    for (size_t i = 0; i < p->numberOfTrials(); ++i)
+    {
+        Trial* trial = p->getTrialAt(int(i));
+        if (trial->getTestConditionType() == testCondition)
+        {
+            PlotDirection direction = PDir_FromView;
+            switch(dataType)
+            {
+                case 0: // DirectionFromView",
+                {
+                    direction = PDir_FromView;
+                    break;
+                }
+                case 1: // "DirectionTowardsNextFixation",
+                {
+                    direction = PDir_ToNextFixation;
+                    break;
+                }
+                case 2: // "DirectionTowardsPreviousFixation",
+                {
+                    direction = PDir_ToPreviousFixation;
+                    break;
+                }
+            }
+
+            std::vector<qreal> anglesForTrial;
+            auto dirCalc = new DirectionCalculations();
+            dirCalc->getAngularDataForTrial(trial, direction,
+                                            PD_Microsaccades, anglesForTrial,
+                                            trial->fixationPointers(gazeType), gazeType);
+
+            if (!anglesForTrial.empty())
+            {
+                values.insert(values.end(), anglesForTrial.begin(), anglesForTrial.end());
+            }
+        }
+    }
+
+    return values;
+}
+
+
+QString AggregatedStatistics::getValue(std::vector<qreal> dataSamples, int valueType, int dataCount)
+{
+    QString value = "";
+
+    if (!m_directionalData)
+    {
+        qreal sum = std::accumulate(dataSamples.begin(), dataSamples.end(), 0.0);
+        qreal elementCount;
+
+        if (dataCount != -1)
+        {
+            elementCount = dataSamples.size();
+        }
+        else
+        {
+            elementCount = dataCount;//currentTrials.size();
+        }
+
+
+        if (valueType == 0) // min
+        {
+            value = QString::number(*std::min_element(dataSamples.begin(), dataSamples.end()));
+        }
+        else if (valueType == 1) // max
+        {
+            value = QString::number(*std::max_element(dataSamples.begin(), dataSamples.end()));
+        }
+        else if (valueType == 2) // mean
+        {
+            if (elementCount > 0)
+            {
+                value = QString::number(sum / elementCount);
+            }
+        }
+        else if (valueType == 3) // median
+        {
+            value = QString::number(QuantileSketch::exactQuantile(dataSamples, 0.5));
+        }
+        else if (valueType == 4) // sum
+        {
+            value = QString::number(sum);
+        }
+        else if (valueType == 5) // single values
+        {
+            value = "[";
+            for (size_t i = 0; i < dataSamples.size(); ++i)
+            {
+                value += QString::number(dataSamples[i]);
+                if (i != dataSamples.size() - 1)
+                {
+                    value += ",";
+                }
+            }
+            value += "]";
+        }
+    }
+    else
+    {
+        if (valueType == 0) // mean
+        {
+            value = QString::number(MathHelpFunctions::angularMean(dataSamples));
+        }
+        else if (valueType == 1) // single values
+        {
+            value = "[";
+            for (size_t i = 0; i < dataSamples.size(); ++i)
+            {
+                value += QString::number(dataSamples[i]);
+                if (i != dataSamples.size() - 1)
+                {
+                    value += ",";
+                }
+            }
+            value += "]";
+        }
+    }
+
+    return value;
+}
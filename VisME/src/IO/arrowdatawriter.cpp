@@ -0,0 +1,183 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file arrowdatawriter.cpp
+ **************************************************************************************************/
+#include "arrowdatawriter.h"
+#include "fileextensions.h"
+#include <QDir>
+#include <vector>
+
+
+// returns the path of the file of the given table in the directory
+static QString tableFileName(const QString& dir, const QString& table)
+{
+    return QDir::cleanPath(dir + QDir::separator() + table + "." + ArrowDataFile);
+}
+
+
+ArrowDataWriter::ArrowDataWriter(bool writeSamples) :
+    m_writeSamples(writeSamples)
+{
+    addKeyColumns(m_fixations);
+    m_fixations.addColumn("fixation", ArrowTable::CT_Int32);
+    m_fixations.addColumn("start", ArrowTable::CT_Int32);
+    m_fixations.addColumn("duration", ArrowTable::CT_Int32);
+    m_fixations.addColumn("duration_ms", ArrowTable::CT_Float64);
+    m_fixations.addColumn("x", ArrowTable::CT_Float64);
+    m_fixations.addColumn("y", ArrowTable::CT_Float64);
+    m_fixations.addColumn("microsaccades", ArrowTable::CT_Int32);
+
+    addKeyColumns(m_microsaccades);
+    m_microsaccades.addColumn("fixation", ArrowTable::CT_Int32);
+    addSaccadeColumns(m_microsaccades);
+
+    addKeyColumns(m_saccades);
+    addSaccadeColumns(m_saccades);
+
+    addKeyColumns(m_samples);
+    m_samples.addColumn("index", ArrowTable::CT_Int32);
+    m_samples.addColumn("x", ArrowTable::CT_Float64);
+    m_samples.addColumn("y", ArrowTable::CT_Float64);
+}
+
+
+bool ArrowDataWriter::open(const QString& dir)
+{
+    bool opened = m_fixations.open(tableFileName(dir, "fixations")) &&
+                  m_microsaccades.open(tableFileName(dir, "microsaccades")) &&
+                  m_saccades.open(tableFileName(dir, "saccades"));
+    if (m_writeSamples)
+    {
+        opened = opened && m_samples.open(tableFileName(dir, "samples"));
+    }
+    return opened;
+}
+
+
+void ArrowDataWriter::writeTrial(Trial& trial)
+{
+    std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
+    std::vector<QString> gazeNames = {"right", "left", "average"};
+    bool fromInput = trial.msFromInputFile();
+
+    for (size_t j = 0; j < gazeTypes.size(); ++j)
+    {
+        for (int i = 0; i < trial.fixationsCount(gazeTypes[j]); ++i)
+        {
+            Fixation* f = trial.getFixationAt(i, gazeTypes[j]);
+
+            int c = appendKeys(m_fixations, trial, gazeNames[j]);
+            m_fixations.appendInt(c++, i);
+            m_fixations.appendInt(c++, f->getStartIndex());
+            m_fixations.appendInt(c++, f->getDuration());
+            m_fixations.appendReal(c++, trial.samplesToTime(f->getDuration()));
+            m_fixations.appendReal(c++, f->getXPosition());
+            m_fixations.appendReal(c++, f->getYPosition());
+            m_fixations.appendInt(c++, int(f->getMicrosaccadesCount(fromInput)));
+
+            for (size_t k = 0; k < f->getMicrosaccadesCount(fromInput); ++k)
+            {
+                Saccade* m = f->getMicrosaccadeAt(k, fromInput);
+
+                c = appendKeys(m_microsaccades, trial, gazeNames[j]);
+                m_microsaccades.appendInt(c++, i);
+                appendSaccade(m_microsaccades, c, trial, *m);
+            }
+        }
+
+        for (size_t i = 0; i < trial.saccadesCount(gazeTypes[j]); ++i)
+        {
+            Saccade* s = trial.getSaccadeAt(i, gazeTypes[j]);
+
+            int c = appendKeys(m_saccades, trial, gazeNames[j]);
+            appendSaccade(m_saccades, c, trial, *s);
+        }
+
+        if (m_writeSamples)
+        {
+            const QMap<int, GazeData> g = trial.gazeData(gazeTypes[j]);
+            for (QMap<int, GazeData>::const_iterator it = g.constBegin(); it != g.constEnd(); ++it)
+            {
+                int c = appendKeys(m_samples, trial, gazeNames[j]);
+                m_samples.appendInt(c++, it.key());
+                m_samples.appendReal(c++, it.value().getXPosition());
+                m_samples.appendReal(c++, it.value().getYPosition());
+            }
+        }
+    }
+
+    // one record batch per trial
+    m_fixations.writeBatch();
+    m_microsaccades.writeBatch();
+    m_saccades.writeBatch();
+    m_samples.writeBatch();
+}
+
+
+void ArrowDataWriter::writeParticipant(Participant& participant)
+{
+    for (size_t i = 0; i < participant.numberOfTrials(); ++i)
+    {
+        writeTrial(*participant.getTrialAt(int(i)));
+    }
+}
+
+
+bool ArrowDataWriter::close()
+{
+    bool closed = m_fixations.close();
+    closed = m_microsaccades.close() && closed;
+    closed = m_saccades.close() && closed;
+    if (m_writeSamples)
+    {
+        closed = m_samples.close() && closed;
+    }
+    return closed;
+}
+
+
+void ArrowDataWriter::addKeyColumns(ArrowTable& table)
+{
+    table.addColumn("participant", ArrowTable::CT_String);
+    table.addColumn("trial", ArrowTable::CT_String);
+    table.addColumn("test_condition", ArrowTable::CT_String);
+    table.addColumn("gaze_type", ArrowTable::CT_String);
+}
+
+
+void ArrowDataWriter::addSaccadeColumns(ArrowTable& table)
+{
+    table.addColumn("onset", ArrowTable::CT_Int32);
+    table.addColumn("duration", ArrowTable::CT_Int32);
+    table.addColumn("duration_ms", ArrowTable::CT_Float64);
+    table.addColumn("peak_velocity", ArrowTable::CT_Float64);
+    table.addColumn("amplitude", ArrowTable::CT_Float64);
+    table.addColumn("horizontal_amplitude", ArrowTable::CT_Float64);
+    table.addColumn("vertical_amplitude", ArrowTable::CT_Float64);
+    table.addColumn("horizontal_component", ArrowTable::CT_Float64);
+    table.addColumn("vertical_component", ArrowTable::CT_Float64);
+}
+
+
+int ArrowDataWriter::appendKeys(ArrowTable& table, Trial& trial, const QString& gazeType)
+{
+    table.appendString(0, trial.getParticipant()->name());
+    table.appendString(1, trial.name());
+    table.appendString(2, trial.getTestConditionType());
+    table.appendString(3, gazeType);
+    return 4;
+}
+
+
+void ArrowDataWriter::appendSaccade(ArrowTable& table, int column, Trial& trial, Saccade& saccade)
+{
+    table.appendInt(column++, int(saccade.getOnsetIndex()));
+    table.appendInt(column++, int(saccade.getDuration()));
+    table.appendReal(column++, trial.samplesToTime(int(saccade.getDuration())));
+    table.appendReal(column++, saccade.getPeakVelocity());
+    table.appendReal(column++, saccade.getAmplitude());
+    table.appendReal(column++, saccade.getHorizontalAmplitude());
+    table.appendReal(column++, saccade.getVerticalAmplitude());
+    table.appendReal(column++, saccade.getHorizontalComponent());
+    table.appendReal(column, saccade.getVerticalComponent());
+}
@@ -0,0 +1,488 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file arrowtable.cpp
+ **************************************************************************************************/
+#include "arrowtable.h"
+#include <algorithm>
+#include <cstring>
+
+// Arrow format constants (Schema.fbs, Message.fbs, File.fbs)
+static const int metadataVersionV5 = 4;
+static const int typeInt = 2;
+static const int typeFloatingPoint = 3;
+static const int typeUtf8 = 5;
+static const int precisionDouble = 2;
+static const int headerSchema = 1;
+static const int headerRecordBatch = 3;
+static const char magic[] = "ARROW1";
+
+
+// appends the little endian bytes of a value to data
+static void appendBytes(std::string& data, quint64 bits, int size)
+{
+    for (int i = 0; i < size; ++i)
+    {
+        data.push_back(char(quint8(bits >> (8 * i))));
+    }
+}
+
+
+// appends the little endian bytes of integer values to data
+static void appendInts(std::string& data, const std::vector<qint32>& values)
+{
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        appendBytes(data, quint32(values[i]), 4);
+    }
+}
+
+
+// returns the bits of a double value
+static quint64 doubleBits(double value)
+{
+    quint64 bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+
+// appends zeros to data until its size is a multiple of 8
+static void pad(std::string& data)
+{
+    data.append((8 - data.size() % 8) % 8, '\0');
+}
+
+
+/***********************************************************************************************//**
+ * Minimal flatbuffers builder for the Arrow metadata. Like the flatbuffers library, the buffer is
+ * built from the back: child objects (strings, vectors, tables) are created before the tables
+ * which refer to them, and objects are identified by their distance to the end of the buffer.
+ * The bytes are stored in reverse order until finish is called.
+ **************************************************************************************************/
+class FlatBufferBuilder
+{
+
+public:
+
+    FlatBufferBuilder() :
+        m_minAlign(1),
+        m_tableStart(0)
+    {}
+
+    // Creates a string and returns its offset.
+    quint32 createString(const std::string& value)
+    {
+        align(4, quint32(value.size()) + 1);
+        m_bytes.push_back('\0');
+        m_bytes.append(value.rbegin(), value.rend());
+        prepend(value.size(), 4);
+        return size();
+    }
+
+    // Creates a vector of objects (tables, strings) and returns its offset.
+    quint32 createOffsetVector(const std::vector<quint32>& offsets)
+    {
+        align(4, quint32(offsets.size()) * 4);
+        for (size_t i = offsets.size(); i > 0; --i)
+        {
+            prepend(size() + 4 - offsets[i - 1], 4);
+        }
+        prepend(offsets.size(), 4);
+        return size();
+    }
+
+    // Creates a vector of structs from their little endian bytes and returns its offset.
+    quint32 createStructVector(const std::string& structs, size_t count)
+    {
+        align(4, quint32(structs.size()));
+        align(8, quint32(structs.size()));
+        m_bytes.append(structs.rbegin(), structs.rend());
+        prepend(count, 4);
+        return size();
+    }
+
+    // Starts a new table, child objects must be created before.
+    void startTable()
+    {
+        m_fields.clear();
+        m_tableStart = size();
+    }
+
+    // Adds a scalar field with the given size in bytes to the current table.
+    void addScalar(int field, quint64 bits, int size)
+    {
+        align(size, 0);
+        prepend(bits, size);
+        m_fields.push_back(std::make_pair(field, this->size()));
+    }
+
+    // Adds a field which refers to an object to the current table.
+    void addOffset(int field, quint32 offset)
+    {
+        align(4, 0);
+        prepend(size() + 4 - offset, 4);
+        m_fields.push_back(std::make_pair(field, size()));
+    }
+
+    // Ends the current table, writes its vtable and returns its offset.
+    quint32 endTable()
+    {
+        align(4, 0);
+        prepend(0, 4);
+        quint32 table = size();
+
+        int fieldCount = 0;
+        for (size_t i = 0; i < m_fields.size(); ++i)
+        {
+            fieldCount = std::max(fieldCount, m_fields[i].first + 1);
+        }
+        std::vector<quint16> fieldOffsets(size_t(fieldCount), 0);
+        for (size_t i = 0; i < m_fields.size(); ++i)
+        {
+            fieldOffsets[size_t(m_fields[i].first)] = quint16(table - m_fields[i].second);
+        }
+
+        for (size_t i = fieldOffsets.size(); i > 0; --i)
+        {
+            prepend(fieldOffsets[i - 1], 2);
+        }
+        prepend(table - m_tableStart, 2);
+        prepend(4 + 2 * fieldOffsets.size(), 2);
+
+        // signed offset from the table to its vtable, written at the start of the table
+        quint32 vtableOffset = size() - table;
+        for (int i = 0; i < 4; ++i)
+        {
+            m_bytes[table - 1 - i] = char(quint8(vtableOffset >> (8 * i)));
+        }
+        return table;
+    }
+
+    // Writes the offset of the root table and returns the buffer.
+    std::string finish(quint32 root)
+    {
+        align(m_minAlign, 4);
+        prepend(size() + 4 - root, 4);
+        return std::string(m_bytes.rbegin(), m_bytes.rend());
+    }
+
+private:
+
+    // Returns the number of bytes written.
+    quint32 size() const
+    {
+        return quint32(m_bytes.size());
+    }
+
+    // Writes the little endian bytes of a value in front of the buffer.
+    void prepend(quint64 bits, int size)
+    {
+        for (int i = size - 1; i >= 0; --i)
+        {
+            m_bytes.push_back(char(quint8(bits >> (8 * i))));
+        }
+    }
+
+    // Writes zeros so that the buffer is aligned after additional bytes are written.
+    void align(int alignment, quint32 additional)
+    {
+        m_minAlign = std::max(m_minAlign, alignment);
+        while ((size() + additional) % quint32(alignment) != 0)
+        {
+            m_bytes.push_back('\0');
+        }
+    }
+
+    // Bytes in reverse order.
+    std::string m_bytes;
+
+    // Largest alignment of all written values.
+    int m_minAlign;
+
+    // Size of the buffer when the current table was started.
+    quint32 m_tableStart;
+
+    // Fields of the current table and their offsets.
+    std::vector<std::pair<int, quint32> > m_fields;
+};
+
+
+// creates a message table and returns the finished flatbuffer
+static std::string createMessage(FlatBufferBuilder& builder, int headerType, quint32 header,
+                                 qint64 bodyLength)
+{
+    builder.startTable();
+    builder.addScalar(0, metadataVersionV5, 2);
+    builder.addScalar(1, quint64(headerType), 1);
+    builder.addOffset(2, header);
+    builder.addScalar(3, quint64(bodyLength), 8);
+    return builder.finish(builder.endTable());
+}
+
+
+ArrowTable::ArrowTable() :
+    m_position(0)
+{}
+
+
+ArrowTable::~ArrowTable()
+{
+    if (m_out.is_open())
+    {
+        close();
+    }
+}
+
+
+int ArrowTable::addColumn(const QString& name, ColumnType type)
+{
+    Column column;
+    column.m_name = name.toStdString();
+    column.m_type = type;
+    column.m_offsets.push_back(0);
+    m_columns.push_back(column);
+    return int(m_columns.size()) - 1;
+}
+
+
+bool ArrowTable::open(const QString& fileName)
+{
+    m_out.open(fileName.toStdString(), std::ios::out | std::ios::binary);
+    if (!m_out.is_open())
+    {
+        return false;
+    }
+
+    std::string start(magic);
+    pad(start);
+    m_out.write(start.data(), std::streamsize(start.size()));
+    m_position = qint64(start.size());
+
+    FlatBufferBuilder builder;
+    quint32 schema = createSchema(builder);
+    writeMessage(createMessage(builder, headerSchema, schema, 0), std::string());
+    return m_out.good();
+}
+
+
+void ArrowTable::appendInt(int column, int value)
+{
+    m_columns[size_t(column)].m_ints.push_back(value);
+}
+
+
+void ArrowTable::appendReal(int column, qreal value)
+{
+    m_columns[size_t(column)].m_reals.push_back(value);
+}
+
+
+void ArrowTable::appendString(int column, const QString& value)
+{
+    Column& c = m_columns[size_t(column)];
+    c.m_chars += value.toStdString();
+    c.m_offsets.push_back(qint32(c.m_chars.size()));
+}
+
+
+size_t ArrowTable::rowCount() const
+{
+    if (m_columns.empty())
+    {
+        return 0;
+    }
+
+    const Column& c = m_columns[0];
+    switch (c.m_type)
+    {
+        case CT_Int32:
+            return c.m_ints.size();
+        case CT_Float64:
+            return c.m_reals.size();
+        case CT_String:
+            return c.m_offsets.size() - 1;
+    }
+    return 0;
+}
+
+
+void ArrowTable::writeBatch()
+{
+    size_t rows = rowCount();
+    if (rows == 0 || !m_out.is_open())
+    {
+        return;
+    }
+
+    // body: validity (empty, no null values) and value buffers of all columns
+    std::string body;
+    std::string nodes;
+    std::string buffers;
+    for (size_t i = 0; i < m_columns.size(); ++i)
+    {
+        Column& c = m_columns[i];
+        appendBytes(nodes, rows, 8);
+        appendBytes(nodes, 0, 8);  // null count
+
+        appendBytes(buffers, body.size(), 8);
+        appendBytes(buffers, 0, 8);
+
+        if (c.m_type == CT_String)
+        {
+            appendBytes(buffers, body.size(), 8);
+            appendBytes(buffers, c.m_offsets.size() * sizeof(qint32), 8);
+            appendInts(body, c.m_offsets);
+            pad(body);
+
+            appendBytes(buffers, body.size(), 8);
+            appendBytes(buffers, c.m_chars.size(), 8);
+            body += c.m_chars;
+        }
+        else if (c.m_type == CT_Int32)
+        {
+            appendBytes(buffers, body.size(), 8);
+            appendBytes(buffers, c.m_ints.size() * sizeof(qint32), 8);
+            appendInts(body, c.m_ints);
+        }
+        else
+        {
+            appendBytes(buffers, body.size(), 8);
+            appendBytes(buffers, c.m_reals.size() * sizeof(double), 8);
+            for (size_t j = 0; j < c.m_reals.size(); ++j)
+            {
+                appendBytes(body, doubleBits(c.m_reals[j]), 8);
+            }
+        }
+        pad(body);
+
+        c.m_ints.clear();
+        c.m_reals.clear();
+        c.m_offsets.resize(1);
+        c.m_chars.clear();
+    }
+
+    FlatBufferBuilder builder;
+    quint32 nodeVector = builder.createStructVector(nodes, m_columns.size());
+    quint32 bufferVector = builder.createStructVector(buffers, buffers.size() / 16);
+    builder.startTable();
+    builder.addScalar(0, rows, 8);
+    builder.addOffset(1, nodeVector);
+    builder.addOffset(2, bufferVector);
+    quint32 recordBatch = builder.endTable();
+
+    m_batches.push_back(writeMessage(createMessage(builder, headerRecordBatch, recordBatch,
+                                                   qint64(body.size())), body));
+}
+
+
+bool ArrowTable::close()
+{
+    if (!m_out.is_open())
+    {
+        return false;
+    }
+
+    writeBatch();
+
+    // end of stream
+    std::string end;
+    appendBytes(end, 0xFFFFFFFF, 4);
+    appendBytes(end, 0, 4);
+
+    std::string blocks;
+    for (size_t i = 0; i < m_batches.size(); ++i)
+    {
+        appendBytes(blocks, quint64(m_batches[i].m_offset), 8);
+        appendBytes(blocks, quint64(m_batches[i].m_metaDataLength), 4);
+        appendBytes(blocks, 0, 4);
+        appendBytes(blocks, quint64(m_batches[i].m_bodyLength), 8);
+    }
+
+    FlatBufferBuilder builder;
+    quint32 schema = createSchema(builder);
+    quint32 dictionaries = builder.createStructVector(std::string(), 0);
+    quint32 recordBatches = builder.createStructVector(blocks, m_batches.size());
+    builder.startTable();
+    builder.addScalar(0, metadataVersionV5, 2);
+    builder.addOffset(1, schema);
+    builder.addOffset(2, dictionaries);
+    builder.addOffset(3, recordBatches);
+    std::string footer = builder.finish(builder.endTable());
+
+    end += footer;
+    appendBytes(end, footer.size(), 4);
+    end += magic;
+    m_out.write(end.data(), std::streamsize(end.size()));
+
+    bool good = m_out.good();
+    m_out.close();
+    m_batches.clear();
+    return good;
+}
+
+
+quint32 ArrowTable::createSchema(FlatBufferBuilder& builder) const
+{
+    std::vector<quint32> fields;
+    for (size_t i = 0; i < m_columns.size(); ++i)
+    {
+        quint32 name = builder.createString(m_columns[i].m_name);
+        quint32 children = builder.createOffsetVector(std::vector<quint32>());
+
+        int typeType = typeUtf8;
+        builder.startTable();
+        if (m_columns[i].m_type == CT_Int32)
+        {
+            typeType = typeInt;
+            builder.addScalar(0, 32, 4);  // bit width
+            builder.addScalar(1, 1, 1);   // signed
+        }
+        else if (m_columns[i].m_type == CT_Float64)
+        {
+            typeType = typeFloatingPoint;
+            builder.addScalar(0, precisionDouble, 2);
+        }
+        quint32 type = builder.endTable();
+
+        builder.startTable();
+        builder.addOffset(0, name);
+        builder.addScalar(1, 0, 1);  // not nullable
+        builder.addScalar(2, quint64(typeType), 1);
+        builder.addOffset(3, type);
+        builder.addOffset(5, children);
+        fields.push_back(builder.endTable());
+    }
+    quint32 fieldVector = builder.createOffsetVector(fields);
+
+    builder.startTable();
+    builder.addScalar(0, 0, 2);  // little endian
+    builder.addOffset(1, fieldVector);
+    return builder.endTable();
+}
+
+
+ArrowTable::Block ArrowTable::writeMessage(const std::string& metadata, const std::string& body)
+{
+    std::string message;
+    appendBytes(message, 0xFFFFFFFF, 4);
+    appendBytes(message, 0, 4);
+    message += metadata;
+    pad(message);
+
+    // size of the padded metadata after the continuation marker and the size
+    qint32 metadataSize = qint32(message.size()) - 8;
+    for (int i = 0; i < 4; ++i)
+    {
+        message[size_t(4 + i)] = char(quint8(quint32(metadataSize) >> (8 * i)));
+    }
+
+    Block block;
+    block.m_offset = m_position;
+    block.m_metaDataLength = qint32(message.size());
+    block.m_bodyLength = qint64(body.size());
+
+    m_out.write(message.data(), std::streamsize(message.size()));
+    m_out.write(body.data(), std::streamsize(body.size()));
+    m_position += qint64(message.size() + body.size());
+    return block;
+}
@@ -0,0 +1,253 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file eventlockedrateexport.cpp
+ **************************************************************************************************/
+#include "diagramlegend.h"
+#include "eventlockedrateexport.h"
+#include "eventrateplot.h"
+#include "fileextensions.h"
+#include <QApplication>
+#include <QDialogButtonBox>
+#include <QDir>
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+
+EventLockedRateExport::EventLockedRateExport(QWidget* parent, EyeTrackingData* eyeTrackingData,
+                                             Settings* settings) :
+    m_parent(parent),
+    m_eyeTrackingData(eyeTrackingData),
+    m_settings(settings),
+    m_timeBefore(500),
+    m_timeAfter(1000),
+    m_binSize(50),
+    m_windowSize(100),
+    m_windowStep(10),
+    m_resultDialog(nullptr),
+    m_participantComboBox(nullptr),
+    m_plot(nullptr),
+    m_legend(nullptr)
+{}
+
+
+void EventLockedRateExport::showEventLockedRate()
+{
+    // trials used for the analysis
+    std::vector<Trial*> trials;
+    if (m_settings->m_displayMode == Multi)
+    {
+        trials = m_settings->m_currentTrials;
+    }
+    else
+    {
+        for (size_t i = 0; i < m_eyeTrackingData->numberOfParticipants(); ++i)
+        {
+            Participant* p = m_eyeTrackingData->participantAt(int(i));
+            for (size_t j = 0; j < p->numberOfTrials(); ++j)
+            {
+                trials.push_back(p->getTrialAt(int(j)));
+            }
+        }
+    }
+
+    QStringList eventNames = EventLockedRate::eventNames(trials);
+    if (eventNames.isEmpty())
+    {
+        QMessageBox::information(m_parent, tr("No data available"),
+                                 tr("No trials with events available"));
+        return;
+    }
+
+    if (!askForParameters(eventNames))
+    {
+        return;
+    }
+
+    qApp->setOverrideCursor(Qt::WaitCursor);
+
+    m_analysis = QSharedPointer<EventLockedRate>(
+                new EventLockedRate(m_eventName, m_timeBefore, m_timeAfter, m_binSize,
+                                    m_windowSize, m_windowStep, m_settings->m_gazeType));
+    m_groups = m_analysis->run(trials);
+
+    qApp->restoreOverrideCursor();
+
+    if (m_resultDialog == nullptr)
+    {
+        createResultDialog();
+    }
+
+    // participants of the groups, the groups of all participants are shown first
+    m_participantComboBox->blockSignals(true);
+    m_participantComboBox->clear();
+    m_participantComboBox->addItem(tr("All Participants"));
+    foreach (const EventLockedRateGroup& g, m_groups)
+    {
+        if (!g.m_participant.isEmpty() && m_participantComboBox->findText(g.m_participant) < 0)
+        {
+            m_participantComboBox->addItem(g.m_participant);
+        }
+    }
+    m_participantComboBox->blockSignals(false);
+
+    selectParticipant(0);
+
+    m_resultDialog->setWindowTitle(tr("Event-Locked Microsaccade Rate: %1").arg(m_eventName));
+    m_legend->show();
+    m_resultDialog->show();
+    m_resultDialog->raise();
+    m_resultDialog->activateWindow();
+}
+
+
+void EventLockedRateExport::exportEventLockedRate()
+{
+    if (m_analysis.isNull())
+    {
+        return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(
+                m_parent, tr("Save Event-Locked Microsaccade Rates"),
+                QDir::cleanPath(m_settings->m_recentDir + QDir::separator() + "eventLockedRate"),
+                tr("%2 (*.%1);;All Files (*)").arg(EventLockedRateFile,
+                                                   EventLockedRateFileDescription));
+    if (fileName.isEmpty())
+    {
+        return;
+    }
+    m_settings->m_recentDir = QFileInfo(fileName).path();
+
+    if (!m_analysis->writeCsv(m_groups, fileName))
+    {
+        QMessageBox::warning(m_parent, tr("Export failed"),
+                             tr("The file %1 could not be written.").arg(fileName));
+    }
+}
+
+
+void EventLockedRateExport::selectParticipant(int index)
+{
+    if (m_analysis.isNull() || index < 0)
+    {
+        return;
+    }
+
+    QString participant = index == 0 ? QString() : m_participantComboBox->itemText(index);
+
+    std::vector<EventLockedRateGroup> groups;
+    foreach (const EventLockedRateGroup& g, m_groups)
+    {
+        if (g.m_participant == participant)
+        {
+            groups.push_back(g);
+        }
+    }
+
+    m_plot->updatePlot(*m_analysis, groups);
+}
+
+
+bool EventLockedRateExport::askForParameters(const QStringList& eventNames)
+{
+    QDialog dialog(m_parent);
+    dialog.setWindowTitle(tr("Event-Locked Microsaccade Rate"));
+
+    QComboBox* eventComboBox = new QComboBox(&dialog);
+    eventComboBox->addItems(eventNames);
+    if (eventNames.contains(m_eventName))
+    {
+        eventComboBox->setCurrentText(m_eventName);
+    }
+
+    // all times in ms
+    auto createSpinBox = [&dialog](int minimum, int value)
+    {
+        QSpinBox* spinBox = new QSpinBox(&dialog);
+        spinBox->setRange(minimum, 100000);
+        spinBox->setSuffix(" ms");
+        spinBox->setValue(value);
+        return spinBox;
+    };
+
+    QSpinBox* timeBeforeSpinBox = createSpinBox(0, m_timeBefore);
+    QSpinBox* timeAfterSpinBox = createSpinBox(0, m_timeAfter);
+    QSpinBox* binSizeSpinBox = createSpinBox(1, m_binSize);
+    QSpinBox* windowSizeSpinBox = createSpinBox(1, m_windowSize);
+    QSpinBox* windowStepSpinBox = createSpinBox(1, m_windowStep);
+
+    QDialogButtonBox* buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok |
+                                                       QDialogButtonBox::Cancel, &dialog);
+    QObject::connect(buttonBox, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    QObject::connect(buttonBox, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+    QFormLayout* layout = new QFormLayout(&dialog);
+    layout->addRow(tr("Event:"), eventComboBox);
+    layout->addRow(tr("Time before event:"), timeBeforeSpinBox);
+    layout->addRow(tr("Time after event:"), timeAfterSpinBox);
+    layout->addRow(tr("Histogram bin size:"), binSizeSpinBox);
+    layout->addRow(tr("Sliding window size:"), windowSizeSpinBox);
+    layout->addRow(tr("Sliding window step:"), windowStepSpinBox);
+    layout->addRow(buttonBox);
+
+    if (dialog.exec() != QDialog::Accepted)
+    {
+        return false;
+    }
+
+    m_eventName = eventComboBox->currentText();
+    m_timeBefore = timeBeforeSpinBox->value();
+    m_timeAfter = timeAfterSpinBox->value();
+    m_binSize = binSizeSpinBox->value();
+    m_windowSize = windowSizeSpinBox->value();
+    m_windowStep = windowStepSpinBox->value();
+
+    return true;
+}
+
+
+void EventLockedRateExport::createResultDialog()
+{
+    m_resultDialog = new QDialog(m_parent);
+    m_resultDialog->resize(600, 650);
+
+    m_participantComboBox = new QComboBox(m_resultDialog);
+    QObject::connect(m_participantComboBox,
+                     static_cast<void (QComboBox::*)(int index)>(&QComboBox::currentIndexChanged),
+                     this, &EventLockedRateExport::selectParticipant);
+
+    QHBoxLayout* participantLayout = new QHBoxLayout();
+    participantLayout->addWidget(new QLabel(tr("Participant:"), m_resultDialog));
+    participantLayout->addWidget(m_participantComboBox, 1);
+
+    m_plot = new EventRatePlot(m_settings);
+    m_plot->setMinimumSize(300, 300);
+
+    m_legend = new DiagramLegend(m_settings);
+
+    QLabel* description = new QLabel(tr("Bars: peri-event histogram, lines: sliding window "
+                                        "(microsaccades per second of gaze data)."),
+                                     m_resultDialog);
+    description->setWordWrap(true);
+
+    QDialogButtonBox* buttonBox = new QDialogButtonBox(QDialogButtonBox::Close, m_resultDialog);
+    QPushButton* exportButton = buttonBox->addButton(tr("Export..."),
+                                                     QDialogButtonBox::ActionRole);
+    QObject::connect(exportButton, &QPushButton::clicked,
+                     this, &EventLockedRateExport::exportEventLockedRate);
+    QObject::connect(buttonBox, &QDialogButtonBox::rejected,
+                     m_resultDialog, &QDialog::close);
+
+    QVBoxLayout* layout = new QVBoxLayout(m_resultDialog);
+    layout->addLayout(participantLayout);
+    layout->addWidget(m_plot, 1);
+    layout->addWidget(m_legend);
+    layout->addWidget(description);
+    layout->addWidget(buttonBox);
+}
@@ -2,12 +2,33 @@
  * @author Tanja Munz
  * @file eyedataexport.cpp
  **************************************************************************************************/
+#include "arrowdatawriter.h"
 #include "eyedataexport.h"
+#include "eyedatawriter.h"
 #include "fileextensions.h"
+#include "sessionfile.h"
 #include "settings.h"
 #include <QApplication>
+#include <QDir>
 #include <QFileDialog>
+#include <QFutureWatcher>
 #include <QMessageBox>
+#include <QProgressDialog>
+#include <QtConcurrent>
+
+
+// writes the .maf file of one participant on a thread of the pool (function object for
+// QtConcurrent::mapped)
+struct ParticipantFileWriter
+{
+    typedef bool result_type;
+
+    bool operator()(const QPair<Participant*, QString>& file) const
+    {
+        return EyeDataWriter::writeParticipantFile(*file.first, file.second);
+    }
+};
+
 
 EyeDataExport::EyeDataExport(QWidget* parent, EyeTrackingData* data, Settings* settings) :
     m_parent(parent),
@@ -36,8 +57,8 @@ void EyeDataExport::exportTrialDataToFile()
 
     if (out.is_open())
     {
-        writeHeader(*m_settings->m_currentTrials[0]->getParticipant(), out);
-        writeTrial(*m_settings->m_currentTrials[0], out);
+        EyeDataWriter::writeHeader(*m_settings->m_currentTrials[0]->getParticipant(), out);
+        EyeDataWriter::writeTrial(*m_settings->m_currentTrials[0], out);
         out.close();
     }
 
@@ -77,90 +98,134 @@ void EyeDataExport::exportAllParticipantDataToFile()
         return;
     }
 
-    for (size_t i = 0; i < m_data->numberOfParticipants(); ++i)
+    m_settings->m_recentDir = QDir::cleanPath(dir);
+
+    // each participant is written to its own file on the thread pool; at most one buffered
+    // participant per thread is in memory. The window modal progress dialog keeps the user
+    // interface responsive and prevents changes of the trials during the export.
+    std::vector<QPair<Participant*, QString> > files = EyeDataWriter::participantFiles(*m_data,
+                                                                                        dir);
+
+    QProgressDialog progress(tr("Exporting participants..."), tr("Cancel"), 0, int(files.size()),
+                             m_parent);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(0);
+    progress.setAutoClose(false);
+    progress.setAutoReset(false);
+
+    QFutureWatcher<bool> watcher;
+    QObject::connect(&watcher, &QFutureWatcher<bool>::progressValueChanged,
+                     &progress, &QProgressDialog::setValue);
+    QObject::connect(&watcher, &QFutureWatcher<bool>::finished,
+                     &progress, &QProgressDialog::accept);
+    QObject::connect(&progress, &QProgressDialog::canceled,
+                     &watcher, &QFutureWatcher<bool>::cancel);
+
+    watcher.setFuture(QtConcurrent::mapped(files, ParticipantFileWriter()));
+    progress.exec();
+    watcher.waitForFinished();
+
+    // files of canceled participants are not started, started files are completed
+    int failed = 0;
+    QList<bool> results = watcher.future().results();
+    for (int i = 0; i < results.size(); ++i)
     {
-        std::ofstream out;
-        exportFile(out,
-                   tr("Save Current Participant"),
-                   eyeTrackingDataFile,
-                   m_data->participantAt(int(i)),
-                   dir);
+        if (!results[i])
+        {
+            failed++;
+        }
+    }
+    if (failed > 0)
+    {
+        QMessageBox::warning(m_parent, tr("Export failed"),
+                             tr("%1 files can not be written to %2").arg(failed).arg(dir));
+    }
 
-        exportParticipantDataToFile(m_data->participantAt(int(i)), out);
+    int notWritten = int(files.size()) - results.size();
+    if (watcher.isCanceled() && notWritten > 0)
+    {
+        QMessageBox::warning(m_parent, tr("Export canceled"),
+                             tr("%1 of %2 files are not written to %3").arg(notWritten)
+                             .arg(int(files.size())).arg(dir));
     }
 }
 
 
-void EyeDataExport::writeHeader(Participant& participant, std::ofstream& out)
+void EyeDataExport::exportAllParticipantDataToArrow()
 {
-    out << "VisME - Visual Microsaccades Explorer" << std::endl;
-    out << "PARTICIPANT " << participant.name().toStdString() << std::endl;
-    out << "PIXELSPERDEGREE " << QString::number(participant.getPixelsPerDegree()).toStdString() << std::endl;
+    exportArrowData(false);
 }
 
 
-void EyeDataExport::writeTrial(Trial& trial, std::ofstream& out)
+void EyeDataExport::exportAllParticipantDataWithSamplesToArrow()
 {
-    if (out.is_open())
+    exportArrowData(true);
+}
+
+
+void EyeDataExport::exportSession()
+{
+    if (m_data->numberOfParticipants() == 0)
     {
-        out << "TRIAL " << trial.name().toStdString() << std::endl;
-        out << "COORDS " << trial.minX() << " " << trial.minY() << " " << trial.maxX() << " "
-           << trial.maxY() << std::endl;
-        out << "FREQ " << trial.frequencyRate() << std::endl;
-        out << "STIMULUS " << trial.getStimulus().toStdString() << std::endl;
+        QMessageBox::information(m_parent, tr("No data available"),
+                                 tr("No data for export available"));
+
+        return;
+    }
 
+    QString fileTypes = tr("%2 (*.%1)").arg(studySessionFile, studySessionFileDescription);
+    QString fileName = QFileDialog::getSaveFileName(m_parent, tr("Save Session"),
+                                                    m_settings->m_recentDir, fileTypes);
+    if (fileName.isEmpty())
+    {
+        return;
+    }
+    m_settings->m_recentDir = QFileInfo(fileName).path();
 
-        std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
-        std::vector<std::string> gazeSigns = {"R", "L", "B"};
-        for (size_t j = 0; j < gazeTypes.size(); ++j)
-        {
-            // fixations
-            for (int i = 0; i < trial.fixationsCount(gazeTypes[j]); ++i)
-            {
-                Fixation* f = trial.getFixationAt(i, gazeTypes[j]);
-
-                out << "F " << gazeSigns[j] << " " << QString::number(f->getStartIndex(), 'g', 10).toStdString() << " " <<
-                       QString::number(f->getDuration(), 'g', 10).toStdString() << " " <<
-                       f->getXPosition() << " " << f->getYPosition() << std::endl;
-            }
-
-            // microsaccades
-            for (int i = 0; i < trial.fixationsCount(gazeTypes[j]); ++i)
-            {
-                for (size_t k = 0; k < trial.getFixationAt(i, gazeTypes[j])->getMicrosaccadesCount(trial.msFromInputFile()); ++k)
-                {
-                    Saccade* m = trial.getFixationAt(i, gazeTypes[j])->getMicrosaccadeAt(k, trial.msFromInputFile());
-
-                    out << "M " << gazeSigns[j] << " " << QString::number(int(m->getOnsetIndex()), 'g', 10).toStdString() << " " <<
-                           QString::number(int(m->getDuration()), 'g', 10).toStdString() << " " <<
-                           m->getPeakVelocity() << " " <<
-                           m->getHorizontalComponent() << " " << m->getVerticalComponent() << " " <<
-                           m->getHorizontalAmplitude() << " " << m->getVerticalAmplitude() << std::endl;
-                }
-            }
-
-            // gaze positions
-            QMapIterator<int, GazeData> i(trial.gazeData(gazeTypes[j]));
-            while (i.hasNext())
-            {
-                i.next();
-                const GazeData& g = i.value();
-                out << gazeSigns[j] << " " << QString::number(i.key(), 'g', 10).toStdString() << " " <<
-                       g.getXPosition() << " " << g.getYPosition() << std::endl;
-            }
-
-            for (size_t i = 0; i < trial.eventCount(); ++i)
-            {
-                Event* e = trial.getEventAt(i);
-
-                out << "E " << QString::number(int(e->getStartIndex()), 'g', 10).toStdString() << " " <<
-                       QString::number(int(e->getDuration()), 'g', 10).toStdString() << " " <<
-                       e->getName().toStdString() << " " << std::endl;
-            }
-        }
+    qApp->setOverrideCursor(Qt::WaitCursor);
 
-        out << "ENDTRIAL" << std::endl;
-        out << std::endl;
+    QString errorString;
+    bool written = SessionFile::write(fileName, *m_data, m_settings->m_testConditions.keys(),
+                                      errorString);
+
+    qApp->restoreOverrideCursor();
+
+    if (!written)
+    {
+        QMessageBox::warning(m_parent, tr("Export failed"),
+                             tr("File %1 can not be written.\n %2").arg(fileName, errorString));
+    }
+}
+
+
+void EyeDataExport::exportArrowData(bool writeSamples)
+{
+    QString dir = QFileDialog::getExistingDirectory(m_parent, tr("Select Directory"),
+                                                    m_settings->m_recentDir,
+                                                    QFileDialog::ShowDirsOnly |
+                                                    QFileDialog::DontResolveSymlinks);
+    if (dir.isEmpty())
+    {
+        return;
+    }
+    m_settings->m_recentDir = dir;
+
+    qApp->setOverrideCursor(Qt::WaitCursor);
+
+    ArrowDataWriter writer(writeSamples);
+    bool written = writer.open(dir);
+    for (size_t i = 0; written && i < m_data->numberOfParticipants(); ++i)
+    {
+        writer.writeParticipant(*m_data->participantAt(int(i)));
+    }
+    written = writer.close() && written;
+
+    qApp->restoreOverrideCursor();
+
+    if (!written)
+    {
+        QMessageBox::warning(m_parent, tr("Export failed"),
+                             tr("Arrow files can not be written to %1").arg(dir));
     }
 }
 
@@ -171,12 +236,7 @@ void EyeDataExport::exportParticipantDataToFile(Participant* participant, std::o
 
     if (out.is_open())
     {
-        writeHeader(*participant, out);
-        for (size_t i = 0; i < participant->numberOfTrials(); ++i)
-        {
-            writeTrial(*participant->getTrialAt(int(i)), out);
-        }
-
+        EyeDataWriter::writeParticipant(*participant, out);
         out.close();
     }
 
@@ -0,0 +1,198 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file eyedatawriter.cpp
+ **************************************************************************************************/
+#include "eyedatawriter.h"
+#include "fileextensions.h"
+#include "outputbuffer.h"
+#include <QDir>
+#include <QMapIterator>
+#include <QSet>
+
+
+void EyeDataWriter::writeHeader(Participant& participant, std::ofstream& out)
+{
+    out << "VisME - Visual Microsaccades Explorer" << std::endl;
+    out << "PARTICIPANT " << participant.name().toStdString() << std::endl;
+    out << "PIXELSPERDEGREE " << QString::number(participant.getPixelsPerDegree()).toStdString() << std::endl;
+}
+
+
+void EyeDataWriter::writeTrial(Trial& trial, std::ofstream& out)
+{
+    if (out.is_open())
+    {
+        OutputBuffer buffer(out);
+
+        buffer << "TRIAL " << trial.name().toStdString() << "\n";
+        buffer << "COORDS " << trial.minX() << " " << trial.minY() << " " << trial.maxX() << " "
+               << trial.maxY() << "\n";
+        buffer << "FREQ " << trial.frequencyRate() << "\n";
+        buffer << "STIMULUS " << trial.getStimulus().toStdString() << "\n";
+
+        std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left,
+                                           GazeType::GT_Average};
+        std::vector<std::string> gazeSigns = {"R", "L", "B"};
+        bool fromInput = trial.msFromInputFile();
+        for (size_t j = 0; j < gazeTypes.size(); ++j)
+        {
+            // fixations
+            for (int i = 0; i < trial.fixationsCount(gazeTypes[j]); ++i)
+            {
+                Fixation* f = trial.getFixationAt(i, gazeTypes[j]);
+
+                buffer << "F " << gazeSigns[j] << " " << f->getStartIndex() << " "
+                       << f->getDuration() << " " << f->getXPosition() << " "
+                       << f->getYPosition() << "\n";
+            }
+
+            // microsaccades
+            for (int i = 0; i < trial.fixationsCount(gazeTypes[j]); ++i)
+            {
+                Fixation* f = trial.getFixationAt(i, gazeTypes[j]);
+                for (size_t k = 0; k < f->getMicrosaccadesCount(fromInput); ++k)
+                {
+                    Saccade* m = f->getMicrosaccadeAt(k, fromInput);
+
+                    buffer << "M " << gazeSigns[j] << " " << int(m->getOnsetIndex()) << " "
+                           << int(m->getDuration()) << " " << m->getPeakVelocity() << " "
+                           << m->getHorizontalComponent() << " " << m->getVerticalComponent()
+                           << " " << m->getHorizontalAmplitude() << " "
+                           << m->getVerticalAmplitude() << "\n";
+                }
+            }
+
+            // gaze positions
+            const QMap<int, GazeData> g = trial.gazeData(gazeTypes[j]);
+            for (QMap<int, GazeData>::const_iterator it = g.constBegin(); it != g.constEnd(); ++it)
+            {
+                buffer << gazeSigns[j] << " " << it.key() << " " << it.value().getXPosition()
+                       << " " << it.value().getYPosition() << "\n";
+            }
+
+            for (size_t i = 0; i < trial.eventCount(); ++i)
+            {
+                Event* e = trial.getEventAt(i);
+
+                buffer << "E " << int(e->getStartIndex()) << " " << int(e->getDuration()) << " "
+                       << e->getName().toStdString() << " " << "\n";
+            }
+        }
+
+        buffer << "ENDTRIAL" << "\n";
+        buffer << "\n";
+    }
+}
+
+
+void EyeDataWriter::writeTrialStream(Trial& trial, std::ofstream& out)
+{
+    if (out.is_open())
+    {
+        out << "TRIAL " << trial.name().toStdString() << std::endl;
+        out << "COORDS " << trial.minX() << " " << trial.minY() << " " << trial.maxX() << " "
+           << trial.maxY() << std::endl;
+        out << "FREQ " << trial.frequencyRate() << std::endl;
+        out << "STIMULUS " << trial.getStimulus().toStdString() << std::endl;
+
+
+        std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
+        std::vector<std::string> gazeSigns = {"R", "L", "B"};
+        for (size_t j = 0; j < gazeTypes.size(); ++j)
+        {
+            // fixations
+            for (int i = 0; i < trial.fixationsCount(gazeTypes[j]); ++i)
+            {
+                Fixation* f = trial.getFixationAt(i, gazeTypes[j]);
+
+                out << "F " << gazeSigns[j] << " " << QString::number(f->getStartIndex(), 'g', 10).toStdString() << " " <<
+                       QString::number(f->getDuration(), 'g', 10).toStdString() << " " <<
+                       f->getXPosition() << " " << f->getYPosition() << std::endl;
+            }
+
+            // microsaccades
+            for (int i = 0; i < trial.fixationsCount(gazeTypes[j]); ++i)
+            {
+                for (size_t k = 0; k < trial.getFixationAt(i, gazeTypes[j])->getMicrosaccadesCount(trial.msFromInputFile()); ++k)
+                {
+                    Saccade* m = trial.getFixationAt(i, gazeTypes[j])->getMicrosaccadeAt(k, trial.msFromInputFile());
+
+                    out << "M " << gazeSigns[j] << " " << QString::number(int(m->getOnsetIndex()), 'g', 10).toStdString() << " " <<
+                           QString::number(int(m->getDuration()), 'g', 10).toStdString() << " " <<
+                           m->getPeakVelocity() << " " <<
+                           m->getHorizontalComponent() << " " << m->getVerticalComponent() << " " <<
+                           m->getHorizontalAmplitude() << " " << m->getVerticalAmplitude() << std::endl;
+                }
+            }
+
+            // gaze positions
+            QMapIterator<int, GazeData> i(trial.gazeData(gazeTypes[j]));
+            while (i.hasNext())
+            {
+                i.next();
+                const GazeData& g = i.value();
+                out << gazeSigns[j] << " " << QString::number(i.key(), 'g', 10).toStdString() << " " <<
+                       g.getXPosition() << " " << g.getYPosition() << std::endl;
+            }
+
+            for (size_t i = 0; i < trial.eventCount(); ++i)
+            {
+                Event* e = trial.getEventAt(i);
+
+                out << "E " << QString::number(int(e->getStartIndex()), 'g', 10).toStdString() << " " <<
+                       QString::number(int(e->getDuration()), 'g', 10).toStdString() << " " <<
+                       e->getName().toStdString() << " " << std::endl;
+            }
+        }
+
+        out << "ENDTRIAL" << std::endl;
+        out << std::endl;
+    }
+}
+
+
+void EyeDataWriter::writeParticipant(Participant& participant, std::ofstream& out)
+{
+    if (out.is_open())
+    {
+        writeHeader(participant, out);
+        for (size_t i = 0; i < participant.numberOfTrials(); ++i)
+        {
+            writeTrial(*participant.getTrialAt(int(i)), out);
+        }
+    }
+}
+
+
+bool EyeDataWriter::writeParticipantFile(Participant& participant, const QString& fileName)
+{
+    std::ofstream out(fileName.toStdString(), std::ios::out);
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    writeParticipant(participant, out);
+    out.close();
+    return !out.fail();
+}
+
+
+std::vector<QPair<Participant*, QString> > EyeDataWriter::participantFiles(EyeTrackingData& data,
+                                                                           const QString& dir)
+{
+    std::vector<QPair<Participant*, QString> > files;
+    QSet<QString> fileNames;
+    for (size_t i = data.numberOfParticipants(); i > 0; --i)
+    {
+        Participant* participant = data.participantAt(int(i - 1));
+        QString fileName = QDir::cleanPath(dir + QDir::separator() + participant->modifiedName() +
+                                           "." + eyeTrackingDataFile);
+        if (!fileNames.contains(fileName))
+        {
+            fileNames.insert(fileName);
+            files.insert(files.begin(), QPair<Participant*, QString>(participant, fileName));
+        }
+    }
+    return files;
+}
@@ -0,0 +1,200 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file outputbuffer.cpp
+ **************************************************************************************************/
+#include "outputbuffer.h"
+#include <cmath>
+#include <locale>
+#include <sstream>
+
+// significant digits of the default floating point format
+static const int precision = 6;
+
+// powers of ten which are compared with the values of the fixed notation
+static const double powersOfTen[] = {1e-4, 1e-3, 1e-2, 1e-1, 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6,
+                                     1e7, 1e8, 1e9};
+
+
+// writes the digits of value to the end of digits and returns the position of the first digit
+static char* formatUnsigned(unsigned long long value, char* end)
+{
+    do
+    {
+        *--end = char('0' + value % 10);
+        value /= 10;
+    }
+    while (value != 0);
+    return end;
+}
+
+
+// formats value like printf("%g") for values of the fixed notation ([1e-4, 1e6)) whose rounding
+// to 6 significant digits is certain and returns the number of characters, 0 otherwise
+static int formatFixed(double value, char* text)
+{
+    double a = std::fabs(value);
+    if (!(a >= powersOfTen[0] && a < powersOfTen[10]))
+    {
+        return 0;
+    }
+
+    // decimal exponent and digits scaled to an integer with 6 digits
+    int exponent = 0;
+    while (exponent < 9 && a >= powersOfTen[exponent + 1])
+    {
+        exponent++;
+    }
+    exponent -= 4;
+    double scaled = a * powersOfTen[4 + precision - 1 - exponent];
+    double digits = std::floor(scaled);
+    double fraction = scaled - digits;
+
+    // (almost) exact ties depend on the binary value and are left to printf
+    if (std::fabs(fraction - 0.5) < 1e-9)
+    {
+        return 0;
+    }
+    if (fraction > 0.5)
+    {
+        digits += 1;
+    }
+    if (digits < powersOfTen[4 + precision - 1] || digits >= powersOfTen[4 + precision])
+    {
+        return 0;
+    }
+
+    char digitText[precision];
+    formatUnsigned((unsigned long long)(digits), digitText + precision);
+
+    // remove trailing zeros of the fraction
+    int last = precision - 1;
+    while (last > exponent && last > 0 && digitText[last] == '0')
+    {
+        last--;
+    }
+
+    int length = 0;
+    if (value < 0)
+    {
+        text[length++] = '-';
+    }
+    if (exponent >= 0)
+    {
+        for (int i = 0; i <= last; ++i)
+        {
+            if (i == exponent + 1)
+            {
+                text[length++] = '.';
+            }
+            text[length++] = digitText[i];
+        }
+    }
+    else
+    {
+        text[length++] = '0';
+        text[length++] = '.';
+        for (int i = exponent + 1; i < 0; ++i)
+        {
+            text[length++] = '0';
+        }
+        for (int i = 0; i <= last; ++i)
+        {
+            text[length++] = digitText[i];
+        }
+    }
+    return length;
+}
+
+
+// formats value like printf("%g") in the classic locale; printf itself uses the decimal separator
+// of LC_NUMERIC, which Qt sets from the environment
+static std::string formatGeneral(double value)
+{
+    std::ostringstream text;
+    text.imbue(std::locale::classic());
+    text << value;
+    return text.str();
+}
+
+
+OutputBuffer::OutputBuffer(std::ostream& out, size_t capacity) :
+    m_out(out),
+    m_capacity(capacity)
+{
+    m_buffer.reserve(capacity + 64);
+}
+
+
+OutputBuffer::~OutputBuffer()
+{
+    flush();
+}
+
+
+OutputBuffer& OutputBuffer::operator<<(const char* text)
+{
+    m_buffer += text;
+    flushIfFull();
+    return *this;
+}
+
+
+OutputBuffer& OutputBuffer::operator<<(const std::string& text)
+{
+    m_buffer += text;
+    flushIfFull();
+    return *this;
+}
+
+
+OutputBuffer& OutputBuffer::operator<<(int value)
+{
+    char text[16];
+    char* end = text + sizeof(text);
+    unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)(value) :
+                                               (unsigned long long)(value);
+    char* begin = formatUnsigned(magnitude, end);
+    if (value < 0)
+    {
+        *--begin = '-';
+    }
+    m_buffer.append(begin, end);
+    flushIfFull();
+    return *this;
+}
+
+
+OutputBuffer& OutputBuffer::operator<<(qreal value)
+{
+    char text[32];
+    int length = formatFixed(value, text);
+    if (length > 0)
+    {
+        m_buffer.append(text, size_t(length));
+    }
+    else
+    {
+        m_buffer += formatGeneral(value);
+    }
+    flushIfFull();
+    return *this;
+}
+
+
+void OutputBuffer::flush()
+{
+    if (!m_buffer.empty())
+    {
+        m_out.write(m_buffer.data(), std::streamsize(m_buffer.size()));
+        m_buffer.clear();
+    }
+}
+
+
+void OutputBuffer::flushIfFull()
+{
+    if (m_buffer.size() >= m_capacity)
+    {
+        flush();
+    }
+}
@@ -0,0 +1,166 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file parametersweepexport.cpp
+ **************************************************************************************************/
+#include "fileextensions.h"
+#include "parametersweep.h"
+#include "parametersweepexport.h"
+#include <QDir>
+#include <QFileDialog>
+#include <QFutureWatcher>
+#include <QInputDialog>
+#include <QMessageBox>
+#include <QProgressDialog>
+#include <QtConcurrent>
+
+
+ParameterSweepExport::ParameterSweepExport(QWidget* parent, EyeTrackingData* eyeTrackingData,
+                                           Settings* settings) :
+    m_parent(parent),
+    m_eyeTrackingData(eyeTrackingData),
+    m_settings(settings),
+    m_velocityThresholds("4, 5, 6, 7, 8"),
+    m_minDurations("4, 6, 8, 10, 12")
+{}
+
+
+void ParameterSweepExport::exportParameterSweep()
+{
+    // trials used for the sweep
+    std::vector<Trial*> trials;
+    if (m_settings->m_displayMode == Multi)
+    {
+        trials = m_settings->m_currentTrials;
+    }
+    else
+    {
+        for (size_t i = 0; i < m_eyeTrackingData->numberOfParticipants(); ++i)
+        {
+            Participant* p = m_eyeTrackingData->participantAt(int(i));
+            for (size_t j = 0; j < p->numberOfTrials(); ++j)
+            {
+                trials.push_back(p->getTrialAt(int(j)));
+            }
+        }
+    }
+
+    if (trials.empty())
+    {
+        QMessageBox::information(m_parent, tr("No data available"),
+                                 tr("No data for the parameter sweep available"));
+        return;
+    }
+
+    // parameter grid
+    bool ok = false;
+    QString velocityThresholds = QInputDialog::getText(
+                m_parent, tr("Parameter Sweep"),
+                tr("Velocity thresholds (comma separated):"), QLineEdit::Normal,
+                m_velocityThresholds, &ok);
+    if (!ok)
+    {
+        return;
+    }
+
+    QString minDurations = QInputDialog::getText(
+                m_parent, tr("Parameter Sweep"),
+                tr("Minimum durations [ms] (comma separated):"), QLineEdit::Normal,
+                m_minDurations, &ok);
+    if (!ok)
+    {
+        return;
+    }
+
+    std::vector<qreal> thresholdValues;
+    std::vector<qreal> durationValues;
+    if (!parseValues(velocityThresholds, thresholdValues) ||
+            !parseValues(minDurations, durationValues))
+    {
+        QMessageBox::warning(m_parent, tr("Invalid values"),
+                             tr("Please specify comma separated lists of numbers."));
+        return;
+    }
+
+    m_velocityThresholds = velocityThresholds;
+    m_minDurations = minDurations;
+
+    std::vector<int> durationValuesInt;
+    for (size_t i = 0; i < durationValues.size(); ++i)
+    {
+        durationValuesInt.push_back(qRound(durationValues[i]));
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(
+                m_parent, tr("Save Parameter Sweep"),
+                QDir::cleanPath(m_settings->m_recentDir + QDir::separator() + "parameterSweep"),
+                tr("%2 (*.%1);;All Files (*)").arg(ParameterSweepFile,
+                                                   ParameterSweepFileDescription));
+    if (fileName.isEmpty())
+    {
+        return;
+    }
+    m_settings->m_recentDir = QFileInfo(fileName).path();
+
+    // the sweep runs on the thread pool; the window modal progress dialog keeps the user
+    // interface responsive, prevents changes of the trials and cancels the sweep
+    const ParameterSweep sweep(*m_settings->m_microsaccadeSettings, m_settings->m_gazeType);
+    CancellationToken cancellation = m_cancellation.start();
+
+    QProgressDialog progress(tr("Evaluating parameter sweep..."), tr("Cancel"), 0,
+                             int(trials.size()), m_parent);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(0);
+    progress.setAutoClose(false);
+    progress.setAutoReset(false);
+
+    QFutureWatcher<std::vector<ParameterSweepResult> > watcher;
+    QObject::connect(this, &ParameterSweepExport::trialsEvaluated,
+                     &progress, &QProgressDialog::setValue);
+    QObject::connect(&watcher, &QFutureWatcher<std::vector<ParameterSweepResult> >::finished,
+                     &progress, &QProgressDialog::accept);
+    QObject::connect(&progress, &QProgressDialog::canceled,
+                     [this]() { m_cancellation.cancel(); });
+
+    watcher.setFuture(QtConcurrent::run([this, sweep, trials, thresholdValues, durationValuesInt,
+                                         cancellation]()
+    {
+        return sweep.run(trials, thresholdValues, durationValuesInt, cancellation,
+                         [this](size_t evaluated, size_t)
+                         { emit trialsEvaluated(int(evaluated)); });
+    }));
+    progress.exec();
+    watcher.waitForFinished();
+
+    QObject::disconnect(this, &ParameterSweepExport::trialsEvaluated, nullptr, nullptr);
+
+    if (cancellation.isCanceled())
+    {
+        return;
+    }
+
+    if (!ParameterSweep::writeCsv(watcher.result(), fileName))
+    {
+        QMessageBox::warning(m_parent, tr("Export failed"),
+                             tr("The file %1 could not be written.").arg(fileName));
+    }
+}
+
+
+bool ParameterSweepExport::parseValues(const QString& text, std::vector<qreal>& values) const
+{
+    values.clear();
+
+    QStringList elements = text.split(",", QString::SkipEmptyParts);
+    foreach (QString element, elements)
+    {
+        bool ok = false;
+        qreal value = element.trimmed().toDouble(&ok);
+        if (!ok || value <= 0)
+        {
+            return false;
+        }
+        values.push_back(value);
+    }
+
+    return !values.empty();
+}
@@ -0,0 +1,452 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file sessionfile.cpp
+ **************************************************************************************************/
+#include "event.h"
+#include "sessionfile.h"
+#include <QDataStream>
+#include <QFile>
+#include <QPair>
+
+
+// identifies session files ("VMS") and the version of the format
+static const quint32 sessionFileMagic = 0x564d5300;
+static const quint32 sessionFileVersion = 1;
+
+// gaze types in the order in which they are stored
+static const GazeType storedGazeTypes[] = {GazeType::GT_Left, GazeType::GT_Right,
+                                           GazeType::GT_Average};
+
+
+// writes a saccade or microsaccade
+static void writeSaccade(QDataStream& out, const Saccade& saccade)
+{
+    out << quint64(saccade.getOnsetIndex()) << quint64(saccade.getEndIndex())
+        << saccade.getPeakVelocity()
+        << saccade.getHorizontalComponent() << saccade.getVerticalComponent()
+        << saccade.getHorizontalAmplitude() << saccade.getVerticalAmplitude()
+        << saccade.isValid();
+}
+
+
+// reads a saccade or microsaccade written by writeSaccade
+static Saccade readSaccade(QDataStream& in)
+{
+    quint64 onset = 0;
+    quint64 end = 0;
+    qreal peakVelocity = 0;
+    qreal horizontalComponent = 0;
+    qreal verticalComponent = 0;
+    qreal horizontalAmplitude = 0;
+    qreal verticalAmplitude = 0;
+    bool isValid = false;
+    in >> onset >> end >> peakVelocity >> horizontalComponent >> verticalComponent
+       >> horizontalAmplitude >> verticalAmplitude >> isValid;
+
+    Saccade saccade(size_t(onset), size_t(end), peakVelocity, horizontalComponent,
+                    verticalComponent, horizontalAmplitude, verticalAmplitude);
+    saccade.setValid(isValid);
+    return saccade;
+}
+
+
+// writes a list of saccades or microsaccades
+static void writeSaccades(QDataStream& out, const std::vector<Saccade>& saccades)
+{
+    out << quint32(saccades.size());
+    for (size_t i = 0; i < saccades.size(); ++i)
+    {
+        writeSaccade(out, saccades[i]);
+    }
+}
+
+
+// reads a list of saccades or microsaccades written by writeSaccades
+static std::vector<Saccade> readSaccades(QDataStream& in)
+{
+    std::vector<Saccade> saccades;
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        saccades.push_back(readSaccade(in));
+    }
+    return saccades;
+}
+
+
+// writes a list of fixations with their microsaccades from the input file and calculated ones
+static void writeFixations(QDataStream& out, std::vector<Fixation>& fixations)
+{
+    out << quint32(fixations.size());
+    for (size_t i = 0; i < fixations.size(); ++i)
+    {
+        Fixation& fixation = fixations[i];
+        out << qint32(fixation.getStartIndex()) << qint32(fixation.getDuration())
+            << fixation.getXPosition() << fixation.getYPosition();
+        writeSaccades(out, *fixation.getMicrosaccades(true));
+        writeSaccades(out, *fixation.getMicrosaccades(false));
+    }
+}
+
+
+// reads a list of fixations written by writeFixations
+static std::vector<Fixation> readFixations(QDataStream& in)
+{
+    std::vector<Fixation> fixations;
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        qint32 startIndex = 0;
+        qint32 duration = 0;
+        qreal x = 0;
+        qreal y = 0;
+        in >> startIndex >> duration >> x >> y;
+
+        Fixation fixation;
+        fixation.setStartIndex(startIndex);
+        fixation.setDuration(duration);
+        fixation.setXPosition(x);
+        fixation.setYPosition(y);
+        fixation.setMicrosaccades(readSaccades(in), true);
+        fixation.setMicrosaccades(readSaccades(in), false);
+        fixations.push_back(fixation);
+    }
+    return fixations;
+}
+
+
+// writes the gaze data of one gaze type
+static void writeGazeData(QDataStream& out, const QMap<int, GazeData>& gazeData)
+{
+    out << quint32(gazeData.size());
+    for (QMap<int, GazeData>::const_iterator it = gazeData.constBegin();
+         it != gazeData.constEnd(); ++it)
+    {
+        out << qint32(it.key()) << it.value().getXPosition() << it.value().getYPosition();
+    }
+}
+
+
+// reads gaze data written by writeGazeData; the indices are stored in ascending order, so each
+// sample is appended at the end of the map
+static QMap<int, GazeData> readGazeData(QDataStream& in)
+{
+    QMap<int, GazeData> gazeData;
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        qint32 index = 0;
+        qreal x = 0;
+        qreal y = 0;
+        in >> index >> x >> y;
+
+        GazeData gaze;
+        gaze.setXPosition(x);
+        gaze.setYPosition(y);
+        gazeData.insert(gazeData.constEnd(), index, gaze);
+    }
+    return gazeData;
+}
+
+
+// writes detection settings of a trial, which are not set if the trial was not detected yet
+static void writeFilterSettings(QDataStream& out, const SaccadeFilterSettings* settings)
+{
+    out << (settings != nullptr);
+    if (settings == nullptr)
+    {
+        return;
+    }
+
+    out << settings->m_fromInputFile << settings->m_velocityThreshold
+        << qint32(settings->m_minDuration) << settings->m_binocular
+        << qint32(settings->m_maxDuration) << settings->m_maxAmplitude << settings->m_minAmplitude
+        << qint32(settings->m_minIntersaccInterval) << settings->m_minVelocity
+        << settings->m_maxVelocity << qint32(settings->m_ignoreAtStart)
+        << qint32(settings->m_ignoreAtEnd) << quint64(settings->m_velocityWindowSize)
+        << qint32(settings->m_ignoreBeforeMissingData)
+        << qint32(settings->m_ignoreAfterMissingData);
+
+    out << settings->m_useMaxDuration << settings->m_useMinAmplitude
+        << settings->m_useMaxAmplitude << settings->m_useMinIntersaccInterval
+        << settings->m_useMinVelocity << settings->m_useMaxVelocity
+        << settings->m_useIgnoreAtStart << settings->m_useIgnoreAtEnd
+        << settings->m_useIgnoreBeforeMissingData << settings->m_useIgnoreAfterMissingData;
+
+    out << qint32(settings->m_algorithm) << qint32(settings->m_preFilter)
+        << quint64(settings->m_preFilterWindowSize) << qint32(settings->m_gapInterpolation)
+        << qint32(settings->m_maxGapDuration);
+}
+
+
+// reads detection settings written by writeFilterSettings; returns if the settings were set
+static QPair<bool, SaccadeFilterSettings> readFilterSettings(QDataStream& in)
+{
+    QPair<bool, SaccadeFilterSettings> result(false, SaccadeFilterSettings());
+    in >> result.first;
+    if (!result.first)
+    {
+        return result;
+    }
+
+    SaccadeFilterSettings& settings = result.second;
+    qint32 minDuration = 0;
+    qint32 maxDuration = 0;
+    qint32 minIntersaccInterval = 0;
+    qint32 ignoreAtStart = 0;
+    qint32 ignoreAtEnd = 0;
+    quint64 velocityWindowSize = 0;
+    qint32 ignoreBeforeMissingData = 0;
+    qint32 ignoreAfterMissingData = 0;
+    in >> settings.m_fromInputFile >> settings.m_velocityThreshold >> minDuration
+       >> settings.m_binocular >> maxDuration >> settings.m_maxAmplitude
+       >> settings.m_minAmplitude >> minIntersaccInterval >> settings.m_minVelocity
+       >> settings.m_maxVelocity >> ignoreAtStart >> ignoreAtEnd >> velocityWindowSize
+       >> ignoreBeforeMissingData >> ignoreAfterMissingData;
+
+    in >> settings.m_useMaxDuration >> settings.m_useMinAmplitude >> settings.m_useMaxAmplitude
+       >> settings.m_useMinIntersaccInterval >> settings.m_useMinVelocity
+       >> settings.m_useMaxVelocity >> settings.m_useIgnoreAtStart >> settings.m_useIgnoreAtEnd
+       >> settings.m_useIgnoreBeforeMissingData >> settings.m_useIgnoreAfterMissingData;
+
+    qint32 algorithm = 0;
+    qint32 preFilter = 0;
+    quint64 preFilterWindowSize = 0;
+    qint32 gapInterpolation = 0;
+    qint32 maxGapDuration = 0;
+    in >> algorithm >> preFilter >> preFilterWindowSize >> gapInterpolation >> maxGapDuration;
+
+    settings.m_minDuration = minDuration;
+    settings.m_maxDuration = maxDuration;
+    settings.m_minIntersaccInterval = minIntersaccInterval;
+    settings.m_ignoreAtStart = ignoreAtStart;
+    settings.m_ignoreAtEnd = ignoreAtEnd;
+    settings.m_velocityWindowSize = size_t(velocityWindowSize);
+    settings.m_ignoreBeforeMissingData = ignoreBeforeMissingData;
+    settings.m_ignoreAfterMissingData = ignoreAfterMissingData;
+    settings.m_algorithm = DetectionAlgorithm(algorithm);
+    settings.m_preFilter = PreFilterType(preFilter);
+    settings.m_preFilterWindowSize = size_t(preFilterWindowSize);
+    settings.m_gapInterpolation = GapInterpolationType(gapInterpolation);
+    settings.m_maxGapDuration = maxGapDuration;
+    return result;
+}
+
+
+// writes all data of a trial except the detection settings
+static void writeTrial(QDataStream& out, Trial& trial)
+{
+    out << trial.name() << trial.getTestConditionType() << trial.getStimulus()
+        << trial.frequencyRate() << trial.minX() << trial.minY() << trial.maxX() << trial.maxY();
+
+    out << quint32(trial.eventCount());
+    for (size_t i = 0; i < trial.eventCount(); ++i)
+    {
+        Event* event = trial.getEventAt(i);
+        out << qint32(event->getStartIndex()) << qint32(event->getDuration()) << event->getName();
+    }
+
+    for (GazeType gazeType : storedGazeTypes)
+    {
+        writeGazeData(out, trial.gazeData(gazeType));
+    }
+
+    out << trial.useFixationsFromInput();
+    for (GazeType gazeType : storedGazeTypes)
+    {
+        writeFixations(out, *trial.fixations(gazeType, true));
+        writeFixations(out, *trial.fixations(gazeType, false));
+        writeSaccades(out, *trial.saccades(gazeType));
+    }
+}
+
+
+// reads the data of a trial written by writeTrial
+static void readTrial(QDataStream& in, Trial& trial)
+{
+    QString name;
+    QString testConditionType;
+    QString stimulus;
+    qreal frequencyRate = 0;
+    qreal minX = 0;
+    qreal minY = 0;
+    qreal maxX = 0;
+    qreal maxY = 0;
+    in >> name >> testConditionType >> stimulus >> frequencyRate >> minX >> minY >> maxX >> maxY;
+
+    trial.setName(name);
+    trial.setTestConditionType(testConditionType);
+    trial.setStimulus(stimulus);
+    trial.setFrequencyRate(frequencyRate);
+    trial.setMinMax(minX, maxX, minY, maxY);
+
+    std::vector<Event> events;
+    quint32 eventCount = 0;
+    in >> eventCount;
+    for (quint32 i = 0; i < eventCount && in.status() == QDataStream::Ok; ++i)
+    {
+        qint32 start = 0;
+        qint32 duration = 0;
+        QString eventName;
+        in >> start >> duration >> eventName;
+        events.push_back(Event(start, duration, eventName));
+    }
+    trial.setEvents(events);
+
+    for (GazeType gazeType : storedGazeTypes)
+    {
+        trial.setGazeData(readGazeData(in), gazeType);
+    }
+
+    bool useFixationsFromInput = true;
+    in >> useFixationsFromInput;
+    for (GazeType gazeType : storedGazeTypes)
+    {
+        *trial.fixations(gazeType, true) = readFixations(in);
+        *trial.fixations(gazeType, false) = readFixations(in);
+        trial.setSaccades(readSaccades(in), gazeType);
+    }
+    trial.setUseFixationsFromInput(useFixationsFromInput);
+}
+
+
+bool SessionFile::write(const QString& fileName, EyeTrackingData& data,
+                        const QStringList& testConditions, QString& errorString)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        errorString = file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out << sessionFileMagic << sessionFileVersion;
+    out.setVersion(QDataStream::Qt_5_6);
+
+    out << quint32(testConditions.size());
+    foreach (const QString& testCondition, testConditions)
+    {
+        out << testCondition;
+    }
+
+    out << quint32(data.numberOfParticipants());
+    for (size_t i = 0; i < data.numberOfParticipants(); ++i)
+    {
+        Participant* participant = data.participantAt(int(i));
+        out << participant->filePath() << participant->name()
+            << participant->getPixelsPerDegree() << quint32(participant->numberOfTrials());
+
+        for (size_t j = 0; j < participant->numberOfTrials(); ++j)
+        {
+            Trial* trial = participant->getTrialAt(int(j));
+            writeTrial(out, *trial);
+            writeFilterSettings(out, trial->getMsFilterSettings());
+            writeFilterSettings(out, trial->getFixationFilterSettings());
+        }
+    }
+
+    file.close();
+
+    if (out.status() != QDataStream::Ok || file.error() != QFileDevice::NoError)
+    {
+        errorString = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+
+ImportResult SessionFile::read(const QString& fileName, Settings* settings,
+                               std::vector<Participant*>& participants,
+                               std::set<QString>& testConditions, QString& errorString)
+{
+    participants.clear();
+    testConditions.clear();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        errorString = file.errorString();
+        return IR_OpenFailed;
+    }
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != sessionFileMagic || version != sessionFileVersion)
+    {
+        return IR_InvalidData;
+    }
+    in.setVersion(QDataStream::Qt_5_6);
+
+    quint32 testConditionCount = 0;
+    in >> testConditionCount;
+    for (quint32 i = 0; i < testConditionCount && in.status() == QDataStream::Ok; ++i)
+    {
+        QString testCondition;
+        in >> testCondition;
+        testConditions.insert(testCondition);
+    }
+
+    quint32 participantCount = 0;
+    in >> participantCount;
+    for (quint32 i = 0; i < participantCount && in.status() == QDataStream::Ok; ++i)
+    {
+        QString filePath;
+        QString name;
+        qreal pixelsPerDegree = 0;
+        quint32 trialCount = 0;
+        in >> filePath >> name >> pixelsPerDegree >> trialCount;
+
+        Participant* participant = new Participant(filePath);
+        participant->setName(name);
+        participant->setPixelsPerDegree(pixelsPerDegree);
+        participants.push_back(participant);
+
+        // trials are copied when they are added and do not copy their detection settings, so
+        // the settings are set after all trials of the participant were added
+        std::vector<QPair<bool, SaccadeFilterSettings> > microsaccadeSettings;
+        std::vector<QPair<bool, SaccadeFilterSettings> > fixationSettings;
+        for (quint32 j = 0; j < trialCount && in.status() == QDataStream::Ok; ++j)
+        {
+            Trial trial(participant, settings);
+            readTrial(in, trial);
+            participant->addTrial(trial);
+
+            microsaccadeSettings.push_back(readFilterSettings(in));
+            fixationSettings.push_back(readFilterSettings(in));
+        }
+
+        for (size_t j = 0; j < participant->numberOfTrials(); ++j)
+        {
+            Trial* trial = participant->getTrialAt(int(j));
+            if (microsaccadeSettings[j].first)
+            {
+                trial->updateMicrosaccadesSettings(microsaccadeSettings[j].second);
+            }
+            if (fixationSettings[j].first)
+            {
+                trial->updateFixationSettings(fixationSettings[j].second);
+            }
+        }
+    }
+
+    file.close();
+
+    if (in.status() != QDataStream::Ok)
+    {
+        for (size_t i = 0; i < participants.size(); ++i)
+        {
+            delete participants[i];
+        }
+        participants.clear();
+        testConditions.clear();
+        return IR_InvalidData;
+    }
+    return IR_Success;
+}
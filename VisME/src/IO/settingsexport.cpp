@@ -57,6 +57,11 @@ void SettingsExport::exportMicroseccadesSettingsToGivenFile(QString fileName)
         out << "UseIgnoreEndFixationTime=" << m_settings->m_microsaccadeSettings->m_useIgnoreAtEnd << std::endl;
         out << "UseIgnoreBeforeMissingData=" << m_settings->m_microsaccadeSettings->m_useIgnoreBeforeMissingData << std::endl;
         out << "UseIgnoreAfterMissingData=" << m_settings->m_microsaccadeSettings->m_useIgnoreAfterMissingData << std::endl;
+        out << "DetectionAlgorithm=" << m_settings->m_microsaccadeSettings->m_algorithm << std::endl;
+        out << "PreFilter=" << m_settings->m_microsaccadeSettings->m_preFilter << std::endl;
+        out << "PreFilterWindowSize=" << m_settings->m_microsaccadeSettings->m_preFilterWindowSize << std::endl;
+        out << "GapInterpolation=" << m_settings->m_microsaccadeSettings->m_gapInterpolation << std::endl;
+        out << "MaxGapDuration=" << m_settings->m_microsaccadeSettings->m_maxGapDuration << std::endl;
 
         out.close();
     }
@@ -101,6 +106,11 @@ void SettingsExport::exportFixationSettingsToFile()
         out << "UseIgnoreEndFixationTime=" << m_settings->m_fixationSettings->m_useIgnoreAtEnd << std::endl;
         out << "UseIgnoreBeforeMissingData=" << m_settings->m_fixationSettings->m_useIgnoreBeforeMissingData << std::endl;
         out << "UseIgnoreAfterMissingData=" << m_settings->m_fixationSettings->m_useIgnoreAfterMissingData << std::endl;
+        out << "DetectionAlgorithm=" << m_settings->m_fixationSettings->m_algorithm << std::endl;
+        out << "PreFilter=" << m_settings->m_fixationSettings->m_preFilter << std::endl;
+        out << "PreFilterWindowSize=" << m_settings->m_fixationSettings->m_preFilterWindowSize << std::endl;
+        out << "GapInterpolation=" << m_settings->m_fixationSettings->m_gapInterpolation << std::endl;
+        out << "MaxGapDuration=" << m_settings->m_fixationSettings->m_maxGapDuration << std::endl;
 
         out.close();
     }
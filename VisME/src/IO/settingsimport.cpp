@@ -58,6 +58,31 @@ void SettingsImport::readMicrosaccadsSettingsFile(const QString fileName)
             {
                 m_ui->m_msVelocityWindowSizeSpinBox->setValue(elements[1].toInt());
             }
+            else if (elements[0] == tr("DetectionAlgorithm"))
+            {
+                m_ui->m_msDetectionAlgorithmComboBox->setCurrentIndex(
+                            qBound(0, elements[1].toInt(),
+                                   m_ui->m_msDetectionAlgorithmComboBox->count() - 1));
+            }
+            else if (elements[0] == tr("PreFilter"))
+            {
+                m_ui->m_msPreFilterComboBox->setCurrentIndex(
+                            qBound(0, elements[1].toInt(), m_ui->m_msPreFilterComboBox->count() - 1));
+            }
+            else if (elements[0] == tr("PreFilterWindowSize"))
+            {
+                m_ui->m_msPreFilterWindowSizeSpinBox->setValue(elements[1].toInt());
+            }
+            else if (elements[0] == tr("GapInterpolation"))
+            {
+                m_ui->m_msGapInterpolationComboBox->setCurrentIndex(
+                            qBound(0, elements[1].toInt(),
+                                   m_ui->m_msGapInterpolationComboBox->count() - 1));
+            }
+            else if (elements[0] == tr("MaxGapDuration"))
+            {
+                m_ui->m_msMaxGapDurationSpinBox->setValue(elements[1].toInt());
+            }
             else if (elements[0] == tr("MaxDuration"))
             {
                 m_ui->m_msMaxDurationSpinBox->setValue(elements[1].toInt());
@@ -190,6 +215,31 @@ void SettingsImport::readFixationSettingsFile(const QString fileName)
             {
                 m_ui->m_fixVelocityWindowSizeSpinBox->setValue(elements[1].toInt());
             }
+            else if (elements[0] == tr("DetectionAlgorithm"))
+            {
+                m_ui->m_fixDetectionAlgorithmComboBox->setCurrentIndex(
+                            qBound(0, elements[1].toInt(),
+                                   m_ui->m_fixDetectionAlgorithmComboBox->count() - 1));
+            }
+            else if (elements[0] == tr("PreFilter"))
+            {
+                m_ui->m_fixPreFilterComboBox->setCurrentIndex(
+                            qBound(0, elements[1].toInt(), m_ui->m_fixPreFilterComboBox->count() - 1));
+            }
+            else if (elements[0] == tr("PreFilterWindowSize"))
+            {
+                m_ui->m_fixPreFilterWindowSizeSpinBox->setValue(elements[1].toInt());
+            }
+            else if (elements[0] == tr("GapInterpolation"))
+            {
+                m_ui->m_fixGapInterpolationComboBox->setCurrentIndex(
+                            qBound(0, elements[1].toInt(),
+                                   m_ui->m_fixGapInterpolationComboBox->count() - 1));
+            }
+            else if (elements[0] == tr("MaxGapDuration"))
+            {
+                m_ui->m_fixMaxGapDurationSpinBox->setValue(elements[1].toInt());
+            }
             else if (elements[0] == tr("MaxDuration"))
             {
                 m_ui->m_fixMaxDurationSpinBox->setValue(elements[1].toInt());
@@ -0,0 +1,219 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file settingsreader.cpp
+ **************************************************************************************************/
+#include "settingsreader.h"
+#include <QFile>
+#include <QStringList>
+
+
+bool SettingsReader::readSettingsFile(const QString& fileName,
+                                      QList<QPair<QString, QString> >& values,
+                                      QString& errorString)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        errorString = file.errorString();
+        return false;
+    }
+
+    while (!file.atEnd())
+    {
+        QString line = file.readLine();
+        line = line.trimmed();
+
+        QStringList elements = line.split("=");
+
+        if (elements.size() == 2)
+        {
+            values.append(QPair<QString, QString>(elements[0], elements[1]));
+        }
+    }
+
+    file.close();
+
+    return true;
+}
+
+
+bool SettingsReader::readMicrosaccadeSettings(const QString& fileName,
+                                              SaccadeFilterSettings& settings,
+                                              QString& errorString)
+{
+    QList<QPair<QString, QString> > values;
+    if (!readSettingsFile(fileName, values, errorString))
+    {
+        return false;
+    }
+
+    applySettings(values, settings, true);
+    return true;
+}
+
+
+bool SettingsReader::readFixationSettings(const QString& fileName,
+                                          SaccadeFilterSettings& settings,
+                                          QString& errorString)
+{
+    QList<QPair<QString, QString> > values;
+    if (!readSettingsFile(fileName, values, errorString))
+    {
+        return false;
+    }
+
+    applySettings(values, settings, false);
+    return true;
+}
+
+
+void SettingsReader::applySettings(const QList<QPair<QString, QString> >& values,
+                                   SaccadeFilterSettings& settings, bool microsaccade)
+{
+    // key prefixes and ranges differ between microsaccade and fixation parameter files
+    QString fromInputKey = microsaccade ? "UseMicrosaccadesFromInput" : "UseFixationsFromInput";
+    QString usePrefix = microsaccade ? "UseMs" : "Use";
+    int maxIgnoreTime = microsaccade ? 10000 : 1000000;
+
+    for (int i = 0; i < values.size(); ++i)
+    {
+        const QString& key = values[i].first;
+        const QString& value = values[i].second;
+
+        if (key == fromInputKey)
+        {
+            settings.m_fromInputFile = value == "1";
+        }
+        else if (key == "RelativeVelocityThreshold")
+        {
+            settings.m_velocityThreshold = toInt(value, 0, 100);
+        }
+        else if (key == "MinDuration")
+        {
+            settings.m_minDuration = toInt(value, 1, 1000);
+        }
+        else if (key == "Binocular")
+        {
+            settings.m_binocular = value == "1";
+        }
+        else if (key == "VelocityWindowSize")
+        {
+            settings.m_velocityWindowSize = size_t(toInt(value, 3, 99));
+        }
+        else if (key == "DetectionAlgorithm")
+        {
+            settings.m_algorithm = DetectionAlgorithm(toInt(value, DA_EngbertKliegl,
+                                                            DA_AdaptiveThreshold));
+        }
+        else if (key == "PreFilter")
+        {
+            settings.m_preFilter = PreFilterType(toInt(value, PFT_None, PFT_RunningMedian));
+        }
+        else if (key == "PreFilterWindowSize")
+        {
+            settings.m_preFilterWindowSize = size_t(toInt(value, 3, 99));
+        }
+        else if (key == "GapInterpolation")
+        {
+            settings.m_gapInterpolation = GapInterpolationType(toInt(value, GIT_None, GIT_Cubic));
+        }
+        else if (key == "MaxGapDuration")
+        {
+            settings.m_maxGapDuration = toInt(value, 0, 1000);
+        }
+        else if (key == "MaxDuration")
+        {
+            settings.m_maxDuration = toInt(value, 0, 10000);
+        }
+        else if (key == "MaxAmplitude")
+        {
+            settings.m_maxAmplitude = toDouble(value, 0, 1000);
+        }
+        else if (key == "MinAmplitude")
+        {
+            settings.m_minAmplitude = toDouble(value, 0, 1000);
+        }
+        else if (key == "MinSaccadicInterval")
+        {
+            settings.m_minIntersaccInterval = toInt(value, 0, 10000);
+        }
+        else if (key == "MinVelocity")
+        {
+            settings.m_minVelocity = toDouble(value, 0, 10000);
+        }
+        else if (key == "MaxVelocity")
+        {
+            settings.m_maxVelocity = toDouble(value, 0, 10000);
+        }
+        else if (key == "IgnoreStartFixationTime")
+        {
+            settings.m_ignoreAtStart = toInt(value, 0, maxIgnoreTime);
+        }
+        else if (key == "IgnoreEndFixationTime")
+        {
+            settings.m_ignoreAtEnd = toInt(value, 0, maxIgnoreTime);
+        }
+        else if (key == "IgnoreBeforeMissingData")
+        {
+            settings.m_ignoreBeforeMissingData = toInt(value, 0, maxIgnoreTime);
+        }
+        else if (key == "IgnoreAfterMissingData")
+        {
+            settings.m_ignoreAfterMissingData = toInt(value, 0, maxIgnoreTime);
+        }
+        else if (key == usePrefix + "MaxDuration")
+        {
+            settings.m_useMaxDuration = value == "1";
+        }
+        else if (key == usePrefix + "MinAmplitude")
+        {
+            settings.m_useMinAmplitude = value == "1";
+        }
+        else if (key == usePrefix + "MaxAmplitude")
+        {
+            settings.m_useMaxAmplitude = value == "1";
+        }
+        else if (key == usePrefix + "MinIntersaccInterval")
+        {
+            settings.m_useMinIntersaccInterval = value == "1";
+        }
+        else if (key == usePrefix + "MinVelocity")
+        {
+            settings.m_useMinVelocity = value == "1";
+        }
+        else if (key == usePrefix + "MaxVelocity")
+        {
+            settings.m_useMaxVelocity = value == "1";
+        }
+        else if (key == "UseIgnoreStartFixationTime")
+        {
+            settings.m_useIgnoreAtStart = value == "1";
+        }
+        else if (key == "UseIgnoreEndFixationTime")
+        {
+            settings.m_useIgnoreAtEnd = value == "1";
+        }
+        else if (key == "UseIgnoreBeforeMissingData")
+        {
+            settings.m_useIgnoreBeforeMissingData = value == "1";
+        }
+        else if (key == "UseIgnoreAfterMissingData")
+        {
+            settings.m_useIgnoreAfterMissingData = value == "1";
+        }
+    }
+}
+
+
+int SettingsReader::toInt(const QString& value, int minimum, int maximum)
+{
+    return qBound(minimum, value.toInt(), maximum);
+}
+
+
+qreal SettingsReader::toDouble(const QString& value, qreal minimum, qreal maximum)
+{
+    // rounded like QDoubleSpinBox::setValue
+    return qBound(minimum, QString::number(value.toDouble(), 'f', 2).toDouble(), maximum);
+}
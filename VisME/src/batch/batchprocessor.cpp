@@ -0,0 +1,634 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file batchprocessor.cpp
+ **************************************************************************************************/
+#include "aggregatedstatistics.h"
+#include "algorithmcomparison.h"
+#include "arrowdatawriter.h"
+#include "batchprocessor.h"
+#include "detectionregression.h"
+#include "eventlockedrate.h"
+#include "eyedatareader.h"
+#include "eyedatawriter.h"
+#include "fileextensions.h"
+#include "outputbuffer.h"
+#include "resampler.h"
+#include "saccadedetector.h"
+#include "sessionfile.h"
+#include "settingssnapshot.h"
+#include "streamingsaccadedetector.h"
+#include "velocitykernels.h"
+#include <algorithm>
+#include <clocale>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <locale>
+#include <map>
+#include <sstream>
+#include <QAtomicInt>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QPair>
+#include <QThread>
+#include <QtConcurrent>
+
+
+BatchProcessor::BatchProcessor(Settings* settings) :
+    m_settings(settings)
+{}
+
+
+int BatchProcessor::loadFiles(const QStringList& fileNames)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    int failed = 0;
+    foreach (QString filePath, fileNames)
+    {
+        Participant* participant = nullptr;
+        QString errorString;
+        ImportResult result = EyeDataReader::readParticipant(filePath, m_settings, participant,
+                                                             errorString);
+
+        if (result == IR_OpenFailed)
+        {
+            qWarning() << QString("File %1 can not be opened: %2").arg(filePath, errorString);
+            failed++;
+            continue;
+        }
+
+        if (result != IR_Success)
+        {
+            qWarning() << QString("Loading file failed %1").arg(filePath);
+            failed++;
+            continue;
+        }
+
+        m_data.addParticipant(participant);
+    }
+
+    qDebug() << QString("Import files: %1 ms").arg(timer.elapsed());
+
+    return failed;
+}
+
+
+void BatchProcessor::addSyntheticTrials(int trialCount)
+{
+    DetectionRegression regression(m_settings);
+    m_data.addParticipant(regression.createSyntheticParticipant(trialCount));
+}
+
+
+bool BatchProcessor::loadTestConditions(const QString& fileName)
+{
+    std::set<QString> testConditions;
+    QString errorString;
+    if (!EyeDataReader::readTestConditions(fileName, &m_data, testConditions, errorString))
+    {
+        qWarning() << QString("File %1 can not be opened: %2").arg(fileName, errorString);
+        return false;
+    }
+
+    // colors are only used for the visualizations
+    m_settings->m_testConditions.clear();
+    foreach (const QString& testCondition, testConditions)
+    {
+        m_settings->m_testConditions.insert(testCondition, QColor());
+    }
+
+    return true;
+}
+
+
+int BatchProcessor::resample(int frequency)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // one resampler (filter) per source rate, shared read only by all trials of this rate
+    std::map<qreal, Resampler*> resamplers;
+    std::vector<QPair<Trial*, const Resampler*> > jobs;
+    int failed = 0;
+    std::vector<Trial*> allTrials = trials();
+    for (size_t i = 0; i < allTrials.size(); ++i)
+    {
+        qreal sourceFrequency = allTrials[i]->frequencyRate();
+        if (resamplers.find(sourceFrequency) == resamplers.end())
+        {
+            resamplers[sourceFrequency] = new Resampler(sourceFrequency, frequency);
+        }
+
+        const Resampler* resampler = resamplers[sourceFrequency];
+        if (!resampler->isValid())
+        {
+            qWarning() << QString("Participant %1, Trial %2: sampling rate %3 can not be "
+                                  "resampled").arg(allTrials[i]->getParticipant()->name(),
+                                                   allTrials[i]->name(),
+                                                   QString::number(sourceFrequency));
+            failed++;
+        }
+        else if (resampler->changesRate())
+        {
+            jobs.push_back(QPair<Trial*, const Resampler*>(allTrials[i], resampler));
+        }
+    }
+
+    QtConcurrent::blockingMap(jobs, [](const QPair<Trial*, const Resampler*>& job)
+    {
+        job.second->resampleTrial(job.first);
+    });
+
+    for (std::map<qreal, Resampler*>::iterator it = resamplers.begin(); it != resamplers.end();
+         ++it)
+    {
+        delete it->second;
+    }
+
+    qDebug() << QString("Resampling: %1 trials: %2 ms").arg(
+                    QString::number(jobs.size()), QString::number(timer.elapsed()));
+
+    return failed;
+}
+
+
+void BatchProcessor::detect()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // trials only share the settings snapshot which is never changed during the detection
+    const SettingsSnapshot settings(*m_settings);
+    std::vector<Trial*> allTrials = trials();
+    QtConcurrent::blockingMap(allTrials, [this, &settings](Trial* trial)
+    {
+        detectTrial(trial, settings);
+    });
+
+    qDebug() << QString("Detection: %1 trials: %2 ms").arg(
+                    QString::number(allTrials.size()), QString::number(timer.elapsed()));
+}
+
+
+void BatchProcessor::compareAlgorithms(std::ostream& out)
+{
+    const SettingsSnapshot settings(*m_settings);
+    AlgorithmComparison comparison(settings.m_microsaccadeSettings, settings.m_gazeType);
+    std::vector<AlgorithmComparisonResult> results = comparison.run(
+                trials(), {DA_EngbertKliegl, DA_AdaptiveThreshold});
+    comparison.writeCsv(results, out);
+}
+
+
+bool BatchProcessor::compareStreaming(qreal minAgreement, std::ostream& out)
+{
+    const SettingsSnapshot settings(*m_settings);
+    std::vector<Trial*> allTrials = trials();
+
+    // trials are replayed in parallel, the results are written in the order of the trials
+    std::vector<QPair<Trial*, StreamingComparison> > comparisons;
+    for (size_t i = 0; i < allTrials.size(); ++i)
+    {
+        comparisons.push_back(qMakePair(allTrials[i], StreamingComparison()));
+    }
+
+    QtConcurrent::blockingMap(comparisons,
+                              [&settings](QPair<Trial*, StreamingComparison>& comparison)
+    {
+        comparison.second = StreamingSaccadeDetector::compareWithBatch(
+                    comparison.first, settings.m_gazeType, settings.m_microsaccadeSettings);
+    });
+
+    bool agreed = true;
+    out << "Participant,Trial,#Streamed,#Batch,#Matched,Agreement,Agreed" << std::endl;
+    for (size_t i = 0; i < comparisons.size(); ++i)
+    {
+        const StreamingComparison& c = comparisons[i].second;
+        size_t count = std::max(c.m_streamedCount, c.m_batchCount);
+        qreal agreement = count > 0 ? qreal(c.m_matchedCount) / count : 1;
+        bool trialAgreed = agreement >= minAgreement;
+        agreed = agreed && trialAgreed;
+
+        out << comparisons[i].first->getParticipant()->name().toStdString() << ","
+            << comparisons[i].first->name().toStdString() << ","
+            << c.m_streamedCount << ","
+            << c.m_batchCount << ","
+            << c.m_matchedCount << ","
+            << agreement << ","
+            << trialAgreed << std::endl;
+    }
+
+    return agreed;
+}
+
+
+bool BatchProcessor::benchmarkVelocityKernels(std::ostream& out)
+{
+    // repetitions to get measurable times for small data sets
+    const int repetitions = 10;
+
+    const SettingsSnapshot settings(*m_settings);
+    SaccadeDetector detector;
+    std::vector<GazeSection> sections;
+    std::vector<Trial*> allTrials = trials();
+    for (size_t i = 0; i < allTrials.size(); ++i)
+    {
+        std::vector<GazeSection> trialSections = detector.determineMicrosaccadeSections(
+                    allTrials[i], settings.m_gazeType, &settings.m_microsaccadeSettings);
+        sections.insert(sections.end(), trialSections.begin(), trialSections.end());
+    }
+
+    size_t samples = 0;
+    for (size_t i = 0; i < sections.size(); ++i)
+    {
+        samples += sections[i].m_size;
+    }
+
+    bool identical = true;
+    out << "WindowSize,#Samples,Generic[ms],Specialized[ms],Speedup,Identical" << std::endl;
+    for (size_t windowSize = 3; windowSize <= 11; windowSize += 2)
+    {
+        int size = int(windowSize - 1) / 2;
+        VelocityKernels::Kernel kernels[2] = {VelocityKernels::genericKernel,
+                                              VelocityKernels::kernel(windowSize)};
+        std::vector<std::vector<qreal> > results[2];
+        qint64 elapsedNs[2];
+
+        for (size_t k = 0; k < 2; ++k)
+        {
+            results[k].resize(sections.size());
+            for (size_t i = 0; i < sections.size(); ++i)
+            {
+                results[k][i] = std::vector<qreal>(sections[i].m_size, 0);
+            }
+
+            QElapsedTimer timer;
+            timer.start();
+            for (int r = 0; r < repetitions; ++r)
+            {
+                for (size_t i = 0; i < sections.size(); ++i)
+                {
+                    kernels[k](sections[i].m_x, results[k][i].data(), int(sections[i].m_size),
+                               size, 1.0 / 6.0);
+                }
+            }
+            elapsedNs[k] = timer.nsecsElapsed();
+        }
+
+        bool windowIdentical = results[0] == results[1];
+        identical = identical && windowIdentical;
+
+        out << windowSize << ","
+            << samples << ","
+            << elapsedNs[0] / 1e6 << ","
+            << elapsedNs[1] / 1e6 << ","
+            << (elapsedNs[1] > 0 ? qreal(elapsedNs[0]) / elapsedNs[1] : 0) << ","
+            << windowIdentical << std::endl;
+    }
+
+    return identical;
+}
+
+
+bool BatchProcessor::benchmarkExport(const QString& dir, std::ostream& out)
+{
+    QString fileNames[2] = {QDir::cleanPath(dir + QDir::separator() + "benchmark-stream." +
+                                            eyeTrackingDataFile),
+                            QDir::cleanPath(dir + QDir::separator() + "benchmark-buffered." +
+                                            eyeTrackingDataFile)};
+    qint64 elapsedNs[2];
+    std::string contents[2];
+
+    for (size_t k = 0; k < 2; ++k)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        std::ofstream file(fileNames[k].toStdString(), std::ios::out);
+        if (!file.is_open())
+        {
+            qWarning() << QString("File %1 can not be written").arg(fileNames[k]);
+            return false;
+        }
+        for (size_t i = 0; i < m_data.numberOfParticipants(); ++i)
+        {
+            Participant* participant = m_data.participantAt(int(i));
+            EyeDataWriter::writeHeader(*participant, file);
+            for (size_t j = 0; j < participant->numberOfTrials(); ++j)
+            {
+                if (k == 0)
+                {
+                    EyeDataWriter::writeTrialStream(*participant->getTrialAt(int(j)), file);
+                }
+                else
+                {
+                    EyeDataWriter::writeTrial(*participant->getTrialAt(int(j)), file);
+                }
+            }
+        }
+        file.close();
+        elapsedNs[k] = timer.nsecsElapsed();
+
+        std::ifstream in(fileNames[k].toStdString(), std::ios::in | std::ios::binary);
+        contents[k].assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        in.close();
+        QFile::remove(fileNames[k]);
+    }
+
+    bool identical = contents[0] == contents[1];
+    qreal sizeInMB = contents[1].size() / 1e6;
+
+    out << "Size[MB],Stream[ms],Buffered[ms],Stream[MB/s],Buffered[MB/s],Speedup,Identical"
+        << std::endl;
+    out << sizeInMB << ","
+        << elapsedNs[0] / 1e6 << ","
+        << elapsedNs[1] / 1e6 << ","
+        << (elapsedNs[0] > 0 ? sizeInMB / (elapsedNs[0] / 1e9) : 0) << ","
+        << (elapsedNs[1] > 0 ? sizeInMB / (elapsedNs[1] / 1e9) : 0) << ","
+        << (elapsedNs[1] > 0 ? qreal(elapsedNs[0]) / elapsedNs[1] : 0) << ","
+        << identical << std::endl;
+
+    return identical;
+}
+
+
+bool BatchProcessor::checkNumberFormat(const QString& localeName, std::ostream& out)
+{
+    // fixed and exponential notation, their boundaries, exact ties and special values
+    std::vector<qreal> values = {0, -0.0, 1, -1, 0.5, 1.5, 2.5, 12.125, 3.14159265358979,
+                                 0.0001, 0.00012345, 0.0000999999, 0.00001, -2.5e-7,
+                                 123456, 999999, 999999.5, 1e6, 1234567, -7654321.5, 1e300,
+                                 std::numeric_limits<qreal>::infinity(),
+                                 std::numeric_limits<qreal>::quiet_NaN()};
+
+    std::vector<Trial*> allTrials = trials();
+    std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
+    for (size_t i = 0; i < allTrials.size(); ++i)
+    {
+        for (size_t j = 0; j < gazeTypes.size(); ++j)
+        {
+            const QMap<int, GazeData>& g = allTrials[i]->gazeData(gazeTypes[j]);
+            for (QMap<int, GazeData>::const_iterator it = g.constBegin(); it != g.constEnd(); ++it)
+            {
+                values.push_back(it.value().getXPosition());
+                values.push_back(it.value().getYPosition());
+            }
+        }
+    }
+
+    std::string previousLocale = setlocale(LC_NUMERIC, nullptr);
+    if (setlocale(LC_NUMERIC, localeName.toLocal8Bit().constData()) == nullptr)
+    {
+        qWarning() << QString("Locale %1 is not available").arg(localeName);
+        return false;
+    }
+
+    std::ostringstream buffered;
+    {
+        OutputBuffer buffer(buffered, 4096);
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            buffer << values[i] << "\t";
+        }
+    }
+
+    setlocale(LC_NUMERIC, previousLocale.c_str());
+
+    std::ostringstream expected;
+    expected.imbue(std::locale::classic());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        expected << values[i] << "\t";
+    }
+
+    bool identical = buffered.str() == expected.str();
+    if (!identical)
+    {
+        std::string a = expected.str();
+        std::string b = buffered.str();
+        size_t position = size_t(std::mismatch(a.begin(), a.begin() + qMin(a.size(), b.size()),
+                                               b.begin()).first - a.begin());
+        qWarning() << QString("Number format differs at character %1: expected \"%2\", "
+                              "actual \"%3\"").arg(
+                          QString::number(position),
+                          QString::fromStdString(a.substr(position, 20)),
+                          QString::fromStdString(b.substr(position, 20)));
+    }
+
+    out << "Locale,#Values,Identical" << std::endl;
+    out << localeName.toStdString() << "," << values.size() << "," << identical << std::endl;
+
+    return identical;
+}
+
+
+bool BatchProcessor::runRegression(const QString& goldenFile, bool writeGolden,
+                                   std::ostream& out)
+{
+    DetectionRegression regression(m_settings);
+    std::vector<DetectionRegressionResult> results = regression.run(
+                trials(), {1, 2, std::max(1, QThread::idealThreadCount())});
+    DetectionRegression::writeCsv(results, out);
+
+    // results must not depend on the number of threads
+    bool identical = true;
+    QString errorString;
+    for (size_t i = 1; i < results.size(); ++i)
+    {
+        if (!DetectionRegression::compare(results[0].m_lines, results[i].m_lines, errorString))
+        {
+            qWarning() << QString("%1 threads differ from 1 thread: %2").arg(
+                              QString::number(results[i].m_threadCount), errorString);
+            identical = false;
+        }
+    }
+
+    if (writeGolden)
+    {
+        if (!DetectionRegression::writeGoldenFile(goldenFile, results[0].m_lines))
+        {
+            qWarning() << QString("File %1 can not be written").arg(goldenFile);
+            return false;
+        }
+        return identical;
+    }
+
+    QStringList expected;
+    if (!DetectionRegression::readGoldenFile(goldenFile, expected, errorString))
+    {
+        qWarning() << QString("File %1 can not be opened: %2").arg(goldenFile, errorString);
+        return false;
+    }
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        if (!DetectionRegression::compare(expected, results[i].m_lines, errorString))
+        {
+            qWarning() << QString("%1 threads differ from golden file: %2").arg(
+                              QString::number(results[i].m_threadCount), errorString);
+            identical = false;
+        }
+    }
+
+    return identical;
+}
+
+
+int BatchProcessor::writeEyeData(const QString& dir)
+{
+    // participants are written to their own files in parallel
+    std::vector<QPair<Participant*, QString> > files = EyeDataWriter::participantFiles(m_data,
+                                                                                        dir);
+    QAtomicInt failed(0);
+    QtConcurrent::blockingMap(files, [&failed](const QPair<Participant*, QString>& file)
+    {
+        if (!EyeDataWriter::writeParticipantFile(*file.first, file.second))
+        {
+            qWarning() << QString("File %1 can not be written").arg(file.second);
+            failed.fetchAndAddOrdered(1);
+        }
+    });
+
+    return failed.loadAcquire();
+}
+
+
+bool BatchProcessor::writeArrowData(const QString& dir, bool writeSamples)
+{
+    ArrowDataWriter writer(writeSamples);
+    if (!writer.open(dir))
+    {
+        qWarning() << QString("Arrow files can not be written to %1").arg(dir);
+        return false;
+    }
+
+    for (size_t i = 0; i < m_data.numberOfParticipants(); ++i)
+    {
+        writer.writeParticipant(*m_data.participantAt(int(i)));
+    }
+
+    if (!writer.close())
+    {
+        qWarning() << QString("Arrow files can not be written to %1").arg(dir);
+        return false;
+    }
+    return true;
+}
+
+
+bool BatchProcessor::writeSession(const QString& dir)
+{
+    QString fileName = QDir::cleanPath(dir + QDir::separator() + "session." + studySessionFile);
+
+    QString errorString;
+    if (!SessionFile::write(fileName, m_data, m_settings->m_testConditions.keys(), errorString))
+    {
+        qWarning() << QString("File %1 can not be written: %2").arg(fileName, errorString);
+        return false;
+    }
+    return true;
+}
+
+
+bool BatchProcessor::writeEventLockedRate(const QString& dir, const QString& eventName)
+{
+    QString fileName = QDir::cleanPath(dir + QDir::separator() + "eventLockedRate." +
+                                       EventLockedRateFile);
+
+    // same default parameters as in the user interface (EventLockedRateExport)
+    EventLockedRate analysis(eventName, 500, 1000, 50, 100, 10, m_settings->m_gazeType);
+    std::vector<EventLockedRateGroup> groups = analysis.run(trials());
+    if (groups.empty())
+    {
+        qWarning() << QString("No events with the name %1").arg(eventName);
+    }
+
+    if (!analysis.writeCsv(groups, fileName))
+    {
+        qWarning() << QString("File %1 can not be written").arg(fileName);
+        return false;
+    }
+    return true;
+}
+
+
+QString BatchProcessor::writeStatistics(const QString& dir, int valueType, bool directionalData)
+{
+    AggregatedStatistics statistics(&m_data, m_settings, directionalData);
+
+    // create sub directory
+    QString dirName = AggregatedStatistics::subDirPath(dir);
+    if (!QDir().mkdir(dirName))
+    {
+        qWarning() << QString("Directory %1 can not be created").arg(dirName);
+        return QString();
+    }
+
+    std::vector<int> dataTypes;
+    for (int i = 0; i < statistics.dataTypes().size(); ++i)
+    {
+        dataTypes.push_back(i);
+    }
+
+    if (!statistics.exportToDirectory(dirName, dataTypes, valueType))
+    {
+        return QString();
+    }
+
+    return dirName;
+}
+
+
+EyeTrackingData* BatchProcessor::data()
+{
+    return &m_data;
+}
+
+
+std::vector<Trial*> BatchProcessor::trials()
+{
+    std::vector<Trial*> result;
+    for (size_t i = 0; i < m_data.numberOfParticipants(); ++i)
+    {
+        Participant* participant = m_data.participantAt(int(i));
+        for (size_t j = 0; j < participant->numberOfTrials(); ++j)
+        {
+            result.push_back(participant->getTrialAt(int(j)));
+        }
+    }
+    return result;
+}
+
+
+void BatchProcessor::detectTrial(Trial* trial, const SettingsSnapshot& settings)
+{
+    SaccadeDetector detector;
+
+    trial->updateFixationSettings(settings.m_fixationSettings);
+
+    if (settings.m_fixationSettings.m_fromInputFile)
+    {
+        trial->setUseFixationsFromInput(true);
+    }
+    else
+    {
+        trial->setUseFixationsFromInput(false);
+
+        if (!detector.detectFixations(trial, settings))
+        {
+            qWarning() << QString("Participant %1, Trial %2: invalid fixation settings").arg(
+                              trial->getParticipant()->name(), trial->name());
+            return;
+        }
+    }
+
+    trial->updateMicrosaccadesSettings(settings.m_microsaccadeSettings);
+
+    if (!settings.m_microsaccadeSettings.m_fromInputFile)
+    {
+        detector.detectMicrosaccades(trial, settings);
+    }
+}
@@ -0,0 +1,305 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file detectionregression.cpp
+ **************************************************************************************************/
+#define _USE_MATH_DEFINES
+#include "detectionregression.h"
+#include "saccadedetector.h"
+#include "trial.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMap>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+
+DetectionRegression::DetectionRegression(Settings* settings) :
+    m_settings(settings)
+{}
+
+
+Participant* DetectionRegression::createSyntheticParticipant(int trialCount)
+{
+    Participant* participant = new Participant("synthetic");
+    participant->setName("synthetic");
+    participant->setPixelsPerDegree(35);
+
+    for (int t = 0; t < trialCount; ++t)
+    {
+        // the data of a trial only depends on its index; the distributions of the standard
+        // library are implementation defined, therefore they are computed here
+        std::mt19937 rng(static_cast<unsigned int>(t));
+        auto uniform = [&rng]() { return (rng() + 0.5) / 4294967296.0; };
+        auto noise = [&uniform]()
+        {
+            // Box-Muller transform
+            qreal u1 = uniform();
+            qreal u2 = uniform();
+            return 0.4 * sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+        };
+
+        Trial trial(participant, m_settings);
+        trial.setName(QString("synthetic_%1").arg(t));
+        trial.setFrequencyRate(t % 2 == 0 ? 500 : 1000);
+
+        QMap<int, GazeData> gazeData[3]; // right, left, average
+        qreal x[2] = {500, 500};
+        qreal y[2] = {400, 400};
+        qreal vx[2] = {0, 0};
+        qreal vy[2] = {0, 0};
+        int samplesLeft[2] = {0, 0};
+
+        int N = 4000 + (t % 5) * 1000;
+        for (int i = 0; i < N; ++i)
+        {
+            // start of a (micro)saccade, the left eye is sometimes delayed
+            if (samplesLeft[0] == 0 && uniform() < 0.01)
+            {
+                int length = 4 + int(uniform() * 20);
+                qreal angle = uniform() * 2 * M_PI;
+                qreal amplitude = (uniform() < 0.7 ? 0.3 : 3.0) * participant->getPixelsPerDegree();
+                for (int e = 0; e < 2; ++e)
+                {
+                    samplesLeft[e] = length + (e == 1 && uniform() < 0.3 ? 3 : 0);
+                    vx[e] = cos(angle) * amplitude / length;
+                    vy[e] = sin(angle) * amplitude / length;
+                }
+            }
+
+            for (int e = 0; e < 2; ++e)
+            {
+                if (samplesLeft[e] > 0)
+                {
+                    x[e] += vx[e];
+                    y[e] += vy[e];
+                    samplesLeft[e]--;
+                }
+                // drift
+                x[e] += noise() * 0.5;
+                y[e] += noise() * 0.5;
+            }
+
+            // blinks and single missing samples
+            if (i % 1300 > 1250 || uniform() < 0.002)
+            {
+                continue;
+            }
+
+            GazeData right;
+            GazeData left;
+            GazeData average;
+            right.setXPosition(x[0] + noise());
+            right.setYPosition(y[0] + noise());
+            left.setXPosition(x[1] + noise());
+            left.setYPosition(y[1] + noise());
+            average.setXPosition((right.getXPosition() + left.getXPosition()) / 2);
+            average.setYPosition((right.getYPosition() + left.getYPosition()) / 2);
+
+            gazeData[0].insert(i, right);
+            gazeData[1].insert(i, left);
+            gazeData[2].insert(i, average);
+        }
+
+        trial.setGazeData(gazeData[0], GazeType::GT_Right);
+        trial.setGazeData(gazeData[1], GazeType::GT_Left);
+        trial.setGazeData(gazeData[2], GazeType::GT_Average);
+
+        participant->addTrial(trial);
+    }
+
+    return participant;
+}
+
+
+std::vector<DetectionRegressionResult> DetectionRegression::run(
+        const std::vector<Trial*>& trials, const std::vector<int>& threadCounts)
+{
+    std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
+
+    // gaze runs are determined once before the measurements
+    size_t samples = 0;
+    for (size_t i = 0; i < trials.size(); ++i)
+    {
+        for (size_t j = 0; j < gazeTypes.size(); ++j)
+        {
+            samples += trials[i]->gazeRuns(gazeTypes[j])->m_index.size();
+        }
+    }
+
+    // all runs use the same settings, also if the global settings are changed meanwhile
+    const SettingsSnapshot settings(*m_settings);
+
+    QThreadPool* pool = QThreadPool::globalInstance();
+    int maxThreadCount = pool->maxThreadCount();
+
+    std::vector<DetectionRegressionResult> results;
+    for (size_t c = 0; c < threadCounts.size(); ++c)
+    {
+        pool->setMaxThreadCount(threadCounts[c]);
+
+        for (size_t i = 0; i < trials.size(); ++i)
+        {
+            trials[i]->microsaccadeCandidates()->clear();
+            trials[i]->saccadeCandidates()->clear();
+        }
+
+        // results are stored per trial and joined in trial order afterwards
+        std::vector<QPair<Trial*, QStringList> > trialResults;
+        for (size_t i = 0; i < trials.size(); ++i)
+        {
+            trialResults.push_back(qMakePair(trials[i], QStringList()));
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QtConcurrent::blockingMap(trialResults,
+                                  [this, &settings](QPair<Trial*, QStringList>& trialResult)
+        {
+            trialResult.second = trialLines(trialResult.first, settings);
+        });
+
+        DetectionRegressionResult result;
+        result.m_threadCount = threadCounts[c];
+        result.m_samples = samples;
+        result.m_elapsedNs = timer.nsecsElapsed();
+        for (size_t i = 0; i < trialResults.size(); ++i)
+        {
+            result.m_lines << trialResults[i].second;
+        }
+
+        qDebug() << QString("Regression: %1 threads: %2 ms").arg(
+                        QString::number(result.m_threadCount),
+                        QString::number(result.m_elapsedNs / 1e6));
+
+        results.push_back(result);
+    }
+
+    pool->setMaxThreadCount(maxThreadCount);
+
+    return results;
+}
+
+
+bool DetectionRegression::compare(const QStringList& expected, const QStringList& actual,
+                                  QString& errorString)
+{
+    for (int i = 0; i < std::min(expected.size(), actual.size()); ++i)
+    {
+        if (expected[i] != actual[i])
+        {
+            errorString = QString("Line %1: expected \"%2\", actual \"%3\"").arg(
+                              QString::number(i + 1), expected[i], actual[i]);
+            return false;
+        }
+    }
+
+    if (expected.size() != actual.size())
+    {
+        errorString = QString("Expected %1 lines, actual %2 lines").arg(
+                          QString::number(expected.size()), QString::number(actual.size()));
+        return false;
+    }
+
+    return true;
+}
+
+
+bool DetectionRegression::readGoldenFile(const QString& fileName, QStringList& lines,
+                                         QString& errorString)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        errorString = file.errorString();
+        return false;
+    }
+
+    while (!file.atEnd())
+    {
+        QString line = file.readLine();
+        line = line.trimmed();
+
+        if (!line.isEmpty())
+        {
+            lines.append(line);
+        }
+    }
+
+    file.close();
+
+    return true;
+}
+
+
+bool DetectionRegression::writeGoldenFile(const QString& fileName, const QStringList& lines)
+{
+    std::ofstream out(fileName.toStdString(), std::ios::out);
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        out << lines[i].toStdString() << std::endl;
+    }
+
+    out.close();
+    return true;
+}
+
+
+void DetectionRegression::writeCsv(const std::vector<DetectionRegressionResult>& results,
+                                   std::ostream& out)
+{
+    out << "Threads,#Samples,Detection[ms],Samples/s" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const DetectionRegressionResult& r = results[i];
+        out << r.m_threadCount << ","
+            << r.m_samples << ","
+            << r.m_elapsedNs / 1e6 << ","
+            << (r.m_elapsedNs > 0 ? r.m_samples / (r.m_elapsedNs / 1e9) : 0) << std::endl;
+    }
+}
+
+
+QStringList DetectionRegression::trialLines(Trial* trial, const SettingsSnapshot& settings)
+{
+    SaccadeDetector detector;
+    std::vector<std::vector<Saccade> > saccades[2] = {
+        detector.determineMicrosaccades(trial, settings),
+        detector.determineRegularSaccades(trial, settings)};
+    QString types[2] = {"MS", "S"};
+
+    QStringList lines;
+    for (size_t t = 0; t < 2; ++t)
+    {
+        for (size_t g = 0; g < saccades[t].size(); ++g)
+        {
+            for (size_t i = 0; i < saccades[t][g].size(); ++i)
+            {
+                const Saccade& s = saccades[t][g][i];
+                lines << QStringList({trial->getParticipant()->name(),
+                                      trial->name(),
+                                      types[t],
+                                      QString::number(g),
+                                      QString::number(s.getOnsetIndex()),
+                                      QString::number(s.getEndIndex()),
+                                      QString::number(s.getPeakVelocity(), 'g', 17),
+                                      QString::number(s.getHorizontalAmplitude(), 'g', 17),
+                                      QString::number(s.getVerticalAmplitude(), 'g', 17)}
+                                     ).join(",");
+            }
+        }
+    }
+
+    return lines;
+}
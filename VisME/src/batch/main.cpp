@@ -0,0 +1,318 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file main.cpp
+ *
+ * Command line tool (visme-batch) to detect fixations and microsaccades without user interface.
+ **************************************************************************************************/
+#include "aggregatedstatistics.h"
+#include "batchprocessor.h"
+#include "settingsreader.h"
+#include <iostream>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+
+
+// returns the index of the given value type name (see AggregatedStatistics) or -1
+static int valueTypeIndex(const QString& name, bool directionalData)
+{
+    AggregatedStatistics statistics(nullptr, nullptr, directionalData);
+    return statistics.valueTypes().indexOf(name.toLower());
+}
+
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("visme-batch");
+    QCoreApplication::setApplicationVersion("1.0");
+
+    QCommandLineParser cmd;
+    cmd.setApplicationDescription(QCoreApplication::translate(
+        "main", "Detects fixations and microsaccades of VisME eye tracking data files and "
+                "exports the results and aggregated statistics."));
+    cmd.addHelpOption();
+    cmd.addVersionOption();
+    cmd.addPositionalArgument("files", QCoreApplication::translate(
+        "main", "Eye tracking data files (.maf)."), "files...");
+
+    QCommandLineOption microsaccadeSettingsOption(
+                QStringList() << "m" << "microsaccade-settings",
+                QCoreApplication::translate("main", "Microsaccade parameter file (.mpf)."), "file");
+    QCommandLineOption fixationSettingsOption(
+                QStringList() << "f" << "fixation-settings",
+                QCoreApplication::translate("main", "Fixation parameter file (.fpf)."), "file");
+    QCommandLineOption testConditionsOption(
+                QStringList() << "c" << "test-conditions",
+                QCoreApplication::translate("main", "Test condition file (.csv)."), "file");
+    QCommandLineOption gazeTypeOption(
+                QStringList() << "g" << "gaze-type",
+                QCoreApplication::translate("main", "Gaze type for statistics: right, left, "
+                                                    "average (default)."), "type", "average");
+    QCommandLineOption outputOption(
+                QStringList() << "o" << "output",
+                QCoreApplication::translate("main", "Output directory."), "dir");
+    QCommandLineOption statisticsOption(
+                QStringList() << "s" << "statistics",
+                QCoreApplication::translate("main", "Aggregated statistics: min, max, mean "
+                                                    "(default), median, sum, \"single values\"."),
+                "value", "mean");
+    QCommandLineOption directionalStatisticsOption(
+                QStringList() << "d" << "directional-statistics",
+                QCoreApplication::translate("main", "Also export directional statistics: mean, "
+                                                    "\"single values\"."), "value");
+    QCommandLineOption arrowOption(
+                QStringList() << "arrow",
+                QCoreApplication::translate("main", "Also export fixations, microsaccades and "
+                                                    "saccades of all trials as Apache Arrow "
+                                                    "files (.arrow)."));
+    QCommandLineOption arrowSamplesOption(
+                QStringList() << "arrow-samples",
+                QCoreApplication::translate("main", "Also export the raw samples with --arrow."));
+    QCommandLineOption sessionOption(
+                QStringList() << "session",
+                QCoreApplication::translate("main", "Also save all participants and detection "
+                                                    "results as study session (session.vms) "
+                                                    "for the user interface."));
+    QCommandLineOption eventLockedRateOption(
+                QStringList() << "event-locked",
+                QCoreApplication::translate("main", "Also export microsaccade rates aligned to "
+                                                    "the events with the given name "
+                                                    "(eventLockedRate.csv)."), "event");
+    QCommandLineOption resampleOption(
+                QStringList() << "r" << "resample",
+                QCoreApplication::translate("main", "Resample all trials to the given sampling "
+                                                    "rate before the detection."), "Hz");
+    QCommandLineOption compareAlgorithmsOption(
+                QStringList() << "b" << "benchmark-algorithms",
+                QCoreApplication::translate("main", "Compare all microsaccade detection algorithms "
+                                                    "on the same data and print counts and run "
+                                                    "times (csv)."));
+    QCommandLineOption compareStreamingOption(
+                QStringList() << "compare-streaming",
+                QCoreApplication::translate("main", "Replay all trials through the streaming "
+                                                    "microsaccade detector, compare with the "
+                                                    "batch detection and print the agreement "
+                                                    "(csv); fails if a trial agrees less than "
+                                                    "the given fraction (0 to 1)."), "agreement");
+    QCommandLineOption benchmarkVelocityOption(
+                QStringList() << "benchmark-velocity",
+                QCoreApplication::translate("main", "Compare the generic and the specialized "
+                                                    "velocity kernels and print run times (csv)."));
+    QCommandLineOption benchmarkExportOption(
+                QStringList() << "benchmark-export",
+                QCoreApplication::translate("main", "Compare the buffered and the stream based "
+                                                    ".maf writer after the detection and print "
+                                                    "the throughput (csv)."));
+    QCommandLineOption checkNumberFormatOption(
+                QStringList() << "check-number-format",
+                QCoreApplication::translate("main", "Check that the buffered .maf writer formats "
+                                                    "numbers like the classic locale while "
+                                                    "LC_NUMERIC is set to the given locale, e.g., "
+                                                    "de_DE.UTF-8 (csv)."), "locale");
+    QCommandLineOption syntheticTrialsOption(
+                QStringList() << "synthetic-trials",
+                QCoreApplication::translate("main", "Add a participant with the given number of "
+                                                    "synthetic trials."), "count");
+    QCommandLineOption regressionOption(
+                QStringList() << "regression",
+                QCoreApplication::translate("main", "Run the detection with 1, 2 and all threads, "
+                                                    "compare the results with the golden file and "
+                                                    "print the throughput (csv); no output is "
+                                                    "written."), "file");
+    QCommandLineOption writeGoldenOption(
+                QStringList() << "write-golden",
+                QCoreApplication::translate("main", "Write the golden file of --regression "
+                                                    "instead of comparing with it."));
+
+    cmd.addOption(microsaccadeSettingsOption);
+    cmd.addOption(fixationSettingsOption);
+    cmd.addOption(testConditionsOption);
+    cmd.addOption(gazeTypeOption);
+    cmd.addOption(outputOption);
+    cmd.addOption(statisticsOption);
+    cmd.addOption(directionalStatisticsOption);
+    cmd.addOption(arrowOption);
+    cmd.addOption(arrowSamplesOption);
+    cmd.addOption(sessionOption);
+    cmd.addOption(eventLockedRateOption);
+    cmd.addOption(resampleOption);
+    cmd.addOption(compareAlgorithmsOption);
+    cmd.addOption(compareStreamingOption);
+    cmd.addOption(benchmarkVelocityOption);
+    cmd.addOption(benchmarkExportOption);
+    cmd.addOption(checkNumberFormatOption);
+    cmd.addOption(syntheticTrialsOption);
+    cmd.addOption(regressionOption);
+    cmd.addOption(writeGoldenOption);
+    cmd.process(app);
+
+    const QStringList files = cmd.positionalArguments();
+    bool regression = cmd.isSet(regressionOption);
+    if ((files.isEmpty() && !cmd.isSet(syntheticTrialsOption)) ||
+            (!regression && !cmd.isSet(outputOption)))
+    {
+        cmd.showHelp(1);
+    }
+
+    Settings settings;
+
+    QString errorString;
+    if (cmd.isSet(microsaccadeSettingsOption) &&
+            !SettingsReader::readMicrosaccadeSettings(cmd.value(microsaccadeSettingsOption),
+                                                      *settings.m_microsaccadeSettings,
+                                                      errorString))
+    {
+        qCritical() << QString("File %1 can not be opened: %2").arg(
+                           cmd.value(microsaccadeSettingsOption), errorString);
+        return 1;
+    }
+    if (cmd.isSet(fixationSettingsOption) &&
+            !SettingsReader::readFixationSettings(cmd.value(fixationSettingsOption),
+                                                  *settings.m_fixationSettings, errorString))
+    {
+        qCritical() << QString("File %1 can not be opened: %2").arg(
+                           cmd.value(fixationSettingsOption), errorString);
+        return 1;
+    }
+
+    QString gazeType = cmd.value(gazeTypeOption).toLower();
+    if (gazeType == "right")
+    {
+        settings.m_gazeType = GT_Right;
+    }
+    else if (gazeType == "left")
+    {
+        settings.m_gazeType = GT_Left;
+    }
+    else if (gazeType == "average")
+    {
+        settings.m_gazeType = GT_Average;
+    }
+    else
+    {
+        qCritical() << QString("Unknown gaze type %1").arg(gazeType);
+        return 1;
+    }
+
+    int valueType = valueTypeIndex(cmd.value(statisticsOption), false);
+    int directionalValueType = cmd.isSet(directionalStatisticsOption) ?
+                valueTypeIndex(cmd.value(directionalStatisticsOption), true) : -1;
+    if (valueType < 0 || (cmd.isSet(directionalStatisticsOption) && directionalValueType < 0))
+    {
+        qCritical() << "Unknown statistics value";
+        return 1;
+    }
+
+    BatchProcessor processor(&settings);
+    int failed = processor.loadFiles(files);
+
+    if (cmd.isSet(syntheticTrialsOption))
+    {
+        processor.addSyntheticTrials(cmd.value(syntheticTrialsOption).toInt());
+    }
+
+    if (cmd.isSet(resampleOption))
+    {
+        int frequency = cmd.value(resampleOption).toInt();
+        if (frequency <= 0)
+        {
+            qCritical() << QString("Invalid sampling rate %1").arg(cmd.value(resampleOption));
+            return 1;
+        }
+        failed += processor.resample(frequency);
+    }
+
+    if (cmd.isSet(testConditionsOption) &&
+            !processor.loadTestConditions(cmd.value(testConditionsOption)))
+    {
+        failed++;
+    }
+
+    if (cmd.isSet(checkNumberFormatOption) &&
+            !processor.checkNumberFormat(cmd.value(checkNumberFormatOption), std::cout))
+    {
+        qCritical() << "Buffered writer depends on the locale";
+        failed++;
+    }
+
+    if (regression)
+    {
+        if (!processor.runRegression(cmd.value(regressionOption), cmd.isSet(writeGoldenOption),
+                                     std::cout))
+        {
+            failed++;
+        }
+        return failed == 0 ? 0 : 1;
+    }
+
+    QString outputDir = cmd.value(outputOption);
+    if (!QDir().mkpath(outputDir))
+    {
+        qCritical() << QString("Directory %1 can not be created").arg(outputDir);
+        return 1;
+    }
+
+    if (cmd.isSet(benchmarkVelocityOption) && !processor.benchmarkVelocityKernels(std::cout))
+    {
+        qCritical() << "Velocity kernels lead to different results";
+        failed++;
+    }
+
+    if (cmd.isSet(compareAlgorithmsOption))
+    {
+        processor.compareAlgorithms(std::cout);
+    }
+
+    if (cmd.isSet(compareStreamingOption))
+    {
+        bool ok = false;
+        qreal minAgreement = cmd.value(compareStreamingOption).toDouble(&ok);
+        if (!ok || minAgreement < 0 || minAgreement > 1)
+        {
+            qCritical() << QString("Invalid agreement %1").arg(cmd.value(compareStreamingOption));
+            return 1;
+        }
+        if (!processor.compareStreaming(minAgreement, std::cout))
+        {
+            qCritical() << "Streaming detection differs from the batch detection";
+            failed++;
+        }
+    }
+
+    processor.detect();
+
+    if (cmd.isSet(benchmarkExportOption) && !processor.benchmarkExport(outputDir, std::cout))
+    {
+        qCritical() << "Writers lead to different files";
+        failed++;
+    }
+
+    failed += processor.writeEyeData(outputDir);
+    if (cmd.isSet(arrowOption) &&
+            !processor.writeArrowData(outputDir, cmd.isSet(arrowSamplesOption)))
+    {
+        failed++;
+    }
+    if (cmd.isSet(sessionOption) && !processor.writeSession(outputDir))
+    {
+        failed++;
+    }
+    if (cmd.isSet(eventLockedRateOption) &&
+            !processor.writeEventLockedRate(outputDir, cmd.value(eventLockedRateOption)))
+    {
+        failed++;
+    }
+    if (processor.writeStatistics(outputDir, valueType, false).isEmpty())
+    {
+        failed++;
+    }
+    if (directionalValueType >= 0 &&
+            processor.writeStatistics(outputDir, directionalValueType, true).isEmpty())
+    {
+        failed++;
+    }
+
+    return failed == 0 ? 0 : 1;
+}
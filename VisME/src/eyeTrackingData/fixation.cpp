@@ -5,8 +5,8 @@
 #include "fixation.h"
 
 
-Fixation::Fixation(Settings* settings) :
-    m_settings(settings), m_xPosition(0), m_yPosition(0),
+Fixation::Fixation() :
+    m_xPosition(0), m_yPosition(0),
     m_startIndex(0), m_duration(0), m_marked(false)
 {}
 
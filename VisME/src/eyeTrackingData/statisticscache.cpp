@@ -0,0 +1,59 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file statisticscache.cpp
+ **************************************************************************************************/
+#include "statisticscache.h"
+#include <QMutexLocker>
+
+
+QSharedPointer<StatisticsTable> StatisticsCache::table(const std::vector<Trial*>& trials,
+                                                       const SettingsSnapshot& settings,
+                                                       bool limitTimeRange,
+                                                       const CancellationToken& cancellation)
+{
+    QSharedPointer<StatisticsTable> table(new StatisticsTable(settings, limitTimeRange));
+    int group = table->addGroup();
+
+    for (size_t i = 0; i < trials.size(); ++i)
+    {
+        if (cancellation.isCanceled())
+        {
+            return QSharedPointer<StatisticsTable>();
+        }
+
+        Trial* trial = trials[i];
+
+        QSharedPointer<const StatisticsTable> trialTable;
+        {
+            QMutexLocker locker(&m_mutex);
+            QHash<Trial*, TrialStatistics>::const_iterator it = m_trials.constFind(trial);
+            if (it != m_trials.constEnd() && it->m_revision == trial->revision() &&
+                    it->m_table->computesSameValues(settings, limitTimeRange))
+            {
+                trialTable = it->m_table;
+            }
+        }
+
+        // the metrics are computed without lock, only the trial is read
+        if (trialTable.isNull())
+        {
+            QSharedPointer<StatisticsTable> newTable(new StatisticsTable(settings, limitTimeRange));
+            newTable->addTrial(trial, newTable->addGroup());
+            trialTable = newTable;
+
+            QMutexLocker locker(&m_mutex);
+            m_trials.insert(trial, {trial->revision(), trialTable});
+        }
+
+        table->addValues(group, *trialTable, 0);
+    }
+
+    return table;
+}
+
+
+void StatisticsCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_trials.clear();
+}
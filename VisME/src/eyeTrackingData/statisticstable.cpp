@@ -0,0 +1,225 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file statisticstable.cpp
+ **************************************************************************************************/
+#include "fixation.h"
+#include "statisticstable.h"
+#include <algorithm>
+#include <iterator>
+#include <QMap>
+
+
+StatisticsTable::StatisticsTable(const SettingsSnapshot& settings, bool limitTimeRange) :
+    m_settings(settings),
+    m_limitTimeRange(limitTimeRange && settings.m_limitTimeRange)
+{}
+
+
+int StatisticsTable::addGroup()
+{
+    m_columns.push_back(std::vector<std::vector<qreal> >(SM_Count));
+    m_trialCounts.push_back(0);
+    if (m_settings.m_approximateQuantiles)
+    {
+        m_sketches.push_back(std::vector<QuantileSketch>(SM_Count));
+    }
+    return int(m_columns.size()) - 1;
+}
+
+
+void StatisticsTable::addTrial(Trial* trial, int group)
+{
+    std::vector<std::vector<qreal> >& columns = m_columns[size_t(group)];
+    m_trialCounts[size_t(group)]++;
+
+    std::vector<size_t> previousSizes(columns.size());
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        previousSizes[i] = columns[i].size();
+    }
+
+    GazeType gazeType = m_settings.m_gazeType;
+    bool fromInput = m_settings.m_microsaccadeSettings.m_fromInputFile;
+
+    // bounds of the time range are resolved once for all samples and fixations of the trial
+    TimeLimit limit = m_limitTimeRange ? trial->timeLimit(m_settings) : TimeLimit();
+
+    int gazeDataSamples = 0;
+    int trialDuration = 0;
+    if (limit.m_active)
+    {
+        const QMap<int, GazeData> g = trial->gazeData(gazeType);
+        gazeDataSamples = int(std::distance(limit.begin(g), limit.end(g)));
+
+        trialDuration = std::min(limit.m_end, trial->lastIndex(gazeType)) -
+                        std::max(limit.m_start, trial->firstIndex(gazeType)) + 1;
+    }
+    else
+    {
+        gazeDataSamples = int(trial->gazeDataCount(gazeType));
+        trialDuration = trial->duration(gazeType);
+    }
+
+    // single pass over all fixations and microsaccades of the trial
+    int fixationDuration = 0;
+    int fixWithMS = 0;
+    int msCountSum = 0;
+    int fixSum = 0;
+    for (int j = 0; j < trial->fixationsCount(gazeType); ++j)
+    {
+        Fixation* fixation = trial->getFixationAt(j, gazeType);
+        if (limit.outside(fixation->getStartIndex(), fixation->getEndIndex()))
+        {
+            continue;
+        }
+
+        fixationDuration += fixation->getDuration();
+
+        int msCount = int(fixation->getMicrosaccadesCount(fromInput));
+        Saccade* prevMS = nullptr;
+        for (int k = 0; k < msCount; ++k)
+        {
+            Saccade* ms = fixation->getMicrosaccadeAt(size_t(k), fromInput);
+
+            columns[SM_MSAmplitude].push_back(ms->getAmplitude());
+            columns[SM_MSDuration].push_back(trial->samplesToTime(int(ms->getDuration())));
+            columns[SM_MSPeakVelocity].push_back(ms->getPeakVelocity());
+
+            if (k > 0)
+            {
+                columns[SM_IntersaccadicInterval].push_back(
+                            trial->samplesToTime(int(ms->getOnsetIndex() - prevMS->getEndIndex())));
+            }
+            prevMS = ms;
+        }
+
+        qreal durationInSec = trial->samplesToTime(fixation->getDuration()) / 1000.0;
+        if (msCount > 0)
+        {
+            columns[SM_FixationWithMSDuration].push_back(durationInSec);
+            columns[SM_MSPerFixationWithMS].push_back(msCount);
+            fixWithMS++;
+        }
+        columns[SM_FixationDuration].push_back(durationInSec);
+        columns[SM_MSPerFixation].push_back(msCount);
+
+        msCountSum += msCount;
+        fixSum++;
+    }
+
+    columns[SM_RawDataSamples].push_back(gazeDataSamples);
+    columns[SM_TrialDuration].push_back(trial->samplesToTime(trialDuration) / 1000.0);
+    columns[SM_FixationCount].push_back(fixSum);
+    columns[SM_FixationWithMSCount].push_back(fixWithMS);
+    columns[SM_FixationWithMSPercentage].push_back(
+                qreal(fixWithMS) / qreal(trial->fixationsCount(gazeType)) * 100);
+    columns[SM_MSCount].push_back(msCountSum);
+    columns[SM_MSPerSecond].push_back(msCountSum / trial->samplesToTime(trialDuration) * 1000.0);
+    columns[SM_MSPerSecondInFixations].push_back(
+                fixationDuration <= 0 ? 0 : msCountSum / trial->samplesToTime(fixationDuration) *
+                                            1000.0);
+
+    if (m_settings.m_approximateQuantiles)
+    {
+        std::vector<QuantileSketch>& sketches = m_sketches[size_t(group)];
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            for (size_t j = previousSizes[i]; j < columns[i].size(); ++j)
+            {
+                sketches[i].add(columns[i][j]);
+            }
+        }
+    }
+}
+
+
+void StatisticsTable::addValues(int group, const StatisticsTable& other, int otherGroup)
+{
+    std::vector<std::vector<qreal> >& columns = m_columns[size_t(group)];
+    const std::vector<std::vector<qreal> >& otherColumns = other.m_columns[size_t(otherGroup)];
+    for (size_t i = 0; i < columns.size(); ++i)
+    {
+        columns[i].insert(columns[i].end(), otherColumns[i].begin(), otherColumns[i].end());
+    }
+    m_trialCounts[size_t(group)] += other.m_trialCounts[size_t(otherGroup)];
+
+    if (m_settings.m_approximateQuantiles)
+    {
+        std::vector<QuantileSketch>& sketches = m_sketches[size_t(group)];
+        for (size_t i = 0; i < sketches.size(); ++i)
+        {
+            if (other.m_settings.m_approximateQuantiles)
+            {
+                sketches[i].merge(other.m_sketches[size_t(otherGroup)][i]);
+            }
+            else
+            {
+                for (size_t j = 0; j < otherColumns[i].size(); ++j)
+                {
+                    sketches[i].add(otherColumns[i][j]);
+                }
+            }
+        }
+    }
+}
+
+
+bool StatisticsTable::computesSameValues(const SettingsSnapshot& settings,
+                                         bool limitTimeRange) const
+{
+    bool limit = limitTimeRange && settings.m_limitTimeRange;
+    return m_settings.m_gazeType == settings.m_gazeType &&
+           m_settings.m_microsaccadeSettings.m_fromInputFile ==
+           settings.m_microsaccadeSettings.m_fromInputFile &&
+           m_settings.m_approximateQuantiles == settings.m_approximateQuantiles &&
+           m_limitTimeRange == limit &&
+           (!limit || (m_settings.m_startTimeInMSec == settings.m_startTimeInMSec &&
+                       m_settings.m_endTimeInMSec == settings.m_endTimeInMSec));
+}
+
+
+int StatisticsTable::numberOfGroups() const
+{
+    return int(m_columns.size());
+}
+
+
+size_t StatisticsTable::trialCount(int group) const
+{
+    return m_trialCounts[size_t(group)];
+}
+
+
+const std::vector<qreal>& StatisticsTable::values(int group, StatisticsMetric metric) const
+{
+    return m_columns[size_t(group)][metric];
+}
+
+
+QuantileSketch::Estimate StatisticsTable::quantile(int group, StatisticsMetric metric,
+                                                   qreal p) const
+{
+    if (m_settings.m_approximateQuantiles)
+    {
+        return m_sketches[size_t(group)][metric].quantile(p);
+    }
+
+    QuantileSketch::Estimate estimate = {0, 0};
+    estimate.m_value = QuantileSketch::exactQuantile(values(group, metric), p);
+    return estimate;
+}
+
+
+qreal StatisticsTable::rankError(int group) const
+{
+    qreal error = 0;
+    if (m_settings.m_approximateQuantiles)
+    {
+        const std::vector<QuantileSketch>& sketches = m_sketches[size_t(group)];
+        for (size_t i = 0; i < sketches.size(); ++i)
+        {
+            error = std::max(error, sketches[i].rankError());
+        }
+    }
+    return error;
+}
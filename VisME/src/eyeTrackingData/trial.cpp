@@ -2,11 +2,23 @@
  * @author Tanja Munz
  * @file trial.cpp
  **************************************************************************************************/
+#include "gapinterpolation.h"
+#include "prefilter.h"
 #include "settings.h"
+#include "settingssnapshot.h"
 #include "trial.h"
 #include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <QAtomicInt>
+
+
+// returns a new revision which is unique for all trials, trials are also changed by parallel jobs
+static int nextRevision()
+{
+    static QAtomicInt revisions(0);
+    return revisions.fetchAndAddOrdered(1) + 1;
+}
 
 
 Trial::Trial(Participant* p, Settings* settings) :
@@ -15,7 +27,8 @@ Trial::Trial(Participant* p, Settings* settings) :
     m_settings(settings),
     m_useFixationsFromInput(true),
     m_microsaccadeSettings(nullptr),
-    m_fixationSettings(nullptr)
+    m_fixationSettings(nullptr),
+    m_revision(nextRevision())
 {}
 
 
@@ -41,6 +54,10 @@ qreal Trial::frequencyRate() const
 void Trial::setFrequencyRate(qreal frequencyRate)
 {
     m_frequencyRate = frequencyRate;
+    m_revision = nextRevision();
+
+    m_microsaccadeCandidates.clear();
+    m_saccadeCandidates.clear();
 }
 
 
@@ -134,6 +151,16 @@ void Trial::setGazeData(const QMap<int, GazeData> gazeData, GazeType gazeType)
     {
         m_gazeDataAverage = gazeData;
     }
+
+    m_revision = nextRevision();
+    m_microsaccadeCandidates.clear();
+    m_saccadeCandidates.clear();
+    m_gazeRunsRight.clear();
+    m_gazeRunsLeft.clear();
+    m_gazeRunsAverage.clear();
+    m_interpolatedGazeRunsRight.clear();
+    m_interpolatedGazeRunsLeft.clear();
+    m_interpolatedGazeRunsAverage.clear();
 }
 
 
@@ -184,6 +211,12 @@ QMap<int, GazeData> Trial::gazeData(GazeType gazeType)
 
 
 std::vector<Fixation>* Trial::fixations(GazeType gazeType)
+{
+    return fixations(gazeType, m_useFixationsFromInput);
+}
+
+
+std::vector<Fixation>* Trial::fixations(GazeType gazeType, bool fromInput)
 {
     if (gazeType == GazeType::GT_Unset)
     {
@@ -192,7 +225,7 @@ std::vector<Fixation>* Trial::fixations(GazeType gazeType)
 
     if (gazeType == GazeType::GT_Right)
     {
-        if (m_useFixationsFromInput)
+        if (fromInput)
         {
             return &m_inputFixationsRight;
         }
@@ -203,7 +236,7 @@ std::vector<Fixation>* Trial::fixations(GazeType gazeType)
     }
     else if (gazeType == GazeType::GT_Left)
     {
-        if (m_useFixationsFromInput)
+        if (fromInput)
         {
             return &m_inputFixationsLeft;
         }
@@ -214,7 +247,7 @@ std::vector<Fixation>* Trial::fixations(GazeType gazeType)
     }
     else if (gazeType == GazeType::GT_Average)
     {
-        if (m_useFixationsFromInput)
+        if (fromInput)
         {
             return &m_inputFixationsAverage;
         }
@@ -281,6 +314,8 @@ void Trial::setFixations(const std::vector<Fixation>& fixations, GazeType gazeTy
             m_calculatedFixationsAverage = fixations;
         }
     }
+
+    m_revision = nextRevision();
 }
 
 
@@ -411,6 +446,7 @@ bool Trial::useFixationsFromInput() const
 void Trial::setUseFixationsFromInput(bool useFixationsFromInput)
 {
     m_useFixationsFromInput = useFixationsFromInput;
+    m_revision = nextRevision();
 }
 
 
@@ -421,7 +457,15 @@ void Trial::setMicrosaccadesForFixations(std::vector<Saccade>* microsaccades, Ga
         gazeType = m_settings->m_gazeType;
     }
 
+    setMicrosaccadesForFixations(microsaccades, gazeType, *m_settings->m_microsaccadeSettings);
+}
+
+
+void Trial::setMicrosaccadesForFixations(std::vector<Saccade>* microsaccades, GazeType gazeType,
+                                         const SaccadeFilterSettings& settings)
+{
     std::vector<Fixation>* currentFixations = fixations(gazeType);
+    m_revision = nextRevision();
 
     for (int i = 0; i < fixationsCount(gazeType); ++i)
     {
@@ -429,10 +473,8 @@ void Trial::setMicrosaccadesForFixations(std::vector<Saccade>* microsaccades, Ga
     }
 
     // remove microsaccades outside fixation areas or within the beginning/end of fixations
-    int ignoreAtStart = m_settings->m_microsaccadeSettings->m_useIgnoreAtStart ?
-                            timeToSamples(m_settings->m_microsaccadeSettings->m_ignoreAtStart) : 0;
-    int ignoreAtEnd = m_settings->m_microsaccadeSettings->m_useIgnoreAtEnd ?
-                            timeToSamples(m_settings->m_microsaccadeSettings->m_ignoreAtEnd) : 0;
+    int ignoreAtStart = settings.m_useIgnoreAtStart ? timeToSamples(settings.m_ignoreAtStart) : 0;
+    int ignoreAtEnd = settings.m_useIgnoreAtEnd ? timeToSamples(settings.m_ignoreAtEnd) : 0;
 
     int fixationIndex = 0;
     // assumes that microsaccades are temporally ordered
@@ -492,24 +534,36 @@ size_t Trial::microsaccadesCount(GazeType gazeType)
 
 
 void Trial::updateMicrosaccadesSettings()
+{
+    updateMicrosaccadesSettings(*m_settings->m_microsaccadeSettings);
+}
+
+
+void Trial::updateMicrosaccadesSettings(const SaccadeFilterSettings& settings)
 {
     if (m_microsaccadeSettings != nullptr)
     {
         delete m_microsaccadeSettings;
     }
 
-    m_microsaccadeSettings = new SaccadeFilterSettings(*m_settings->m_microsaccadeSettings);
+    m_microsaccadeSettings = new SaccadeFilterSettings(settings);
 }
 
 
 void Trial::updateFixationSettings()
+{
+    updateFixationSettings(*m_settings->m_fixationSettings);
+}
+
+
+void Trial::updateFixationSettings(const SaccadeFilterSettings& settings)
 {
     if (m_fixationSettings != nullptr)
     {
         delete m_fixationSettings;
     }
 
-    m_fixationSettings = new SaccadeFilterSettings(*m_settings->m_fixationSettings);
+    m_fixationSettings = new SaccadeFilterSettings(settings);
 }
 
 
@@ -537,6 +591,170 @@ SaccadeFilterSettings* Trial::getFixationFilterSettings() const
 }
 
 
+SaccadeCandidates* Trial::microsaccadeCandidates()
+{
+    return &m_microsaccadeCandidates;
+}
+
+
+SaccadeCandidates* Trial::saccadeCandidates()
+{
+    return &m_saccadeCandidates;
+}
+
+
+const GazeRuns* Trial::gazeRuns(GazeType gazeType)
+{
+    return updatedGazeRuns(gazeType);
+}
+
+
+const GazeRuns* Trial::gazeRuns(GazeType gazeType, const SaccadeFilterSettings& settings)
+{
+    return detectionGazeRuns(gazeType, settings);
+}
+
+
+const FilteredGazeColumns* Trial::filteredGazeColumns(GazeType gazeType,
+                                                      const SaccadeFilterSettings& settings)
+{
+    // the gaze runs own the filtered columns, they are cleared together
+    GazeRuns* runs = detectionGazeRuns(gazeType, settings);
+
+    const FilteredGazeColumns* filtered = runs->filtered(settings.m_preFilter,
+                                                         settings.m_preFilterWindowSize);
+    if (filtered != nullptr)
+    {
+        return filtered;
+    }
+
+    // the cache is bounded, so that changing the filter interactively does not keep a copy of
+    // the columns for each setting ever used
+    if (runs->m_filtered.size() >= GazeRuns::maxCachedSettings)
+    {
+        runs->m_filtered.pop_front();
+    }
+
+    runs->m_filtered.push_back(FilteredGazeColumns());
+    PreFilter::apply(*runs, settings.m_preFilter, settings.m_preFilterWindowSize,
+                     runs->m_filtered.back());
+
+    return &runs->m_filtered.back();
+}
+
+
+GazeRuns* Trial::detectionGazeRuns(GazeType gazeType, const SaccadeFilterSettings& settings)
+{
+    GazeRuns* runs = updatedGazeRuns(gazeType);
+    size_t maxGapSamples = timeToSamples(settings.m_maxGapDuration);
+    if (settings.m_gapInterpolation == GIT_None || maxGapSamples == 0)
+    {
+        return runs;
+    }
+
+    if (gazeType == GazeType::GT_Unset)
+    {
+        gazeType = m_settings->m_gazeType;
+    }
+
+    std::deque<GazeRuns>* interpolatedRuns = &m_interpolatedGazeRunsAverage;
+    if (gazeType == GazeType::GT_Right)
+    {
+        interpolatedRuns = &m_interpolatedGazeRunsRight;
+    }
+    else if (gazeType == GazeType::GT_Left)
+    {
+        interpolatedRuns = &m_interpolatedGazeRunsLeft;
+    }
+
+    for (size_t i = 0; i < interpolatedRuns->size(); ++i)
+    {
+        GazeRuns& filled = (*interpolatedRuns)[i];
+        if (filled.m_gapInterpolation == settings.m_gapInterpolation &&
+                filled.m_maxGapSamples == maxGapSamples &&
+                filled.isUpToDate(runs->m_pixelsPerDegree))
+        {
+            return &filled;
+        }
+    }
+
+    // entries of an outdated conversion factor are replaced
+    if (!interpolatedRuns->empty() &&
+            !interpolatedRuns->front().isUpToDate(runs->m_pixelsPerDegree))
+    {
+        interpolatedRuns->clear();
+    }
+
+    // bounded like the filtered columns (see filteredGazeColumns)
+    if (interpolatedRuns->size() >= GazeRuns::maxCachedSettings)
+    {
+        interpolatedRuns->pop_front();
+    }
+
+    interpolatedRuns->push_back(GazeRuns());
+    GapInterpolation::apply(*runs, settings.m_gapInterpolation, maxGapSamples,
+                            interpolatedRuns->back());
+
+    return &interpolatedRuns->back();
+}
+
+
+GazeRuns* Trial::updatedGazeRuns(GazeType gazeType)
+{
+    if (gazeType == GazeType::GT_Unset)
+    {
+        gazeType = m_settings->m_gazeType;
+    }
+
+    GazeRuns* runs = &m_gazeRunsAverage;
+    if (gazeType == GazeType::GT_Right)
+    {
+        runs = &m_gazeRunsRight;
+    }
+    else if (gazeType == GazeType::GT_Left)
+    {
+        runs = &m_gazeRunsLeft;
+    }
+
+    qreal pixelsPerDegree = m_participant->getPixelsPerDegree();
+    if (runs->isUpToDate(pixelsPerDegree))
+    {
+        return runs;
+    }
+
+    runs->clear();
+
+    const QMap<int, GazeData>& g = gazeData(gazeType);
+    runs->m_x.reserve(size_t(g.size()));
+    runs->m_y.reserve(size_t(g.size()));
+    runs->m_index.reserve(size_t(g.size()));
+
+    // one pass over the gaze data; a new run starts after each missing index
+    size_t runStart = 0;
+    for (QMap<int, GazeData>::const_iterator it = g.constBegin(); it != g.constEnd(); ++it)
+    {
+        if (!runs->m_index.empty() && it.key() != runs->m_index.back() + 1)
+        {
+            runs->m_runs.push_back(QPair<size_t, size_t>(runStart, runs->m_index.size()));
+            runStart = runs->m_index.size();
+        }
+
+        runs->m_x.push_back(it.value().getXPosition() / pixelsPerDegree);
+        runs->m_y.push_back(it.value().getYPosition() / pixelsPerDegree);
+        runs->m_index.push_back(it.key());
+    }
+    if (runStart < runs->m_index.size())
+    {
+        runs->m_runs.push_back(QPair<size_t, size_t>(runStart, runs->m_index.size()));
+    }
+
+    runs->m_pixelsPerDegree = pixelsPerDegree;
+    runs->m_isSet = true;
+
+    return runs;
+}
+
+
 std::set<int> Trial::getMicrosaccadeIndices(GazeType gazeType)
 {
     std::set<int> indices;
@@ -625,7 +843,7 @@ int Trial::firstIndex(GazeType gazeType)
     const QMap<int, GazeData>& data = gazeData(gazeType);
     if (!data.isEmpty())
     {
-        return gazeData(gazeType).firstKey();
+        return data.firstKey();
     }
     return 0;
 }
@@ -640,7 +858,7 @@ int Trial::lastIndex(GazeType gazeType)
     const QMap<int, GazeData>& data = gazeData(gazeType);
     if (!data.isEmpty())
     {
-        return gazeData(gazeType).lastKey();
+        return data.lastKey();
     }
     return 0;
 }
@@ -658,15 +876,53 @@ size_t Trial::timeToSamples(qreal time)
 }
 
 
-int Trial::timeToSampleInTrial(qreal time)
+int Trial::timeToSampleInTrial(qreal time, GazeType gazeType)
 {
-    return int(timeToSamples(time)) + firstIndex(m_settings->m_gazeType); //round to upper
+    return int(timeToSamples(time)) + firstIndex(gazeType); //round to upper
 }
 
 
 bool Trial::outsideTimeLimitIfActivated(int start, int end)
 {
-    return (m_settings->m_limitTimeRange &&
-            (start < timeToSampleInTrial(m_settings->m_startTimeInMSec) ||
-             end > timeToSampleInTrial(m_settings->m_endTimeInMSec)));
+    return timeLimit().outside(start, end);
+}
+
+
+bool Trial::outsideTimeLimitIfActivated(int start, int end, const SettingsSnapshot& settings)
+{
+    return timeLimit(settings).outside(start, end);
+}
+
+
+TimeLimit Trial::timeLimit()
+{
+    return timeLimit(m_settings->m_limitTimeRange, m_settings->m_startTimeInMSec,
+                     m_settings->m_endTimeInMSec, m_settings->m_gazeType);
+}
+
+
+TimeLimit Trial::timeLimit(const SettingsSnapshot& settings)
+{
+    return timeLimit(settings.m_limitTimeRange, settings.m_startTimeInMSec,
+                     settings.m_endTimeInMSec, settings.m_gazeType);
+}
+
+
+TimeLimit Trial::timeLimit(bool active, qreal startTime, qreal endTime, GazeType gazeType)
+{
+    TimeLimit limit;
+    if (active)
+    {
+        int first = firstIndex(gazeType);
+        limit.m_active = true;
+        limit.m_start = int(timeToSamples(startTime)) + first;
+        limit.m_end = int(timeToSamples(endTime)) + first;
+    }
+    return limit;
+}
+
+
+int Trial::revision() const
+{
+    return m_revision;
 }
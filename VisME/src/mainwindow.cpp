@@ -15,12 +15,16 @@
 #include "pngexporter.h"
 #include "radialscatterplot.h"
 #include "saccadedetector.h"
+#include "settingssnapshot.h"
+#include "statisticstable.h"
 #include "timelineview.h"
+#include <algorithm>
 #include <iostream>
 #include <numeric>
 #include <QComboBox>
 #include <QGuiApplication>
 #include <QMap>
+#include <QtConcurrent>
 #include <QtWidgets>
 #include <set>
 #include <sstream>
@@ -73,6 +77,13 @@ MainWindow::MainWindow(QWidget* parent):
     QObject::connect(m_timelineView, &TimelineView::timelineSelection,
                      this, &MainWindow::limitTimeRangeToSelection);
 
+    QObject::connect(&m_statisticsWatcher,
+                     &QFutureWatcher<QSharedPointer<StatisticsTable> >::finished,
+                     this, &MainWindow::showStatisticsInfo);
+
+    QObject::connect(&m_detectionWatcher, &QFutureWatcher<void>::finished,
+                     this, &MainWindow::detectionJobFinished);
+
     m_ui = new UserInterface(this, m_settings, m_mainView, m_timelineView);
 
     // initialize the scenes
@@ -82,6 +93,9 @@ MainWindow::MainWindow(QWidget* parent):
 
 MainWindow::~MainWindow()
 {
+    cancelDetectionJob();
+    cancelStatisticsJob();
+
     delete m_settings;
     delete m_mainVisualization;
     delete m_timelineVisualization;
@@ -92,6 +106,14 @@ MainWindow::~MainWindow()
 
 void MainWindow::openFiles(const QStringList& fileNames, bool add)
 {
+    // a running detection or statistics job must not continue with removed trials
+    cancelDetectionJob();
+    cancelStatisticsJob();
+    if (!add)
+    {
+        m_statisticsCache.clear();
+    }
+
     qApp->processEvents();
     EyeDataImport eyeDataImport(this, m_eyeTrackingData, m_settings);
     connect(&eyeDataImport, &EyeDataImport::setTestConditionsInUI, m_ui, &UserInterface::setTestConditionsInUI);
@@ -100,6 +122,26 @@ void MainWindow::openFiles(const QStringList& fileNames, bool add)
 }
 
 
+void MainWindow::openSession(const QString& fileName)
+{
+    if (fileName.isEmpty())
+    {
+        return;
+    }
+
+    // a running detection or statistics job must not continue with removed trials
+    cancelDetectionJob();
+    cancelStatisticsJob();
+    m_statisticsCache.clear();
+
+    qApp->processEvents();
+    EyeDataImport eyeDataImport(this, m_eyeTrackingData, m_settings);
+    connect(&eyeDataImport, &EyeDataImport::setTestConditionsInUI, m_ui, &UserInterface::setTestConditionsInUI);
+    connect(&eyeDataImport, &EyeDataImport::updateParticipantsInUI, this, &MainWindow::addParticipantsInUI);
+    eyeDataImport.openSession(fileName);
+}
+
+
 void MainWindow::showData(bool resetTimeline)
 {
     if (m_ui == nullptr || m_eyeTrackingData->numberOfParticipants() == 0)
@@ -208,19 +250,126 @@ void MainWindow::newScenes()
 }
 
 
-void MainWindow::updateMicrosaccadesDetection(Trial* trial)
+void MainWindow::cancelDetectionJob()
+{
+    m_detectionCancellation.cancel();
+    m_detectionWatcher.waitForFinished();
+}
+
+
+void MainWindow::waitForDetectionJob()
 {
-    if (trial == nullptr)
+    if (m_detectionWatcher.isRunning())
+    {
+        qApp->setOverrideCursor(Qt::WaitCursor);
+        m_detectionWatcher.waitForFinished();
+        qApp->restoreOverrideCursor();
+    }
+}
+
+
+void MainWindow::startDetectionJob(const std::vector<Trial*>& trials, bool fixations)
+{
+    // the trials of the running job may be part of the new job; both jobs read the trials
+    cancelDetectionJob();
+    cancelStatisticsJob();
+
+    qApp->setOverrideCursor(Qt::WaitCursor);
+
+    // all trials of the job are updated with the same settings, changes in the UI cancel the job
+    readMicrosaccadeSettings();
+    if (fixations)
+    {
+        readFixationSettings();
+    }
+    const SettingsSnapshot settings(*m_settings);
+    CancellationToken cancellation = m_detectionCancellation.start();
+
+    m_detectionTimer.start();
+
+    // the shown trials are read by the views and are therefore not updated in the background
+    std::set<Trial*> currentTrials(m_settings->m_currentTrials.begin(),
+                                   m_settings->m_currentTrials.end());
+    m_detectionTrials.clear();
+    for (size_t i = 0; i < trials.size(); ++i)
+    {
+        if (currentTrials.find(trials[i]) == currentTrials.end())
+        {
+            m_detectionTrials.push_back(trials[i]);
+        }
+        else if (fixations)
+        {
+            updateFixationsDetection(trials[i], settings, cancellation);
+        }
+        else
+        {
+            updateMicrosaccadesDetection(trials[i], settings, cancellation);
+        }
+    }
+
+    updateUI();
+    if (fixations && !m_settings->m_currentTrials.empty() &&
+            std::find(trials.begin(), trials.end(), m_settings->m_currentTrials[0]) != trials.end())
+    {
+        fixationSelected(m_settings->m_currentTrials[0]->getFixationAt(
+                             m_settings->m_currentFixationIndex));
+    }
+
+    qApp->restoreOverrideCursor();
+
+    if (m_detectionTrials.empty())
     {
         return;
     }
 
-    QElapsedTimer timer;
-    timer.start();
+    m_detectionJob = cancellation;
+    m_ui->setDetectionRunning(true);
+    m_detectionWatcher.setFuture(QtConcurrent::map(
+        m_detectionTrials,
+        [settings, cancellation, fixations](Trial* trial)
+        {
+            if (fixations)
+            {
+                updateFixationsDetection(trial, settings, cancellation);
+            }
+            else
+            {
+                updateMicrosaccadesDetection(trial, settings, cancellation);
+            }
+        }));
+}
+
+
+void MainWindow::detectionJobFinished()
+{
+    // a new job may have been started after the finished one
+    if (m_detectionWatcher.isRunning())
+    {
+        return;
+    }
+
+    qDebug() << QString("Detection job: %1 trials%2: %3 ms").arg(
+                    QString::number(m_detectionTrials.size()),
+                    m_detectionJob.isCanceled() ? " (canceled)" : "",
+                    QString::number(m_detectionTimer.elapsed()));
 
+    m_detectionTrials.clear();
+    m_ui->setDetectionRunning(false);
+
+    updateMicrosaccadeStatBarsInUI();
+}
+
+
+void MainWindow::readMicrosaccadeSettings()
+{
     m_settings->m_microsaccadeSettings->m_fromInputFile = m_ui->m_microsaccadesFromInputFileCheckbox->isChecked();
 
     m_settings->m_microsaccadeSettings->m_velocityThreshold = m_ui->m_msVelocityThresholdSpinBox->value();
+    m_settings->m_microsaccadeSettings->m_algorithm = DetectionAlgorithm(m_ui->m_msDetectionAlgorithmComboBox->currentIndex());
+    m_settings->m_microsaccadeSettings->m_preFilter = PreFilterType(m_ui->m_msPreFilterComboBox->currentIndex());
+    m_settings->m_microsaccadeSettings->m_preFilterWindowSize = size_t(m_ui->m_msPreFilterWindowSizeSpinBox->value());
+    m_settings->m_microsaccadeSettings->m_gapInterpolation = GapInterpolationType(m_ui->m_msGapInterpolationComboBox->currentIndex());
+    m_settings->m_microsaccadeSettings->m_maxGapDuration = m_ui->m_msMaxGapDurationSpinBox->value();
     m_settings->m_microsaccadeSettings->m_minDuration = m_ui->m_msMinDurationSpinBox->value();
     m_settings->m_microsaccadeSettings->m_binocular = m_ui->m_msBinocularCheckBox->isChecked();
     m_settings->m_microsaccadeSettings->m_velocityWindowSize = size_t(m_ui->m_msVelocityWindowSizeSpinBox->value());
@@ -245,50 +394,19 @@ void MainWindow::updateMicrosaccadesDetection(Trial* trial)
     m_settings->m_microsaccadeSettings->m_useIgnoreAtEnd = m_ui->m_msIgnoreAtFixationEndCheckBox->isChecked();
     m_settings->m_microsaccadeSettings->m_useIgnoreBeforeMissingData = m_ui->m_msIgnoreBeforeMissingDataCheckBox->isChecked();
     m_settings->m_microsaccadeSettings->m_useIgnoreAfterMissingData = m_ui->m_msIgnoreAfterMissingDataCheckBox->isChecked();
-
-    trial->updateMicrosaccadesSettings();
-
-    if (!m_settings->m_microsaccadeSettings->m_fromInputFile)
-    {
-        std::vector<std::vector<Saccade>> microsaccades;
-        auto m = new SaccadeDetector();
-
-        microsaccades = m->determineMicrosaccades(trial, m_settings);
-
-        // update microsaccades for all gaze types
-        std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
-        for (size_t i = 0; i < gazeTypes.size(); ++i)
-        {
-            // set for fixations and remove ms outside start/end
-            trial->setMicrosaccadesForFixations(&microsaccades[i], gazeTypes[i]);
-
-            if (m_settings->m_microsaccadeSettings->m_useMinIntersaccInterval)
-            {
-                // remove microsaccades inside inter-saccadic interval
-                for (int j = 0; j < trial->fixationsCount(gazeTypes[i]); ++j)
-                {
-                    m->removeMicrosaccadesForIntersaccadicInterval(trial, m_settings, trial->getFixationAt(j, gazeTypes[i]));
-                }
-            }
-        }
-        updateMicrosaccadesInFixationTable();
-    }
-
-    qDebug() << QString("Participant %1, Trial %2, MS detection: %3 ms").arg(
-                    trial->getParticipant()->name(), trial->name(), QString::number(timer.elapsed()));
 }
 
 
-void MainWindow::updateFixationsDetection(Trial* trial)
+void MainWindow::readFixationSettings()
 {
-    if (trial == nullptr)
-    {
-        return;
-    }
-
     m_settings->m_fixationSettings->m_fromInputFile = m_ui->m_fixationsFromInputFileCheckbox->isChecked();
 
     m_settings->m_fixationSettings->m_velocityThreshold = m_ui->m_fixVelocityThresholdSpinBox->value();
+    m_settings->m_fixationSettings->m_algorithm = DetectionAlgorithm(m_ui->m_fixDetectionAlgorithmComboBox->currentIndex());
+    m_settings->m_fixationSettings->m_preFilter = PreFilterType(m_ui->m_fixPreFilterComboBox->currentIndex());
+    m_settings->m_fixationSettings->m_preFilterWindowSize = size_t(m_ui->m_fixPreFilterWindowSizeSpinBox->value());
+    m_settings->m_fixationSettings->m_gapInterpolation = GapInterpolationType(m_ui->m_fixGapInterpolationComboBox->currentIndex());
+    m_settings->m_fixationSettings->m_maxGapDuration = m_ui->m_fixMaxGapDurationSpinBox->value();
     m_settings->m_fixationSettings->m_minDuration = m_ui->m_fixMinSaccadeDurationSpinBox->value();
     m_settings->m_fixationSettings->m_binocular = m_ui->m_fixBinocularCheckBox->isChecked();
     m_settings->m_fixationSettings->m_velocityWindowSize = size_t(m_ui->m_fixVelocityWindowSizeSpinBox->value());
@@ -315,134 +433,97 @@ void MainWindow::updateFixationsDetection(Trial* trial)
     m_settings->m_fixationSettings->m_useIgnoreAtEnd = m_ui->m_fixIgnoreAtFixationEndCheckBox->isChecked();
     m_settings->m_fixationSettings->m_useIgnoreBeforeMissingData = m_ui->m_fixIgnoreBeforeMissingDataCheckBox->isChecked();
     m_settings->m_fixationSettings->m_useIgnoreAfterMissingData = m_ui->m_fixIgnoreAfterMissingDataCheckBox->isChecked();
+}
 
-    trial->updateFixationSettings();
 
-    if (m_settings->m_fixationSettings->m_fromInputFile)
+void MainWindow::updateMicrosaccadesDetection(Trial* trial, const SettingsSnapshot& settings,
+                                              const CancellationToken& cancellation)
+{
+    if (trial == nullptr || cancellation.isCanceled())
     {
-        trial->setUseFixationsFromInput(true);
+        return;
     }
-    else
-    {
-        trial->setUseFixationsFromInput(false);
 
-        // update microsaccades for all gaze types
-        std::vector<std::vector<Saccade>> saccades;
-
-        SaccadeDetector m = SaccadeDetector();
-        saccades = m.determineRegularSaccades(trial, m_settings);
+    QElapsedTimer timer;
+    timer.start();
 
-        std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
-        for (size_t k = 0; k < gazeTypes.size(); ++k)
+    // detect before the trial is changed; settings and results are only stored together
+    SaccadeDetector m = SaccadeDetector();
+    std::vector<std::vector<Saccade>> microsaccades;
+    if (!settings.m_microsaccadeSettings.m_fromInputFile)
+    {
+        microsaccades = m.determineMicrosaccades(trial, settings, cancellation);
+        if (cancellation.isCanceled())
         {
-            const QMap<int, GazeData>& g = trial->gazeData(gazeTypes[k]);
-            std::vector<Fixation> fixations;
+            return;
+        }
+    }
 
-            if (!g.empty())
-            {
-                int ignoreAtStart = m_settings->m_fixationSettings->m_useIgnoreAtStart ?
-                                        int(trial->timeToSamples(m_settings->m_fixationSettings->m_ignoreAtStart)) : 0;
-                int ignoreAtEnd = m_settings->m_fixationSettings->m_useIgnoreAtEnd ?
-                                      int(trial->timeToSamples(m_settings->m_fixationSettings->m_ignoreAtEnd)) : 0;
-                int startIndex = g.firstKey() + ignoreAtStart;
-                int endIndex = g.lastKey() - ignoreAtEnd;
-
-                if(startIndex < 0 || endIndex < 0)
-                {
-                    return;
-                }
+    trial->updateMicrosaccadesSettings(settings.m_microsaccadeSettings);
 
-                int minimumFixLength = 0; // in samples
+    if (!settings.m_microsaccadeSettings.m_fromInputFile)
+    {
+        m.setMicrosaccades(trial, settings, microsaccades);
+    }
 
-                // everything that is not a saccade is handled as fixation...
-                for (size_t i = 0; i < saccades[k].size() + 1; ++i)
-                {
-                    // area before first saccade (or after ignore time) and after the last one is added as fixations
-                    int start = i == 0 ? startIndex : int(saccades[k][i - 1].getEndIndex()) + 1;
-                    int end = i < saccades[k].size() ? (saccades[k][i].getEndIndex() > size_t(endIndex) ?
-                                                              endIndex :
-                                                              int(saccades[k][i].getOnsetIndex()) - 1) : endIndex;
-
-                    qreal x = 0;
-                    qreal y = 0;
-                    int count = 0;
-                    int s = start;
-                    int e = end;
-                    for (int j = start; j < end; ++j)
-                    {
-                        if (g.contains(j))
-                        {
-                            x += g[j].getXPosition();
-                            y += g[j].getYPosition();
-                            e = j;
-                            s == -1 ? s = j : s;
-                            count++;
-                        }
-                        else
-                        {
-                            if (count > 0)
-                            {
-                                if (e - s + 1 >= minimumFixLength)
-                                {
-                                    x /= count;
-                                    y /= count;
-
-                                    Fixation fixation = Fixation(m_settings);
-                                    fixation.setStartIndex(s);
-                                    fixation.setDuration(e - s + 1);
-                                    fixation.setXPosition(x);
-                                    fixation.setYPosition(y);
-
-                                    fixations.push_back(fixation);
-
-                                    x = 0;
-                                    y = 0;
-                                }
-                                count = 0;
-                                s = -1;
-                            }
-                        }
-                    }
+    qDebug() << QString("Participant %1, Trial %2, MS detection: %3 ms").arg(
+                    trial->getParticipant()->name(), trial->name(), QString::number(timer.elapsed()));
+}
 
-                    if (count > 0)
-                    {
-                        if (e - s + 1 >= minimumFixLength)
-                        {
-                            x /= count;
-                            y /= count;
-
-                            Fixation fixation = Fixation(m_settings);
-                            fixation.setStartIndex(s);
-                            fixation.setDuration(e - s + 1);
-                            fixation.setXPosition(x);
-                            fixation.setYPosition(y);
-
-                            fixations.push_back(fixation);
-                        }
-                    }
 
-                }
-            }
+void MainWindow::updateFixationsDetection(Trial* trial, const SettingsSnapshot& settings,
+                                          const CancellationToken& cancellation)
+{
+    if (trial == nullptr || cancellation.isCanceled())
+    {
+        return;
+    }
 
-            trial->setSaccades(saccades[k], gazeTypes[k]);
-            trial->setFixations(fixations, gazeTypes[k]);
-        }
+    QElapsedTimer timer;
+    timer.start();
+
+    // fixations and microsaccades are detected before the trial is changed; settings, fixation
+    // source and results are only stored together if the detection was not canceled
+    SaccadeDetector m = SaccadeDetector();
+    const bool fixationsFromInput = settings.m_fixationSettings.m_fromInputFile;
+    FixationDetectionResult fixations;
+    bool valid = true;
+    if (!fixationsFromInput)
+    {
+        valid = m.determineFixations(trial, settings, fixations, cancellation);
     }
 
-    updateFixationTable();
+    // the microsaccades do not depend on the fixations, only their assignment does
+    const bool detectMicrosaccades = valid && !settings.m_microsaccadeSettings.m_fromInputFile;
+    std::vector<std::vector<Saccade>> microsaccades;
+    if (detectMicrosaccades)
+    {
+        microsaccades = m.determineMicrosaccades(trial, settings, cancellation);
+    }
 
-    if (m_settings->m_displayMode == DisplayMode::Individual)
+    if (cancellation.isCanceled())
     {
-        m_mainVisualization->updateTrial();
-        m_timelineVisualization->updateTrial();
+        return;
     }
 
-    updateMicrosaccadesDetection(trial); // update ms as well for the new fixations
+    trial->updateFixationSettings(settings.m_fixationSettings);
+    trial->setUseFixationsFromInput(fixationsFromInput);
+    if (!fixationsFromInput)
+    {
+        m.setFixations(trial, fixations);
+    }
 
-    if (!m_settings->m_currentTrials.empty() && trial == m_settings->m_currentTrials[0])
+    if (valid)
     {
-        fixationSelected(trial->getFixationAt(m_settings->m_currentFixationIndex));
+        trial->updateMicrosaccadesSettings(settings.m_microsaccadeSettings);
+        if (detectMicrosaccades)
+        {
+            m.setMicrosaccades(trial, settings, microsaccades);
+        }
     }
+
+    qDebug() << QString("Participant %1, Trial %2, Fixation and MS detection: %3 ms").arg(
+                    trial->getParticipant()->name(), trial->name(), QString::number(timer.elapsed()));
 }
 
 
@@ -502,6 +583,9 @@ void MainWindow::updateGeneralInfo(std::vector<Trial*> currentTrials)
 
 void MainWindow::updateStatisticsInfo(std::vector<Trial*> currentTrials)
 {
+    // a running job computes the statistics of other trials or with other settings
+    cancelStatisticsJob();
+
     // update infos in dock widget
     if (currentTrials.empty())
     {
@@ -596,411 +680,374 @@ void MainWindow::updateStatisticsInfo(std::vector<Trial*> currentTrials)
     }
     else
     {
-        std::vector<qreal> rawDataSamples;
-        qreal rawDataSamplesSum = 0;
-        qreal rawDataSamplesMin = 0;
-        qreal rawDataSamplesMax = 0;
-        qreal rawDataSamplesMean = 0;
-        qreal rawDataSamplesMedian = 0;
-
-        std::vector<qreal> durationsInSec;
-        qreal durationSum = 0;
-        qreal durationMin = 0;
-        qreal durationMax = 0;
-        qreal durationMean = 0;
-        qreal durationMedian = 0;
-
-        std::vector<int> fixationCounts;
-        int fixCountSum = 0;
-        qreal fixCountMin = 0;
-        qreal fixCountMax = 0;
-        qreal fixCountMean = 0;
-        qreal fixCountMedian = 0;
-
-        std::vector<int> fixationWithMSCounts;
-        int fixWithMSCountSum = 0;
-        qreal fixWithMSCountMin = 0;
-        qreal fixWithMSCountMax = 0;
-        qreal fixWithMSCountMean = 0;
-        qreal fixWithMSCountMedian = 0;
-
-        std::vector<qreal> fixationWithMSRatio;
-        qreal fixWithMSRatioMin = 0;
-        qreal fixWithMSRatioMax = 0;
-        qreal fixWithMSRatioMean = 0;
-        qreal fixWithMSRatioMedian = 0;
-
-        std::vector<qreal> fixDurationsInSec;
-        qreal fixDurationSum = 0;
-        qreal fixDurationMin = 0;
-        qreal fixDurationMax = 0;
-        qreal fixDurationMean = 0;
-        qreal fixDurationMedian = 0;
-
-        std::vector<qreal> fixDurationsWithMSInSec;
-        qreal fixDurationWithMSSum = 0;
-        qreal fixDurationWithMSMin = 0;
-        qreal fixDurationWithMSMax = 0;
-        qreal fixDurationWithMSMean = 0;
-        qreal fixDurationWithMSMedian = 0;
-
-        std::vector<int> msCounts;
-        int msCountSum = 0;
-        qreal msCountMin = 0;
-        qreal msCountMax = 0;
-        qreal msCountMean = 0;
-        qreal msCountMedian = 0;
-
-        std::vector<int> msPerFix;
-        qreal msPerFixMin = 0;
-        qreal msPerFixMax = 0;
-        qreal msPerFixMean = 0;
-        qreal msPerFixMedian = 0;
-        qreal msPerFixSum = 0;
-
-        std::vector<int> msPerFixWithMS;
-        qreal msPerFixWithMSMin = 0;
-        qreal msPerFixWithMSMax = 0;
-        qreal msPerFixWithMSMean = 0;
-        qreal msPerFixWithMSMedian = 0;
-        qreal msPerFixWithMSSum = 0;
-
-        std::vector<qreal> msPerSecond;
-        qreal msPerSecondMin = 0;
-        qreal msPerSecondMax = 0;
-        qreal msPerSecondMean = 0;
-        qreal msPerSecondMedian = 0;
-
-        std::vector<qreal> msPerSecondInFix;
-        qreal msPerSecondInFixMin = 0;
-        qreal msPerSecondInFixMax = 0;
-        qreal msPerSecondInFixMean = 0;
-        qreal msPerSecondInFixMedian = 0;
-
-        std::vector<qreal> msAmplitudes;
-        qreal msAmplitudeMin = 0;
-        qreal msAmplitudeMax = 0;
-        qreal msAmplitudeMean = 0;
-        qreal msAmplitudeMedian = 0;
-
-        std::vector<qreal> msIntersaccIntervals;
-        qreal msIntersaccIntervalMin = 0;
-        qreal msIntersaccIntervalMax = 0;
-        qreal msIntersaccIntervalMean = 0;
-        qreal msIntersaccIntervalMedian = 0;
-
-        std::vector<qreal> msDurations;
-        qreal msDurationMin = 0;
-        qreal msDurationMax = 0;
-        qreal msDurationMean = 0;
-        qreal msDurationMedian = 0;
-
-        std::vector<qreal> msPeakVelocities;
-        qreal msVelocityMin = 0;
-        qreal msVelocityMax = 0;
-        qreal msVelocityMean = 0;
-        qreal msVelocityMedian = 0;
-
-        for (size_t i = 0; i < currentTrials.size(); ++i)
-        {
-            int gazeDataSamples = 0;
-
-            const QMap<int, GazeData>& g = currentTrials[i]->gazeData();
-            if (!g.empty())
-            {
-                QMapIterator<int, GazeData> it(g);
-                while(it.hasNext())
-                {
-                    it.next();
-                    if (!m_settings->m_limitTimeRange ||
-                            (it.key() >= currentTrials[i]->timeToSampleInTrial(m_settings->m_startTimeInMSec) &&
-                            it.key() <= currentTrials[i]->timeToSampleInTrial(m_settings->m_endTimeInMSec)))
-                        gazeDataSamples++;
-                }
-            }
-            rawDataSamples.push_back(gazeDataSamples);
+        // all metrics of the current trials, limited to the time range if activated, are computed
+        // in the background; only trials which changed since the last job are recomputed
+        const SettingsSnapshot settings(*m_settings);
+        CancellationToken cancellation = m_statisticsCancellation.start();
+        StatisticsCache* cache = &m_statisticsCache;
 
-            int duration = 0;
-            int fixWithMS = 0;
-            int msCountSum = 0;
-            int fixSum = 0;
-            for (int j = 0; j < int(currentTrials[i]->fixationsCount()); ++j)
+        m_statisticsJob = cancellation;
+        m_statisticsWatcher.setFuture(QtConcurrent::run(
+            [cache, currentTrials, settings, cancellation]()
             {
-                Fixation* fixation = currentTrials[i]->getFixationAt(j);
-                if (!currentTrials[i]->outsideTimeLimitIfActivated(fixation->getStartIndex(), fixation->getEndIndex()))
-                {
-                    duration += fixation->getDuration();
-
-                    bool fromInput = m_settings->m_microsaccadeSettings->m_fromInputFile;
-                    int msCount = int(fixation->getMicrosaccadesCount(fromInput));
-                    Saccade* prevMS = nullptr;
-                    for (int k = 0; k < msCount; ++k)
-                    {
-                        Saccade* ms = fixation->getMicrosaccadeAt(size_t(k), fromInput);
-
-                        msAmplitudes.push_back(ms->getAmplitude());
-                        msDurations.push_back(currentTrials[i]->samplesToTime(int(ms->getDuration())));
-
-                        msPeakVelocities.push_back(ms->getPeakVelocity());
-
-                        if (k > 0)
-                        {
-                            msIntersaccIntervals.push_back(currentTrials[i]->samplesToTime(int(ms->getOnsetIndex() - prevMS->getEndIndex())));
-                        }
-                        prevMS = ms;
-                    }
-
-                    if (msCount > 0)
-                    {
-                        fixDurationsWithMSInSec.push_back(currentTrials[i]->samplesToTime(fixation->getDuration()) / 1000.0);
-                        msPerFixWithMS.push_back(msCount);
-                        fixWithMS++;
-                    }
-                    fixDurationsInSec.push_back(currentTrials[i]->samplesToTime(fixation->getDuration()) / 1000.0);
-
-                    msPerFix.push_back(msCount);
-                    msCountSum += msCount;
-                    fixSum++;
-                }
-            }
-
-            msCounts.push_back(msCountSum);
-            fixationCounts.push_back(fixSum);
+                return cache->table(currentTrials, settings, true, cancellation);
+            }));
+    }
+}
 
-            fixationWithMSCounts.push_back(fixWithMS);
-            fixationWithMSRatio.push_back(qreal(fixWithMS) / currentTrials[i]->fixationsCount());
-            msPerSecondInFix.push_back(duration == 0 ? 0 : msCountSum / currentTrials[i]->samplesToTime(duration) * 1000.0);
 
-            int trialDuration;
-            if(m_settings->m_limitTimeRange)
-            {
-                trialDuration = std::min(currentTrials[i]->timeToSampleInTrial(m_settings->m_endTimeInMSec),
-                                         currentTrials[i]->lastIndex()) -
-                                std::max(currentTrials[i]->timeToSampleInTrial(m_settings->m_startTimeInMSec),
-                                         currentTrials[i]->firstIndex()) + 1;
-            }
-            else
-            {
-                trialDuration = currentTrials[i]->duration();
-            }
-            durationsInSec.push_back(currentTrials[i]->samplesToTime(trialDuration) / 1000.0);
-            msPerSecond.push_back(msCountSum / currentTrials[i]->samplesToTime(trialDuration) * 1000.0);
-        }
+void MainWindow::cancelStatisticsJob()
+{
+    m_statisticsCancellation.cancel();
+    m_statisticsWatcher.waitForFinished();
+}
 
-        rawDataSamplesSum = std::accumulate(rawDataSamples.begin(), rawDataSamples.end(), 0.0);
-        rawDataSamplesMin = *std::min_element(rawDataSamples.begin(), rawDataSamples.end());
-        rawDataSamplesMax = *std::max_element(rawDataSamples.begin(), rawDataSamples.end());
-        rawDataSamplesMedian = MathHelpFunctions::median<qreal>(rawDataSamples);
-        rawDataSamplesMean = rawDataSamplesSum / currentTrials.size();
-
-        durationSum = std::accumulate(durationsInSec.begin(), durationsInSec.end(), 0.0);
-        durationMin = *std::min_element(durationsInSec.begin(), durationsInSec.end());
-        durationMax = *std::max_element(durationsInSec.begin(), durationsInSec.end());
-        durationMedian = MathHelpFunctions::median<qreal>(durationsInSec);
-        durationMean = durationSum / currentTrials.size();
-
-        fixCountSum = std::accumulate(fixationCounts.begin(), fixationCounts.end(), 0);
-        fixCountMin = *std::min_element(fixationCounts.begin(), fixationCounts.end());
-        fixCountMax = *std::max_element(fixationCounts.begin(), fixationCounts.end());
-        fixCountMedian = MathHelpFunctions::median<int>(fixationCounts);
-        fixCountMean = qreal(fixCountSum) / currentTrials.size();
-
-        fixWithMSCountSum = std::accumulate(fixationWithMSCounts.begin(), fixationWithMSCounts.end(), 0);
-        fixWithMSCountMin = *std::min_element(fixationWithMSCounts.begin(), fixationWithMSCounts.end());
-        fixWithMSCountMax = *std::max_element(fixationWithMSCounts.begin(), fixationWithMSCounts.end());
-        fixWithMSCountMedian = MathHelpFunctions::median<int>(fixationWithMSCounts);
-        fixWithMSCountMean = qreal(fixWithMSCountSum) / currentTrials.size();
-
-        qreal fixWithMSRatioSum = std::accumulate(fixationWithMSRatio.begin(), fixationWithMSRatio.end(), 0.0);
-        fixWithMSRatioMin = *std::min_element(fixationWithMSRatio.begin(),fixationWithMSRatio.end()) * 100;
-        fixWithMSRatioMax = *std::max_element(fixationWithMSRatio.begin(),fixationWithMSRatio.end()) * 100;
-        fixWithMSRatioMedian = MathHelpFunctions::median<qreal>(fixationWithMSRatio) * 100;
-        fixWithMSRatioMean = qreal(fixWithMSRatioSum) / fixationWithMSRatio.size() * 100;
-
-        if (!fixDurationsInSec.empty())
-        {
-            fixDurationSum = std::accumulate(fixDurationsInSec.begin(), fixDurationsInSec.end(), 0.0);
-            fixDurationMin = *std::min_element(fixDurationsInSec.begin(), fixDurationsInSec.end());
-            fixDurationMax = *std::max_element(fixDurationsInSec.begin(), fixDurationsInSec.end());
-            fixDurationMedian = MathHelpFunctions::median<qreal>(fixDurationsInSec);
-            fixDurationMean = fixDurationSum / fixDurationsInSec.size();
-        }
 
-        if (!fixDurationsWithMSInSec.empty())
-        {
-            fixDurationWithMSSum = std::accumulate(fixDurationsWithMSInSec.begin(), fixDurationsWithMSInSec.end(), 0.0);
-            fixDurationWithMSMin = *std::min_element(fixDurationsWithMSInSec.begin(), fixDurationsWithMSInSec.end());
-            fixDurationWithMSMax = *std::max_element(fixDurationsWithMSInSec.begin(), fixDurationsWithMSInSec.end());
-            fixDurationWithMSMedian = MathHelpFunctions::median<qreal>(fixDurationsWithMSInSec);
-            fixDurationWithMSMean = fixDurationWithMSSum / fixDurationsWithMSInSec.size();
-        }
-
-        msCountSum = std::accumulate(msCounts.begin(), msCounts.end(), 0);
-        msCountMin = *std::min_element(msCounts.begin(), msCounts.end());
-        msCountMax = *std::max_element(msCounts.begin(), msCounts.end());
-        msCountMedian = MathHelpFunctions::median<int>(msCounts);
-        msCountMean = double(msCountSum) / currentTrials.size();
+void MainWindow::showStatisticsInfo()
+{
+    // results of a canceled job belong to other trials or settings
+    QSharedPointer<StatisticsTable> table = m_statisticsWatcher.result();
+    if (m_statisticsJob.isCanceled() || table.isNull())
+    {
+        return;
+    }
 
-        if (!msPerFix.empty())
-        {
-            msPerFixSum = std::accumulate(msPerFix.begin(), msPerFix.end(), 0.0);
-            msPerFixMin = *std::min_element(msPerFix.begin(), msPerFix.end());
-            msPerFixMax = *std::max_element(msPerFix.begin(), msPerFix.end());
-            msPerFixMedian = MathHelpFunctions::median<int>(msPerFix);
-            msPerFixMean = msPerFixSum / msPerFix.size();
-        }
+    int group = 0;
+    size_t trialCount = table->trialCount(group);
+
+    const std::vector<qreal>& rawDataSamples = table->values(group, SM_RawDataSamples);
+    qreal rawDataSamplesSum = 0;
+    qreal rawDataSamplesMin = 0;
+    qreal rawDataSamplesMax = 0;
+    qreal rawDataSamplesMean = 0;
+    qreal rawDataSamplesMedian = 0;
+
+    const std::vector<qreal>& durationsInSec = table->values(group, SM_TrialDuration);
+    qreal durationSum = 0;
+    qreal durationMin = 0;
+    qreal durationMax = 0;
+    qreal durationMean = 0;
+    qreal durationMedian = 0;
+
+    const std::vector<qreal>& fixationCounts = table->values(group, SM_FixationCount);
+    int fixCountSum = 0;
+    qreal fixCountMin = 0;
+    qreal fixCountMax = 0;
+    qreal fixCountMean = 0;
+    qreal fixCountMedian = 0;
+
+    const std::vector<qreal>& fixationWithMSCounts = table->values(group, SM_FixationWithMSCount);
+    int fixWithMSCountSum = 0;
+    qreal fixWithMSCountMin = 0;
+    qreal fixWithMSCountMax = 0;
+    qreal fixWithMSCountMean = 0;
+    qreal fixWithMSCountMedian = 0;
+
+    const std::vector<qreal>& fixationWithMSRatio = table->values(group, SM_FixationWithMSPercentage);
+    qreal fixWithMSRatioMin = 0;
+    qreal fixWithMSRatioMax = 0;
+    qreal fixWithMSRatioMean = 0;
+    qreal fixWithMSRatioMedian = 0;
+
+    const std::vector<qreal>& fixDurationsInSec = table->values(group, SM_FixationDuration);
+    qreal fixDurationSum = 0;
+    qreal fixDurationMin = 0;
+    qreal fixDurationMax = 0;
+    qreal fixDurationMean = 0;
+    qreal fixDurationMedian = 0;
+
+    const std::vector<qreal>& fixDurationsWithMSInSec = table->values(group, SM_FixationWithMSDuration);
+    qreal fixDurationWithMSSum = 0;
+    qreal fixDurationWithMSMin = 0;
+    qreal fixDurationWithMSMax = 0;
+    qreal fixDurationWithMSMean = 0;
+    qreal fixDurationWithMSMedian = 0;
+
+    const std::vector<qreal>& msCounts = table->values(group, SM_MSCount);
+    int msCountSum = 0;
+    qreal msCountMin = 0;
+    qreal msCountMax = 0;
+    qreal msCountMean = 0;
+    qreal msCountMedian = 0;
+
+    const std::vector<qreal>& msPerFix = table->values(group, SM_MSPerFixation);
+    qreal msPerFixMin = 0;
+    qreal msPerFixMax = 0;
+    qreal msPerFixMean = 0;
+    qreal msPerFixMedian = 0;
+    qreal msPerFixSum = 0;
+
+    const std::vector<qreal>& msPerFixWithMS = table->values(group, SM_MSPerFixationWithMS);
+    qreal msPerFixWithMSMin = 0;
+    qreal msPerFixWithMSMax = 0;
+    qreal msPerFixWithMSMean = 0;
+    qreal msPerFixWithMSMedian = 0;
+    qreal msPerFixWithMSSum = 0;
+
+    const std::vector<qreal>& msPerSecond = table->values(group, SM_MSPerSecond);
+    qreal msPerSecondMin = 0;
+    qreal msPerSecondMax = 0;
+    qreal msPerSecondMean = 0;
+    qreal msPerSecondMedian = 0;
+
+    const std::vector<qreal>& msPerSecondInFix = table->values(group, SM_MSPerSecondInFixations);
+    qreal msPerSecondInFixMin = 0;
+    qreal msPerSecondInFixMax = 0;
+    qreal msPerSecondInFixMean = 0;
+    qreal msPerSecondInFixMedian = 0;
+
+    const std::vector<qreal>& msAmplitudes = table->values(group, SM_MSAmplitude);
+    qreal msAmplitudeMin = 0;
+    qreal msAmplitudeMax = 0;
+    qreal msAmplitudeMean = 0;
+    qreal msAmplitudeMedian = 0;
+
+    const std::vector<qreal>& msIntersaccIntervals = table->values(group, SM_IntersaccadicInterval);
+    qreal msIntersaccIntervalMin = 0;
+    qreal msIntersaccIntervalMax = 0;
+    qreal msIntersaccIntervalMean = 0;
+    qreal msIntersaccIntervalMedian = 0;
+
+    const std::vector<qreal>& msDurations = table->values(group, SM_MSDuration);
+    qreal msDurationMin = 0;
+    qreal msDurationMax = 0;
+    qreal msDurationMean = 0;
+    qreal msDurationMedian = 0;
+
+    const std::vector<qreal>& msPeakVelocities = table->values(group, SM_MSPeakVelocity);
+    qreal msVelocityMin = 0;
+    qreal msVelocityMax = 0;
+    qreal msVelocityMean = 0;
+    qreal msVelocityMedian = 0;
+
+    rawDataSamplesSum = std::accumulate(rawDataSamples.begin(), rawDataSamples.end(), 0.0);
+    rawDataSamplesMin = *std::min_element(rawDataSamples.begin(), rawDataSamples.end());
+    rawDataSamplesMax = *std::max_element(rawDataSamples.begin(), rawDataSamples.end());
+    rawDataSamplesMedian = table->quantile(group, SM_RawDataSamples, 0.5).m_value;
+    rawDataSamplesMean = rawDataSamplesSum / trialCount;
+
+    durationSum = std::accumulate(durationsInSec.begin(), durationsInSec.end(), 0.0);
+    durationMin = *std::min_element(durationsInSec.begin(), durationsInSec.end());
+    durationMax = *std::max_element(durationsInSec.begin(), durationsInSec.end());
+    durationMedian = table->quantile(group, SM_TrialDuration, 0.5).m_value;
+    durationMean = durationSum / trialCount;
+
+    fixCountSum = int(std::accumulate(fixationCounts.begin(), fixationCounts.end(), 0.0));
+    fixCountMin = *std::min_element(fixationCounts.begin(), fixationCounts.end());
+    fixCountMax = *std::max_element(fixationCounts.begin(), fixationCounts.end());
+    fixCountMedian = table->quantile(group, SM_FixationCount, 0.5).m_value;
+    fixCountMean = qreal(fixCountSum) / trialCount;
+
+    fixWithMSCountSum = int(std::accumulate(fixationWithMSCounts.begin(), fixationWithMSCounts.end(), 0.0));
+    fixWithMSCountMin = *std::min_element(fixationWithMSCounts.begin(), fixationWithMSCounts.end());
+    fixWithMSCountMax = *std::max_element(fixationWithMSCounts.begin(), fixationWithMSCounts.end());
+    fixWithMSCountMedian = table->quantile(group, SM_FixationWithMSCount, 0.5).m_value;
+    fixWithMSCountMean = qreal(fixWithMSCountSum) / trialCount;
+
+    qreal fixWithMSRatioSum = std::accumulate(fixationWithMSRatio.begin(), fixationWithMSRatio.end(), 0.0);
+    fixWithMSRatioMin = *std::min_element(fixationWithMSRatio.begin(),fixationWithMSRatio.end());
+    fixWithMSRatioMax = *std::max_element(fixationWithMSRatio.begin(),fixationWithMSRatio.end());
+    fixWithMSRatioMedian = table->quantile(group, SM_FixationWithMSPercentage, 0.5).m_value;
+    fixWithMSRatioMean = qreal(fixWithMSRatioSum) / fixationWithMSRatio.size();
+
+    if (!fixDurationsInSec.empty())
+    {
+        fixDurationSum = std::accumulate(fixDurationsInSec.begin(), fixDurationsInSec.end(), 0.0);
+        fixDurationMin = *std::min_element(fixDurationsInSec.begin(), fixDurationsInSec.end());
+        fixDurationMax = *std::max_element(fixDurationsInSec.begin(), fixDurationsInSec.end());
+        fixDurationMedian = table->quantile(group, SM_FixationDuration, 0.5).m_value;
+        fixDurationMean = fixDurationSum / fixDurationsInSec.size();
+    }
+
+    if (!fixDurationsWithMSInSec.empty())
+    {
+        fixDurationWithMSSum = std::accumulate(fixDurationsWithMSInSec.begin(), fixDurationsWithMSInSec.end(), 0.0);
+        fixDurationWithMSMin = *std::min_element(fixDurationsWithMSInSec.begin(), fixDurationsWithMSInSec.end());
+        fixDurationWithMSMax = *std::max_element(fixDurationsWithMSInSec.begin(), fixDurationsWithMSInSec.end());
+        fixDurationWithMSMedian = table->quantile(group, SM_FixationWithMSDuration, 0.5).m_value;
+        fixDurationWithMSMean = fixDurationWithMSSum / fixDurationsWithMSInSec.size();
+    }
+
+    msCountSum = int(std::accumulate(msCounts.begin(), msCounts.end(), 0.0));
+    msCountMin = *std::min_element(msCounts.begin(), msCounts.end());
+    msCountMax = *std::max_element(msCounts.begin(), msCounts.end());
+    msCountMedian = table->quantile(group, SM_MSCount, 0.5).m_value;
+    msCountMean = double(msCountSum) / trialCount;
+
+    if (!msPerFix.empty())
+    {
+        msPerFixSum = std::accumulate(msPerFix.begin(), msPerFix.end(), 0.0);
+        msPerFixMin = *std::min_element(msPerFix.begin(), msPerFix.end());
+        msPerFixMax = *std::max_element(msPerFix.begin(), msPerFix.end());
+        msPerFixMedian = table->quantile(group, SM_MSPerFixation, 0.5).m_value;
+        msPerFixMean = msPerFixSum / msPerFix.size();
+    }
+
+    if (!msPerFixWithMS.empty())
+    {
+        msPerFixWithMSSum = std::accumulate(msPerFixWithMS.begin(), msPerFixWithMS.end(), 0.0);
+        msPerFixWithMSMin = *std::min_element(msPerFixWithMS.begin(), msPerFixWithMS.end());
+        msPerFixWithMSMax = *std::max_element(msPerFixWithMS.begin(), msPerFixWithMS.end());
+        msPerFixWithMSMedian = table->quantile(group, SM_MSPerFixationWithMS, 0.5).m_value;
+        msPerFixWithMSMean = msPerFixWithMSSum / msPerFixWithMS.size();
+    }
+
+    if (!msPerSecond.empty())
+    {
+        qreal msPerSecondSum = std::accumulate(msPerSecond.begin(), msPerSecond.end(), 0.0);
+        msPerSecondMin = *std::min_element(msPerSecond.begin(), msPerSecond.end());
+        msPerSecondMax = *std::max_element(msPerSecond.begin(), msPerSecond.end());
+        msPerSecondMedian = table->quantile(group, SM_MSPerSecond, 0.5).m_value;
+        msPerSecondMean = msPerSecondSum / trialCount;
+    }
+
+    if (!msPerSecondInFix.empty())
+    {
+        qreal msPerSecondInFixSum = std::accumulate(msPerSecondInFix.begin(), msPerSecondInFix.end(), 0.0);
+        msPerSecondInFixMin = *std::min_element(msPerSecondInFix.begin(), msPerSecondInFix.end());
+        msPerSecondInFixMax = *std::max_element(msPerSecondInFix.begin(), msPerSecondInFix.end());
+        msPerSecondInFixMedian = table->quantile(group, SM_MSPerSecondInFixations, 0.5).m_value;
+        msPerSecondInFixMean = msPerSecondInFixSum / msPerSecondInFix.size();
+    }
+
+    if (!msAmplitudes.empty())
+    {
+        qreal msAmplitudeSum = std::accumulate(msAmplitudes.begin(), msAmplitudes.end(), 0.0);
+        msAmplitudeMin = *std::min_element(msAmplitudes.begin(), msAmplitudes.end());
+        msAmplitudeMax = *std::max_element(msAmplitudes.begin(), msAmplitudes.end());
+        msAmplitudeMedian = table->quantile(group, SM_MSAmplitude, 0.5).m_value;
+        msAmplitudeMean = msAmplitudeSum / msAmplitudes.size();
+    }
+
+    if (!msDurations.empty())
+    {
+        qreal msDurationSum = std::accumulate(msDurations.begin(), msDurations.end(), 0.0);
+        msDurationMin = *std::min_element(msDurations.begin(), msDurations.end());
+        msDurationMax = *std::max_element(msDurations.begin(), msDurations.end());
+        msDurationMedian = table->quantile(group, SM_MSDuration, 0.5).m_value;
+        msDurationMean = msDurationSum / msDurations.size();
+    }
+
+    if (!msIntersaccIntervals.empty())
+    {
+        qreal msIntersaccInterrvalSum = std::accumulate(msIntersaccIntervals.begin(), msIntersaccIntervals.end(), 0.0);
+        msIntersaccIntervalMin = *std::min_element(msIntersaccIntervals.begin(), msIntersaccIntervals.end());
+        msIntersaccIntervalMax = *std::max_element(msIntersaccIntervals.begin(), msIntersaccIntervals.end());
+        msIntersaccIntervalMedian = table->quantile(group, SM_IntersaccadicInterval, 0.5).m_value;
+        msIntersaccIntervalMean = msIntersaccInterrvalSum / msIntersaccIntervals.size();
+    }
 
-        if (!msPerFixWithMS.empty())
-        {
-            msPerFixWithMSSum = std::accumulate(msPerFixWithMS.begin(), msPerFixWithMS.end(), 0.0);
-            msPerFixWithMSMin = *std::min_element(msPerFixWithMS.begin(), msPerFixWithMS.end());
-            msPerFixWithMSMax = *std::max_element(msPerFixWithMS.begin(), msPerFixWithMS.end());
-            msPerFixWithMSMedian = MathHelpFunctions::median<int>(msPerFixWithMS);
-            msPerFixWithMSMean = msPerFixWithMSSum / msPerFixWithMS.size();
-        }
+    if (!msPeakVelocities.empty())
+    {
+        qreal msVelocitySum = std::accumulate(msPeakVelocities.begin(), msPeakVelocities.end(), 0.0);
+        msVelocityMin = *std::min_element(msPeakVelocities.begin(), msPeakVelocities.end());
+        msVelocityMax = *std::max_element(msPeakVelocities.begin(), msPeakVelocities.end());
+        msVelocityMedian = table->quantile(group, SM_MSPeakVelocity, 0.5).m_value;
+        msVelocityMean = msVelocitySum / msPeakVelocities.size();
+    }
 
-        if (!msPerSecond.empty())
-        {
-            qreal msPerSecondSum = std::accumulate(msPerSecond.begin(), msPerSecond.end(), 0.0);
-            msPerSecondMin = *std::min_element(msPerSecond.begin(), msPerSecond.end());
-            msPerSecondMax = *std::max_element(msPerSecond.begin(), msPerSecond.end());
-            msPerSecondMedian = MathHelpFunctions::median<qreal>(msPerSecond);
-            msPerSecondMean = msPerSecondSum / currentTrials.size();
-        }
+    m_ui->m_inputSamplesNumberLabelMin->setText(QString::number(rawDataSamplesMin, 'g', 10));
+    m_ui->m_inputSamplesNumberLabelMax->setText(QString::number(rawDataSamplesMax, 'g', 10));
+    m_ui->m_inputSamplesNumberLabelMean->setText(QString::number(rawDataSamplesMean, 'f', 2));
+    m_ui->m_inputSamplesNumberLabelMedian->setText(QString::number(rawDataSamplesMedian, 'g', 10));
+    m_ui->m_inputSamplesNumberLabelSum->setText(QString::number(rawDataSamplesSum, 'g', 10));
 
-        if (!msPerSecondInFix.empty())
-        {
-            qreal msPerSecondInFixSum = std::accumulate(msPerSecondInFix.begin(), msPerSecondInFix.end(), 0.0);
-            msPerSecondInFixMin = *std::min_element(msPerSecondInFix.begin(), msPerSecondInFix.end());
-            msPerSecondInFixMax = *std::max_element(msPerSecondInFix.begin(), msPerSecondInFix.end());
-            msPerSecondInFixMedian = MathHelpFunctions::median<qreal>(msPerSecondInFix);
-            msPerSecondInFixMean = msPerSecondInFixSum / msPerSecondInFix.size();
-        }
+    m_ui->m_durationValueLabelMin->setText(QString::number(durationMin, 'f', 2));
+    m_ui->m_durationValueLabelMax->setText(QString::number(durationMax, 'f', 2));
+    m_ui->m_durationValueLabelMean->setText(QString::number(durationMean, 'f', 2));
+    m_ui->m_durationValueLabelMedian->setText(QString::number(durationMedian, 'f', 2));
+    m_ui->m_durationValueLabelSum->setText(QString::number(durationSum, 'f', 2));
 
-        if (!msAmplitudes.empty())
-        {
-            qreal msAmplitudeSum = std::accumulate(msAmplitudes.begin(), msAmplitudes.end(), 0.0);
-            msAmplitudeMin = *std::min_element(msAmplitudes.begin(), msAmplitudes.end());
-            msAmplitudeMax = *std::max_element(msAmplitudes.begin(), msAmplitudes.end());
-            msAmplitudeMedian = MathHelpFunctions::median<qreal>(msAmplitudes);
-            msAmplitudeMean = msAmplitudeSum / msAmplitudes.size();
-        }
+    m_ui->m_fixationCountLabelMin->setText(QString::number(fixCountMin, 'g', 10));
+    m_ui->m_fixationCountLabelMax->setText(QString::number(fixCountMax, 'g', 10));
+    m_ui->m_fixationCountLabelMean->setText(QString::number(fixCountMean, 'f', 2));
+    m_ui->m_fixationCountLabelMedian->setText(QString::number(fixCountMedian, 'f', 2));
+    m_ui->m_fixationCountLabelSum->setText(QString::number(fixCountSum, 'g', 10));
 
-        if (!msDurations.empty())
-        {
-            qreal msDurationSum = std::accumulate(msDurations.begin(), msDurations.end(), 0.0);
-            msDurationMin = *std::min_element(msDurations.begin(), msDurations.end());
-            msDurationMax = *std::max_element(msDurations.begin(), msDurations.end());
-            msDurationMedian = MathHelpFunctions::median<qreal>(msDurations);
-            msDurationMean = msDurationSum / msDurations.size();
-        }
+    m_ui->m_fixationsWithMicrosaccadesCountLabelMin->setText(QString::number(fixWithMSCountMin, 'g', 10));
+    m_ui->m_fixationsWithMicrosaccadesCountLabelMax->setText(QString::number(fixWithMSCountMax, 'g', 10));
+    m_ui->m_fixationsWithMicrosaccadesCountLabelMean->setText(QString::number(fixWithMSCountMean, 'f', 2));
+    m_ui->m_fixationsWithMicrosaccadesCountLabelMedian->setText(QString::number(fixWithMSCountMedian, 'f', 2));
+    m_ui->m_fixationsWithMicrosaccadesCountLabelSum->setText(QString::number(fixWithMSCountSum, 'g', 10));
 
-        if (!msIntersaccIntervals.empty())
-        {
-            qreal msIntersaccInterrvalSum = std::accumulate(msIntersaccIntervals.begin(), msIntersaccIntervals.end(), 0.0);
-            msIntersaccIntervalMin = *std::min_element(msIntersaccIntervals.begin(), msIntersaccIntervals.end());
-            msIntersaccIntervalMax = *std::max_element(msIntersaccIntervals.begin(), msIntersaccIntervals.end());
-            msIntersaccIntervalMedian = MathHelpFunctions::median<qreal>(msIntersaccIntervals);
-            msIntersaccIntervalMean = msIntersaccInterrvalSum / msIntersaccIntervals.size();
-        }
+    m_ui->m_fixationsWithMicrosaccadesRatioLabelMin->setText(QString::number(fixWithMSRatioMin, 'f', 2));
+    m_ui->m_fixationsWithMicrosaccadesRatioLabelMax->setText(QString::number(fixWithMSRatioMax, 'f', 2));
+    m_ui->m_fixationsWithMicrosaccadesRatioLabelMean->setText(QString::number(fixWithMSRatioMean, 'f', 2));
+    m_ui->m_fixationsWithMicrosaccadesRatioLabelMedian->setText(QString::number(fixWithMSRatioMedian, 'f', 2));
 
-        if (!msPeakVelocities.empty())
-        {
-            qreal msVelocitySum = std::accumulate(msPeakVelocities.begin(), msPeakVelocities.end(), 0.0);
-            msVelocityMin = *std::min_element(msPeakVelocities.begin(), msPeakVelocities.end());
-            msVelocityMax = *std::max_element(msPeakVelocities.begin(), msPeakVelocities.end());
-            msVelocityMedian = MathHelpFunctions::median<qreal>(msPeakVelocities);
-            msVelocityMean = msVelocitySum / msPeakVelocities.size();
-        }
+    m_ui->m_fixationDurationLabelMin->setText(QString::number(fixDurationMin, 'f', 2));
+    m_ui->m_fixationDurationLabelMax->setText(QString::number(fixDurationMax, 'f', 2));
+    m_ui->m_fixationDurationLabelMean->setText(QString::number(fixDurationMean, 'f', 2));
+    m_ui->m_fixationDurationLabelMedian->setText(QString::number(fixDurationMedian, 'f', 2));
+    m_ui->m_fixationDurationLabelSum->setText(QString::number(fixDurationSum, 'f', 2));
 
-        m_ui->m_inputSamplesNumberLabelMin->setText(QString::number(rawDataSamplesMin, 'g', 10));
-        m_ui->m_inputSamplesNumberLabelMax->setText(QString::number(rawDataSamplesMax, 'g', 10));
-        m_ui->m_inputSamplesNumberLabelMean->setText(QString::number(rawDataSamplesMean, 'f', 2));
-        m_ui->m_inputSamplesNumberLabelMedian->setText(QString::number(rawDataSamplesMedian, 'g', 10));
-        m_ui->m_inputSamplesNumberLabelSum->setText(QString::number(rawDataSamplesSum, 'g', 10));
-
-        m_ui->m_durationValueLabelMin->setText(QString::number(durationMin, 'f', 2));
-        m_ui->m_durationValueLabelMax->setText(QString::number(durationMax, 'f', 2));
-        m_ui->m_durationValueLabelMean->setText(QString::number(durationMean, 'f', 2));
-        m_ui->m_durationValueLabelMedian->setText(QString::number(durationMedian, 'f', 2));
-        m_ui->m_durationValueLabelSum->setText(QString::number(durationSum, 'f', 2));
-
-        m_ui->m_fixationCountLabelMin->setText(QString::number(fixCountMin, 'g', 10));
-        m_ui->m_fixationCountLabelMax->setText(QString::number(fixCountMax, 'g', 10));
-        m_ui->m_fixationCountLabelMean->setText(QString::number(fixCountMean, 'f', 2));
-        m_ui->m_fixationCountLabelMedian->setText(QString::number(fixCountMedian, 'f', 2));
-        m_ui->m_fixationCountLabelSum->setText(QString::number(fixCountSum, 'g', 10));
-
-        m_ui->m_fixationsWithMicrosaccadesCountLabelMin->setText(QString::number(fixWithMSCountMin, 'g', 10));
-        m_ui->m_fixationsWithMicrosaccadesCountLabelMax->setText(QString::number(fixWithMSCountMax, 'g', 10));
-        m_ui->m_fixationsWithMicrosaccadesCountLabelMean->setText(QString::number(fixWithMSCountMean, 'f', 2));
-        m_ui->m_fixationsWithMicrosaccadesCountLabelMedian->setText(QString::number(fixWithMSCountMedian, 'f', 2));
-        m_ui->m_fixationsWithMicrosaccadesCountLabelSum->setText(QString::number(fixWithMSCountSum, 'g', 10));
-
-        m_ui->m_fixationsWithMicrosaccadesRatioLabelMin->setText(QString::number(fixWithMSRatioMin, 'f', 2));
-        m_ui->m_fixationsWithMicrosaccadesRatioLabelMax->setText(QString::number(fixWithMSRatioMax, 'f', 2));
-        m_ui->m_fixationsWithMicrosaccadesRatioLabelMean->setText(QString::number(fixWithMSRatioMean, 'f', 2));
-        m_ui->m_fixationsWithMicrosaccadesRatioLabelMedian->setText(QString::number(fixWithMSRatioMedian, 'f', 2));
-
-        m_ui->m_fixationDurationLabelMin->setText(QString::number(fixDurationMin, 'f', 2));
-        m_ui->m_fixationDurationLabelMax->setText(QString::number(fixDurationMax, 'f', 2));
-        m_ui->m_fixationDurationLabelMean->setText(QString::number(fixDurationMean, 'f', 2));
-        m_ui->m_fixationDurationLabelMedian->setText(QString::number(fixDurationMedian, 'f', 2));
-        m_ui->m_fixationDurationLabelSum->setText(QString::number(fixDurationSum, 'f', 2));
-
-        m_ui->m_fixationDurationWithMSLabelMin->setText(QString::number(fixDurationWithMSMin, 'f', 2));
-        m_ui->m_fixationDurationWithMSLabelMax->setText(QString::number(fixDurationWithMSMax, 'f', 2));
-        m_ui->m_fixationDurationWithMSLabelMean->setText(QString::number(fixDurationWithMSMean, 'f', 2));
-        m_ui->m_fixationDurationWithMSLabelMedian->setText(QString::number(fixDurationWithMSMedian, 'f', 2));
-        m_ui->m_fixationDurationWithMSLabelSum->setText(QString::number(fixDurationWithMSSum, 'f', 2));
-
-        m_ui->m_microsaccadesCountLabelMin->setText(QString::number(msCountMin, 'g', 10));
-        m_ui->m_microsaccadesCountLabelMax->setText(QString::number(msCountMax, 'g', 10));
-        m_ui->m_microsaccadesCountLabelMean->setText(QString::number(msCountMean, 'f', 2));
-        m_ui->m_microsaccadesCountLabelMedian->setText(QString::number(msCountMedian, 'f', 2));
-        m_ui->m_microsaccadesCountLabelSum->setText(QString::number(msCountSum, 'g', 10));
-
-        m_ui->m_microsaccadesPerFixationLabelMin->setText(QString::number(msPerFixMin, 'g', 10));
-        m_ui->m_microsaccadesPerFixationLabelMax->setText(QString::number(msPerFixMax, 'g', 10));
-        m_ui->m_microsaccadesPerFixationLabelMean->setText(QString::number(msPerFixMean, 'f', 2));
-        m_ui->m_microsaccadesPerFixationLabelMedian->setText(QString::number(msPerFixMedian, 'f', 2));
-        m_ui->m_microsaccadesPerFixationLabelSum->setText(QString::number(msPerFixSum, 'g', 10));
-
-        m_ui->m_microsaccadesPerFixationWithMSLabelMin->setText(QString::number(msPerFixWithMSMin, 'g', 10));
-        m_ui->m_microsaccadesPerFixationWithMSLabelMax->setText(QString::number(msPerFixWithMSMax, 'g', 10));
-        m_ui->m_microsaccadesPerFixationWithMSLabelMean->setText(QString::number(msPerFixWithMSMean, 'f', 2));
-        m_ui->m_microsaccadesPerFixationWithMSLabelMedian->setText(QString::number(msPerFixWithMSMedian, 'f', 2));
-        m_ui->m_microsaccadesPerFixationWithMSLabelSum->setText(QString::number(msPerFixWithMSSum, 'g', 10));
-
-        m_ui->m_microsaccadesPerSecondLabelMin->setText(QString::number(msPerSecondMin, 'f', 2));
-        m_ui->m_microsaccadesPerSecondLabelMax->setText(QString::number(msPerSecondMax, 'f', 2));
-        m_ui->m_microsaccadesPerSecondLabelMean->setText(QString::number(msPerSecondMean, 'f', 2));
-        m_ui->m_microsaccadesPerSecondLabelMedian->setText(QString::number(msPerSecondMedian, 'f', 2));
-
-        m_ui->m_microsaccadesPerSecondInFixationsLabelMin->setText(QString::number(msPerSecondInFixMin, 'f', 2));
-        m_ui->m_microsaccadesPerSecondInFixationsLabelMax->setText(QString::number(msPerSecondInFixMax, 'f', 2));
-        m_ui->m_microsaccadesPerSecondInFixationsLabelMean->setText(QString::number(msPerSecondInFixMean, 'f', 2));
-        m_ui->m_microsaccadesPerSecondInFixationsLabelMedian->setText(QString::number(msPerSecondInFixMedian, 'f', 2));
-
-        m_ui->m_microsaccadeAmplitudeLabelMin->setText(QString::number(msAmplitudeMin, 'f', 2));
-        m_ui->m_microsaccadeAmplitudeLabelMax->setText(QString::number(msAmplitudeMax, 'f', 2));
-        m_ui->m_microsaccadeAmplitudeLabelMean->setText(QString::number(msAmplitudeMean, 'f', 2));
-        m_ui->m_microsaccadeAmplitudeLabelMedian->setText(QString::number(msAmplitudeMedian, 'f', 2));
-
-        m_ui->m_microsaccadesIntersaccIntervalLabelMin->setText(QString::number(msIntersaccIntervalMin, 'f', 2));
-        m_ui->m_microsaccadesIntersaccIntervalLabelMax->setText(QString::number(msIntersaccIntervalMax, 'f', 2));
-        m_ui->m_microsaccadesIntersaccIntervalLabelMean->setText(QString::number(msIntersaccIntervalMean, 'f', 2));
-        m_ui->m_microsaccadesIntersaccIntervalLabelMedian->setText(QString::number(msIntersaccIntervalMedian, 'f', 2));
-
-        m_ui->m_microsaccadeDurationLabelMin->setText(QString::number(msDurationMin, 'f', 2));
-        m_ui->m_microsaccadeDurationLabelMax->setText(QString::number(msDurationMax, 'f', 2));
-        m_ui->m_microsaccadeDurationLabelMean->setText(QString::number(msDurationMean, 'f', 2));
-        m_ui->m_microsaccadeDurationLabelMedian->setText(QString::number(msDurationMedian, 'f', 2));
-
-        m_ui->m_microsaccadeVelocityLabelMin->setText(QString::number(msVelocityMin, 'f', 2));
-        m_ui->m_microsaccadeVelocityLabelMax->setText(QString::number(msVelocityMax, 'f', 2));
-        m_ui->m_microsaccadeVelocityLabelMean->setText(QString::number(msVelocityMean, 'f', 2));
-        m_ui->m_microsaccadeVelocityLabelMedian->setText(QString::number(msVelocityMedian, 'f', 2));
+    m_ui->m_fixationDurationWithMSLabelMin->setText(QString::number(fixDurationWithMSMin, 'f', 2));
+    m_ui->m_fixationDurationWithMSLabelMax->setText(QString::number(fixDurationWithMSMax, 'f', 2));
+    m_ui->m_fixationDurationWithMSLabelMean->setText(QString::number(fixDurationWithMSMean, 'f', 2));
+    m_ui->m_fixationDurationWithMSLabelMedian->setText(QString::number(fixDurationWithMSMedian, 'f', 2));
+    m_ui->m_fixationDurationWithMSLabelSum->setText(QString::number(fixDurationWithMSSum, 'f', 2));
+
+    m_ui->m_microsaccadesCountLabelMin->setText(QString::number(msCountMin, 'g', 10));
+    m_ui->m_microsaccadesCountLabelMax->setText(QString::number(msCountMax, 'g', 10));
+    m_ui->m_microsaccadesCountLabelMean->setText(QString::number(msCountMean, 'f', 2));
+    m_ui->m_microsaccadesCountLabelMedian->setText(QString::number(msCountMedian, 'f', 2));
+    m_ui->m_microsaccadesCountLabelSum->setText(QString::number(msCountSum, 'g', 10));
+
+    m_ui->m_microsaccadesPerFixationLabelMin->setText(QString::number(msPerFixMin, 'g', 10));
+    m_ui->m_microsaccadesPerFixationLabelMax->setText(QString::number(msPerFixMax, 'g', 10));
+    m_ui->m_microsaccadesPerFixationLabelMean->setText(QString::number(msPerFixMean, 'f', 2));
+    m_ui->m_microsaccadesPerFixationLabelMedian->setText(QString::number(msPerFixMedian, 'f', 2));
+    m_ui->m_microsaccadesPerFixationLabelSum->setText(QString::number(msPerFixSum, 'g', 10));
+
+    m_ui->m_microsaccadesPerFixationWithMSLabelMin->setText(QString::number(msPerFixWithMSMin, 'g', 10));
+    m_ui->m_microsaccadesPerFixationWithMSLabelMax->setText(QString::number(msPerFixWithMSMax, 'g', 10));
+    m_ui->m_microsaccadesPerFixationWithMSLabelMean->setText(QString::number(msPerFixWithMSMean, 'f', 2));
+    m_ui->m_microsaccadesPerFixationWithMSLabelMedian->setText(QString::number(msPerFixWithMSMedian, 'f', 2));
+    m_ui->m_microsaccadesPerFixationWithMSLabelSum->setText(QString::number(msPerFixWithMSSum, 'g', 10));
+
+    m_ui->m_microsaccadesPerSecondLabelMin->setText(QString::number(msPerSecondMin, 'f', 2));
+    m_ui->m_microsaccadesPerSecondLabelMax->setText(QString::number(msPerSecondMax, 'f', 2));
+    m_ui->m_microsaccadesPerSecondLabelMean->setText(QString::number(msPerSecondMean, 'f', 2));
+    m_ui->m_microsaccadesPerSecondLabelMedian->setText(QString::number(msPerSecondMedian, 'f', 2));
+
+    m_ui->m_microsaccadesPerSecondInFixationsLabelMin->setText(QString::number(msPerSecondInFixMin, 'f', 2));
+    m_ui->m_microsaccadesPerSecondInFixationsLabelMax->setText(QString::number(msPerSecondInFixMax, 'f', 2));
+    m_ui->m_microsaccadesPerSecondInFixationsLabelMean->setText(QString::number(msPerSecondInFixMean, 'f', 2));
+    m_ui->m_microsaccadesPerSecondInFixationsLabelMedian->setText(QString::number(msPerSecondInFixMedian, 'f', 2));
+
+    m_ui->m_microsaccadeAmplitudeLabelMin->setText(QString::number(msAmplitudeMin, 'f', 2));
+    m_ui->m_microsaccadeAmplitudeLabelMax->setText(QString::number(msAmplitudeMax, 'f', 2));
+    m_ui->m_microsaccadeAmplitudeLabelMean->setText(QString::number(msAmplitudeMean, 'f', 2));
+    m_ui->m_microsaccadeAmplitudeLabelMedian->setText(QString::number(msAmplitudeMedian, 'f', 2));
+
+    m_ui->m_microsaccadesIntersaccIntervalLabelMin->setText(QString::number(msIntersaccIntervalMin, 'f', 2));
+    m_ui->m_microsaccadesIntersaccIntervalLabelMax->setText(QString::number(msIntersaccIntervalMax, 'f', 2));
+    m_ui->m_microsaccadesIntersaccIntervalLabelMean->setText(QString::number(msIntersaccIntervalMean, 'f', 2));
+    m_ui->m_microsaccadesIntersaccIntervalLabelMedian->setText(QString::number(msIntersaccIntervalMedian, 'f', 2));
+
+    m_ui->m_microsaccadeDurationLabelMin->setText(QString::number(msDurationMin, 'f', 2));
+    m_ui->m_microsaccadeDurationLabelMax->setText(QString::number(msDurationMax, 'f', 2));
+    m_ui->m_microsaccadeDurationLabelMean->setText(QString::number(msDurationMean, 'f', 2));
+    m_ui->m_microsaccadeDurationLabelMedian->setText(QString::number(msDurationMedian, 'f', 2));
+
+    m_ui->m_microsaccadeVelocityLabelMin->setText(QString::number(msVelocityMin, 'f', 2));
+    m_ui->m_microsaccadeVelocityLabelMax->setText(QString::number(msVelocityMax, 'f', 2));
+    m_ui->m_microsaccadeVelocityLabelMean->setText(QString::number(msVelocityMean, 'f', 2));
+    m_ui->m_microsaccadeVelocityLabelMedian->setText(QString::number(msVelocityMedian, 'f', 2));
+
+    // estimated medians are marked with their error bound
+    qreal rankError = table->rankError(group);
+    if (rankError > 0)
+    {
+        m_ui->m_statisticsMedianHeaderLabel->setText(tr("~Median"));
+        m_ui->m_statisticsMedianHeaderLabel->setToolTip(
+                    tr("Medians are estimated with quantile sketches: rank error below %1% (99% "
+                       "confidence).").arg(QString::number(rankError * 100, 'f', 1)));
+    }
+    else
+    {
+        m_ui->m_statisticsMedianHeaderLabel->setText(tr("Median"));
+        m_ui->m_statisticsMedianHeaderLabel->setToolTip(tr("Exact medians."));
     }
 }
 
@@ -1447,14 +1494,14 @@ std::vector<std::vector<Fixation*> > MainWindow::getFixationsForTrials(
     for (size_t i = 0; i < trials.size(); ++i)
     {
         std::vector<Fixation*> fixations;
+        TimeLimit limit = trials[i]->timeLimit();
 
         if (trials.size() > 1 || plotElements == PF_All)
         {
             for (int j = 0; j < trials[i]->fixationsCount(); ++j)
             {
                 Fixation* fixation = trials[i]->getFixationAt(j);
-                if (!trials[i]->outsideTimeLimitIfActivated(fixation->getStartIndex(),
-                                                            fixation->getEndIndex()))
+                if (!limit.outside(fixation->getStartIndex(), fixation->getEndIndex()))
                 {
                     fixations.push_back(fixation);
                 }
@@ -1463,8 +1510,7 @@ std::vector<std::vector<Fixation*> > MainWindow::getFixationsForTrials(
         else if (plotElements == PF_Current && m_settings->m_currentFixationIndex != -1 && i == 0)
         {
             Fixation* fixation = trials[i]->getFixationAt(m_settings->m_currentFixationIndex);
-            if (!trials[i]->outsideTimeLimitIfActivated(fixation->getStartIndex(),
-                                                        fixation->getEndIndex()))
+            if (!limit.outside(fixation->getStartIndex(), fixation->getEndIndex()))
             {
                 fixations.push_back(fixation);
             }
@@ -1481,8 +1527,7 @@ std::vector<std::vector<Fixation*> > MainWindow::getFixationsForTrials(
                       m_settings->m_previousFixationsCount)))
                 {
                     Fixation* fixation = trials[i]->getFixationAt(j);
-                    if (!trials[i]->outsideTimeLimitIfActivated(fixation->getStartIndex(),
-                                                                fixation->getEndIndex()))
+                    if (!limit.outside(fixation->getStartIndex(), fixation->getEndIndex()))
                     {
                         fixations.push_back(fixation);
                     }
@@ -1505,11 +1550,11 @@ std::vector<std::vector<Saccade*> > MainWindow::getSaccadesForTrial(
     for (size_t i = 0; i < trials.size(); ++i)
     {
         std::vector<Saccade*> saccades;
+        TimeLimit limit = trials[i]->timeLimit();
         for (size_t j = 0; j < trials[i]->saccadesCount(); ++j)
         {
             Saccade* saccade = trials[i]->getSaccadeAt(j);
-            if (!trials[i]->outsideTimeLimitIfActivated(int(saccade->getOnsetIndex()),
-                                                        int(saccade->getEndIndex())))
+            if (!limit.outside(int(saccade->getOnsetIndex()), int(saccade->getEndIndex())))
             {
                 saccades.push_back(saccade);
             }
@@ -2090,6 +2135,11 @@ QString MainWindow::getMicrosaccadesDetectionSettingString() const
 
     settingsList << tr("MS_UseMicrosaccadesFromInput : %1").arg(QString::number(m_settings->m_microsaccadeSettings->m_fromInputFile));
     settingsList << tr("MS_RelativeVelocityThreshold : %1").arg(QString::number(m_settings->m_microsaccadeSettings->m_velocityThreshold));
+    settingsList << tr("MS_DetectionAlgorithm : %1").arg(QString::number(m_settings->m_microsaccadeSettings->m_algorithm));
+    settingsList << tr("MS_PreFilter : %1").arg(QString::number(m_settings->m_microsaccadeSettings->m_preFilter));
+    settingsList << tr("MS_PreFilterWindowSize : %1").arg(QString::number(m_settings->m_microsaccadeSettings->m_preFilterWindowSize));
+    settingsList << tr("MS_GapInterpolation : %1").arg(QString::number(m_settings->m_microsaccadeSettings->m_gapInterpolation));
+    settingsList << tr("MS_MaxGapDuration : %1").arg(QString::number(m_settings->m_microsaccadeSettings->m_maxGapDuration));
     settingsList << tr("MS_MinDuration : %1").arg(QString::number(m_settings->m_microsaccadeSettings->m_minDuration));
     settingsList << tr("MS_Binocular : %1").arg(QString::number(m_settings->m_microsaccadeSettings->m_binocular));
     settingsList << tr("MS_MaxDuration : %1").arg(QString::number(m_settings->m_microsaccadeSettings->m_maxDuration));
@@ -2128,6 +2178,11 @@ QString MainWindow::getFixationDetectionSettingString() const
 
     settingsList << tr("Fix_UseFixationsFromInput : %1").arg(QString::number(m_settings->m_fixationSettings->m_fromInputFile));
     settingsList << tr("Fix_RelativeVelocityThreshold : %1").arg(QString::number(m_settings->m_fixationSettings->m_velocityThreshold));
+    settingsList << tr("Fix_DetectionAlgorithm : %1").arg(QString::number(m_settings->m_fixationSettings->m_algorithm));
+    settingsList << tr("Fix_PreFilter : %1").arg(QString::number(m_settings->m_fixationSettings->m_preFilter));
+    settingsList << tr("Fix_PreFilterWindowSize : %1").arg(QString::number(m_settings->m_fixationSettings->m_preFilterWindowSize));
+    settingsList << tr("Fix_GapInterpolation : %1").arg(QString::number(m_settings->m_fixationSettings->m_gapInterpolation));
+    settingsList << tr("Fix_MaxGapDuration : %1").arg(QString::number(m_settings->m_fixationSettings->m_maxGapDuration));
     settingsList << tr("Fix_MinDuration : %1").arg(QString::number(m_settings->m_fixationSettings->m_minDuration));
     settingsList << tr("Fix_Binocular : %1").arg(QString::number(m_settings->m_fixationSettings->m_binocular));
     settingsList << tr("Fix_MaxDuration : %1").arg(QString::number(m_settings->m_fixationSettings->m_maxDuration));
@@ -2317,6 +2372,16 @@ void MainWindow::openCSV()
 }
 
 
+void MainWindow::loadSession()
+{
+    QString fileName = getFileName(tr("Open Session"),
+                                   tr("%2 (*.%1)").arg(studySessionFile,
+                                                       studySessionFileDescription),
+                                   m_settings->m_recentDir);
+    openSession(fileName);
+}
+
+
 void MainWindow::loadMicrosaccadsSettingsFile()
 {
     QString fileName = getFileName(tr("Open Microsaccades Parameters"),
@@ -2352,113 +2417,79 @@ void MainWindow::loadColorSettingsFile()
 
 void MainWindow::updateCurrentMicrosaccadesDetection()
 {
-    qApp->setOverrideCursor(Qt::WaitCursor);
-
+    std::vector<Trial*> trials;
     if (!m_settings->m_currentTrials.empty())
     {
-        updateMicrosaccadesDetection(m_settings->m_currentTrials[0]);
+        trials.push_back(m_settings->m_currentTrials[0]);
     }
-    updateUI();
-
-    qApp->restoreOverrideCursor();
+    startDetectionJob(trials, false);
 }
 
 
 void MainWindow::updateMicrosaccadesForParticipant()
 {
-    qApp->setOverrideCursor(Qt::WaitCursor);
-
-    QElapsedTimer timer;
-    timer.start();
-
+    std::vector<Trial*> trials;
     if (!m_settings->m_currentTrials.empty())
     {
         Participant* p = m_settings->m_currentTrials[0]->getParticipant();
         for (size_t j = 0; j < p->numberOfTrials(); ++j)
         {
-            updateMicrosaccadesDetection(p->getTrialAt(int(j)));
+            trials.push_back(p->getTrialAt(int(j)));
         }
     }
-
-    qDebug() << QString("updateMicrosaccadesForParticipant: %1 ms").arg(timer.elapsed());
-
-    updateUI();
-
-    qApp->restoreOverrideCursor();
+    startDetectionJob(trials, false);
 }
 
 
 void MainWindow::updateMicrosaccadesForAllDetection()
 {
-    qApp->setOverrideCursor(Qt::WaitCursor);
-
-    QElapsedTimer timer;
-    timer.start();
-
+    std::vector<Trial*> trials;
     for (size_t i = 0; i < m_eyeTrackingData->numberOfParticipants(); ++i)
     {
         for (size_t j = 0; j < m_eyeTrackingData->participantAt(int(i))->numberOfTrials(); ++j)
         {
-            updateMicrosaccadesDetection(m_eyeTrackingData->participantAt(int(i))->getTrialAt(int(j)));
+            trials.push_back(m_eyeTrackingData->participantAt(int(i))->getTrialAt(int(j)));
         }
     }
-
-    qDebug() << QString("updateMicrosaccadesForAllDetection: %1 ms").arg(timer.elapsed());
-
-    updateUI();
-
-    qApp->restoreOverrideCursor();
+    startDetectionJob(trials, false);
 }
 
 
 void MainWindow::updateCurrentFixationsDetection()
 {
-    qApp->setOverrideCursor(Qt::WaitCursor);
-
     if (!m_settings->m_currentTrials.empty())
     {
-        updateFixationsDetection(m_settings->m_currentTrials[0]);
-
-        updateUI();
+        startDetectionJob(std::vector<Trial*>(1, m_settings->m_currentTrials[0]), true);
     }
-
-    qApp->restoreOverrideCursor();
 }
 
 
 void MainWindow::updateFixationsForCurrentParticipantDetection()
 {
-    qApp->setOverrideCursor(Qt::WaitCursor);
-
     if (!m_settings->m_currentTrials.empty())
     {
-        for (size_t j = 0; j < m_settings->m_currentTrials[0]->getParticipant()->numberOfTrials(); ++j)
+        std::vector<Trial*> trials;
+        Participant* p = m_settings->m_currentTrials[0]->getParticipant();
+        for (size_t j = 0; j < p->numberOfTrials(); ++j)
         {
-            updateFixationsDetection(m_settings->m_currentTrials[0]->getParticipant()->getTrialAt(int(j)));
+            trials.push_back(p->getTrialAt(int(j)));
         }
-
-        updateUI();
+        startDetectionJob(trials, true);
     }
-
-    qApp->restoreOverrideCursor();
 }
 
 
 void MainWindow::updateFixationsForAllDetection()
 {
-    qApp->setOverrideCursor(Qt::WaitCursor);
-
+    std::vector<Trial*> trials;
     for (size_t i = 0; i < m_eyeTrackingData->numberOfParticipants(); ++i)
     {
         for (size_t j = 0; j < m_eyeTrackingData->participantAt(int(i))->numberOfTrials(); ++j)
         {
-            updateFixationsDetection(m_eyeTrackingData->participantAt(int(i))->getTrialAt(int(j)));
+            trials.push_back(m_eyeTrackingData->participantAt(int(i))->getTrialAt(int(j)));
         }
     }
-
-    updateUI();
-
-    qApp->restoreOverrideCursor();
+    startDetectionJob(trials, true);
 }
 
 
@@ -2507,6 +2538,9 @@ void MainWindow::determineTrials()
         return;
     }
 
+    // the trials which will be shown may be updated by the detection job
+    waitForDetectionJob();
+
     qApp->setOverrideCursor(Qt::WaitCursor);
     qApp->processEvents();
 
@@ -2793,6 +2827,16 @@ void MainWindow::showSaccadeDirections(bool show)
 }
 
 
+void MainWindow::approximateMedians(bool approximate)
+{
+    if (m_settings->m_approximateQuantiles != approximate)
+    {
+        m_settings->m_approximateQuantiles = approximate;
+        updateStatisticsInfo(m_settings->m_currentTrials);
+    }
+}
+
+
 void MainWindow::showScanPath(bool show)
 {
     if (m_settings->m_showScanpath != show)
@@ -3091,6 +3135,9 @@ void MainWindow::addParticipantsInUI()
 
 void MainWindow::addTestConditionsInUI()
 {
+    // the microsaccade counts of all trials are read
+    waitForDetectionJob();
+
     std::set<int> checkedTestConditions;
     for (int i = 0; i < m_ui->m_testConditionList->count(); ++i)
     {
@@ -3150,6 +3197,12 @@ void MainWindow::addTestConditionsInUI()
 
 void MainWindow::updateMicrosaccadeStatBarsInUI()
 {
+    // the counts of all trials are read; updated when the detection job is finished
+    if (m_detectionWatcher.isRunning())
+    {
+        return;
+    }
+
     QList<QString> trialList;
     if (m_eyeTrackingData->numberOfParticipants() > 0)
     {
@@ -3264,6 +3317,7 @@ void MainWindow::dropEvent(QDropEvent* e)
     QString msParameterFile;
     QString fixParameterFile;
     QString colorSettingsFile;
+    QString sessionFile;
 
     foreach (const QUrl& url, e->mimeData()->urls())
     {
@@ -3272,6 +3326,10 @@ void MainWindow::dropEvent(QDropEvent* e)
         {
             files.push_back(fileName);
         }
+        else if (QFileInfo(fileName).suffix() == studySessionFile)
+        {
+            sessionFile = fileName;
+        }
         else if (QFileInfo(fileName).suffix() == eyeTrackingTestConditions)
         {
             testConditionFile = fileName;
@@ -3290,6 +3348,12 @@ void MainWindow::dropEvent(QDropEvent* e)
         }
     }
 
+    // a session replaces all loaded participants
+    if (!sessionFile.isEmpty())
+    {
+        openSession(sessionFile);
+    }
+
     if (!files.empty())
     {
         std::sort(files.begin(), files.end());
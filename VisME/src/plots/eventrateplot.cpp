@@ -0,0 +1,162 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file eventrateplot.cpp
+ **************************************************************************************************/
+#include "eventrateplot.h"
+
+
+EventRatePlot::EventRatePlot(Settings* settings) :
+    CartesianPlot(),
+    m_settings(settings),
+    m_timeBefore(0),
+    m_timeAfter(0),
+    m_maxRate(0)
+{
+    m_mainPlotColor = *(m_settings->m_colors.dataPlotColor);
+    m_xScale = 1;
+    m_yScale = 1;
+}
+
+
+void EventRatePlot::updatePlot(const EventLockedRate& analysis,
+                               const std::vector<EventLockedRateGroup>& groups)
+{
+    m_eventName = analysis.eventName();
+    m_timeBefore = analysis.timeBefore();
+    m_timeAfter = analysis.timeAfter();
+
+    m_bins.clear();
+    for (size_t b = 0; b < analysis.binCount(); ++b)
+    {
+        m_bins.push_back(qMakePair(analysis.binStart(b), analysis.binEnd(b)));
+    }
+
+    m_windowCenters.clear();
+    for (size_t w = 0; w < analysis.windowCount(); ++w)
+    {
+        m_windowCenters.push_back(analysis.windowCenter(w));
+    }
+
+    m_groups = groups;
+
+    m_maxRate = 0;
+    foreach (const EventLockedRateGroup& g, m_groups)
+    {
+        for (size_t b = 0; b < g.m_binCounts.size(); ++b)
+        {
+            m_maxRate = std::max(m_maxRate,
+                                 EventLockedRate::rate(g.m_binCounts[b], g.m_binExposure[b]));
+        }
+        for (size_t w = 0; w < g.m_windowCounts.size(); ++w)
+        {
+            m_maxRate = std::max(m_maxRate,
+                                 EventLockedRate::rate(g.m_windowCounts[w], g.m_windowExposure[w]));
+        }
+    }
+
+    update();
+}
+
+
+void EventRatePlot::draw(QPainter& painter)
+{
+    setPlotSize();
+
+    QColor baseColor = *(m_settings->m_colors.dataPlotBaseColor);
+
+    // center plot
+    painter.translate((width() - m_plotSize) / 2, (height() - m_plotSize) / 2);
+
+    painter.setPen(baseColor);
+    painter.setBrush(Qt::transparent);
+
+    QFont font = painter.font();
+    font.setStyleStrategy(QFont::PreferAntialias);
+    font.setPixelSize(std::max(1, m_spacingV - 2));
+    painter.setFont(font);
+
+    if (m_groups.empty())
+    {
+        drawMessage(m_plotSize, painter, tr("No events with the name %1").arg(m_eventName));
+        return;
+    }
+
+    qreal maxRate = m_maxRate > 0 ? m_maxRate : 1;
+
+    // x, y axis
+    drawAxis(m_plotSize, 0, tr("#Microsaccades per Second"),
+             tr("Time relative to %1 [ms]").arg(m_eventName), 0, 0, 0, painter, baseColor);
+
+    // markers for the time range, the event start and the maximum rate
+    int markerSize = 2;
+    QList<int> times = {-m_timeBefore, 0, m_timeAfter};
+    foreach (int time, times)
+    {
+        QPointF p = getTimePointInVis(time, 0);
+        painter.drawLine(QPointF(p.x(), p.y() - markerSize), QPointF(p.x(), p.y() + markerSize));
+        painter.drawText(QRectF(p.x() - m_plotSize / 2.0, p.y() + m_plotSize / 70.0,
+                                m_plotSize, m_plotSize / 20.0),
+                         Qt::AlignVCenter | Qt::AlignHCenter, QString::number(time));
+    }
+
+    painter.drawLine(QPointF(-markerSize, getTimePointInVis(0, maxRate).y()),
+                     QPointF(markerSize, getTimePointInVis(0, maxRate).y()));
+    painter.drawText(QRectF(-m_plotSize, getTimePointInVis(0, maxRate).y() - m_plotSize / 40.0,
+                            m_plotSize - m_plotSize / 30.0, m_plotSize / 20.0),
+                     Qt::AlignVCenter | Qt::AlignRight, QString::number(maxRate, 'f', 2));
+
+    painter.save();
+    painter.setPen(QPen(baseColor, 1, Qt::DashLine));
+    painter.drawLine(getTimePointInVis(0, 0), getTimePointInVis(0, maxRate));
+    painter.restore();
+
+    foreach (const EventLockedRateGroup& g, m_groups)
+    {
+        QColor color = getColor(g.m_testCondition);
+        QColor transparentColor = color;
+        transparentColor.setAlpha(m_settings->m_colors.alphaForPlots);
+
+        // peri-event histogram
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(transparentColor);
+        for (size_t b = 0; b < g.m_binCounts.size() && b < m_bins.size(); ++b)
+        {
+            qreal rate = EventLockedRate::rate(g.m_binCounts[b], g.m_binExposure[b]);
+            if (rate > 0)
+            {
+                painter.drawRect(QRectF(getTimePointInVis(m_bins[b].first, rate),
+                                        getTimePointInVis(m_bins[b].second, 0)));
+            }
+        }
+
+        // sliding window rate
+        QPolygonF line;
+        for (size_t w = 0; w < g.m_windowCounts.size() && w < m_windowCenters.size(); ++w)
+        {
+            qreal rate = EventLockedRate::rate(g.m_windowCounts[w], g.m_windowExposure[w]);
+            line << getTimePointInVis(m_windowCenters[w], rate);
+        }
+        painter.setPen(QPen(color, 2));
+        painter.setBrush(Qt::NoBrush);
+        painter.drawPolyline(line);
+    }
+}
+
+
+QPointF EventRatePlot::getTimePointInVis(qreal time, qreal rate)
+{
+    qreal duration = std::max(1, m_timeBefore + m_timeAfter);
+    qreal maxRate = m_maxRate > 0 ? m_maxRate : 1;
+    return CartesianPlot::getPointInVis((time + m_timeBefore) / duration, rate / maxRate);
+}
+
+
+QColor EventRatePlot::getColor(const QString& testCondition) const
+{
+    QColor color = m_settings->m_testConditions.value(testCondition);
+    if (!color.isValid())
+    {
+        return m_mainPlotColor;
+    }
+    return color;
+}
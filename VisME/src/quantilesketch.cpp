@@ -0,0 +1,178 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file quantilesketch.cpp
+ **************************************************************************************************/
+#include "quantilesketch.h"
+#include <algorithm>
+#include <cmath>
+#include <QPair>
+
+
+QuantileSketch::QuantileSketch(int k) :
+    m_k(k),
+    m_count(0),
+    m_size(0),
+    m_maxSize(0)
+{
+    grow();
+}
+
+
+void QuantileSketch::add(qreal value)
+{
+    m_levels[0].push_back(value);
+    m_count++;
+    m_size++;
+
+    while (m_size >= m_maxSize)
+    {
+        compress();
+    }
+}
+
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+    while (m_levels.size() < other.m_levels.size())
+    {
+        grow();
+    }
+
+    for (size_t h = 0; h < other.m_levels.size(); ++h)
+    {
+        m_levels[h].insert(m_levels[h].end(), other.m_levels[h].begin(),
+                           other.m_levels[h].end());
+    }
+    m_count += other.m_count;
+    m_size += other.m_size;
+
+    while (m_size >= m_maxSize)
+    {
+        compress();
+    }
+}
+
+
+size_t QuantileSketch::count() const
+{
+    return m_count;
+}
+
+
+bool QuantileSketch::isExact() const
+{
+    return m_size == m_count;
+}
+
+
+qreal QuantileSketch::rankError() const
+{
+    return isExact() ? 0 : 2.296 / std::pow(qreal(m_k), 0.9723);
+}
+
+
+QuantileSketch::Estimate QuantileSketch::quantile(qreal p) const
+{
+    Estimate estimate = {0, rankError()};
+    if (m_count == 0)
+    {
+        return estimate;
+    }
+
+    if (isExact())
+    {
+        estimate.m_value = exactQuantile(m_levels[0], p);
+        return estimate;
+    }
+
+    // stored values with their weights, sorted by value
+    std::vector<QPair<qreal, size_t> > values;
+    values.reserve(m_size);
+    for (size_t h = 0; h < m_levels.size(); ++h)
+    {
+        for (size_t i = 0; i < m_levels[h].size(); ++i)
+        {
+            values.push_back(qMakePair(m_levels[h][i], size_t(1) << h));
+        }
+    }
+    std::sort(values.begin(), values.end());
+
+    size_t rank = std::max(size_t(1), size_t(std::ceil(p * m_count)));
+    size_t weight = 0;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        weight += values[i].second;
+        estimate.m_value = values[i].first;
+        if (weight >= rank)
+        {
+            break;
+        }
+    }
+
+    return estimate;
+}
+
+
+qreal QuantileSketch::exactQuantile(std::vector<qreal> values, qreal p)
+{
+    if (values.empty())
+    {
+        return 0;
+    }
+
+    size_t rank = std::max(size_t(1), size_t(std::ceil(p * values.size())));
+    std::vector<qreal>::iterator it = values.begin() + std::min(rank, values.size()) - 1;
+    std::nth_element(values.begin(), it, values.end());
+    return *it;
+}
+
+
+size_t QuantileSketch::capacity(size_t level) const
+{
+    // levels below the top level shrink by 2/3 per level
+    size_t depth = m_levels.size() - level - 1;
+    return size_t(std::ceil(m_k * std::pow(2.0 / 3.0, qreal(depth)))) + 1;
+}
+
+
+void QuantileSketch::grow()
+{
+    m_levels.push_back(std::vector<qreal>());
+
+    m_maxSize = 0;
+    for (size_t h = 0; h < m_levels.size(); ++h)
+    {
+        m_maxSize += capacity(h);
+    }
+}
+
+
+void QuantileSketch::compress()
+{
+    for (size_t h = 0; h < m_levels.size(); ++h)
+    {
+        if (m_levels[h].size() < capacity(h))
+        {
+            continue;
+        }
+
+        if (h + 1 == m_levels.size())
+        {
+            grow();
+        }
+
+        // every other value of the sorted level is kept with twice the weight, the smallest
+        // value stays in the level if the number of values is odd
+        std::vector<qreal>& level = m_levels[h];
+        std::sort(level.begin(), level.end());
+        size_t first = level.size() % 2;
+        size_t offset = m_random() % 2;
+        for (size_t i = first + offset; i < level.size(); i += 2)
+        {
+            m_levels[h + 1].push_back(level[i]);
+        }
+        m_size -= (level.size() - first) / 2;
+        level.resize(first);
+        return;
+    }
+}
@@ -0,0 +1,170 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file adaptivethresholdalgorithm.cpp
+ **************************************************************************************************/
+#include "adaptivethresholdalgorithm.h"
+#include "saccadedetector.h"
+#include "trial.h"
+#include <algorithm>
+#include <cmath>
+
+// the peak threshold is converged if it changes less than this value [degree/s]
+static const qreal convergenceThreshold = 0.1;
+
+// maximum number of iterations for the peak threshold
+static const int maxIterations = 100;
+
+// time before the onset used for the local noise of the offset threshold [ms]
+static const int localNoiseWindow = 40;
+
+
+std::vector<Saccade> AdaptiveThresholdAlgorithm::detect(const GazeSection& x,
+                                                        const GazeVelocity& v,
+                                                        const SaccadeFilterSettings* settings,
+                                                        Trial* trial)
+{
+    size_t N = v.m_x.size();
+
+    // absolute velocity
+    std::vector<qreal> speed(N);
+    qreal maxSpeed = 0;
+    for (size_t i = 0; i < N; ++i)
+    {
+        speed[i] = sqrt(v.m_x[i] * v.m_x[i] + v.m_y[i] * v.m_y[i]);
+        maxSpeed = std::max(maxSpeed, speed[i]);
+    }
+
+    // iterative peak threshold
+    qreal lambda = settings->m_velocityThreshold;
+    qreal peakThreshold = maxSpeed;
+    QPair<qreal, qreal> meanStd;
+    for (int iteration = 0; iteration < maxIterations; ++iteration)
+    {
+        if (!statisticsBelow(speed, peakThreshold, meanStd))
+        {
+            return std::vector<Saccade>();
+        }
+
+        qreal newThreshold = meanStd.first + lambda * meanStd.second;
+        bool converged = std::abs(newThreshold - peakThreshold) < convergenceThreshold;
+        peakThreshold = newThreshold;
+        if (converged)
+        {
+            break;
+        }
+    }
+
+    if (meanStd.second < 1e-10) // no variation, no saccades can be determined
+    {
+        return std::vector<Saccade>();
+    }
+
+    qreal onsetThreshold = meanStd.first + lambda / 2 * meanStd.second;
+    size_t minDuration = trial->timeToSamples(settings->m_minDuration);
+    size_t noiseWindow = trial->timeToSamples(localNoiseWindow);
+
+    std::vector<Saccade> sac;
+    size_t begin = 0; // first index after the previous saccade
+    size_t i = 0;
+    while (i < N)
+    {
+        if (speed[i] <= peakThreshold)
+        {
+            ++i;
+            continue;
+        }
+
+        // onset: backwards below the onset threshold and to the local minimum
+        size_t onset = i;
+        while (onset > begin && (speed[onset] > onsetThreshold || speed[onset - 1] < speed[onset]))
+        {
+            --onset;
+        }
+
+        // offset threshold: weighted with the local noise before the saccade
+        qreal offsetThreshold = onsetThreshold;
+        QPair<qreal, qreal> localNoise;
+        if (statistics(speed, onset > noiseWindow ? onset - noiseWindow : 0, onset, localNoise))
+        {
+            offsetThreshold = 0.7 * onsetThreshold +
+                              0.3 * (localNoise.first + lambda / 2 * localNoise.second);
+        }
+
+        // offset: forwards below the offset threshold and to the local minimum
+        size_t offset = i;
+        while (offset < N - 1 &&
+               (speed[offset] > offsetThreshold || speed[offset + 1] < speed[offset]))
+        {
+            ++offset;
+        }
+
+        // Minimum duration criterion
+        if (offset - onset + 1 >= minDuration)
+        {
+            sac.push_back(Saccade(onset, offset, 0, 0, 0, 0, 0));
+        }
+
+        begin = offset + 1;
+        i = offset + 1;
+    }
+
+    SaccadeDetector detector;
+    detector.setSaccadeProperties(x, v, sac);
+
+    return sac;
+}
+
+
+QString AdaptiveThresholdAlgorithm::name() const
+{
+    return "Adaptive Threshold";
+}
+
+
+bool AdaptiveThresholdAlgorithm::statisticsBelow(const std::vector<qreal>& speed, qreal threshold,
+                                                 QPair<qreal, qreal>& meanStd) const
+{
+    qreal sum = 0;
+    qreal sumSquares = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < speed.size(); ++i)
+    {
+        if (speed[i] < threshold)
+        {
+            sum += speed[i];
+            sumSquares += speed[i] * speed[i];
+            ++count;
+        }
+    }
+
+    if (count < 2)
+    {
+        return false;
+    }
+
+    qreal mean = sum / count;
+    meanStd = QPair<qreal, qreal>(mean, sqrt(std::max(0.0, sumSquares / count - mean * mean)));
+    return true;
+}
+
+
+bool AdaptiveThresholdAlgorithm::statistics(const std::vector<qreal>& speed, size_t begin,
+                                            size_t end, QPair<qreal, qreal>& meanStd) const
+{
+    if (end < begin + 2)
+    {
+        return false;
+    }
+
+    qreal sum = 0;
+    qreal sumSquares = 0;
+    for (size_t i = begin; i < end; ++i)
+    {
+        sum += speed[i];
+        sumSquares += speed[i] * speed[i];
+    }
+
+    qreal mean = sum / (end - begin);
+    meanStd = QPair<qreal, qreal>(mean, sqrt(std::max(0.0, sumSquares / (end - begin) - mean * mean)));
+    return true;
+}
@@ -0,0 +1,131 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file algorithmcomparison.cpp
+ **************************************************************************************************/
+#include "algorithmcomparison.h"
+#include "saccadedetectionalgorithm.h"
+#include "saccadedetector.h"
+#include "trial.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QtConcurrent>
+
+
+AlgorithmComparison::AlgorithmComparison(const SaccadeFilterSettings& settings,
+                                         GazeType gazeType) :
+    m_settings(settings),
+    m_gazeType(gazeType),
+    m_preparationNs(0)
+{}
+
+
+std::vector<AlgorithmComparisonResult> AlgorithmComparison::run(
+        const std::vector<Trial*>& trials,
+        const std::vector<DetectionAlgorithm>& algorithms)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // sections and velocities are computed once and shared by all algorithms
+    std::vector<std::vector<PreparedSection> > prepared(trials.size());
+    std::vector<size_t> indices(trials.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        indices[i] = i;
+    }
+    QtConcurrent::blockingMap(indices, [&](size_t i)
+    {
+        prepared[i] = prepareTrial(trials[i]);
+    });
+
+    m_preparationNs = timer.nsecsElapsed();
+
+    std::vector<AlgorithmComparisonResult> results;
+    for (size_t a = 0; a < algorithms.size(); ++a)
+    {
+        SaccadeFilterSettings settings(m_settings);
+        settings.m_algorithm = algorithms[a];
+
+        SaccadeDetectionAlgorithm* algorithm = SaccadeDetectionAlgorithm::create(algorithms[a]);
+        SaccadeDetector detector;
+
+        AlgorithmComparisonResult result;
+        result.m_algorithm = algorithms[a];
+        result.m_name = algorithm->name();
+
+        timer.restart();
+        for (size_t t = 0; t < prepared.size(); ++t)
+        {
+            for (size_t s = 0; s < prepared[t].size(); ++s)
+            {
+                const PreparedSection& section = prepared[t][s];
+                std::vector<Saccade> saccades = algorithm->detect(section.m_section,
+                                                                  section.m_velocity,
+                                                                  &settings, section.m_trial);
+                result.m_candidateCount += saccades.size();
+
+                detector.removeInvalidSaccades(saccades, &settings, section.m_trial);
+                result.m_microsaccadeCount += saccades.size();
+            }
+        }
+        result.m_elapsedNs = timer.nsecsElapsed();
+
+        delete algorithm;
+
+        qDebug() << QString("Algorithm %1: %2 microsaccades: %3 ms").arg(
+                        result.m_name, QString::number(result.m_microsaccadeCount),
+                        QString::number(result.m_elapsedNs / 1e6));
+
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+
+qint64 AlgorithmComparison::preparationNs() const
+{
+    return m_preparationNs;
+}
+
+
+void AlgorithmComparison::writeCsv(const std::vector<AlgorithmComparisonResult>& results,
+                                   std::ostream& out) const
+{
+    out << "Algorithm,#Candidates,#Microsaccades,Detection[ms],Preparation[ms]" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const AlgorithmComparisonResult& r = results[i];
+        out << r.m_name.toStdString() << ","
+            << r.m_candidateCount << ","
+            << r.m_microsaccadeCount << ","
+            << r.m_elapsedNs / 1e6 << ","
+            << m_preparationNs / 1e6 << std::endl;
+    }
+}
+
+
+std::vector<AlgorithmComparison::PreparedSection> AlgorithmComparison::prepareTrial(Trial* trial)
+{
+    SaccadeDetector detector;
+    std::vector<PreparedSection> prepared;
+
+    std::vector<GazeSection> sections = detector.determineMicrosaccadeSections(trial, m_gazeType,
+                                                                               &m_settings);
+    for (size_t i = 0; i < sections.size(); ++i)
+    {
+        PreparedSection section;
+        section.m_trial = trial;
+        section.m_section = sections[i];
+        section.m_velocity = detector.determineVelocity(sections[i], trial->frequencyRate(),
+                                                        m_settings.m_velocityWindowSize);
+
+        // no data for processing
+        if (!section.m_velocity.m_x.empty())
+        {
+            prepared.push_back(section);
+        }
+    }
+
+    return prepared;
+}
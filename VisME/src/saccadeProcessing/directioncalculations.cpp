@@ -11,9 +11,10 @@ void DirectionCalculations::getAngularDataForTrial(Trial* trial,
                                                    PlotDirection dataPlotDirection,
                                                    PlotData dataPlotData,
                                                    std::vector<qreal>& anglesForTrial,
-                                                   std::vector<Fixation*> fixations)
+                                                   std::vector<Fixation*> fixations,
+                                                   GazeType gazeType)
 {
-    const QMap<int, GazeData>& g = trial->gazeData();
+    const QMap<int, GazeData>& g = trial->gazeData(gazeType);
     size_t fixationCount = 0;
 
     foreach (Fixation* fixation, fixations)
@@ -30,8 +31,8 @@ void DirectionCalculations::getAngularDataForTrial(Trial* trial,
                 {
                     Saccade* ms = fixation->getMicrosaccadeAt(i, trial->msFromInputFile());
 
-                    Fixation* nextFixation = trial->getNextFixation(fixation);
-                    Fixation* prevFixation = trial->getPrevFixation(fixation);
+                    Fixation* nextFixation = trial->getNextFixation(fixation, gazeType);
+                    Fixation* prevFixation = trial->getPrevFixation(fixation, gazeType);
 
                     qreal microsaccadeAngle = MathHelpFunctions::getAngle(
                             g[int(ms->getOnsetIndex())].getXPosition(),
@@ -74,7 +75,7 @@ void DirectionCalculations::getAngularDataForTrial(Trial* trial,
         }
         else if (dataPlotData == PD_Saccades)
         {
-            Fixation* nextFixation = trial->getNextFixation(fixation);
+            Fixation* nextFixation = trial->getNextFixation(fixation, gazeType);
             qreal angleInDegreesBetweenFixations = 0;
             if (nextFixation != nullptr && fixationCount < fixations.size() - 1)
             {
@@ -90,7 +91,7 @@ void DirectionCalculations::getAngularDataForTrial(Trial* trial,
                 }
                 else if (dataPlotDirection == PDir_ToPreviousFixation)
                 {
-                    Fixation* prevFixation = trial->getPrevFixation(fixation);
+                    Fixation* prevFixation = trial->getPrevFixation(fixation, gazeType);
                     if (prevFixation != nullptr)
                     {
                         qreal angleInDegreestoPrevFixation = MathHelpFunctions::getAngle(
@@ -111,8 +112,8 @@ void DirectionCalculations::getAngularDataForTrial(Trial* trial,
         }
         else if (dataPlotData == PD_GazeRawData)
         {
-            Fixation* nextFixation = trial->getNextFixation(fixation);
-            Fixation* prevFixation = trial->getPrevFixation(fixation);
+            Fixation* nextFixation = trial->getNextFixation(fixation, gazeType);
+            Fixation* prevFixation = trial->getPrevFixation(fixation, gazeType);
             qreal angleInDegreesBetweenFixations = 0;
             if (nextFixation != nullptr && dataPlotDirection == PDir_ToNextFixation)
             {
@@ -131,7 +132,7 @@ void DirectionCalculations::getAngularDataForTrial(Trial* trial,
                                                           prevFixation->getYPosition());
             }
 
-            const QMap<int, GazeData>& g = trial->gazeData();
+            const QMap<int, GazeData>& g = trial->gazeData(gazeType);
             for (int i = fixation->getStartIndex(); i <= fixation->getEndIndex(); ++i) // -1 as there is no next point within this fixation for the last data point
             {
                 if (g.contains(i))
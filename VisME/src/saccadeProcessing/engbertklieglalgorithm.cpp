@@ -0,0 +1,33 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file engbertklieglalgorithm.cpp
+ **************************************************************************************************/
+#include "engbertklieglalgorithm.h"
+#include "saccadedetector.h"
+#include "trial.h"
+
+
+std::vector<Saccade> EngbertKlieglAlgorithm::detect(const GazeSection& x, const GazeVelocity& v,
+                                                    const SaccadeFilterSettings* settings,
+                                                    Trial* trial)
+{
+    SaccadeDetector detector;
+
+    // median based standard deviation of the velocity components
+    QPair<qreal, qreal> msd;
+    if (!detector.velocityStatistics(v, msd))
+    {
+        return std::vector<Saccade>();
+    }
+
+    QPair<qreal, qreal> newRadius;
+    return detector.determineSaccadeCandidates(x, v, msd, settings->m_velocityThreshold,
+                                               trial->timeToSamples(settings->m_minDuration),
+                                               newRadius);
+}
+
+
+QString EngbertKlieglAlgorithm::name() const
+{
+    return "Engbert-Kliegl";
+}
@@ -0,0 +1,375 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file eventlockedrate.cpp
+ **************************************************************************************************/
+#include "eventlockedrate.h"
+#include "gazeruns.h"
+#include "participant.h"
+#include "trial.h"
+#include <fstream>
+#include <map>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QtConcurrent>
+#include <set>
+
+
+EventLockedRate::EventLockedRate(const QString& eventName, int timeBefore, int timeAfter,
+                                 int binSize, int windowSize, int windowStep, GazeType gazeType) :
+    m_eventName(eventName),
+    m_timeBefore(std::max(0, timeBefore)),
+    m_timeAfter(std::max(0, timeAfter)),
+    m_binSize(std::max(1, binSize)),
+    m_windowSize(std::max(1, windowSize)),
+    m_windowStep(std::max(1, windowStep)),
+    m_gazeType(gazeType)
+{}
+
+
+std::vector<EventLockedRateGroup> EventLockedRate::run(const std::vector<Trial*>& trials) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // trials are evaluated in parallel, the results are combined in the order of the trials
+    std::vector<QPair<Trial*, EventLockedRateGroup> > trialResults;
+    for (size_t i = 0; i < trials.size(); ++i)
+    {
+        trialResults.push_back(qMakePair(trials[i], EventLockedRateGroup()));
+    }
+
+    QtConcurrent::blockingMap(trialResults,
+                              [&](QPair<Trial*, EventLockedRateGroup>& trialResult)
+    {
+        trialResult.second = evaluateTrial(trialResult.first);
+    });
+
+    std::vector<EventLockedRateGroup> participantGroups;
+    std::vector<EventLockedRateGroup> testConditionGroups;
+    std::map<std::pair<Participant*, QString>, size_t> participantGroupIndices;
+    std::map<QString, size_t> testConditionGroupIndices;
+
+    for (size_t t = 0; t < trialResults.size(); ++t)
+    {
+        const EventLockedRateGroup& trialResult = trialResults[t].second;
+        if (trialResult.m_eventCount == 0)
+        {
+            continue;
+        }
+
+        std::pair<Participant*, QString> key(trialResults[t].first->getParticipant(),
+                                             trialResult.m_testCondition);
+        if (participantGroupIndices.find(key) == participantGroupIndices.end())
+        {
+            participantGroupIndices[key] = participantGroups.size();
+            EventLockedRateGroup group;
+            group.m_participant = trialResult.m_participant;
+            group.m_testCondition = trialResult.m_testCondition;
+            participantGroups.push_back(group);
+        }
+        addToGroup(participantGroups[participantGroupIndices[key]], trialResult);
+
+        if (testConditionGroupIndices.find(trialResult.m_testCondition) ==
+                testConditionGroupIndices.end())
+        {
+            testConditionGroupIndices[trialResult.m_testCondition] = testConditionGroups.size();
+            EventLockedRateGroup group;
+            group.m_testCondition = trialResult.m_testCondition;
+            testConditionGroups.push_back(group);
+        }
+        addToGroup(testConditionGroups[testConditionGroupIndices[trialResult.m_testCondition]],
+                   trialResult);
+    }
+
+    participantGroups.insert(participantGroups.end(), testConditionGroups.begin(),
+                             testConditionGroups.end());
+
+    qDebug() << QString("Event-locked rate: %1 trials, %2 groups: %3 ms").arg(
+                    QString::number(trials.size()), QString::number(participantGroups.size()),
+                    QString::number(timer.elapsed()));
+
+    return participantGroups;
+}
+
+
+EventLockedRateGroup EventLockedRate::evaluateTrial(Trial* trial) const
+{
+    EventLockedRateGroup result;
+    result.m_participant = trial->getParticipant()->name();
+    result.m_testCondition = trial->getTestConditionType();
+    result.m_binCounts.assign(binCount(), 0);
+    result.m_binExposure.assign(binCount(), 0);
+    result.m_windowCounts.assign(windowCount(), 0);
+    result.m_windowExposure.assign(windowCount(), 0);
+
+    std::vector<int> eventStarts;
+    for (size_t i = 0; i < trial->eventCount(); ++i)
+    {
+        Event* event = trial->getEventAt(i);
+        if (event->getName() == m_eventName)
+        {
+            eventStarts.push_back(event->getStartIndex());
+        }
+    }
+
+    if (eventStarts.empty())
+    {
+        return result;
+    }
+
+    result.m_trialCount = 1;
+    result.m_eventCount = eventStarts.size();
+
+    const GazeRuns* runs = trial->gazeRuns(m_gazeType);
+    if (runs->m_index.empty())
+    {
+        return result;
+    }
+
+    // prefix sums over the sample indices [first, last]: number of gaze samples and
+    // microsaccade onsets before each index
+    int first = runs->m_index.front();
+    int last = runs->m_index.back();
+    std::vector<size_t> samplesBefore(size_t(last - first + 2), 0);
+    std::vector<size_t> onsetsBefore(size_t(last - first + 2), 0);
+
+    for (size_t i = 0; i < runs->m_index.size(); ++i)
+    {
+        samplesBefore[size_t(runs->m_index[i] - first + 1)]++;
+    }
+
+    std::vector<Fixation>* fixations = trial->fixations(m_gazeType);
+    bool fromInput = trial->msFromInputFile();
+    if (fixations != nullptr)
+    {
+        for (size_t i = 0; i < fixations->size(); ++i)
+        {
+            Fixation& f = (*fixations)[i];
+            for (size_t k = 0; k < f.getMicrosaccadesCount(fromInput); ++k)
+            {
+                int onset = int(f.getMicrosaccadeAt(k, fromInput)->getOnsetIndex());
+                if (onset >= first && onset <= last)
+                {
+                    onsetsBefore[size_t(onset - first + 1)]++;
+                }
+            }
+        }
+    }
+
+    for (size_t i = 1; i < samplesBefore.size(); ++i)
+    {
+        samplesBefore[i] += samplesBefore[i - 1];
+        onsetsBefore[i] += onsetsBefore[i - 1];
+    }
+
+    // number of values in the sample range [begin, end)
+    auto countInRange = [first, last](const std::vector<size_t>& prefixSums, int begin, int end)
+    {
+        begin = qBound(first, begin, last + 1);
+        end = qBound(first, end, last + 1);
+        return begin < end ? prefixSums[size_t(end - first)] - prefixSums[size_t(begin - first)] :
+                             size_t(0);
+    };
+
+    qreal frequency = trial->frequencyRate();
+    auto toSamples = [frequency](int time)
+    {
+        return qRound(time * frequency / 1000.0);
+    };
+
+    // offsets of bins and windows in samples are the same for all events of the trial
+    std::vector<QPair<int, int> > binRanges;
+    for (size_t b = 0; b < binCount(); ++b)
+    {
+        binRanges.push_back(qMakePair(toSamples(binStart(b)), toSamples(binEnd(b))));
+    }
+
+    std::vector<QPair<int, int> > windowRanges;
+    for (size_t w = 0; w < windowCount(); ++w)
+    {
+        int start = windowCenter(w) - m_windowSize / 2;
+        windowRanges.push_back(qMakePair(toSamples(start), toSamples(start + m_windowSize)));
+    }
+
+    std::vector<size_t> binSamples(binCount(), 0);
+    std::vector<size_t> windowSamples(windowCount(), 0);
+    for (size_t e = 0; e < eventStarts.size(); ++e)
+    {
+        int start = eventStarts[e];
+        for (size_t b = 0; b < binRanges.size(); ++b)
+        {
+            int begin = start + binRanges[b].first;
+            int end = start + binRanges[b].second;
+            result.m_binCounts[b] += countInRange(onsetsBefore, begin, end);
+            binSamples[b] += countInRange(samplesBefore, begin, end);
+        }
+
+        for (size_t w = 0; w < windowRanges.size(); ++w)
+        {
+            int begin = start + windowRanges[w].first;
+            int end = start + windowRanges[w].second;
+            result.m_windowCounts[w] += countInRange(onsetsBefore, begin, end);
+            windowSamples[w] += countInRange(samplesBefore, begin, end);
+        }
+    }
+
+    for (size_t b = 0; b < binSamples.size(); ++b)
+    {
+        result.m_binExposure[b] = binSamples[b] / frequency;
+    }
+    for (size_t w = 0; w < windowSamples.size(); ++w)
+    {
+        result.m_windowExposure[w] = windowSamples[w] / frequency;
+    }
+
+    return result;
+}
+
+
+void EventLockedRate::addToGroup(EventLockedRateGroup& group, const EventLockedRateGroup& source)
+{
+    if (group.m_binCounts.empty())
+    {
+        group.m_binCounts.assign(source.m_binCounts.size(), 0);
+        group.m_binExposure.assign(source.m_binExposure.size(), 0);
+        group.m_windowCounts.assign(source.m_windowCounts.size(), 0);
+        group.m_windowExposure.assign(source.m_windowExposure.size(), 0);
+    }
+
+    group.m_trialCount += source.m_trialCount;
+    group.m_eventCount += source.m_eventCount;
+    for (size_t i = 0; i < source.m_binCounts.size(); ++i)
+    {
+        group.m_binCounts[i] += source.m_binCounts[i];
+        group.m_binExposure[i] += source.m_binExposure[i];
+    }
+    for (size_t i = 0; i < source.m_windowCounts.size(); ++i)
+    {
+        group.m_windowCounts[i] += source.m_windowCounts[i];
+        group.m_windowExposure[i] += source.m_windowExposure[i];
+    }
+}
+
+
+QStringList EventLockedRate::eventNames(const std::vector<Trial*>& trials)
+{
+    std::set<QString> names;
+    for (size_t i = 0; i < trials.size(); ++i)
+    {
+        for (size_t j = 0; j < trials[i]->eventCount(); ++j)
+        {
+            names.insert(trials[i]->getEventAt(j)->getName());
+        }
+    }
+
+    QStringList sortedNames;
+    for (std::set<QString>::iterator it = names.begin(); it != names.end(); ++it)
+    {
+        sortedNames.append(*it);
+    }
+    return sortedNames;
+}
+
+
+qreal EventLockedRate::rate(size_t count, qreal exposure)
+{
+    return exposure > 0 ? count / exposure : 0;
+}
+
+
+QString EventLockedRate::eventName() const
+{
+    return m_eventName;
+}
+
+
+int EventLockedRate::timeBefore() const
+{
+    return m_timeBefore;
+}
+
+
+int EventLockedRate::timeAfter() const
+{
+    return m_timeAfter;
+}
+
+
+size_t EventLockedRate::binCount() const
+{
+    // round up, the last bin ends at timeAfter
+    return size_t(std::max(1, (m_timeBefore + m_timeAfter + m_binSize - 1) / m_binSize));
+}
+
+
+int EventLockedRate::binStart(size_t bin) const
+{
+    return -m_timeBefore + int(bin) * m_binSize;
+}
+
+
+int EventLockedRate::binEnd(size_t bin) const
+{
+    return std::min(m_timeAfter, binStart(bin) + m_binSize);
+}
+
+
+size_t EventLockedRate::windowCount() const
+{
+    return size_t((m_timeBefore + m_timeAfter) / m_windowStep + 1);
+}
+
+
+int EventLockedRate::windowCenter(size_t window) const
+{
+    return -m_timeBefore + int(window) * m_windowStep;
+}
+
+
+bool EventLockedRate::writeCsv(const std::vector<EventLockedRateGroup>& groups,
+                               const QString& fileName) const
+{
+    std::ofstream out(fileName.toStdString(), std::ios::out);
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    out << "Event,Participant,TestCondition,#Trials,#Events,Type,Start[ms],End[ms],"
+           "#Microsaccades,Exposure[s],#MicrosaccadesPerSecond" << std::endl;
+
+    std::string eventName = m_eventName.toStdString();
+    foreach (const EventLockedRateGroup& g, groups)
+    {
+        std::string participant = g.m_participant.isEmpty() ? std::string("all") :
+                                                              g.m_participant.toStdString();
+        std::string prefix = eventName + "," + participant + "," +
+                             g.m_testCondition.toStdString() + "," +
+                             std::to_string(g.m_trialCount) + "," +
+                             std::to_string(g.m_eventCount) + ",";
+
+        for (size_t b = 0; b < g.m_binCounts.size(); ++b)
+        {
+            out << prefix << "bin,"
+                << binStart(b) << ","
+                << binEnd(b) << ","
+                << g.m_binCounts[b] << ","
+                << g.m_binExposure[b] << ","
+                << rate(g.m_binCounts[b], g.m_binExposure[b]) << std::endl;
+        }
+
+        for (size_t w = 0; w < g.m_windowCounts.size(); ++w)
+        {
+            int start = windowCenter(w) - m_windowSize / 2;
+            out << prefix << "window,"
+                << start << ","
+                << start + m_windowSize << ","
+                << g.m_windowCounts[w] << ","
+                << g.m_windowExposure[w] << ","
+                << rate(g.m_windowCounts[w], g.m_windowExposure[w]) << std::endl;
+        }
+    }
+
+    out.close();
+    return true;
+}
@@ -0,0 +1,118 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file gapinterpolation.cpp
+ **************************************************************************************************/
+#include "gapinterpolation.h"
+
+
+void GapInterpolation::interpolate(const std::vector<qreal>& x, size_t last, size_t first,
+                                   size_t lastRunBegin, size_t firstRunEnd, int gap,
+                                   GapInterpolationType interpolation, std::vector<qreal>& values)
+{
+    // positions at t = 0 (last sample) and t = 1 (first sample), slopes per gap length
+    qreal x0 = x[last];
+    qreal x1 = x[first];
+    qreal length = gap + 1;
+    qreal m0 = x1 - x0;
+    qreal m1 = x1 - x0;
+    if (interpolation == GIT_Cubic)
+    {
+        if (last > lastRunBegin)
+        {
+            m0 = (x[last] - x[last - 1]) * length;
+        }
+        if (first + 1 < firstRunEnd)
+        {
+            m1 = (x[first + 1] - x[first]) * length;
+        }
+    }
+
+    for (int k = 1; k <= gap; ++k)
+    {
+        qreal t = k / length;
+        if (interpolation == GIT_Cubic)
+        {
+            qreal t2 = t * t;
+            qreal t3 = t2 * t;
+            values.push_back((2 * t3 - 3 * t2 + 1) * x0 + (t3 - 2 * t2 + t) * m0 +
+                             (-2 * t3 + 3 * t2) * x1 + (t3 - t2) * m1);
+        }
+        else
+        {
+            values.push_back(x0 + t * (x1 - x0));
+        }
+    }
+}
+
+
+void GapInterpolation::apply(const GazeRuns& runs, GapInterpolationType interpolation,
+                             size_t maxGapSamples, GazeRuns& filled)
+{
+    filled.clear();
+    filled.m_pixelsPerDegree = runs.m_pixelsPerDegree;
+    filled.m_gapInterpolation = interpolation;
+    filled.m_maxGapSamples = maxGapSamples;
+    filled.m_isSet = true;
+
+    if (interpolation == GIT_None || maxGapSamples == 0 || runs.m_runs.size() < 2)
+    {
+        filled.m_x = runs.m_x;
+        filled.m_y = runs.m_y;
+        filled.m_index = runs.m_index;
+        filled.m_runs = runs.m_runs;
+        return;
+    }
+
+    filled.m_x.reserve(runs.m_x.size());
+    filled.m_y.reserve(runs.m_y.size());
+    filled.m_index.reserve(runs.m_index.size());
+    filled.m_interpolated.reserve(runs.m_index.size());
+
+    size_t runStart = 0;
+    for (size_t i = 0; i < runs.m_runs.size(); ++i)
+    {
+        size_t begin = runs.m_runs[i].first;
+        size_t end = runs.m_runs[i].second;
+
+        // gap to the previous run: filled and merged, or a new run starts
+        if (i > 0)
+        {
+            size_t previousBegin = runs.m_runs[i - 1].first;
+            size_t last = runs.m_runs[i - 1].second - 1;
+            int gap = runs.m_index[begin] - runs.m_index[last] - 1;
+            if (size_t(gap) <= maxGapSamples)
+            {
+                interpolate(runs.m_x, last, begin, previousBegin, end, gap, interpolation,
+                            filled.m_x);
+                interpolate(runs.m_y, last, begin, previousBegin, end, gap, interpolation,
+                            filled.m_y);
+                for (int k = 1; k <= gap; ++k)
+                {
+                    filled.m_index.push_back(runs.m_index[last] + k);
+                    filled.m_interpolated.push_back(true);
+                }
+            }
+            else
+            {
+                filled.m_runs.push_back(QPair<size_t, size_t>(runStart, filled.m_index.size()));
+                runStart = filled.m_index.size();
+            }
+        }
+
+        filled.m_x.insert(filled.m_x.end(), runs.m_x.begin() + long(begin),
+                          runs.m_x.begin() + long(end));
+        filled.m_y.insert(filled.m_y.end(), runs.m_y.begin() + long(begin),
+                          runs.m_y.begin() + long(end));
+        filled.m_index.insert(filled.m_index.end(), runs.m_index.begin() + long(begin),
+                              runs.m_index.begin() + long(end));
+        filled.m_interpolated.insert(filled.m_interpolated.end(), end - begin, false);
+    }
+    filled.m_runs.push_back(QPair<size_t, size_t>(runStart, filled.m_index.size()));
+}
+
+
+QStringList GapInterpolation::interpolationNames()
+{
+    // same order as GapInterpolationType
+    return QStringList() << "None" << "Linear" << "Cubic";
+}
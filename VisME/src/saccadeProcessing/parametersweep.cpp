@@ -0,0 +1,295 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file parametersweep.cpp
+ **************************************************************************************************/
+#include "mathhelpfunctions.h"
+#include "parametersweep.h"
+#include "saccadedetector.h"
+#include "trial.h"
+#include <fstream>
+#include <QAtomicInt>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QtConcurrent>
+
+
+ParameterSweep::ParameterSweep(const SaccadeFilterSettings& settings, GazeType gazeType) :
+    m_settings(settings),
+    m_gazeType(gazeType)
+{}
+
+
+std::vector<ParameterSweepResult> ParameterSweep::run(const std::vector<Trial*>& trials,
+                                                      const std::vector<qreal>& velocityThresholds,
+                                                      const std::vector<int>& minDurations,
+                                                      const CancellationToken& cancellation,
+                                                      const std::function<void(size_t, size_t)>& progress) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // trials are evaluated in parallel, the results are combined in the order of the trials
+    std::vector<QPair<Trial*, std::vector<ParameterSweepResult> > > trialResults;
+    for (size_t i = 0; i < trials.size(); ++i)
+    {
+        trialResults.push_back(qMakePair(trials[i], std::vector<ParameterSweepResult>()));
+    }
+
+    QAtomicInt evaluatedCount(0);
+    QtConcurrent::blockingMap(trialResults,
+                              [&](QPair<Trial*, std::vector<ParameterSweepResult> >& trialResult)
+    {
+        if (cancellation.isCanceled())
+        {
+            return;
+        }
+
+        trialResult.second = evaluateTrial(trialResult.first, velocityThresholds, minDurations);
+
+        if (progress)
+        {
+            progress(size_t(evaluatedCount.fetchAndAddOrdered(1) + 1), trialResults.size());
+        }
+    });
+
+    std::vector<ParameterSweepResult> results;
+    for (size_t i = 0; i < velocityThresholds.size(); ++i)
+    {
+        for (size_t j = 0; j < minDurations.size(); ++j)
+        {
+            ParameterSweepResult result;
+            result.m_velocityThreshold = velocityThresholds[i];
+            result.m_minDuration = minDurations[j];
+            results.push_back(result);
+        }
+    }
+
+    for (size_t t = 0; t < trialResults.size(); ++t)
+    {
+        const std::vector<ParameterSweepResult>& trialResult = trialResults[t].second;
+        for (size_t i = 0; i < trialResult.size(); ++i)
+        {
+            results[i].m_trialCount += trialResult[i].m_trialCount;
+            results[i].m_fixationCount += trialResult[i].m_fixationCount;
+            results[i].m_microsaccadeCount += trialResult[i].m_microsaccadeCount;
+            results[i].m_duration += trialResult[i].m_duration;
+            results[i].m_amplitudes.insert(results[i].m_amplitudes.end(),
+                                           trialResult[i].m_amplitudes.begin(),
+                                           trialResult[i].m_amplitudes.end());
+        }
+    }
+
+    qDebug() << QString("Parameter sweep: %1 trials, %2 combinations: %3 ms%4").arg(
+                    QString::number(trials.size()), QString::number(results.size()),
+                    QString::number(timer.elapsed()),
+                    cancellation.isCanceled() ? " (canceled)" : "");
+
+    return results;
+}
+
+
+std::vector<ParameterSweepResult> ParameterSweep::evaluateTrial(
+        Trial* trial,
+        const std::vector<qreal>& velocityThresholds,
+        const std::vector<int>& minDurations) const
+{
+    std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
+    size_t gridSize = velocityThresholds.size() * minDurations.size();
+
+    SaccadeDetector detector;
+
+    // microsaccade candidates for each combination and gaze type
+    std::vector<std::vector<std::vector<Saccade> > > candidates(
+                gridSize, std::vector<std::vector<Saccade> >(gazeTypes.size()));
+
+    std::vector<size_t> minDurationSamples;
+    for (size_t j = 0; j < minDurations.size(); ++j)
+    {
+        minDurationSamples.push_back(trial->timeToSamples(minDurations[j]));
+    }
+
+    for (size_t g = 0; g < gazeTypes.size(); ++g)
+    {
+        // all gaze types are needed only for binocular microsaccades
+        if (!m_settings.m_binocular && gazeTypes[g] != m_gazeType)
+        {
+            continue;
+        }
+
+        std::vector<GazeSection> sections =
+                detector.determineMicrosaccadeSections(trial, gazeTypes[g], &m_settings);
+
+        for (size_t s = 0; s < sections.size(); ++s)
+        {
+            // shared for all combinations
+            GazeVelocity v = detector.determineVelocity(
+                        sections[s], trial->frequencyRate(), m_settings.m_velocityWindowSize);
+
+            QPair<qreal, qreal> msd;
+            if (v.m_x.empty() || !detector.velocityStatistics(v, msd))
+            {
+                continue;
+            }
+
+            for (size_t i = 0; i < velocityThresholds.size(); ++i)
+            {
+                for (size_t j = 0; j < minDurations.size(); ++j)
+                {
+                    QPair<qreal, qreal> newRadius;
+                    std::vector<Saccade> sectionCandidates = detector.determineSaccadeCandidates(
+                                sections[s], v, msd, velocityThresholds[i], minDurationSamples[j],
+                                newRadius);
+
+                    std::vector<Saccade>& c = candidates[i * minDurations.size() + j][g];
+                    c.insert(c.end(), sectionCandidates.begin(), sectionCandidates.end());
+                }
+            }
+        }
+    }
+
+    size_t fixationCount = size_t(trial->fixationsCount(m_gazeType));
+    qreal duration = trial->samplesToTime(trial->duration(m_gazeType)) / 1000.0;
+
+    std::vector<ParameterSweepResult> results(gridSize);
+    for (size_t k = 0; k < gridSize; ++k)
+    {
+        std::vector<std::vector<Saccade> >& msforGazeTypes = candidates[k];
+        for (size_t g = 0; g < msforGazeTypes.size(); ++g)
+        {
+            detector.removeInvalidSaccades(msforGazeTypes[g], &m_settings, trial);
+        }
+
+        // binocular saccades, see SaccadeDetector::determineMicrosaccades
+        if (m_settings.m_binocular)
+        {
+            QPair<std::vector<Saccade>, std::vector<Saccade>> binSaccades =
+                    detector.determineBinocularSaccades(msforGazeTypes[1], msforGazeTypes[0]);
+
+            QPair<std::vector<Saccade>, std::vector<Saccade>> binSaccadesAverage =
+                    detector.determineBinocularSaccades(msforGazeTypes[2], msforGazeTypes[0]);
+            binSaccadesAverage = detector.determineBinocularSaccades(binSaccadesAverage.first,
+                                                                     msforGazeTypes[1]);
+
+            msforGazeTypes = {binSaccades.second, binSaccades.first, binSaccadesAverage.first};
+        }
+
+        size_t gazeTypeIndex = size_t(std::find(gazeTypes.begin(), gazeTypes.end(), m_gazeType) -
+                                      gazeTypes.begin());
+
+        results[k].m_trialCount = 1;
+        results[k].m_fixationCount = fixationCount;
+        results[k].m_duration = duration;
+        if (gazeTypeIndex < msforGazeTypes.size())
+        {
+            addMicrosaccadesInFixations(trial, msforGazeTypes[gazeTypeIndex], results[k]);
+        }
+    }
+
+    return results;
+}
+
+
+void ParameterSweep::addMicrosaccadesInFixations(Trial* trial,
+                                                 const std::vector<Saccade>& microsaccades,
+                                                 ParameterSweepResult& result) const
+{
+    std::vector<Fixation>* fixations = trial->fixations(m_gazeType);
+    if (fixations == nullptr)
+    {
+        return;
+    }
+
+    int ignoreAtStart = m_settings.m_useIgnoreAtStart ?
+                            int(trial->timeToSamples(m_settings.m_ignoreAtStart)) : 0;
+    int ignoreAtEnd = m_settings.m_useIgnoreAtEnd ?
+                          int(trial->timeToSamples(m_settings.m_ignoreAtEnd)) : 0;
+    size_t minIntersaccInterval = trial->timeToSamples(m_settings.m_minIntersaccInterval);
+
+    // same assignment as Trial::setMicrosaccadesForFixations and
+    // SaccadeDetector::removeMicrosaccadesForIntersaccadicInterval
+    size_t fixationIndex = 0;
+    const Saccade* prevMs = nullptr;
+    size_t prevMsFixationIndex = 0;
+    for (size_t i = 0; i < microsaccades.size(); ++i)
+    {
+        const Saccade& ms = microsaccades[i];
+        bool fixationFound = false;
+        while (!fixationFound)
+        {
+            if (fixations->size() <= fixationIndex ||
+                    (*fixations)[fixationIndex].getStartIndex() > int(ms.getOnsetIndex()))
+            {
+                break;
+            }
+
+            const Fixation& f = (*fixations)[fixationIndex];
+            if (f.getStartIndex() <= int(ms.getOnsetIndex()) &&
+                    f.getEndIndex() >= int(ms.getEndIndex()))
+            {
+                // just in boundaries
+                if (f.getStartIndex() + ignoreAtStart <= int(ms.getOnsetIndex()) &&
+                        f.getEndIndex() - ignoreAtEnd >= int(ms.getEndIndex()))
+                {
+                    // check for minimum distance between saccades -> for overshooting
+                    if (!m_settings.m_useMinIntersaccInterval || prevMs == nullptr ||
+                            prevMsFixationIndex != fixationIndex ||
+                            ms.getOnsetIndex() - prevMs->getEndIndex() > minIntersaccInterval)
+                    {
+                        result.m_microsaccadeCount++;
+                        result.m_amplitudes.push_back(ms.getAmplitude());
+                        prevMs = &ms;
+                        prevMsFixationIndex = fixationIndex;
+                    }
+                }
+                fixationFound = true;
+            }
+            else
+            {
+                fixationIndex++;
+            }
+        }
+    }
+}
+
+
+bool ParameterSweep::writeCsv(const std::vector<ParameterSweepResult>& results,
+                              const QString& fileName)
+{
+    std::ofstream out(fileName.toStdString(), std::ios::out);
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    out << "VelocityThreshold,MinDuration[ms],#Trials,#Fixations,#Microsaccades,"
+           "Duration[s],#MicrosaccadesPerSecond,#MicrosaccadesPerFixation,"
+           "AmplitudeMean[deg],AmplitudeQ25[deg],AmplitudeMedian[deg],AmplitudeQ75[deg]"
+        << std::endl;
+
+    foreach (const ParameterSweepResult& r, results)
+    {
+        out << r.m_velocityThreshold << ","
+            << r.m_minDuration << ","
+            << r.m_trialCount << ","
+            << r.m_fixationCount << ","
+            << r.m_microsaccadeCount << ","
+            << r.m_duration << ","
+            << (r.m_duration > 0 ? r.m_microsaccadeCount / r.m_duration : 0) << ","
+            << (r.m_fixationCount > 0 ? qreal(r.m_microsaccadeCount) / r.m_fixationCount : 0) << ",";
+
+        if (r.m_amplitudes.empty())
+        {
+            out << ",,," << std::endl;
+        }
+        else
+        {
+            out << MathHelpFunctions::mean(r.m_amplitudes) << ","
+                << MathHelpFunctions::quantile<qreal>(r.m_amplitudes, 0.25) << ","
+                << MathHelpFunctions::median<qreal>(r.m_amplitudes) << ","
+                << MathHelpFunctions::quantile<qreal>(r.m_amplitudes, 0.75) << std::endl;
+        }
+    }
+
+    out.close();
+    return true;
+}
@@ -0,0 +1,103 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file prefilter.cpp
+ **************************************************************************************************/
+#include "prefilter.h"
+#include <algorithm>
+
+
+std::vector<qreal> PreFilter::savitzkyGolayCoefficients(int m)
+{
+    std::vector<qreal> coefficients(size_t(2 * m + 1), 0);
+    if (m == 0)
+    {
+        coefficients[0] = 1;
+        return coefficients;
+    }
+
+    // closed form of the least squares fit of a quadratic polynomial (m >= 1)
+    qreal denominator = (2 * m - 1) * (2 * m + 1) * (2 * m + 3);
+    for (int k = -m; k <= m; ++k)
+    {
+        coefficients[size_t(k + m)] = 3 * (3 * m * m + 3 * m - 1 - 5 * k * k) / denominator;
+    }
+    return coefficients;
+}
+
+
+void PreFilter::savitzkyGolay(const qreal* x, qreal* y, int N, int size)
+{
+    // coefficients for all (shrunk) half window sizes
+    std::vector<std::vector<qreal> > coefficients(size_t(size + 1));
+    for (int m = 0; m <= size; ++m)
+    {
+        coefficients[size_t(m)] = savitzkyGolayCoefficients(m);
+    }
+
+    for (int j = 0; j < N; ++j)
+    {
+        int m = std::min(size, std::min(j, N - 1 - j));
+        const qreal* c = coefficients[size_t(m)].data() + m;
+        qreal value = 0;
+        for (int k = -m; k <= m; ++k)
+        {
+            value += c[k] * x[j + k];
+        }
+        y[j] = value;
+    }
+}
+
+
+void PreFilter::runningMedian(const qreal* x, qreal* y, int N, int size)
+{
+    std::vector<qreal> window(size_t(2 * size + 1));
+    for (int j = 0; j < N; ++j)
+    {
+        int m = std::min(size, std::min(j, N - 1 - j));
+        std::copy(x + j - m, x + j + m + 1, window.begin());
+        std::nth_element(window.begin(), window.begin() + m, window.begin() + 2 * m + 1);
+        y[j] = window[size_t(m)];
+    }
+}
+
+
+void PreFilter::apply(const GazeRuns& runs, PreFilterType filter, size_t windowSize,
+                      FilteredGazeColumns& filtered)
+{
+    filtered.m_filter = filter;
+    filtered.m_windowSize = windowSize;
+    filtered.m_x = runs.m_x;
+    filtered.m_y = runs.m_y;
+
+    int size = int(windowSize - 1) / 2;
+    if (filter == PFT_None || size < 1)
+    {
+        return;
+    }
+
+    const qreal* columns[2] = {runs.m_x.data(), runs.m_y.data()};
+    qreal* filteredColumns[2] = {filtered.m_x.data(), filtered.m_y.data()};
+    for (size_t i = 0; i < runs.m_runs.size(); ++i)
+    {
+        size_t begin = runs.m_runs[i].first;
+        int N = int(runs.m_runs[i].second - begin);
+        for (size_t c = 0; c < 2; ++c)
+        {
+            if (filter == PFT_SavitzkyGolay)
+            {
+                savitzkyGolay(columns[c] + begin, filteredColumns[c] + begin, N, size);
+            }
+            else
+            {
+                runningMedian(columns[c] + begin, filteredColumns[c] + begin, N, size);
+            }
+        }
+    }
+}
+
+
+QStringList PreFilter::filterNames()
+{
+    // same order as PreFilterType
+    return QStringList() << "None" << "Savitzky-Golay" << "Running Median";
+}
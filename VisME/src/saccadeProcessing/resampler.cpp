@@ -0,0 +1,274 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file resampler.cpp
+ **************************************************************************************************/
+#include "resampler.h"
+#include "trial.h"
+#include <algorithm>
+#include <cmath>
+
+
+// rounds towards negative infinity, also for negative indices
+static qint64 floorDiv(qint64 a, qint64 b)
+{
+    qint64 q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+
+Resampler::Resampler(qreal sourceFrequency, qreal targetFrequency) :
+    m_sourceFrequency(qRound(sourceFrequency)),
+    m_targetFrequency(qRound(targetFrequency)),
+    m_up(1),
+    m_down(1),
+    m_halfLength(0),
+    m_filterLength(1)
+{
+    if (!isValid() || qreal(m_sourceFrequency) != sourceFrequency ||
+            qreal(m_targetFrequency) != targetFrequency)
+    {
+        m_sourceFrequency = 0;
+        m_targetFrequency = 0;
+        return;
+    }
+
+    int divisor = m_targetFrequency;
+    for (int r = m_sourceFrequency; r != 0;)
+    {
+        int t = divisor % r;
+        divisor = r;
+        r = t;
+    }
+    m_up = m_targetFrequency / divisor;
+    m_down = m_sourceFrequency / divisor;
+
+    // windowed sinc at the up sampled rate, cut off at the lower Nyquist frequency
+    const qreal beta = 5.0;
+    int factor = std::max(m_up, m_down);
+    m_halfLength = 10 * factor;
+    m_filterLength = size_t(2 * m_halfLength + 1);
+    std::vector<qreal> h(m_filterLength, 0);
+    for (size_t n = 0; n < m_filterLength; ++n)
+    {
+        qreal t = (qreal(n) - m_halfLength) / factor;
+        qreal sinc = t == 0 ? 1 : std::sin(M_PI * t) / (M_PI * t);
+        qreal r = 2.0 * n / (m_filterLength - 1) - 1;
+        h[n] = sinc * besselI0(beta * std::sqrt(std::max(qreal(0), 1 - r * r))) / besselI0(beta);
+    }
+
+    // phase p uses the taps p, p + up, ...; padded with zeros to the same length
+    size_t taps = (m_filterLength + size_t(m_up) - 1) / size_t(m_up);
+    m_phases.assign(size_t(m_up), std::vector<qreal>(taps, 0));
+    for (size_t p = 0; p < size_t(m_up); ++p)
+    {
+        qreal sum = 0;
+        for (size_t t = 0; t < taps; ++t)
+        {
+            size_t n = p + t * size_t(m_up);
+            qreal value = n < m_filterLength ? h[n] : 0;
+            m_phases[p][taps - 1 - t] = value;
+            sum += value;
+        }
+
+        // unit gain of each phase: constant signals stay constant
+        for (size_t t = 0; t < taps && sum != 0; ++t)
+        {
+            m_phases[p][t] /= sum;
+        }
+    }
+}
+
+
+bool Resampler::isValid() const
+{
+    return m_sourceFrequency > 0 && m_targetFrequency > 0;
+}
+
+
+bool Resampler::changesRate() const
+{
+    return isValid() && m_sourceFrequency != m_targetFrequency;
+}
+
+
+int Resampler::mapIndex(int index) const
+{
+    return int(floorDiv(2 * qint64(index) * m_up + m_down, 2 * qint64(m_down)));
+}
+
+
+void Resampler::resampleRun(const qreal* x, int first, int N, std::vector<qreal>& y,
+                            std::vector<int>& index) const
+{
+    if (N <= 0)
+    {
+        return;
+    }
+
+    const int taps = int(m_phases[0].size());
+    qint64 begin = -floorDiv(-qint64(first) * m_up, m_down);
+    qint64 end = floorDiv(qint64(first + N - 1) * m_up, m_down);
+    std::vector<qreal> window(size_t(taps), 0);
+
+    for (qint64 j = begin; j <= end; ++j)
+    {
+        // position of the output sample at the up sampled rate shifted by the filter delay
+        qint64 q = j * m_down + m_halfLength;
+        qint64 kMax = floorDiv(q, m_up);
+        const qreal* phase = m_phases[size_t(q - kMax * m_up)].data();
+
+        // first input sample of the window relative to the run
+        qint64 k0 = kMax - first - taps + 1;
+        const qreal* values = window.data();
+        if (k0 >= 0 && k0 + taps <= N)
+        {
+            values = x + k0;
+        }
+        else
+        {
+            // samples outside the run are replaced by the closest sample of the run
+            for (int t = 0; t < taps; ++t)
+            {
+                window[size_t(t)] = x[std::min(qint64(N - 1), std::max(qint64(0), k0 + t))];
+            }
+        }
+
+        qreal value = 0;
+        for (int t = 0; t < taps; ++t)
+        {
+            value += phase[t] * values[t];
+        }
+
+        y.push_back(value);
+        index.push_back(int(j));
+    }
+}
+
+
+QMap<int, GazeData> Resampler::resampleGazeData(const QMap<int, GazeData>& gazeData) const
+{
+    if (!changesRate())
+    {
+        return gazeData;
+    }
+
+    QMap<int, GazeData> result;
+    std::vector<qreal> x;
+    std::vector<qreal> y;
+    std::vector<qreal> resampledX;
+    std::vector<qreal> resampledY;
+    std::vector<int> indices;
+    std::vector<int> unused;
+
+    // one pass over the gaze data; each run is resampled when the next missing index is reached
+    QMap<int, GazeData>::const_iterator it = gazeData.constBegin();
+    while (it != gazeData.constEnd())
+    {
+        int first = it.key();
+        x.clear();
+        y.clear();
+        for (int expected = first; it != gazeData.constEnd() && it.key() == expected;
+             ++it, ++expected)
+        {
+            x.push_back(it.value().getXPosition());
+            y.push_back(it.value().getYPosition());
+        }
+
+        resampledX.clear();
+        resampledY.clear();
+        indices.clear();
+        unused.clear();
+        resampleRun(x.data(), first, int(x.size()), resampledX, indices);
+        resampleRun(y.data(), first, int(y.size()), resampledY, unused);
+
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            GazeData gaze;
+            gaze.setXPosition(resampledX[i]);
+            gaze.setYPosition(resampledY[i]);
+            result.insert(result.constEnd(), indices[i], gaze);
+        }
+    }
+
+    return result;
+}
+
+
+void Resampler::resampleTrial(Trial* trial) const
+{
+    if (!changesRate())
+    {
+        return;
+    }
+
+    std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
+    for (size_t i = 0; i < gazeTypes.size(); ++i)
+    {
+        trial->setGazeData(resampleGazeData(trial->gazeData(gazeTypes[i])), gazeTypes[i]);
+    }
+
+    std::vector<Event> events;
+    for (size_t i = 0; i < trial->eventCount(); ++i)
+    {
+        Event* event = trial->getEventAt(i);
+        int start = mapIndex(event->getStartIndex());
+        events.push_back(Event(start, mapIndex(event->getEndIndex()) - start + 1,
+                               event->getName()));
+    }
+    trial->setEvents(events);
+
+    // fixations and microsaccades of the input file keep their times
+    bool useFixationsFromInput = trial->useFixationsFromInput();
+    trial->setUseFixationsFromInput(true);
+    for (size_t i = 0; i < gazeTypes.size(); ++i)
+    {
+        std::vector<Fixation>* fixations = trial->fixations(gazeTypes[i]);
+        for (size_t j = 0; j < fixations->size(); ++j)
+        {
+            Fixation& fixation = (*fixations)[j];
+            int start = mapIndex(fixation.getStartIndex());
+            fixation.setDuration(mapIndex(fixation.getEndIndex()) - start + 1);
+            fixation.setStartIndex(start);
+            fixation.clearMicrosaccades(false);
+
+            std::vector<Saccade>* microsaccades = fixation.getMicrosaccades(true);
+            for (size_t k = 0; k < microsaccades->size(); ++k)
+            {
+                Saccade& microsaccade = (*microsaccades)[k];
+                microsaccade.setOnsetIndex(size_t(mapIndex(int(microsaccade.getOnsetIndex()))));
+                microsaccade.setEndIndex(size_t(mapIndex(int(microsaccade.getEndIndex()))));
+            }
+        }
+    }
+
+    // detected results belong to the old rate
+    trial->setUseFixationsFromInput(false);
+    for (size_t i = 0; i < gazeTypes.size(); ++i)
+    {
+        trial->setFixations(std::vector<Fixation>(), gazeTypes[i]);
+        trial->setSaccades(std::vector<Saccade>(), gazeTypes[i]);
+    }
+    trial->setUseFixationsFromInput(useFixationsFromInput);
+
+    trial->setFrequencyRate(m_targetFrequency);
+}
+
+
+size_t Resampler::filterLength() const
+{
+    return m_filterLength;
+}
+
+
+qreal Resampler::besselI0(qreal x)
+{
+    // power series, converges quickly for the small arguments of the window
+    qreal sum = 1;
+    qreal term = 1;
+    for (int k = 1; k < 50 && term > 1e-17 * sum; ++k)
+    {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+    }
+    return sum;
+}
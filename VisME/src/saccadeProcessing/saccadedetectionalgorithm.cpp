@@ -0,0 +1,29 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file saccadedetectionalgorithm.cpp
+ **************************************************************************************************/
+#include "adaptivethresholdalgorithm.h"
+#include "engbertklieglalgorithm.h"
+#include "saccadedetectionalgorithm.h"
+
+
+SaccadeDetectionAlgorithm::~SaccadeDetectionAlgorithm(){}
+
+
+SaccadeDetectionAlgorithm* SaccadeDetectionAlgorithm::create(DetectionAlgorithm algorithm)
+{
+    switch (algorithm)
+    {
+        case DA_AdaptiveThreshold:
+            return new AdaptiveThresholdAlgorithm();
+        case DA_EngbertKliegl:
+        default:
+            return new EngbertKlieglAlgorithm();
+    }
+}
+
+
+QStringList SaccadeDetectionAlgorithm::algorithmNames()
+{
+    return QStringList() << EngbertKlieglAlgorithm().name() << AdaptiveThresholdAlgorithm().name();
+}
@@ -4,9 +4,12 @@
  **************************************************************************************************/
 #define _USE_MATH_DEFINES
 #include "mathhelpfunctions.h"
+#include "saccadedetectionalgorithm.h"
 #include "saccadedetector.h"
-#include "settings.h"
+#include "settingssnapshot.h"
 #include "trial.h"
+#include "velocitykernels.h"
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 #include <QList>
@@ -14,85 +17,34 @@
 SaccadeDetector::SaccadeDetector(){}
 
 
-std::vector<std::vector<Saccade>> SaccadeDetector::determineMicrosaccades(Trial* trial,
-                                                                          Settings* settings)
+std::vector<std::vector<Saccade>> SaccadeDetector::determineMicrosaccades(
+        Trial* trial, const SettingsSnapshot& settings, const CancellationToken& cancellation)
 {
-    std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
-    std::vector<std::vector<Saccade>> msforGazeTypes = std::vector<std::vector<Saccade>>();
-
-    int ignoreBeforeMissingData = settings->m_microsaccadeSettings->m_useIgnoreBeforeMissingData ?
-                            trial->timeToSamples(settings->m_microsaccadeSettings->m_ignoreBeforeMissingData) : 0;
-    int ignoreAfterMissingData = settings->m_microsaccadeSettings->m_useIgnoreAfterMissingData ?
-                          trial->timeToSamples(settings->m_microsaccadeSettings->m_ignoreAfterMissingData) : 0;
-
-    for (size_t i = 0; i < gazeTypes.size(); ++i)
+    // velocities and thresholds are only computed again if parameters changed which influence the
+    // candidates; otherwise just the validity criteria are applied to the stored candidates
+    SaccadeCandidates* candidates = trial->microsaccadeCandidates();
+    qreal pixelsPerDegree = trial->getParticipant()->getPixelsPerDegree();
+    if (!candidates->isUpToDate(settings.m_microsaccadeSettings, pixelsPerDegree))
     {
-        std::vector<Saccade> microsaccades = std::vector<Saccade>();
-
-        // first detect areas without missing data then use only these parts for detection
-        // detect microsaccades for all data (not just fixation areas...)
-        const QMap<int, GazeData>& gazeData = trial->gazeData(gazeTypes[i]);
+        std::vector<std::vector<Saccade>> newCandidates =
+                determineMicrosaccadeCandidates(trial, settings, cancellation);
 
-        if (!gazeData.isEmpty())
+        // candidates of a canceled detection are incomplete and not cached
+        if (cancellation.isCanceled())
         {
-            int start = gazeData.firstKey();
-            int end = gazeData.lastKey();
-
-            std::vector<Saccade> saccadeFilterResult;
-
-            int indicesStart = -1;
-            int indicesEnd = -1;
-            bool removeNextBeginning = false;
-            if (start <= end)
-            {
-                for (int j = start; j <= end; ++j)
-                {
-                    if (gazeData.contains(j))
-                    {
-                        if (indicesStart == -1)
-                        {
-                            if (removeNextBeginning)
-                            {
-                                indicesStart = j + ignoreAfterMissingData;
-                                removeNextBeginning = false;
-                            }
-                            else
-                            {
-                                indicesStart = std::max(j, indicesStart);
-                            }
-                        }
-                    }
-                    else if (indicesStart != -1)
-                    {
-                        indicesEnd = std::max(indicesStart, j - ignoreBeforeMissingData);
-                        if (indicesStart < indicesEnd)
-                        {
-                            saccadeFilterResult = calculateMicrosaccades(gazeData, indicesStart,
-                                                                         indicesEnd, trial, settings);
-                            microsaccades.insert(microsaccades.end(), saccadeFilterResult.begin(), saccadeFilterResult.end());
-
-                        }
-                        indicesStart = -1;
-                        removeNextBeginning = true;
-                    }
-                }
-            }
-
-            if (indicesStart != -1)
-            {
-               indicesEnd = end;
-               saccadeFilterResult = calculateMicrosaccades(gazeData, indicesStart, indicesEnd,
-                                                            trial, settings);
-               microsaccades.insert(microsaccades.end(), saccadeFilterResult.begin(), saccadeFilterResult.end());
-
-            }
-
+            return std::vector<std::vector<Saccade>>(3);
         }
-        msforGazeTypes.push_back(microsaccades);
+        candidates->set(settings.m_microsaccadeSettings, pixelsPerDegree, newCandidates);
+    }
+
+    std::vector<std::vector<Saccade>> msforGazeTypes = candidates->m_candidates;
+    for (size_t i = 0; i < msforGazeTypes.size(); ++i)
+    {
+        removeInvalidSaccades(msforGazeTypes[i], &settings.m_microsaccadeSettings, trial);
     }
 
     // binocular saccades
-    if (settings->m_microsaccadeSettings->m_binocular)
+    if (settings.m_microsaccadeSettings.m_binocular)
     {
         // right and left binocular saccades: if overlap
         QPair<std::vector<Saccade>, std::vector<Saccade>> binSaccades =
@@ -112,100 +64,162 @@ std::vector<std::vector<Saccade>> SaccadeDetector::determineMicrosaccades(Trial*
 }
 
 
-std::vector<std::vector<Saccade>> SaccadeDetector::determineRegularSaccades(Trial* trial,
-                                                                            Settings* settings)
+std::vector<std::vector<Saccade>> SaccadeDetector::determineMicrosaccadeCandidates(
+        Trial* trial, const SettingsSnapshot& settings, const CancellationToken& cancellation)
 {
     std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
-    std::vector<std::vector<Saccade>> saccadesforGazeTypes = std::vector<std::vector<Saccade>>();
+    std::vector<std::vector<Saccade>> msforGazeTypes = std::vector<std::vector<Saccade>>();
 
     for (size_t i = 0; i < gazeTypes.size(); ++i)
     {
-        std::vector<Saccade> saccades = std::vector<Saccade>();
-        const QMap<int, GazeData>& g = trial->gazeData(gazeTypes[i]);
+        msforGazeTypes.push_back(determineMicrosaccadeCandidates(trial, gazeTypes[i],
+                                                                 &settings.m_microsaccadeSettings,
+                                                                 cancellation));
+    }
 
-        if (!g.empty())
-        {
-            QMapIterator<int, GazeData> it(g);
+    return msforGazeTypes;
+}
 
-            std::vector<int> indices;
-            int prevIndex = g.firstKey() - 1;
 
-            int start = g.firstKey();
-            int end = g.lastKey();
+std::vector<Saccade> SaccadeDetector::determineMicrosaccadeCandidates(
+        Trial* trial, GazeType gazeType, const SaccadeFilterSettings* settings,
+        const CancellationToken& cancellation)
+{
+    std::vector<Saccade> microsaccades = std::vector<Saccade>();
 
-            int ignoreBeforeMissingData = settings->m_fixationSettings->m_useIgnoreBeforeMissingData ?
-                                    trial->timeToSamples(settings->m_fixationSettings->m_ignoreBeforeMissingData) : 0;
-            int ignoreAfterMissingData = settings->m_fixationSettings->m_useIgnoreAfterMissingData ?
-                                  trial->timeToSamples(settings->m_fixationSettings->m_ignoreAfterMissingData) : 0;
+    std::vector<GazeSection> sections = determineMicrosaccadeSections(trial, gazeType, settings);
+    SaccadeDetectionAlgorithm* algorithm = SaccadeDetectionAlgorithm::create(settings->m_algorithm);
 
-            qreal pixelsPerDegree = trial->getParticipant()->getPixelsPerDegree();
+    for (size_t j = 0; j < sections.size() && !cancellation.isCanceled(); ++j)
+    {
+        std::vector<Saccade> saccadeFilterResult = saccadesFilter(sections[j], algorithm,
+                                                                  settings, trial);
+        microsaccades.insert(microsaccades.end(), saccadeFilterResult.begin(), saccadeFilterResult.end());
+    }
+
+    delete algorithm;
+
+    return microsaccades;
+}
+
+
+std::vector<GazeSection> SaccadeDetector::determineMicrosaccadeSections(
+        Trial* trial, GazeType gazeType, const SaccadeFilterSettings* settings)
+{
+    std::vector<GazeSection> sections;
+
+    int ignoreBeforeMissingData = settings->m_useIgnoreBeforeMissingData ?
+                            trial->timeToSamples(settings->m_ignoreBeforeMissingData) : 0;
+    int ignoreAfterMissingData = settings->m_useIgnoreAfterMissingData ?
+                          trial->timeToSamples(settings->m_ignoreAfterMissingData) : 0;
 
-            int ignoreUntilIndex = -1;
-            int minimum = start;
+    // first detect areas without missing data then use only these parts for detection
+    // detect microsaccades for all data (not just fixation areas...)
+    const GazeRuns* runs = trial->gazeRuns(gazeType, *settings);
 
-            while(it.hasNext())
+    // optional smoothing of each run, cached in the trial
+    const FilteredGazeColumns* filtered = settings->m_preFilter == PFT_None ? nullptr :
+            trial->filteredGazeColumns(gazeType, *settings);
+
+    for (size_t i = 0; i < runs->m_runs.size(); ++i)
+    {
+        size_t begin = runs->m_runs[i].first;
+        size_t end = runs->m_runs[i].second;
+        int first = runs->m_index[begin];
+        int last = runs->m_index[end - 1];
+
+        // samples after missing data are ignored (not at the beginning of the trial)
+        int indicesStart = i == 0 ? first : first + ignoreAfterMissingData;
+        int indicesEnd = last;
+
+        // samples before missing data are ignored (not at the end of the trial)
+        if (i + 1 < runs->m_runs.size())
+        {
+            if (indicesStart >= last + 1 - ignoreBeforeMissingData)
             {
-                it.next();
+                continue;
+            }
+            indicesEnd = std::min(last, last + 1 - ignoreBeforeMissingData);
+        }
 
-                if (it.key() < start)
-                {
-                    prevIndex = it.key();
-                    continue;
-                }
+        if (indicesStart <= indicesEnd)
+        {
+            sections.push_back(runs->section(begin + size_t(indicesStart - first),
+                                             begin + size_t(indicesEnd - first) + 1, filtered));
+        }
+    }
 
+    return sections;
+}
 
-                // use saccade filter on areas without missing data
-                if ((it.key() - prevIndex > 1 || !it.hasNext() || it.key() == end))
-                {
-                    if (!indices.empty())
-                    {
-                        std::vector<std::vector<qreal> > x;
 
-                        int maxValues = indices.size();
-                        it.key() - prevIndex > 1 ? maxValues = std::max(0, maxValues - ignoreBeforeMissingData) : maxValues;
+std::vector<GazeSection> SaccadeDetector::determineRegularSaccadeSections(
+        Trial* trial, GazeType gazeType, const SaccadeFilterSettings* settings)
+{
+    std::vector<GazeSection> sections;
 
-                        for (size_t i = 0; i < maxValues; ++i)
-                        {
-                            std::vector<qreal> values;
+    int ignoreBeforeMissingData = settings->m_useIgnoreBeforeMissingData ?
+                            trial->timeToSamples(settings->m_ignoreBeforeMissingData) : 0;
+    int ignoreAfterMissingData = settings->m_useIgnoreAfterMissingData ?
+                          trial->timeToSamples(settings->m_ignoreAfterMissingData) : 0;
 
-                            values.push_back(g[indices[i]].getXPosition() / pixelsPerDegree); // 0
-                            values.push_back(g[indices[i]].getYPosition() / pixelsPerDegree); // 1
-                            values.push_back(indices[i]); // 2, index/time
+    const GazeRuns* runs = trial->gazeRuns(gazeType, *settings);
 
-                            x.push_back(values);
-                        }
+    // optional smoothing of each run, cached in the trial
+    const FilteredGazeColumns* filtered = settings->m_preFilter == PFT_None ? nullptr :
+            trial->filteredGazeColumns(gazeType, *settings);
 
-                        QPair<qreal, qreal> newRadius;
+    for (size_t i = 0; i < runs->m_runs.size(); ++i)
+    {
+        size_t begin = runs->m_runs[i].first;
+        size_t end = runs->m_runs[i].second;
+        int first = runs->m_index[begin];
+        int last = runs->m_index[end - 1];
 
-                        std::vector<Saccade> saccadeFilterResult =
-                                saccadesFilter(x,
-                                               newRadius,
-                                               settings->m_fixationSettings,
-                                               trial);
+        // the first sample after missing data and the last sample of the trial are not used
+        int indicesStart = i == 0 ? std::max(first, 0) : first + ignoreAfterMissingData + 1;
+        int indicesEnd = i + 1 < runs->m_runs.size() ? last - ignoreBeforeMissingData : last - 1;
 
-                        saccades.insert(saccades.end(), saccadeFilterResult.begin(), saccadeFilterResult.end());
+        if (indicesStart <= indicesEnd)
+        {
+            sections.push_back(runs->section(begin + size_t(indicesStart - first),
+                                             begin + size_t(indicesEnd - first) + 1, filtered));
+        }
+    }
 
-                        indices.clear();
-                    }
+    return sections;
+}
 
-                    it.key() - prevIndex > 1 ? ignoreUntilIndex = it.key() + ignoreAfterMissingData : ignoreUntilIndex = it.key();
-                }
-                else
-                {
-                    if (it.key() > ignoreUntilIndex)
-                    {
-                        indices.push_back(it.key());
-                    }
-                }
 
-                prevIndex = it.key();
-            }
+std::vector<std::vector<Saccade>> SaccadeDetector::determineRegularSaccades(
+        Trial* trial, const SettingsSnapshot& settings, const CancellationToken& cancellation)
+{
+    std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
+
+    // velocities and thresholds are only computed again if parameters changed which influence the
+    // candidates; otherwise just the validity criteria are applied to the stored candidates
+    SaccadeCandidates* candidates = trial->saccadeCandidates();
+    qreal pixelsPerDegree = trial->getParticipant()->getPixelsPerDegree();
+    if (!candidates->isUpToDate(settings.m_fixationSettings, pixelsPerDegree))
+    {
+        std::vector<std::vector<Saccade>> newCandidates =
+                determineRegularSaccadeCandidates(trial, settings, cancellation);
+
+        // candidates of a canceled detection are incomplete and not cached
+        if (cancellation.isCanceled())
+        {
+            return std::vector<std::vector<Saccade>>(gazeTypes.size());
         }
+        candidates->set(settings.m_fixationSettings, pixelsPerDegree, newCandidates);
+    }
 
-        saccadesforGazeTypes.push_back(saccades);
+    std::vector<std::vector<Saccade>> saccadesforGazeTypes = candidates->m_candidates;
+    for (size_t i = 0; i < saccadesforGazeTypes.size(); ++i)
+    {
+        removeInvalidSaccades(saccadesforGazeTypes[i], &settings.m_fixationSettings, trial);
     }
 
-    if (settings->m_fixationSettings->m_binocular)
+    if (settings.m_fixationSettings.m_binocular)
     {
         // right and left binocular saccades: if overlap
         QPair<std::vector<Saccade>, std::vector<Saccade>> binSaccades =
@@ -224,10 +238,10 @@ std::vector<std::vector<Saccade>> SaccadeDetector::determineRegularSaccades(Tria
     }
 
 
-    int ignoreAtStart = settings->m_fixationSettings->m_useIgnoreAtStart ?
-                            trial->timeToSamples(settings->m_fixationSettings->m_ignoreAtStart) : 0;
-    int ignoreAtEnd = settings->m_fixationSettings->m_useIgnoreAtEnd ?
-                          trial->timeToSamples(settings->m_fixationSettings->m_ignoreAtEnd) : 0;
+    int ignoreAtStart = settings.m_fixationSettings.m_useIgnoreAtStart ?
+                            trial->timeToSamples(settings.m_fixationSettings.m_ignoreAtStart) : 0;
+    int ignoreAtEnd = settings.m_fixationSettings.m_useIgnoreAtEnd ?
+                          trial->timeToSamples(settings.m_fixationSettings.m_ignoreAtEnd) : 0;
 
     for (size_t i = 0; i < gazeTypes.size(); ++i)
     {
@@ -239,7 +253,7 @@ std::vector<std::vector<Saccade>> SaccadeDetector::determineRegularSaccades(Tria
             int start = g.firstKey();
             int end = g.lastKey();
 
-            if (settings->m_fixationSettings->m_useIgnoreAtStart ||settings->m_fixationSettings->m_useIgnoreAtEnd)
+            if (settings.m_fixationSettings.m_useIgnoreAtStart ||settings.m_fixationSettings.m_useIgnoreAtEnd)
             {
                 std::vector<int> indicesToDelete;
 
@@ -262,13 +276,13 @@ std::vector<std::vector<Saccade>> SaccadeDetector::determineRegularSaccades(Tria
             }
 
             // check for minimum distance between saccades -> for overshooting
-            if (settings->m_fixationSettings->m_useMinIntersaccInterval && !saccadesforGazeTypes[i].empty())
+            if (settings.m_fixationSettings.m_useMinIntersaccInterval && !saccadesforGazeTypes[i].empty())
             {
                 std::vector<int> indicesToDelete;
                 for (size_t j = 1; j < saccadesforGazeTypes[i].size(); ++j)
                 {
                     size_t timeDiff = saccadesforGazeTypes[i][j].getOnsetIndex() - saccadesforGazeTypes[i][j - 1].getEndIndex();
-                    if (timeDiff <= trial->timeToSamples(settings->m_fixationSettings->m_minIntersaccInterval))
+                    if (timeDiff <= trial->timeToSamples(settings.m_fixationSettings.m_minIntersaccInterval))
                     {
                         indicesToDelete.push_back(int(j));
                     }
@@ -288,108 +302,283 @@ std::vector<std::vector<Saccade>> SaccadeDetector::determineRegularSaccades(Tria
 }
 
 
-void SaccadeDetector::removeMicrosaccadesForIntersaccadicInterval(Trial* trial, Settings* settings, Fixation* fixation)
+std::vector<std::vector<Saccade>> SaccadeDetector::determineRegularSaccadeCandidates(
+        Trial* trial, const SettingsSnapshot& settings, const CancellationToken& cancellation)
 {
-    if (!settings->m_microsaccadeSettings->m_useMinIntersaccInterval ||
-            fixation->getMicrosaccadesCount(false) <= 1)
+    std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
+    std::vector<std::vector<Saccade>> saccadesforGazeTypes = std::vector<std::vector<Saccade>>();
+    SaccadeDetectionAlgorithm* algorithm =
+            SaccadeDetectionAlgorithm::create(settings.m_fixationSettings.m_algorithm);
+
+    for (size_t i = 0; i < gazeTypes.size(); ++i)
     {
-        return;
+        std::vector<Saccade> saccades = std::vector<Saccade>();
+
+        // use saccade filter on areas without missing data
+        std::vector<GazeSection> sections = determineRegularSaccadeSections(
+                    trial, gazeTypes[i], &settings.m_fixationSettings);
+
+        for (size_t j = 0; j < sections.size() && !cancellation.isCanceled(); ++j)
+        {
+            std::vector<Saccade> saccadeFilterResult =
+                    saccadesFilter(sections[j],
+                                   algorithm,
+                                   &settings.m_fixationSettings,
+                                   trial);
+
+            saccades.insert(saccades.end(), saccadeFilterResult.begin(), saccadeFilterResult.end());
+        }
+
+        saccadesforGazeTypes.push_back(saccades);
     }
 
-    size_t prevMSIndex = 0;
-    std::vector<int> msToRemove;
+    delete algorithm;
 
-    for (size_t i = 1; i < fixation->getMicrosaccadesCount(false); ++i)
+    return saccadesforGazeTypes;
+}
+
+
+bool SaccadeDetector::detectFixations(Trial* trial, const SettingsSnapshot& settings,
+                                      const CancellationToken& cancellation)
+{
+    // fixations of all gaze types are determined before the trial is changed, so that a canceled
+    // detection does not leave a partly updated trial
+    FixationDetectionResult result;
+    bool valid = determineFixations(trial, settings, result, cancellation);
+
+    if (cancellation.isCanceled())
     {
-        Saccade* prevMs = fixation->getMicrosaccadeAt(prevMSIndex, false);
-        Saccade* ms = fixation->getMicrosaccadeAt(i, false);
+        return false;
+    }
 
-        // check for minimum distance between saccades -> for overshooting
-        size_t timeDiff = ms->getOnsetIndex() - prevMs->getEndIndex();
-        if (timeDiff <= trial->timeToSamples(settings->m_microsaccadeSettings->m_minIntersaccInterval))
-        {
-            // remove
-            msToRemove.push_back(int(i));
-        }
-        else
-        {
-            prevMSIndex = i;
-        }
+    setFixations(trial, result);
+
+    return valid;
+}
+
+
+bool SaccadeDetector::determineFixations(Trial* trial, const SettingsSnapshot& settings,
+                                         FixationDetectionResult& result,
+                                         const CancellationToken& cancellation)
+{
+    result.m_saccades = determineRegularSaccades(trial, settings, cancellation);
+
+    std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
+    result.m_fixations = std::vector<std::vector<Fixation>>(gazeTypes.size());
+    result.m_validCount = 0;
+    while (result.m_validCount < gazeTypes.size() &&
+           determineFixations(trial, result.m_saccades[result.m_validCount],
+                              gazeTypes[result.m_validCount], settings,
+                              result.m_fixations[result.m_validCount], cancellation))
+    {
+        result.m_validCount++;
     }
 
-    fixation->removeMicrosaccades(msToRemove, false);
+    return !cancellation.isCanceled() && result.m_validCount == gazeTypes.size();
 }
 
 
-std::vector<Saccade> SaccadeDetector::calculateMicrosaccades(
-        const QMap<int, GazeData>& gazeData,
-        int indicesStart, int indicesEnd,
-        Trial* trial,
-        Settings* settings)
+void SaccadeDetector::setFixations(Trial* trial, const FixationDetectionResult& result)
 {
-    std::vector<std::vector<std::vector<qreal> > > xSections;
-    std::vector<std::vector<qreal> > x;
+    std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
+    for (size_t k = 0; k < result.m_validCount && k < gazeTypes.size(); ++k)
+    {
+        trial->setSaccades(result.m_saccades[k], gazeTypes[k]);
+        trial->setFixations(result.m_fixations[k], gazeTypes[k]);
+    }
+}
 
-    qreal pixelsPerDegree = trial->getParticipant()->getPixelsPerDegree();
 
-    for (int i = indicesStart; i <= indicesEnd; ++i)
+bool SaccadeDetector::detectMicrosaccades(Trial* trial, const SettingsSnapshot& settings,
+                                          const CancellationToken& cancellation)
+{
+    std::vector<std::vector<Saccade>> microsaccades = determineMicrosaccades(trial, settings,
+                                                                             cancellation);
+    if (cancellation.isCanceled())
+    {
+        return false;
+    }
+
+    setMicrosaccades(trial, settings, microsaccades);
+
+    return true;
+}
+
+
+void SaccadeDetector::setMicrosaccades(Trial* trial, const SettingsSnapshot& settings,
+                                       std::vector<std::vector<Saccade>>& microsaccades)
+{
+    // update microsaccades for all gaze types
+    std::vector<GazeType> gazeTypes = {GazeType::GT_Right, GazeType::GT_Left, GazeType::GT_Average};
+    for (size_t i = 0; i < gazeTypes.size() && i < microsaccades.size(); ++i)
     {
-        if (!gazeData.contains(i))
+        // set for fixations and remove ms outside start/end
+        trial->setMicrosaccadesForFixations(&microsaccades[i], gazeTypes[i],
+                                            settings.m_microsaccadeSettings);
+
+        if (settings.m_microsaccadeSettings.m_useMinIntersaccInterval)
         {
-            if (!x.empty())
+            // remove microsaccades inside inter-saccadic interval
+            for (int j = 0; j < trial->fixationsCount(gazeTypes[i]); ++j)
             {
-                xSections.push_back(x);
-                x.clear();
+                removeMicrosaccadesForIntersaccadicInterval(trial, settings, trial->getFixationAt(j, gazeTypes[i]));
             }
-            continue;
         }
+    }
+}
+
 
-        std::vector<qreal> values;
+bool SaccadeDetector::determineFixations(Trial* trial, const std::vector<Saccade>& saccades,
+                                         GazeType gazeType, const SettingsSnapshot& settings,
+                                         std::vector<Fixation>& fixations,
+                                         const CancellationToken& cancellation)
+{
+    const QMap<int, GazeData>& g = trial->gazeData(gazeType);
+    if (g.empty())
+    {
+        return true;
+    }
 
-        values.push_back(gazeData[i].getXPosition() / pixelsPerDegree); // 0
-        values.push_back(gazeData[i].getYPosition() / pixelsPerDegree); // 1
-        values.push_back(i); //2, index/time
+    int ignoreAtStart = settings.m_fixationSettings.m_useIgnoreAtStart ?
+                            int(trial->timeToSamples(settings.m_fixationSettings.m_ignoreAtStart)) : 0;
+    int ignoreAtEnd = settings.m_fixationSettings.m_useIgnoreAtEnd ?
+                          int(trial->timeToSamples(settings.m_fixationSettings.m_ignoreAtEnd)) : 0;
+    int startIndex = g.firstKey() + ignoreAtStart;
+    int endIndex = g.lastKey() - ignoreAtEnd;
 
-        x.push_back(values);
+    if (startIndex < 0 || endIndex < 0)
+    {
+        return false;
     }
-    if (!x.empty())
+
+    int minimumFixLength = 0; // in samples
+
+    // everything that is not a saccade is handled as fixation...
+    for (size_t i = 0; i < saccades.size() + 1; ++i)
     {
-        xSections.push_back(x);
+        if (cancellation.isCanceled())
+        {
+            return false;
+        }
+
+        // area before first saccade (or after ignore time) and after the last one is added as fixations
+        int start = i == 0 ? startIndex : int(saccades[i - 1].getEndIndex()) + 1;
+        int end = i < saccades.size() ? (saccades[i].getEndIndex() > size_t(endIndex) ?
+                                             endIndex :
+                                             int(saccades[i].getOnsetIndex()) - 1) : endIndex;
+
+        // one pass over the available samples in [start, end); a missing index ends a fixation
+        qreal x = 0;
+        qreal y = 0;
+        int count = 0;
+        int s = start;
+        int e = end;
+        int previousIndex = start - 1;
+        for (QMap<int, GazeData>::const_iterator it = g.lowerBound(start);
+             it != g.constEnd() && it.key() < end; ++it)
+        {
+            if (it.key() > previousIndex + 1 && count > 0)
+            {
+                if (e - s + 1 >= minimumFixLength)
+                {
+                    Fixation fixation = Fixation();
+                    fixation.setStartIndex(s);
+                    fixation.setDuration(e - s + 1);
+                    fixation.setXPosition(x / count);
+                    fixation.setYPosition(y / count);
+
+                    fixations.push_back(fixation);
+
+                    x = 0;
+                    y = 0;
+                }
+                count = 0;
+                s = -1;
+            }
+
+            x += it.value().getXPosition();
+            y += it.value().getYPosition();
+            e = it.key();
+            s == -1 ? s = it.key() : s;
+            count++;
+            previousIndex = it.key();
+        }
+
+        if (count > 0)
+        {
+            if (e - s + 1 >= minimumFixLength)
+            {
+                Fixation fixation = Fixation();
+                fixation.setStartIndex(s);
+                fixation.setDuration(e - s + 1);
+                fixation.setXPosition(x / count);
+                fixation.setYPosition(y / count);
+
+                fixations.push_back(fixation);
+            }
+        }
     }
 
-    std::vector<Saccade> saccades;
-    foreach (std::vector<std::vector<qreal> > xValues, xSections)
+    return true;
+}
+
+
+void SaccadeDetector::removeMicrosaccadesForIntersaccadicInterval(Trial* trial,
+                                                                  const SettingsSnapshot& settings,
+                                                                  Fixation* fixation)
+{
+    if (!settings.m_microsaccadeSettings.m_useMinIntersaccInterval ||
+            fixation->getMicrosaccadesCount(false) <= 1)
     {
-        QPair<qreal, qreal> newRadius;
-        std::vector<Saccade> s = saccadesFilter(
-            xValues,
-            newRadius,
-            settings->m_microsaccadeSettings,
-            trial);
+        return;
+    }
+
+    size_t prevMSIndex = 0;
+    std::vector<int> msToRemove;
 
-         saccades.insert(saccades.end(), s.begin(), s.end());
+    for (size_t i = 1; i < fixation->getMicrosaccadesCount(false); ++i)
+    {
+        Saccade* prevMs = fixation->getMicrosaccadeAt(prevMSIndex, false);
+        Saccade* ms = fixation->getMicrosaccadeAt(i, false);
+
+        // check for minimum distance between saccades -> for overshooting
+        size_t timeDiff = ms->getOnsetIndex() - prevMs->getEndIndex();
+        if (timeDiff <= trial->timeToSamples(settings.m_microsaccadeSettings.m_minIntersaccInterval))
+        {
+            // remove
+            msToRemove.push_back(int(i));
+        }
+        else
+        {
+            prevMSIndex = i;
+        }
     }
 
-    return saccades;
+    fixation->removeMicrosaccades(msToRemove, false);
 }
 
 
-std::vector<Saccade> SaccadeDetector::saccadesFilter(std::vector<std::vector<qreal> >& x,
-                                                     QPair<qreal, qreal>& newRadius,
-                                                     SaccadeFilterSettings* settings,
+std::vector<Saccade> SaccadeDetector::saccadesFilter(const GazeSection& x,
+                                                     SaccadeDetectionAlgorithm* algorithm,
+                                                     const SaccadeFilterSettings* settings,
                                                      Trial* trial)
 {
     // velocity
-    std::vector<std::vector<qreal> > v = determineVelocity(x, trial->frequencyRate(), settings->m_velocityWindowSize);
+    GazeVelocity v = determineVelocity(x, trial->frequencyRate(), settings->m_velocityWindowSize);
 
-    if (v.empty()) // no data for processing
+    if (v.m_x.empty()) // no data for processing
     {
         return std::vector<Saccade>();
     }
 
-    // threshold
-    std::vector<qreal> col0 = MathHelpFunctions::getColumn(v, 0);
-    std::vector<qreal> col1 = MathHelpFunctions::getColumn(v, 1);
+    return algorithm->detect(x, v, settings, trial);
+}
+
+
+bool SaccadeDetector::velocityStatistics(const GazeVelocity& v, QPair<qreal, qreal>& msd)
+{
+    const std::vector<qreal>& col0 = v.m_x;
+    const std::vector<qreal>& col1 = v.m_y;
 
     auto medx = MathHelpFunctions::median<qreal>(col0);
     auto msdx = sqrt(MathHelpFunctions::median<qreal>(
@@ -405,7 +594,7 @@ std::vector<Saccade> SaccadeDetector::saccadesFilter(std::vector<std::vector<qre
         msdx = sqrt(pow(MathHelpFunctions::mean(col0), 2));
         if (msdx < 1e-10)
         {
-            return std::vector<Saccade>();
+            return false;
         }
     }
     if (msdy < 1e-10)
@@ -413,12 +602,28 @@ std::vector<Saccade> SaccadeDetector::saccadesFilter(std::vector<std::vector<qre
         msdy = sqrt(pow(MathHelpFunctions::mean(col1), 2));
         if (msdy < 1e-10)
         {
-            return std::vector<Saccade>();
+            return false;
         }
     }
 
-    qreal radiusX = settings->m_velocityThreshold * msdx;
-    qreal radiusY = settings->m_velocityThreshold * msdy;
+    msd = QPair<qreal, qreal>(msdx, msdy);
+    return true;
+}
+
+
+std::vector<Saccade> SaccadeDetector::determineSaccadeCandidates(
+        const GazeSection& x,
+        const GazeVelocity& v,
+        const QPair<qreal, qreal>& msd,
+        qreal velocityThreshold,
+        size_t minDuration,
+        QPair<qreal, qreal>& newRadius)
+{
+    const std::vector<qreal>& col0 = v.m_x;
+    const std::vector<qreal>& col1 = v.m_y;
+
+    qreal radiusX = velocityThreshold * msd.first;
+    qreal radiusY = velocityThreshold * msd.second;
     newRadius = QPair<qreal, qreal>(radiusX, radiusY);
 
     // Apply test criterion: elliptic treshold
@@ -448,7 +653,7 @@ std::vector<Saccade> SaccadeDetector::saccadesFilter(std::vector<std::vector<qre
         else
         {
             // Minimum duration criterion (exception: last saccade)
-            if (dur >= trial->timeToSamples(settings->m_minDuration))
+            if (dur >= minDuration)
             {
                 b = k;
                 Saccade m = Saccade(indx[a], indx[b], 0, 0, 0, 0, 0);
@@ -461,149 +666,161 @@ std::vector<Saccade> SaccadeDetector::saccadesFilter(std::vector<std::vector<qre
     }
 
     // Check minimum duration for last saccade
-    if (N > 0 && dur >= trial->timeToSamples(settings->m_minDuration))
+    if (N > 0 && dur >= minDuration)
     {
         b = k;
         Saccade m = Saccade(indx[a], indx[b], 0, 0, 0, 0, 0);
         sac.push_back(m);
     }
 
-    if (!sac.empty())
-    {
-        // Compute peak velocity, horiztonal and vertical components
-        for (size_t s = 0; s < sac.size(); ++s)
-        {
-            // Onset and offset for saccades
-            a = int(sac[s].getOnsetIndex());
-            b = int(sac[s].getEndIndex());
+    setSaccadeProperties(x, v, sac);
 
-            std::vector<int> idx(b - a + 1);
-            for (int i = 0; i <= b - a; ++i)
-            {
-                idx[i] = i + a;
-            }
+    return sac;
+}
 
-            std::vector<qreal> v_idx0(idx.size());
-            std::vector<qreal> v_idx1(idx.size());
-            std::vector<qreal> x_idx0(idx.size());
-            std::vector<qreal> x_idx1(idx.size());
-            for (size_t i = 0; i < idx.size(); ++i)
-            {
-                v_idx0[i] = v[idx[i]][0];
-                v_idx1[i] = v[idx[i]][1];
-                x_idx0[i] = x[idx[i]][0];
-                x_idx1[i] = x[idx[i]][1];
-            }
 
-            // Saccade peak velocity (vpeak)
-            qreal vpeak = MathHelpFunctions::maxValue(
-                              MathHelpFunctions::sqrtComponents(
-                                  MathHelpFunctions::add(
-                                    MathHelpFunctions::squareComponents(v_idx0),
-                                    MathHelpFunctions::squareComponents(v_idx1))));
-
-            sac[s].setPeakVelocity(vpeak);
-
-            // Saccade vector (dx,dy);
-            qreal dx = x[b][0] - x[a][0];
-            qreal dy = x[b][1] - x[a][1];
-
-            sac[s].setHorizontalComponent(dx);
-            sac[s].setVerticalComponent(dy);
-            // Saccade amplitude (dX,dY)
-            qreal minx = MathHelpFunctions::minValue(x_idx0);
-            qreal maxx = MathHelpFunctions::maxValue(x_idx0);
-            qreal miny = MathHelpFunctions::minValue(x_idx1);
-            qreal maxy = MathHelpFunctions::maxValue(x_idx1);
-            int ix1 = MathHelpFunctions::minIndex(x_idx0);
-            int ix2 = MathHelpFunctions::maxIndex(x_idx0);
-            int iy1 = MathHelpFunctions::minIndex(x_idx1);
-            int iy2 = MathHelpFunctions::maxIndex(x_idx1);
-            qreal dX = ((ix2 - ix1) < 0 ? -1.0 : 1.0) * (maxx - minx);
-            qreal dY = ((iy2 - iy1) < 0 ? -1.0 : 1.0) * (maxy - miny);
-            sac[s].setHorizontalAmplitude(dX);
-            sac[s].setVerticalAmplitude(dY);
-
-            // from paper "McCamy et al.: Microsaccades Scan Highly Informative Image Areas"
-            // amplitude > 1 degree => saccade
-            // amplitude <= 1 degree => microsaccade
-            qreal amplitude = sqrt(pow(dX, 2) + pow(dY, 2));
-            sac[s].setValid((settings->m_useMaxAmplitude ? amplitude <= settings->m_maxAmplitude : true) &&
-                            (settings->m_useMinAmplitude ? amplitude >= settings->m_minAmplitude : true));
-
-            // set valid according to peak velocity
-            sac[s].setValid(sac[s].isValid() &&
-                            (settings->m_useMaxVelocity ? sac[s].getPeakVelocity() <= settings->m_maxVelocity : true) &&
-                            (settings->m_useMinVelocity ? sac[s].getPeakVelocity() >= settings->m_minVelocity : true));
-
-            // set valid according to duration
-            sac[s].setValid(sac[s].isValid() && (settings->m_useMaxDuration ? sac[s].getDuration() <= trial->timeToSamples(settings->m_maxDuration) : true));
-        }
+void SaccadeDetector::setSaccadeProperties(const GazeSection& x, const GazeVelocity& v,
+                                           std::vector<Saccade>& sac)
+{
+    // Compute peak velocity, horiztonal and vertical components
+    for (size_t s = 0; s < sac.size(); ++s)
+    {
+        // Onset and offset for saccades
+        int a = int(sac[s].getOnsetIndex());
+        int b = int(sac[s].getEndIndex());
 
-        // check for saccades that are too large
-        for (int i = int(sac.size()) - 1; i >= 0 ; --i) // i needs to be int
+        std::vector<int> idx(b - a + 1);
+        for (int i = 0; i <= b - a; ++i)
         {
-            sac[i].setEndIndex(x[sac[i].getEndIndex()][2]);
-            sac[i].setOnsetIndex(x[sac[i].getOnsetIndex()][2]);
+            idx[i] = i + a;
+        }
 
-            // delete saccades that are too large (-> they are no microsaccades)
-            if (!sac[i].isValid())
-            {
-                sac.erase(sac.begin() + i);
-            }
+        std::vector<qreal> v_idx0(idx.size());
+        std::vector<qreal> v_idx1(idx.size());
+        std::vector<qreal> x_idx0(idx.size());
+        std::vector<qreal> x_idx1(idx.size());
+        for (size_t i = 0; i < idx.size(); ++i)
+        {
+            v_idx0[i] = v.m_x[idx[i]];
+            v_idx1[i] = v.m_y[idx[i]];
+            x_idx0[i] = x.m_x[idx[i]];
+            x_idx1[i] = x.m_y[idx[i]];
         }
 
-        return sac;
+        // Saccade peak velocity (vpeak)
+        qreal vpeak = MathHelpFunctions::maxValue(
+                          MathHelpFunctions::sqrtComponents(
+                              MathHelpFunctions::add(
+                                MathHelpFunctions::squareComponents(v_idx0),
+                                MathHelpFunctions::squareComponents(v_idx1))));
+
+        sac[s].setPeakVelocity(vpeak);
+
+        // Saccade vector (dx,dy);
+        qreal dx = x.m_x[b] - x.m_x[a];
+        qreal dy = x.m_y[b] - x.m_y[a];
+
+        sac[s].setHorizontalComponent(dx);
+        sac[s].setVerticalComponent(dy);
+        // Saccade amplitude (dX,dY)
+        qreal minx = MathHelpFunctions::minValue(x_idx0);
+        qreal maxx = MathHelpFunctions::maxValue(x_idx0);
+        qreal miny = MathHelpFunctions::minValue(x_idx1);
+        qreal maxy = MathHelpFunctions::maxValue(x_idx1);
+        int ix1 = MathHelpFunctions::minIndex(x_idx0);
+        int ix2 = MathHelpFunctions::maxIndex(x_idx0);
+        int iy1 = MathHelpFunctions::minIndex(x_idx1);
+        int iy2 = MathHelpFunctions::maxIndex(x_idx1);
+        qreal dX = ((ix2 - ix1) < 0 ? -1.0 : 1.0) * (maxx - minx);
+        qreal dY = ((iy2 - iy1) < 0 ? -1.0 : 1.0) * (maxy - miny);
+        sac[s].setHorizontalAmplitude(dX);
+        sac[s].setVerticalAmplitude(dY);
+    }
+
+    // convert to indices of the raw data; validity criteria are applied afterwards on these
+    // candidates (removeInvalidSaccades) so that they can be reused if only criteria change
+    for (size_t i = 0; i < sac.size(); ++i)
+    {
+        sac[i].setEndIndex(x.m_index[sac[i].getEndIndex()]);
+        sac[i].setOnsetIndex(x.m_index[sac[i].getOnsetIndex()]);
     }
-    return std::vector<Saccade>();
 }
 
 
-std::vector<std::vector<qreal> > SaccadeDetector::determineVelocity(
-        std::vector<std::vector<qreal> >& xValues, qreal frequency, size_t windowSize)//, int type)
+bool SaccadeDetector::isValidSaccade(const Saccade& saccade,
+                                     const SaccadeFilterSettings* settings, size_t maxDuration)
+{
+    // from paper "McCamy et al.: Microsaccades Scan Highly Informative Image Areas"
+    // amplitude > 1 degree => saccade
+    // amplitude <= 1 degree => microsaccade
+    qreal amplitude = saccade.getAmplitude();
+    bool valid = (settings->m_useMaxAmplitude ? amplitude <= settings->m_maxAmplitude : true) &&
+                 (settings->m_useMinAmplitude ? amplitude >= settings->m_minAmplitude : true);
+
+    // valid according to peak velocity
+    valid = valid &&
+            (settings->m_useMaxVelocity ? saccade.getPeakVelocity() <= settings->m_maxVelocity : true) &&
+            (settings->m_useMinVelocity ? saccade.getPeakVelocity() >= settings->m_minVelocity : true);
+
+    // valid according to duration
+    valid = valid && (settings->m_useMaxDuration ? saccade.getDuration() <= maxDuration : true);
+
+    return valid;
+}
+
+
+void SaccadeDetector::removeInvalidSaccades(std::vector<Saccade>& saccades,
+                                            const SaccadeFilterSettings* settings, Trial* trial)
 {
-    // first two columns in xValues is x and y value; third column in xValues is for time
-    int N = int(xValues.size()); // rows
+    size_t maxDuration = trial->timeToSamples(settings->m_maxDuration);
 
-    std::vector<std::vector<qreal> > velocityMatrix;
-    for (int i = 0; i < N; ++i)
+    size_t validCount = 0;
+    for (size_t i = 0; i < saccades.size(); ++i)
     {
-        std::vector<qreal> velocityRow;
-        for (int j = 0; j < 2; ++j)
+        if (isValidSaccade(saccades[i], settings, maxDuration))
         {
-            velocityRow.push_back(0);
+            if (validCount != i)
+            {
+                saccades[validCount] = saccades[i];
+            }
+            ++validCount;
         }
-        velocityMatrix.push_back(velocityRow);
     }
+    saccades.erase(saccades.begin() + long(validCount), saccades.end());
+}
+
+
+GazeVelocity SaccadeDetector::determineVelocity(const GazeSection& xValues, qreal frequency,
+                                                size_t windowSize)//, int type)
+{
+    // x and y values of the section
+    int N = int(xValues.m_size); // rows
+    const qreal* columns[2] = {xValues.m_x, xValues.m_y};
+
+    GazeVelocity velocity;
+    velocity.m_x = std::vector<qreal>(size_t(N), 0);
+    velocity.m_y = std::vector<qreal>(size_t(N), 0);
+    std::vector<qreal>* velocityColumns[2] = {&velocity.m_x, &velocity.m_y};
 
     // in order to determine the velocity windowSize data samples are required
     int size = (int(windowSize) - 1) / 2;
-    if (xValues.size() < windowSize)
+    if (xValues.m_size < windowSize)
     {
-        return velocityMatrix;
+        return velocity;
     }
 
-    // with general window size
+    // with general window size; specialized kernels for common window sizes
+    VelocityKernels::Kernel kernel = VelocityKernels::kernel(windowSize);
     for (size_t i = 0; i < 2; ++i)
     {
-        for (int j = size; j < N - size; ++j)
-        {
-            qreal windowValue = 0;
-            for (int k = -size; k <= size; ++k)
-            {
-                if (k == 0)
-                {
-                    continue;
-                }
-                windowValue += (k < 0 ? -1 : 1) * xValues[size_t(j + k)][i];
-            }
-            velocityMatrix[size_t(j)][i] = frequency / 6.0 * windowValue;
-        }
+        kernel(columns[i], velocityColumns[i]->data(), N, size, frequency / 6.0);
     }
 
     // values for which not enough data samples are available
     for (size_t i = 0; i < 2; ++i)
     {
+        const qreal* x = columns[i];
+        std::vector<qreal>& v = *velocityColumns[i];
         for (int j = 0; j < size - 1; ++j)
         {
             qreal windowValue1 = 0;
@@ -614,15 +831,15 @@ std::vector<std::vector<qreal> > SaccadeDetector::determineVelocity(
                 {
                     continue;
                 }
-                windowValue1 += (k > size / 2 ? 1 : -1) * xValues[k][i];
-                windowValue2 += (k > size / 2 ? -1 : 1) * xValues[N - k - 1][i];
+                windowValue1 += (k > size / 2 ? 1 : -1) * x[k];
+                windowValue2 += (k > size / 2 ? -1 : 1) * x[N - k - 1];
             }
 
-            velocityMatrix[1][i] = frequency / qreal(size) * windowValue1;
-            velocityMatrix[N - 2][i] = frequency / qreal(size) * windowValue2;
+            v[1] = frequency / qreal(size) * windowValue1;
+            v[size_t(N - 2)] = frequency / qreal(size) * windowValue2;
         }
     }
-    return velocityMatrix;
+    return velocity;
 
     // original algorithm used by Engbert
     //if (type == 2)
@@ -656,149 +873,125 @@ std::vector<std::vector<qreal> > SaccadeDetector::determineVelocity(
 
 
 QPair<std::vector<Saccade>, std::vector<Saccade>> SaccadeDetector::determineBinocularSaccades(
-        std::vector<Saccade> leftEye, std::vector<Saccade> rightEye)
+        const std::vector<Saccade>& leftEye, const std::vector<Saccade>& rightEye)
 {
     std::vector<Saccade> binL;
     std::vector<Saccade> binR;
-    std::vector<Saccade> monoL;
-    std::vector<Saccade> monoR;
-
-    int NB = 0;
-    int NR = 0;
-    int NL = 0;
-    if (leftEye.size() * rightEye.size() > 0)
-    {
-        // Determine saccade clusters
-        int TR = 0;
-        int TL = 0;
-        for (size_t i = 0; i < rightEye.size(); ++i)
-        {
-            TR = std::max(TR, int(rightEye[i].getEndIndex()));
-        }
-        for (size_t i = 0; i < leftEye.size(); ++i)
-        {
-            TL = std::max(TL, int(leftEye[i].getEndIndex()));
-        }
 
-        int TB = std::max(TR, TL);
+    // Special case of exclusively monocular saccades: no binocular saccades
+    if (leftEye.empty() || rightEye.empty())
+    {
+        return QPair<std::vector<Saccade>, std::vector<Saccade>>(binL, binR);
+    }
 
-        std::vector<int> s(size_t(TB + 1), 0);
+    const std::vector<Saccade>* eyes[2] = {&leftEye, &rightEye};
 
-        for (size_t i = 0; i < leftEye.size(); ++i)
+    // Determine saccade clusters: samples covered by saccades of both eyes where the first sample
+    // (index 0) and the last sample (largest end index) are never part of a cluster
+    int TB = 0;
+    for (size_t e = 0; e < 2; ++e)
+    {
+        for (size_t i = 0; i < eyes[e]->size(); ++i)
         {
-            for (size_t j = leftEye[i].getOnsetIndex(); j <= leftEye[i].getEndIndex(); ++j)
-            {
-                s[j] = 1;
-            }
+            TB = std::max(TB, int((*eyes[e])[i].getEndIndex()));
         }
-        for (size_t i = 0; i < rightEye.size(); ++i)
+    }
+
+    std::vector<QPair<int, int> > intervals;
+    intervals.reserve(leftEye.size() + rightEye.size());
+    for (size_t e = 0; e < 2; ++e)
+    {
+        for (size_t i = 0; i < eyes[e]->size(); ++i)
         {
-            for (size_t j = rightEye[i].getOnsetIndex(); j <= rightEye[i].getEndIndex(); ++j)
+            int onset = std::max(1, int((*eyes[e])[i].getOnsetIndex()));
+            int end = std::min(TB - 1, int((*eyes[e])[i].getEndIndex()));
+            if (onset <= end)
             {
-                s[j] = 1;
+                intervals.push_back(QPair<int, int>(onset, end));
             }
         }
-        s[0] = 0;
-        s[size_t(TB)] = 0;
+    }
+    std::sort(intervals.begin(), intervals.end());
 
-        // Find onsets and offsets of microsaccades
-        std::vector<int> diff = MathHelpFunctions::differences(s);
-        std::vector<size_t> onoff = MathHelpFunctions::indicesUnequalTo(diff, 0);
+    // merge overlapping and adjacent intervals; cluster: first and last sample
+    std::vector<QPair<int, int> > clusters;
+    for (size_t i = 0; i < intervals.size(); ++i)
+    {
+        if (!clusters.empty() && intervals[i].first <= clusters.back().second + 1)
+        {
+            clusters.back().second = std::max(clusters.back().second, intervals[i].second);
+        }
+        else
+        {
+            clusters.push_back(intervals[i]);
+        }
+    }
+
+    // largest event in each eye for each cluster (first one in the input order if equal)
+    std::vector<int> largest[2] = {std::vector<int>(clusters.size(), -1),
+                                   std::vector<int>(clusters.size(), -1)};
+    for (size_t e = 0; e < 2; ++e)
+    {
+        const std::vector<Saccade>& eye = *eyes[e];
 
-        std::vector<std::vector<size_t> > m;
-        for (size_t i = 0; i < onoff.size(); i += 2)
+        // saccades sorted by onset to find their cluster in one sweep
+        std::vector<size_t> order(eye.size());
+        for (size_t i = 0; i < order.size(); ++i)
         {
-            std::vector<size_t> v;
-            v.push_back(onoff[i] + 1);
-            v.push_back(onoff[i + 1] + 1);
-            m.push_back(v);
+            order[i] = i;
         }
+        std::sort(order.begin(), order.end(), [&eye](size_t a, size_t b)
+        {
+            return eye[a].getOnsetIndex() < eye[b].getOnsetIndex();
+        });
 
-        // Determine binocular saccades
-        for (size_t i = 0; i < m.size(); ++i)
+        // cluster containing the saccade (onset and end in [first, last + 1]), -1 if none
+        std::vector<int> clusterOf(eye.size(), -1);
+        size_t c = 0;
+        for (size_t i = 0; i < order.size(); ++i)
         {
-            std::vector<size_t> left;
-            std::vector<size_t> right;
-            for (size_t j = 0; j < leftEye.size(); ++j)
+            const Saccade& saccade = eye[order[i]];
+            while (c + 1 < clusters.size() &&
+                   clusters[c + 1].first <= int(saccade.getOnsetIndex()))
             {
-                if (m[i][0] <= leftEye[j].getOnsetIndex() && leftEye[j].getEndIndex() <= m[i][1])
-                {
-                    left.push_back(j);
-                }
+                ++c;
             }
-            for (size_t j = 0; j < rightEye.size(); ++j)
+            if (c < clusters.size() &&
+                    clusters[c].first <= int(saccade.getOnsetIndex()) &&
+                    int(saccade.getEndIndex()) <= clusters[c].second + 1)
             {
-                if (m[i][0] <= rightEye[j].getOnsetIndex() && rightEye[j].getEndIndex() <= m[i][1])
-                {
-                    right.push_back(j);
-                }
+                clusterOf[order[i]] = int(c);
             }
+        }
 
-            // Binocular saccades
-            if (left.size() * right.size() > 0)
+        std::vector<qreal> largestAmplitude(clusters.size(), 0.0);
+        for (size_t i = 0; i < eye.size(); ++i)
+        {
+            if (clusterOf[i] == -1)
             {
-                std::vector<qreal> ampr;
-                std::vector<qreal> ampl;
-
-                for (size_t j = 0; j < right.size(); ++j)
-                {
-                    ampr.push_back(sqrt(pow(rightEye[right[j]].getHorizontalAmplitude(), 2) +
-                                   pow(rightEye[right[j]].getVerticalAmplitude(), 2)));
-                }
-                for (size_t j = 0; j < left.size(); ++j)
-                {
-                    ampl.push_back(sqrt(pow(leftEye[left[j]].getHorizontalAmplitude(), 2) +
-                                   pow(leftEye[left[j]].getVerticalAmplitude(), 2)));
-                }
-                // Determine largest event in each eye
-                int ir = MathHelpFunctions::maxIndex(ampr);
-                int il = MathHelpFunctions::maxIndex(ampl);
-                NB = NB + 1;
-
-                binL.push_back(leftEye[left[il]]);
-                binR.push_back(rightEye[right[ir]]);
+                continue;
             }
-            else
-            {
-                // Determine monocular saccades
-                if (left.empty())
-                {
-                    NR = NR + 1;
-
-                    std::vector<qreal> ampr;
-                    for (size_t j = 0; j < right.size(); ++j)
-                    {
-                        ampr.push_back(sqrt(pow(rightEye[right[j]].getHorizontalAmplitude(), 2) +
-                                       pow(rightEye[right[j]].getVerticalAmplitude(), 2)));
-                    }
-                }
-                if (right.empty())
-                {
-                    NL = NL + 1;
 
-                    std::vector<qreal> ampl;
-                    for (size_t j = 0; j < left.size(); ++j)
-                    {
-                        ampl.push_back(sqrt(pow(leftEye[left[j]].getHorizontalAmplitude(), 2) +
-                                       pow(leftEye[left[j]].getVerticalAmplitude(), 2)));
-                    }
-                }
+            size_t cluster = size_t(clusterOf[i]);
+            qreal amplitude = eye[i].getAmplitude();
+            if (largest[e][cluster] == -1 || largestAmplitude[cluster] < amplitude)
+            {
+                largest[e][cluster] = int(i);
+                largestAmplitude[cluster] = amplitude;
             }
         }
     }
-    else
+
+    // Binocular saccades: clusters with saccades in both eyes
+    for (size_t i = 0; i < clusters.size(); ++i)
     {
-        // Special case of exclusively monocular saccades
-        if (rightEye.empty())
-        {
-            monoL = leftEye;
-        }
-        if (leftEye.empty())
+        if (largest[0][i] != -1 && largest[1][i] != -1)
         {
-            monoR = rightEye;
+            binL.push_back(leftEye[size_t(largest[0][i])]);
+            binR.push_back(rightEye[size_t(largest[1][i])]);
         }
     }
 
-    return QPair<std::vector<Saccade>, std::vector<Saccade>>(binL, binR); // monoR, monoL?
+    return QPair<std::vector<Saccade>, std::vector<Saccade>>(binL, binR);
 }
 
@@ -0,0 +1,400 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file streamingsaccadedetector.cpp
+ **************************************************************************************************/
+#include "participant.h"
+#include "saccadedetector.h"
+#include "streamingsaccadedetector.h"
+#include "trial.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <QMapIterator>
+
+
+StreamingSaccadeDetector::StreamingSaccadeDetector(const SaccadeFilterSettings& settings,
+                                                   qreal frequency, qreal pixelsPerDegree,
+                                                   int thresholdWindow) :
+    m_settings(settings),
+    m_frequency(frequency),
+    m_pixelsPerDegree(pixelsPerDegree)
+{
+    m_windowSize = std::max(size_t(3), settings.m_velocityWindowSize);
+    m_halfWindow = (m_windowSize - 1) / 2;
+    m_minDuration = timeToSamples(settings.m_minDuration);
+    m_maxDuration = timeToSamples(settings.m_maxDuration);
+    m_ignoreBeforeMissingData = settings.m_useIgnoreBeforeMissingData ?
+                                    int(timeToSamples(settings.m_ignoreBeforeMissingData)) : 0;
+    m_ignoreAfterMissingData = settings.m_useIgnoreAfterMissingData ?
+                                   int(timeToSamples(settings.m_ignoreAfterMissingData)) : 0;
+    m_thresholdWindow = std::max(m_windowSize, timeToSamples(thresholdWindow));
+    m_warmUp = std::max(m_windowSize, std::min(m_thresholdWindow, timeToSamples(1000)));
+    m_maxRunSize = m_thresholdWindow;
+
+    reset();
+}
+
+
+std::vector<Saccade> StreamingSaccadeDetector::addSample(int index, const GazeData& gazeData)
+{
+    std::vector<Saccade> result;
+
+    if (m_lastIndex != std::numeric_limits<int>::min())
+    {
+        if (index <= m_lastIndex)
+        {
+            return result;
+        }
+
+        // missing data: kept back samples are within the ignored range before missing data
+        if (index > m_lastIndex + 1)
+        {
+            m_pending.clear();
+            endSection(result);
+            m_ignoreUntilIndex = index + m_ignoreAfterMissingData;
+        }
+    }
+    m_lastIndex = index;
+
+    if (index < m_ignoreUntilIndex)
+    {
+        return result;
+    }
+
+    Sample sample;
+    sample.m_index = index;
+    sample.m_x = gazeData.getXPosition() / m_pixelsPerDegree;
+    sample.m_y = gazeData.getYPosition() / m_pixelsPerDegree;
+    sample.m_vx = 0;
+    sample.m_vy = 0;
+    m_pending.push_back(sample);
+
+    // a sample is used as soon as no missing data can follow within the ignored range
+    int delay = std::max(0, m_ignoreBeforeMissingData - 1);
+    while (!m_pending.empty() && m_pending.front().m_index <= index - delay)
+    {
+        addToSection(m_pending.front(), result);
+        m_pending.pop_front();
+    }
+
+    return result;
+}
+
+
+std::vector<Saccade> StreamingSaccadeDetector::finish()
+{
+    std::vector<Saccade> result;
+
+    // the last section is not shortened (no missing data follows)
+    while (!m_pending.empty())
+    {
+        addToSection(m_pending.front(), result);
+        m_pending.pop_front();
+    }
+    endSection(result);
+
+    reset();
+    return result;
+}
+
+
+void StreamingSaccadeDetector::reset()
+{
+    m_lastIndex = std::numeric_limits<int>::min();
+    m_ignoreUntilIndex = std::numeric_limits<int>::min();
+    m_pending.clear();
+    m_ringBuffer = std::vector<Sample>(m_windowSize);
+    m_sectionSize = 0;
+    m_processedRows = 0;
+    m_velocityX.clear();
+    m_velocityY.clear();
+    m_rowsSinceUpdate = 0;
+    m_msd = QPair<qreal, qreal>(0, 0);
+    m_thresholdValid = false;
+    m_run.clear();
+    m_skipRun = false;
+}
+
+
+std::vector<Saccade> StreamingSaccadeDetector::replay(Trial* trial, GazeType gazeType,
+                                                      const SaccadeFilterSettings& settings,
+                                                      int thresholdWindow)
+{
+    StreamingSaccadeDetector detector(settings, trial->frequencyRate(),
+                                      trial->getParticipant()->getPixelsPerDegree(),
+                                      thresholdWindow);
+
+    std::vector<Saccade> microsaccades;
+
+    QMapIterator<int, GazeData> it(trial->gazeData(gazeType));
+    while (it.hasNext())
+    {
+        it.next();
+        std::vector<Saccade> s = detector.addSample(it.key(), it.value());
+        microsaccades.insert(microsaccades.end(), s.begin(), s.end());
+    }
+
+    std::vector<Saccade> s = detector.finish();
+    microsaccades.insert(microsaccades.end(), s.begin(), s.end());
+
+    return microsaccades;
+}
+
+
+StreamingComparison StreamingSaccadeDetector::compareWithBatch(Trial* trial, GazeType gazeType,
+                                                               const SaccadeFilterSettings& settings,
+                                                               int thresholdWindow)
+{
+    std::vector<Saccade> streamed = replay(trial, gazeType, settings, thresholdWindow);
+
+    // the streaming detector always uses the Engbert-Kliegl threshold on the unfiltered samples
+    // and does not interpolate gaps; the batch detection is restricted to the same method
+    SaccadeFilterSettings batchSettings(settings);
+    batchSettings.m_algorithm = DA_EngbertKliegl;
+    batchSettings.m_preFilter = PFT_None;
+    batchSettings.m_gapInterpolation = GIT_None;
+    SaccadeDetector detector;
+    std::vector<Saccade> batch = detector.determineMicrosaccadeCandidates(trial, gazeType,
+                                                                          &batchSettings);
+    detector.removeInvalidSaccades(batch, &batchSettings, trial);
+
+    StreamingComparison comparison;
+    comparison.m_streamedCount = streamed.size();
+    comparison.m_batchCount = batch.size();
+
+    // both lists are temporally ordered: one to one matching of overlapping microsaccades
+    size_t i = 0;
+    size_t j = 0;
+    while (i < streamed.size() && j < batch.size())
+    {
+        if (streamed[i].getEndIndex() < batch[j].getOnsetIndex())
+        {
+            ++i;
+        }
+        else if (batch[j].getEndIndex() < streamed[i].getOnsetIndex())
+        {
+            ++j;
+        }
+        else
+        {
+            comparison.m_matchedCount++;
+            ++i;
+            ++j;
+        }
+    }
+
+    return comparison;
+}
+
+
+void StreamingSaccadeDetector::addToSection(const Sample& sample, std::vector<Saccade>& result)
+{
+    m_ringBuffer[m_sectionSize % m_windowSize] = sample;
+    m_sectionSize++;
+
+    // velocities are only determined for sections with at least windowSize samples; afterwards
+    // each row can be processed as soon as the following halfWindow samples are available
+    while (m_sectionSize >= m_windowSize && m_processedRows + m_halfWindow < m_sectionSize)
+    {
+        processRow(m_processedRows, false, result);
+        m_processedRows++;
+    }
+}
+
+
+void StreamingSaccadeDetector::endSection(std::vector<Saccade>& result)
+{
+    // no velocities are determined for sections shorter than the velocity window; their rows
+    // neither contribute to the threshold estimation nor to microsaccades
+    while (m_sectionSize >= m_windowSize && m_processedRows < m_sectionSize)
+    {
+        processRow(m_processedRows, true, result);
+        m_processedRows++;
+    }
+    endRun(result);
+    m_skipRun = false;
+
+    m_sectionSize = 0;
+    m_processedRows = 0;
+}
+
+
+void StreamingSaccadeDetector::processRow(size_t row, bool sectionComplete,
+                                          std::vector<Saccade>& result)
+{
+    Sample& sample = m_ringBuffer[row % m_windowSize];
+
+    // velocity, see SaccadeDetector::determineVelocity
+    int size = int(m_halfWindow);
+    int N = int(m_sectionSize);
+    int j = int(row);
+    qreal v[2] = {0, 0};
+    if (m_sectionSize >= m_windowSize)
+    {
+        for (size_t i = 0; i < 2; ++i)
+        {
+            if (j >= size && j < N - size)
+            {
+                qreal windowValue = 0;
+                for (int k = -size; k <= size; ++k)
+                {
+                    if (k == 0)
+                    {
+                        continue;
+                    }
+                    const Sample& s = m_ringBuffer[size_t(j + k) % m_windowSize];
+                    windowValue += (k < 0 ? -1 : 1) * (i == 0 ? s.m_x : s.m_y);
+                }
+                v[i] = m_frequency / 6.0 * windowValue;
+            }
+            else if (size > 1 && (j == 1 || (sectionComplete && j == N - 2)))
+            {
+                // values for which not enough data samples are available
+                qreal windowValue = 0;
+                for (int k = 0; k <= size; ++k)
+                {
+                    if (size % 2 == 0 && k % 2 != 0)
+                    {
+                        continue;
+                    }
+                    if (j == 1)
+                    {
+                        const Sample& s = m_ringBuffer[size_t(k) % m_windowSize];
+                        windowValue += (k > size / 2 ? 1 : -1) * (i == 0 ? s.m_x : s.m_y);
+                    }
+                    else
+                    {
+                        const Sample& s = m_ringBuffer[size_t(N - k - 1) % m_windowSize];
+                        windowValue += (k > size / 2 ? -1 : 1) * (i == 0 ? s.m_x : s.m_y);
+                    }
+                }
+                v[i] = m_frequency / qreal(size) * windowValue;
+            }
+        }
+    }
+    sample.m_vx = v[0];
+    sample.m_vy = v[1];
+
+    // threshold estimation on the most recent velocity values
+    m_velocityX.push_back(sample.m_vx);
+    m_velocityY.push_back(sample.m_vy);
+    if (m_velocityX.size() > m_thresholdWindow)
+    {
+        m_velocityX.pop_front();
+        m_velocityY.pop_front();
+    }
+    m_rowsSinceUpdate++;
+
+    // the threshold is not changed within a microsaccade; it is updated every 1% of the window
+    if (m_run.empty() && m_velocityX.size() >= m_warmUp &&
+            (!m_thresholdValid || m_rowsSinceUpdate >= std::max(size_t(1), m_thresholdWindow / 100)))
+    {
+        updateThreshold();
+    }
+
+    bool aboveThreshold = false;
+    if (m_thresholdValid)
+    {
+        // elliptic threshold
+        qreal radiusX = m_settings.m_velocityThreshold * m_msd.first;
+        qreal radiusY = m_settings.m_velocityThreshold * m_msd.second;
+        qreal testX = sample.m_vx / radiusX;
+        qreal testY = sample.m_vy / radiusY;
+        aboveThreshold = testX * testX + testY * testY > 1;
+    }
+
+    if (aboveThreshold)
+    {
+        if (!m_skipRun)
+        {
+            m_run.push_back(sample);
+        }
+
+        // runs longer than the maximum duration are rejected immediately (as in the batch
+        // detection); the remaining samples above the threshold are skipped
+        if (m_settings.m_useMaxDuration && m_run.size() > m_maxDuration)
+        {
+            m_run.clear();
+            m_skipRun = true;
+        }
+        // without maximum duration, runs are only limited by the threshold window so that
+        // neither the run nor the latency grows without limit (e.g., noisy data with a low
+        // threshold estimate); such a run is reported with its first samples
+        else if (m_run.size() >= m_maxRunSize)
+        {
+            endRun(result);
+            m_skipRun = true;
+        }
+    }
+    else
+    {
+        endRun(result);
+        m_skipRun = false;
+    }
+}
+
+
+void StreamingSaccadeDetector::endRun(std::vector<Saccade>& result)
+{
+    if (m_run.empty())
+    {
+        return;
+    }
+
+    if (m_run.size() >= m_minDuration)
+    {
+        std::vector<qreal> xValues;
+        std::vector<qreal> yValues;
+        std::vector<int> indices;
+        GazeVelocity v;
+        for (size_t i = 0; i < m_run.size(); ++i)
+        {
+            xValues.push_back(m_run[i].m_x);
+            yValues.push_back(m_run[i].m_y);
+            indices.push_back(m_run[i].m_index);
+            v.m_x.push_back(m_run[i].m_vx);
+            v.m_y.push_back(m_run[i].m_vy);
+        }
+
+        GazeSection x;
+        x.m_x = xValues.data();
+        x.m_y = yValues.data();
+        x.m_index = indices.data();
+        x.m_size = m_run.size();
+
+        // peak velocity and amplitudes like in the batch detection; with the threshold used
+        // for the whole run, the run is one candidate
+        SaccadeDetector detector;
+        QPair<qreal, qreal> newRadius;
+        std::vector<Saccade> candidates = detector.determineSaccadeCandidates(
+                    x, v, m_msd, m_settings.m_velocityThreshold, m_minDuration, newRadius);
+
+        for (size_t i = 0; i < candidates.size(); ++i)
+        {
+            if (detector.isValidSaccade(candidates[i], &m_settings, m_maxDuration))
+            {
+                result.push_back(candidates[i]);
+            }
+        }
+    }
+
+    m_run.clear();
+}
+
+
+void StreamingSaccadeDetector::updateThreshold()
+{
+    GazeVelocity v;
+    v.m_x.assign(m_velocityX.begin(), m_velocityX.end());
+    v.m_y.assign(m_velocityY.begin(), m_velocityY.end());
+
+    SaccadeDetector detector;
+    m_thresholdValid = detector.velocityStatistics(v, m_msd);
+    m_rowsSinceUpdate = 0;
+}
+
+
+size_t StreamingSaccadeDetector::timeToSamples(qreal time) const
+{
+    return size_t(ceil(time / 1000.0 * m_frequency)); //round to upper
+}
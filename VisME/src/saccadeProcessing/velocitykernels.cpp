@@ -0,0 +1,42 @@
+/***********************************************************************************************//**
+ * @author Tanja Munz
+ * @file velocitykernels.cpp
+ **************************************************************************************************/
+#include "velocitykernels.h"
+
+
+void VelocityKernels::genericKernel(const qreal* x, qreal* v, int N, int size, qreal factor)
+{
+    for (int j = size; j < N - size; ++j)
+    {
+        qreal windowValue = 0;
+        for (int k = -size; k <= size; ++k)
+        {
+            if (k == 0)
+            {
+                continue;
+            }
+            windowValue += (k < 0 ? -1 : 1) * x[j + k];
+        }
+        v[j] = factor * windowValue;
+    }
+}
+
+
+VelocityKernels::Kernel VelocityKernels::kernel(size_t windowSize)
+{
+    // index: half window size
+    static const Kernel kernels[] = {genericKernel,
+                                     windowKernel<1>,
+                                     windowKernel<2>,
+                                     windowKernel<3>,
+                                     windowKernel<4>,
+                                     windowKernel<5>};
+
+    size_t size = (windowSize - 1) / 2;
+    if (windowSize % 2 == 0 || size >= sizeof(kernels) / sizeof(kernels[0]))
+    {
+        return genericKernel;
+    }
+    return kernels[size];
+}
@@ -4,16 +4,21 @@
  **************************************************************************************************/
 #define _USE_MATH_DEFINES
 #include "colorgenerator.h"
+#include "eventlockedrateexport.h"
 #include "eyedirectionhistogram.h"
 #include "eyegazeplot.h"
 #include "eyehistogram.h"
 #include "eyehistogram.h"
 #include "eyescatterplot.h"
+#include "gapinterpolation.h"
 #include "itemdelegate.h"
 #include "mainwindow.h"
+#include "parametersweepexport.h"
 #include "polarplot.h"
+#include "prefilter.h"
 #include "radialscatterplot.h"
 #include "roseplot.h"
+#include "saccadedetectionalgorithm.h"
 #include "statisticsexport.h"
 #include "timelineview.h"
 #include "userinterface.h"
@@ -50,6 +55,10 @@ UserInterface::UserInterface(MainWindow* mainWindow, Settings* settings,
     m_dataExport = new EyeDataExport(m_window, m_window->m_eyeTrackingData, m_settings);
     m_settingsExport = new SettingsExport(m_window, m_settings);
     m_statisticsExport = new StatisticsExport(m_window, m_window->m_eyeTrackingData, m_settings);
+    m_parameterSweepExport = new ParameterSweepExport(m_window, m_window->m_eyeTrackingData,
+                                                      m_settings);
+    m_eventLockedRateExport = new EventLockedRateExport(m_window, m_window->m_eyeTrackingData,
+                                                        m_settings);
 
     // the main window contains two main views
     QSplitter* splitter = new QSplitter(Qt::Vertical);
@@ -124,6 +133,24 @@ void UserInterface::createMenu()
     QObject::connect(openTestConditionsFileAction, &QAction::triggered,
                      m_window, &MainWindow::openCSV);
 
+    QAction* openSessionAction = new QAction(tr("Open &Session"), m_window);
+    openSessionAction->setStatusTip(
+                tr("Open a study session with participants, test conditions and detection "
+                   "results."));
+    fileMenu->addAction(openSessionAction);
+    QObject::connect(openSessionAction, &QAction::triggered,
+                     m_window, &MainWindow::loadSession);
+
+    QAction* saveSessionAction = new QAction(tr("Sa&ve Session"), m_window);
+    saveSessionAction->setShortcut(tr("Ctrl+S"));
+    saveSessionAction->setStatusTip(
+                tr("Save participants, test conditions and detection results with their "
+                   "settings as study session."));
+    fileMenu->addAction(saveSessionAction);
+    QObject::connect(saveSessionAction, &QAction::triggered,
+                     m_dataExport, &EyeDataExport::exportSession);
+    m_trialDataActions.append(saveSessionAction);
+
     QAction* loadMSAction = new QAction(tr("&Load Microsaccades Parameters"), m_window);
     loadMSAction->setStatusTip(tr("Load microsaccades parameter settings files."));
     fileMenu->addAction(loadMSAction);
@@ -163,6 +190,7 @@ void UserInterface::createMenu()
     exportDataMenu->addAction(exportData2);
     QObject::connect(exportData2, &QAction::triggered,
                      m_dataExport, &EyeDataExport::exportCurrentParticipantDataToFile);
+    m_trialDataActions.append(exportData2);
 
     QAction* exportData3 = new
             QAction(tr("Data for all Participants"), m_window);
@@ -172,6 +200,27 @@ void UserInterface::createMenu()
     exportDataMenu->addAction(exportData3);
     QObject::connect(exportData3, &QAction::triggered,
                      m_dataExport, &EyeDataExport::exportAllParticipantDataToFile);
+    m_trialDataActions.append(exportData3);
+
+    QAction* exportData10 = new
+            QAction(tr("Data for all Participants (Arrow)"), m_window);
+    exportData10->setStatusTip(
+                tr("Export fixations, microsaccades and saccades for all participants as Apache "
+                   "Arrow files."));
+    exportDataMenu->addAction(exportData10);
+    QObject::connect(exportData10, &QAction::triggered,
+                     m_dataExport, &EyeDataExport::exportAllParticipantDataToArrow);
+    m_trialDataActions.append(exportData10);
+
+    QAction* exportData11 = new
+            QAction(tr("Data with Samples for all Participants (Arrow)"), m_window);
+    exportData11->setStatusTip(
+                tr("Export fixations, microsaccades, saccades and gaze data for all participants "
+                   "as Apache Arrow files."));
+    exportDataMenu->addAction(exportData11);
+    QObject::connect(exportData11, &QAction::triggered,
+                     m_dataExport, &EyeDataExport::exportAllParticipantDataWithSamplesToArrow);
+    m_trialDataActions.append(exportData11);
 
     // -- export data 2 ----------------------------------------------------------------------------
 
@@ -184,6 +233,7 @@ void UserInterface::createMenu()
     exportDataMenu->addAction(exportData7);
     QObject::connect(exportData7, &QAction::triggered,
                      m_statisticsExport, &StatisticsExport::exportDataToFile);
+    m_trialDataActions.append(exportData7);
 
     QAction* exportData8 = new
             QAction(tr("Aggregated Directional Data"), m_window);
@@ -192,6 +242,17 @@ void UserInterface::createMenu()
     exportDataMenu->addAction(exportData8);
     QObject::connect(exportData8, &QAction::triggered,
                      m_statisticsExport, &StatisticsExport::exportDirectionalDataToFile);
+    m_trialDataActions.append(exportData8);
+
+    QAction* exportData9 = new
+            QAction(tr("Microsaccade Parameter Sweep"), m_window);
+    exportData9->setStatusTip(
+                tr("Export microsaccade statistics for combinations of velocity thresholds and "
+                   "minimum durations."));
+    exportDataMenu->addAction(exportData9);
+    QObject::connect(exportData9, &QAction::triggered,
+                     m_parameterSweepExport, &ParameterSweepExport::exportParameterSweep);
+    m_trialDataActions.append(exportData9);
 
     // -- export data 3 ----------------------------------------------------------------------------
 
@@ -350,6 +411,16 @@ void UserInterface::createMenu()
 
     zoomMenu->addSeparator();
 
+    // -- event-locked microsaccade rate -----------------------------------------------------------
+    QAction* eventLockedRateAction = new QAction(tr("&Event-Locked Microsaccade Rate"), m_window);
+    eventLockedRateAction->setStatusTip(
+                tr("Show and export microsaccade rates aligned to events for all participants/"
+                   "test conditions."));
+    m_viewMenu->addAction(eventLockedRateAction);
+    QObject::connect(eventLockedRateAction, &QAction::triggered,
+                     m_eventLockedRateExport, &EventLockedRateExport::showEventLockedRate);
+    m_trialDataActions.append(eventLockedRateAction);
+
     m_viewMenu->addSeparator();
 
     // info ****************************************************************************************
@@ -517,7 +588,7 @@ void UserInterface::createGeneralInformationDock()
     QLabel* headerLabelMin = new QLabel(tr("Min"), m_window);
     QLabel* headerLabelMax = new QLabel(tr("Max"), m_window);
     QLabel* headerLabelMean = new QLabel(tr("Mean"), m_window);
-    QLabel* headerLabelMedian = new QLabel(tr("Median"), m_window);
+    m_statisticsMedianHeaderLabel = new QLabel(tr("Median"), m_window);
     QLabel* headerLabelSum = new QLabel(tr("Sum"), m_window);
 
     QLabel* inputSamplesLabel = new QLabel(tr("#Raw Data Samples in Trials: "), m_window);
@@ -649,7 +720,7 @@ void UserInterface::createGeneralInformationDock()
     statisticsLayout->addWidget(headerLabelMin, 1, 1);
     statisticsLayout->addWidget(headerLabelMax, 1, 2);
     statisticsLayout->addWidget(headerLabelMean, 1, 3);
-    statisticsLayout->addWidget(headerLabelMedian, 1, 4);
+    statisticsLayout->addWidget(m_statisticsMedianHeaderLabel, 1, 4);
     statisticsLayout->addWidget(headerLabelSum, 1, 5);
 
     statisticsLayout->addWidget(inputSamplesLabel, 2, 0);
@@ -757,6 +828,16 @@ void UserInterface::createGeneralInformationDock()
     statisticsLayout->addWidget(m_microsaccadeVelocityLabelMean, 17, 3);
     statisticsLayout->addWidget(m_microsaccadeVelocityLabelMedian, 17, 4);
 
+    m_approximateMediansCheckBox = new QCheckBox(tr("Approximate Medians"), m_window);
+    m_approximateMediansCheckBox->setToolTip(tr("Estimates the medians with quantile sketches "
+                                                "which are merged for all trials instead of "
+                                                "sorting all values. Medians of up to 200 values "
+                                                "are exact, otherwise the rank error is below "
+                                                "1.3% (99% confidence)."));
+    QObject::connect(m_approximateMediansCheckBox, &QCheckBox::toggled,
+                     m_window, &MainWindow::approximateMedians);
+    statisticsLayout->addWidget(m_approximateMediansCheckBox, 18, 0, 1, 6);
+
     // group box
     QGroupBox* statisticsGroupBox = new QGroupBox(m_window);
     statisticsGroupBox->setLayout(statisticsLayout);
@@ -1442,6 +1523,34 @@ void UserInterface::createMicrosaccadesDetectionDock()
     m_msVelocityThresholdSpinBox->setMinimum(0);
     m_msVelocityThresholdSpinBox->setMaximum(100);
 
+    // detection algorithm
+    QLabel* msDetectionAlgorithmLabel = new QLabel(tr("Detection Algorithm"), m_window);
+    m_msDetectionAlgorithmComboBox = new QComboBox(m_window);
+    m_msDetectionAlgorithmComboBox->addItems(SaccadeDetectionAlgorithm::algorithmNames());
+
+    // pre-filter and its window size
+    QLabel* msPreFilterLabel = new QLabel(tr("Pre-Filter"), m_window);
+    m_msPreFilterComboBox = new QComboBox(m_window);
+    m_msPreFilterComboBox->addItems(PreFilter::filterNames());
+    m_msPreFilterComboBox->setToolTip(tr("Smooth the positions before the velocity computation."));
+    QLabel* msPreFilterWindowSizeLabel =
+            new QLabel(tr("Pre-Filter Window Size [samples]"), m_window);
+    m_msPreFilterWindowSizeSpinBox = new QSpinBox(m_window);
+    m_msPreFilterWindowSizeSpinBox->setMinimum(3);
+    m_msPreFilterWindowSizeSpinBox->setMaximum(99);
+    m_msPreFilterWindowSizeSpinBox->setSingleStep(2);
+
+    // interpolation of short gaps and maximum gap duration [ms]
+    QLabel* msGapInterpolationLabel = new QLabel(tr("Gap Interpolation"), m_window);
+    m_msGapInterpolationComboBox = new QComboBox(m_window);
+    m_msGapInterpolationComboBox->addItems(GapInterpolation::interpolationNames());
+    m_msGapInterpolationComboBox->setToolTip(tr("Fill short gaps of missing data before the "
+                                                "detection."));
+    QLabel* msMaxGapDurationLabel = new QLabel(tr("Maximum Gap Duration [ms]"), m_window);
+    m_msMaxGapDurationSpinBox = new QSpinBox(m_window);
+    m_msMaxGapDurationSpinBox->setMinimum(0);
+    m_msMaxGapDurationSpinBox->setMaximum(1000);
+
     // minimum microsaccade duration [ms]
     QLabel* msMinDurationLabel =
             new QLabel(tr("Minimum Microsaccade Duration [ms]"), m_window);
@@ -1544,47 +1653,58 @@ void UserInterface::createMicrosaccadesDetectionDock()
     microsaccadesDockWidgetLayout->addWidget(m_microsaccadesFromInputFileCheckbox, 0, 0, 1, 2);
     microsaccadesDockWidgetLayout->addWidget(msVelocityThresholdLabel, 1, 0);
     microsaccadesDockWidgetLayout->addWidget(m_msVelocityThresholdSpinBox, 1, 1);
-    microsaccadesDockWidgetLayout->addWidget(msMinDurationLabel, 2, 0);
-    microsaccadesDockWidgetLayout->addWidget(m_msMinDurationSpinBox, 2, 1);
-
-    microsaccadesDockWidgetLayout->addWidget(velocityWindowSizeLabel, 3, 0);
-    microsaccadesDockWidgetLayout->addWidget(m_msVelocityWindowSizeSpinBox, 3, 1);
-
-    microsaccadesDockWidgetLayout->addWidget(m_msBinocularCheckBox, 4, 0);
-
-    microsaccadesDockWidgetLayout->addWidget(m_msMaxDurationCheckBox, 5, 0);
-    microsaccadesDockWidgetLayout->addWidget(m_msMaxDurationSpinBox, 5, 1);
-
-    microsaccadesDockWidgetLayout->addWidget(m_msMinAmplitudeCheckBox, 6, 0);
-    microsaccadesDockWidgetLayout->addWidget(m_msMinAmplitudeSpinBox, 6, 1);
-    microsaccadesDockWidgetLayout->addWidget(m_msMaxAmplitudeCheckBox, 7, 0);
-    microsaccadesDockWidgetLayout->addWidget(m_msMaxAmplitudeSpinBox, 7, 1);
-    microsaccadesDockWidgetLayout->addWidget(m_msMinIntersaccIntervalCheckBox, 8, 0);
-    microsaccadesDockWidgetLayout->addWidget(m_msMinIntersaccIntervalSpinBox, 8, 1);
-
-    microsaccadesDockWidgetLayout->addWidget(m_msMinVelocityCheckBox, 9, 0);
-    microsaccadesDockWidgetLayout->addWidget(m_msMinVelocitySpinBox, 9, 1);
-    microsaccadesDockWidgetLayout->addWidget(m_msMaxVelocityCheckBox, 10, 0);
-    microsaccadesDockWidgetLayout->addWidget(m_msMaxVelocitySpinBox, 10, 1);
-
-    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreAtFixationStartCheckBox, 11, 0);
-    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreAtFixationStartSpinBox, 11, 1);
-    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreAtFixationEndCheckBox, 12, 0);
-    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreAtFixationEndSpinBox, 12, 1);
-
-    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreBeforeMissingDataCheckBox, 13, 0);
-    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreBeforeMissingDataSpinBox, 13, 1);
-    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreAfterMissingDataCheckBox, 14, 0);
-    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreAfterMissingDataSpinBox, 14, 1);
-
-    microsaccadesDockWidgetLayout->addWidget(m_updateMicrosaccadesButton, 15, 0, 1, 2);
-    microsaccadesDockWidgetLayout->addWidget(m_updateCurrentParticipantMicrosaccadesButton, 16, 0, 1, 2);
-    microsaccadesDockWidgetLayout->addWidget(updateAllMicrosaccadesButton, 17, 0, 1, 2);
-    microsaccadesDockWidgetLayout->setRowStretch(18, 1); // add stretch in next line
+    microsaccadesDockWidgetLayout->addWidget(msDetectionAlgorithmLabel, 2, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msDetectionAlgorithmComboBox, 2, 1);
+    microsaccadesDockWidgetLayout->addWidget(msPreFilterLabel, 3, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msPreFilterComboBox, 3, 1);
+    microsaccadesDockWidgetLayout->addWidget(msPreFilterWindowSizeLabel, 4, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msPreFilterWindowSizeSpinBox, 4, 1);
+    microsaccadesDockWidgetLayout->addWidget(msGapInterpolationLabel, 5, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msGapInterpolationComboBox, 5, 1);
+    microsaccadesDockWidgetLayout->addWidget(msMaxGapDurationLabel, 6, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msMaxGapDurationSpinBox, 6, 1);
+    microsaccadesDockWidgetLayout->addWidget(msMinDurationLabel, 7, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msMinDurationSpinBox, 7, 1);
+
+    microsaccadesDockWidgetLayout->addWidget(velocityWindowSizeLabel, 8, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msVelocityWindowSizeSpinBox, 8, 1);
+
+    microsaccadesDockWidgetLayout->addWidget(m_msBinocularCheckBox, 9, 0);
+
+    microsaccadesDockWidgetLayout->addWidget(m_msMaxDurationCheckBox, 10, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msMaxDurationSpinBox, 10, 1);
+
+    microsaccadesDockWidgetLayout->addWidget(m_msMinAmplitudeCheckBox, 11, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msMinAmplitudeSpinBox, 11, 1);
+    microsaccadesDockWidgetLayout->addWidget(m_msMaxAmplitudeCheckBox, 12, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msMaxAmplitudeSpinBox, 12, 1);
+    microsaccadesDockWidgetLayout->addWidget(m_msMinIntersaccIntervalCheckBox, 13, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msMinIntersaccIntervalSpinBox, 13, 1);
+
+    microsaccadesDockWidgetLayout->addWidget(m_msMinVelocityCheckBox, 14, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msMinVelocitySpinBox, 14, 1);
+    microsaccadesDockWidgetLayout->addWidget(m_msMaxVelocityCheckBox, 15, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msMaxVelocitySpinBox, 15, 1);
+
+    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreAtFixationStartCheckBox, 16, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreAtFixationStartSpinBox, 16, 1);
+    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreAtFixationEndCheckBox, 17, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreAtFixationEndSpinBox, 17, 1);
+
+    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreBeforeMissingDataCheckBox, 18, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreBeforeMissingDataSpinBox, 18, 1);
+    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreAfterMissingDataCheckBox, 19, 0);
+    microsaccadesDockWidgetLayout->addWidget(m_msIgnoreAfterMissingDataSpinBox, 19, 1);
+
+    microsaccadesDockWidgetLayout->addWidget(m_updateMicrosaccadesButton, 20, 0, 1, 2);
+    microsaccadesDockWidgetLayout->addWidget(m_updateCurrentParticipantMicrosaccadesButton, 21, 0, 1, 2);
+    microsaccadesDockWidgetLayout->addWidget(updateAllMicrosaccadesButton, 22, 0, 1, 2);
+    microsaccadesDockWidgetLayout->setRowStretch(23, 1); // add stretch in next line
 
     // dock
     QWidget* microsaccadesWidget = new QWidget();
     microsaccadesWidget->setLayout(microsaccadesDockWidgetLayout);
+    cancelDetectionOnChange(microsaccadesWidget);
 
     scrollArea->setWidget(microsaccadesWidget);
     scrollArea->setWidgetResizable(true);
@@ -1611,6 +1731,34 @@ void UserInterface::createFixationsDetectionDock()
     m_fixVelocityThresholdSpinBox->setMinimum(0);
     m_fixVelocityThresholdSpinBox->setMaximum(100);
 
+    // detection algorithm
+    QLabel* fixDetectionAlgorithmLabel = new QLabel(tr("Detection Algorithm"), m_window);
+    m_fixDetectionAlgorithmComboBox = new QComboBox(m_window);
+    m_fixDetectionAlgorithmComboBox->addItems(SaccadeDetectionAlgorithm::algorithmNames());
+
+    // pre-filter and its window size
+    QLabel* fixPreFilterLabel = new QLabel(tr("Pre-Filter"), m_window);
+    m_fixPreFilterComboBox = new QComboBox(m_window);
+    m_fixPreFilterComboBox->addItems(PreFilter::filterNames());
+    m_fixPreFilterComboBox->setToolTip(tr("Smooth the positions before the velocity computation."));
+    QLabel* fixPreFilterWindowSizeLabel =
+            new QLabel(tr("Pre-Filter Window Size [samples]"), m_window);
+    m_fixPreFilterWindowSizeSpinBox = new QSpinBox(m_window);
+    m_fixPreFilterWindowSizeSpinBox->setMinimum(3);
+    m_fixPreFilterWindowSizeSpinBox->setMaximum(99);
+    m_fixPreFilterWindowSizeSpinBox->setSingleStep(2);
+
+    // interpolation of short gaps and maximum gap duration [ms]
+    QLabel* fixGapInterpolationLabel = new QLabel(tr("Gap Interpolation"), m_window);
+    m_fixGapInterpolationComboBox = new QComboBox(m_window);
+    m_fixGapInterpolationComboBox->addItems(GapInterpolation::interpolationNames());
+    m_fixGapInterpolationComboBox->setToolTip(tr("Fill short gaps of missing data before the "
+                                                "detection."));
+    QLabel* fixMaxGapDurationLabel = new QLabel(tr("Maximum Gap Duration [ms]"), m_window);
+    m_fixMaxGapDurationSpinBox = new QSpinBox(m_window);
+    m_fixMaxGapDurationSpinBox->setMinimum(0);
+    m_fixMaxGapDurationSpinBox->setMaximum(1000);
+
     // minimum saccade duration [ms]
     QLabel* minSaccadeDurationLabel =
             new QLabel(tr("Minimum Saccade Duration [ms]"), m_window);
@@ -1710,47 +1858,58 @@ void UserInterface::createFixationsDetectionDock()
     fixationsDockWidgetLayout->addWidget(m_fixationsFromInputFileCheckbox, 0, 0, 1, 2);
     fixationsDockWidgetLayout->addWidget(velocityThresholdLabel, 1, 0);
     fixationsDockWidgetLayout->addWidget(m_fixVelocityThresholdSpinBox, 1, 1);
-    fixationsDockWidgetLayout->addWidget(minSaccadeDurationLabel, 2, 0);
-    fixationsDockWidgetLayout->addWidget(m_fixMinSaccadeDurationSpinBox, 2, 1);
-
-    fixationsDockWidgetLayout->addWidget(velocityWindowSizeLabel, 3, 0);
-    fixationsDockWidgetLayout->addWidget(m_fixVelocityWindowSizeSpinBox, 3, 1);
-
-    fixationsDockWidgetLayout->addWidget(m_fixBinocularCheckBox, 4, 0);
-
-    fixationsDockWidgetLayout->addWidget(m_fixMaxDurationCheckBox, 5, 0);
-    fixationsDockWidgetLayout->addWidget(m_fixMaxDurationSpinBox, 5, 1);
-
-    fixationsDockWidgetLayout->addWidget(m_fixMinAmplitudeCheckBox, 6, 0);
-    fixationsDockWidgetLayout->addWidget(m_fixMinSaccadeAmplitudeSpinBox, 6, 1);
-    fixationsDockWidgetLayout->addWidget(m_fixMaxAmplitudeCheckBox, 7, 0);
-    fixationsDockWidgetLayout->addWidget(m_fixMaxSaccadeAmplitudeSpinBox, 7, 1);
-    fixationsDockWidgetLayout->addWidget(m_fixMinIntersaccIntervalCheckBox, 8, 0);
-    fixationsDockWidgetLayout->addWidget(m_fixMinSaccadeIntersaccIntervalSpinBox, 8, 1);
-
-    fixationsDockWidgetLayout->addWidget(m_fixMinVelocityCheckBox, 9, 0);
-    fixationsDockWidgetLayout->addWidget(m_fixMinVelocitySpinBox, 9, 1);
-    fixationsDockWidgetLayout->addWidget(m_fixMaxVelocityCheckBox, 10, 0);
-    fixationsDockWidgetLayout->addWidget(m_fixMaxVelocitySpinBox, 10, 1);
-
-    fixationsDockWidgetLayout->addWidget(m_fixIgnoreAtFixationStartCheckBox, 11, 0);
-    fixationsDockWidgetLayout->addWidget(m_fixIgnoreAtStartSpinBox, 11, 1);
-    fixationsDockWidgetLayout->addWidget(m_fixIgnoreAtFixationEndCheckBox, 12, 0);
-    fixationsDockWidgetLayout->addWidget(m_fixIgnoreAtEndSpinBox, 12, 1);
-
-    fixationsDockWidgetLayout->addWidget(m_fixIgnoreBeforeMissingDataCheckBox, 13, 0);
-    fixationsDockWidgetLayout->addWidget(m_fixIgnoreBeforeMissingDataSpinBox, 13, 1);
-    fixationsDockWidgetLayout->addWidget(m_fixIgnoreAfterMissingDataCheckBox, 14, 0);
-    fixationsDockWidgetLayout->addWidget(m_fixIgnoreAfterMissingDataSpinBox, 14, 1);
-
-    fixationsDockWidgetLayout->addWidget(m_updateFixationsButton, 15, 0, 1, 2);
-    fixationsDockWidgetLayout->addWidget(m_updateFixationsForParticipantButton, 16, 0, 1, 2);
-    fixationsDockWidgetLayout->addWidget(updateAllFixationsButton, 17, 0, 1, 2);
-    fixationsDockWidgetLayout->setRowStretch(18, 1); // add stretch in next line
+    fixationsDockWidgetLayout->addWidget(fixDetectionAlgorithmLabel, 2, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixDetectionAlgorithmComboBox, 2, 1);
+    fixationsDockWidgetLayout->addWidget(fixPreFilterLabel, 3, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixPreFilterComboBox, 3, 1);
+    fixationsDockWidgetLayout->addWidget(fixPreFilterWindowSizeLabel, 4, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixPreFilterWindowSizeSpinBox, 4, 1);
+    fixationsDockWidgetLayout->addWidget(fixGapInterpolationLabel, 5, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixGapInterpolationComboBox, 5, 1);
+    fixationsDockWidgetLayout->addWidget(fixMaxGapDurationLabel, 6, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixMaxGapDurationSpinBox, 6, 1);
+    fixationsDockWidgetLayout->addWidget(minSaccadeDurationLabel, 7, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixMinSaccadeDurationSpinBox, 7, 1);
+
+    fixationsDockWidgetLayout->addWidget(velocityWindowSizeLabel, 8, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixVelocityWindowSizeSpinBox, 8, 1);
+
+    fixationsDockWidgetLayout->addWidget(m_fixBinocularCheckBox, 9, 0);
+
+    fixationsDockWidgetLayout->addWidget(m_fixMaxDurationCheckBox, 10, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixMaxDurationSpinBox, 10, 1);
+
+    fixationsDockWidgetLayout->addWidget(m_fixMinAmplitudeCheckBox, 11, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixMinSaccadeAmplitudeSpinBox, 11, 1);
+    fixationsDockWidgetLayout->addWidget(m_fixMaxAmplitudeCheckBox, 12, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixMaxSaccadeAmplitudeSpinBox, 12, 1);
+    fixationsDockWidgetLayout->addWidget(m_fixMinIntersaccIntervalCheckBox, 13, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixMinSaccadeIntersaccIntervalSpinBox, 13, 1);
+
+    fixationsDockWidgetLayout->addWidget(m_fixMinVelocityCheckBox, 14, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixMinVelocitySpinBox, 14, 1);
+    fixationsDockWidgetLayout->addWidget(m_fixMaxVelocityCheckBox, 15, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixMaxVelocitySpinBox, 15, 1);
+
+    fixationsDockWidgetLayout->addWidget(m_fixIgnoreAtFixationStartCheckBox, 16, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixIgnoreAtStartSpinBox, 16, 1);
+    fixationsDockWidgetLayout->addWidget(m_fixIgnoreAtFixationEndCheckBox, 17, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixIgnoreAtEndSpinBox, 17, 1);
+
+    fixationsDockWidgetLayout->addWidget(m_fixIgnoreBeforeMissingDataCheckBox, 18, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixIgnoreBeforeMissingDataSpinBox, 18, 1);
+    fixationsDockWidgetLayout->addWidget(m_fixIgnoreAfterMissingDataCheckBox, 19, 0);
+    fixationsDockWidgetLayout->addWidget(m_fixIgnoreAfterMissingDataSpinBox, 19, 1);
+
+    fixationsDockWidgetLayout->addWidget(m_updateFixationsButton, 20, 0, 1, 2);
+    fixationsDockWidgetLayout->addWidget(m_updateFixationsForParticipantButton, 21, 0, 1, 2);
+    fixationsDockWidgetLayout->addWidget(updateAllFixationsButton, 22, 0, 1, 2);
+    fixationsDockWidgetLayout->setRowStretch(23, 1); // add stretch in next line
 
     // dock
     QWidget* fixationsWidget = new QWidget;
     fixationsWidget->setLayout(fixationsDockWidgetLayout);
+    cancelDetectionOnChange(fixationsWidget);
 
     scrollArea->setWidget(fixationsWidget);
     scrollArea->setWidgetResizable(true);
@@ -1814,7 +1973,7 @@ void UserInterface::createColorDock()
     colorDescription.push_back("Microsaccades Color"); // microsaccadesColor
     colorDescription.push_back("Microsaccades Direction End Color"); // microsaccadesDirEndColor
 
-    colorDescription.push_back("Missing Data in Stimulus View and Timeline"); // missingDataColor
+    colorDescription.push_back("Missing/Interpolated Data in Stimulus View and Timeline"); // missingDataColor
 
     colorDescription.push_back("Scene Border in Stimulus View"); // sceneBorder
 
@@ -2236,6 +2395,8 @@ void UserInterface::updateValuesFromSettings()
 
     m_showScanpathCheckBox->setChecked(m_settings->m_showScanpath);
 
+    m_approximateMediansCheckBox->setChecked(m_settings->m_approximateQuantiles);
+
     m_showMicrosaccadesCheckbox->setChecked(m_settings->m_showMicrosaccades);
 
     m_showSamplesCheckbox->setChecked(m_settings->m_showSamples);
@@ -2268,6 +2429,11 @@ void UserInterface::updateValuesFromSettings()
     // ** microsaccade detection **
     m_microsaccadesFromInputFileCheckbox->setChecked(m_settings->m_microsaccadeSettings->m_fromInputFile);
     m_msVelocityThresholdSpinBox->setValue(m_settings->m_microsaccadeSettings->m_velocityThreshold);
+    m_msDetectionAlgorithmComboBox->setCurrentIndex(m_settings->m_microsaccadeSettings->m_algorithm);
+    m_msPreFilterComboBox->setCurrentIndex(m_settings->m_microsaccadeSettings->m_preFilter);
+    m_msPreFilterWindowSizeSpinBox->setValue(int(m_settings->m_microsaccadeSettings->m_preFilterWindowSize));
+    m_msGapInterpolationComboBox->setCurrentIndex(m_settings->m_microsaccadeSettings->m_gapInterpolation);
+    m_msMaxGapDurationSpinBox->setValue(m_settings->m_microsaccadeSettings->m_maxGapDuration);
     m_msMinDurationSpinBox->setValue(m_settings->m_microsaccadeSettings->m_minDuration);
     m_msVelocityWindowSizeSpinBox->setValue(int(m_settings->m_microsaccadeSettings->m_velocityWindowSize));
     m_msIgnoreBeforeMissingDataSpinBox->setValue(int(m_settings->m_microsaccadeSettings->m_ignoreBeforeMissingData));
@@ -2326,6 +2492,11 @@ void UserInterface::updateValuesFromSettings()
     // ** fixations detection **
     m_fixationsFromInputFileCheckbox->setChecked(m_settings->m_fixationSettings->m_fromInputFile);
     m_fixVelocityThresholdSpinBox->setValue(m_settings->m_fixationSettings->m_velocityThreshold);
+    m_fixDetectionAlgorithmComboBox->setCurrentIndex(m_settings->m_fixationSettings->m_algorithm);
+    m_fixPreFilterComboBox->setCurrentIndex(m_settings->m_fixationSettings->m_preFilter);
+    m_fixPreFilterWindowSizeSpinBox->setValue(int(m_settings->m_fixationSettings->m_preFilterWindowSize));
+    m_fixGapInterpolationComboBox->setCurrentIndex(m_settings->m_fixationSettings->m_gapInterpolation);
+    m_fixMaxGapDurationSpinBox->setValue(m_settings->m_fixationSettings->m_maxGapDuration);
     m_fixMinSaccadeDurationSpinBox->setValue(m_settings->m_fixationSettings->m_minDuration);
     m_fixBinocularCheckBox->setChecked(m_settings->m_fixationSettings->m_binocular);
     m_fixVelocityWindowSizeSpinBox->setValue(int(m_settings->m_fixationSettings->m_velocityWindowSize));
@@ -2367,6 +2538,11 @@ void UserInterface::updateMicrosaccadeSettings(Trial& trial)
         SaccadeFilterSettings* settings = trial.getMsFilterSettings();
         m_microsaccadesFromInputFileCheckbox->setChecked(settings->m_fromInputFile);
         m_msVelocityThresholdSpinBox->setValue(settings->m_velocityThreshold);
+        m_msDetectionAlgorithmComboBox->setCurrentIndex(settings->m_algorithm);
+        m_msPreFilterComboBox->setCurrentIndex(settings->m_preFilter);
+        m_msPreFilterWindowSizeSpinBox->setValue(int(settings->m_preFilterWindowSize));
+        m_msGapInterpolationComboBox->setCurrentIndex(settings->m_gapInterpolation);
+        m_msMaxGapDurationSpinBox->setValue(settings->m_maxGapDuration);
         m_msMinDurationSpinBox->setValue(settings->m_minDuration);
         m_msBinocularCheckBox->setChecked(settings->m_binocular);
         m_msVelocityWindowSizeSpinBox->setValue(int(settings->m_velocityWindowSize));
@@ -2407,6 +2583,11 @@ void UserInterface::updateFixationsSettings(Trial& trial)
        SaccadeFilterSettings* settings = trial.getFixationFilterSettings();
        m_fixationsFromInputFileCheckbox->setChecked(settings->m_fromInputFile);
        m_fixVelocityThresholdSpinBox->setValue(settings->m_velocityThreshold);
+       m_fixDetectionAlgorithmComboBox->setCurrentIndex(settings->m_algorithm);
+       m_fixPreFilterComboBox->setCurrentIndex(settings->m_preFilter);
+       m_fixPreFilterWindowSizeSpinBox->setValue(int(settings->m_preFilterWindowSize));
+       m_fixGapInterpolationComboBox->setCurrentIndex(settings->m_gapInterpolation);
+       m_fixMaxGapDurationSpinBox->setValue(settings->m_maxGapDuration);
        m_fixMinSaccadeDurationSpinBox->setValue(settings->m_minDuration);
        m_fixBinocularCheckBox->setChecked(settings->m_binocular);
        m_fixVelocityWindowSizeSpinBox->setValue(int(settings->m_velocityWindowSize));
@@ -2576,6 +2757,51 @@ void UserInterface::setTestConditionsInUI(std::set<QString> testConditions)
 }
 
 
+void UserInterface::setDetectionRunning(bool running)
+{
+    foreach (QAction* action, m_trialDataActions)
+    {
+        action->setEnabled(!running);
+    }
+
+    if (running)
+    {
+        m_window->statusBar()->showMessage(tr("Detection running..."));
+    }
+    else
+    {
+        m_window->statusBar()->clearMessage();
+    }
+}
+
+
+void UserInterface::cancelDetectionOnChange(QWidget* widget)
+{
+    // a detection job uses the settings of its start, changed settings are used by the next one
+    foreach (QSpinBox* spinBox, widget->findChildren<QSpinBox*>())
+    {
+        QObject::connect(spinBox, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged),
+                         m_window, &MainWindow::cancelDetectionJob);
+    }
+    foreach (QDoubleSpinBox* spinBox, widget->findChildren<QDoubleSpinBox*>())
+    {
+        QObject::connect(spinBox,
+                         static_cast<void(QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged),
+                         m_window, &MainWindow::cancelDetectionJob);
+    }
+    foreach (QCheckBox* checkBox, widget->findChildren<QCheckBox*>())
+    {
+        QObject::connect(checkBox, &QCheckBox::toggled, m_window, &MainWindow::cancelDetectionJob);
+    }
+    foreach (QComboBox* comboBox, widget->findChildren<QComboBox*>())
+    {
+        QObject::connect(comboBox,
+                         static_cast<void (QComboBox::*)(int index)>(&QComboBox::currentIndexChanged),
+                         m_window, &MainWindow::cancelDetectionJob);
+    }
+}
+
+
 void UserInterface::updateHistogramOptions()
 {
     if (m_settings->m_histogramYAxis == MSStart)
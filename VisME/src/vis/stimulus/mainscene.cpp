@@ -86,12 +86,13 @@ void MainScene::drawForeground(QPainter* painter, const QRectF& rect)
                 if (fixEnd >= 0 && fixStart >= 0 &&
                         trial->fixationsCount() > fixEnd && trial->fixationsCount() > fixStart)
                 {
+                    TimeLimit limit = trial->timeLimit();
                     for (int i = fixStart; i <= fixEnd; ++i)
                     {
                         int start = trial->getFixationAt(i)->getStartIndex() + 1;
                         int end = trial->getFixationAt(i)->getEndIndex();
 
-                        if (trial->outsideTimeLimitIfActivated(start, end))
+                        if (limit.outside(start, end))
                         {
                             continue;
                         }
@@ -250,14 +251,11 @@ void MainScene::drawBackground(QPainter* painter, const QRectF& rect)
 
             if (m_settings->m_showSamples)
             {
-                QMapIterator<int, GazeData> it(trial->gazeData());
-                while (it.hasNext())
+                const QMap<int, GazeData> g = trial->gazeData();
+                TimeLimit limit = trial->timeLimit();
+                for (QMap<int, GazeData>::const_iterator it = limit.begin(g); it != limit.end(g);
+                     ++it)
                 {
-                    it.next();
-                    if (trial->outsideTimeLimitIfActivated(it.key(), it.key()))
-                    {
-                        continue;
-                    }
                     painter->setPen(QPen(*(m_settings->m_colors.sampleColor), scaleToView(2.0)));
 
                     painter->drawPoint(QPointF(it.value().getXPosition(), it.value().getYPosition()));
@@ -266,22 +264,19 @@ void MainScene::drawBackground(QPainter* painter, const QRectF& rect)
 
             if (m_settings->m_showSampleConnections)
             {
-                // Raw data left eye
-                QMapIterator<int, GazeData> it(trial->gazeData());
-                it.next();
-                QMapIterator<int, GazeData> prev(trial->gazeData());
-                while (it.hasNext())
+                // Raw data left eye: connections from each sample inside the time range to the
+                // next sample
+                const QMap<int, GazeData> g = trial->gazeData();
+                TimeLimit limit = trial->timeLimit();
+                QMap<int, GazeData>::const_iterator end = limit.end(g);
+                for (QMap<int, GazeData>::const_iterator prev = limit.begin(g); prev != end; ++prev)
                 {
-                    prev = it;
-
-                    if (trial->outsideTimeLimitIfActivated(it.key(), it.key()))
+                    QMap<int, GazeData>::const_iterator it = prev + 1;
+                    if (it == g.constEnd())
                     {
-                        it.next();
-                        continue;
+                        break;
                     }
 
-                    it.next();
-
                     if (it.key() - prev.key() == 1)
                     {
                         painter->setPen(QPen(*(m_settings->m_colors.sampleConnectionColor), 0));
@@ -304,11 +299,12 @@ void MainScene::drawBackground(QPainter* painter, const QRectF& rect)
                     return;
                 }
 
+                TimeLimit limit = trial->timeLimit();
                 for (int i = 0; i < trial->fixationsCount(); ++i)
                 {
 
-                    if (trial->outsideTimeLimitIfActivated(trial->getFixationAt(i)->getStartIndex(),
-                                                           trial->getFixationAt(i)->getEndIndex()))
+                    if (limit.outside(trial->getFixationAt(i)->getStartIndex(),
+                                      trial->getFixationAt(i)->getEndIndex()))
                     {
                         continue;
                     }
@@ -392,11 +388,12 @@ void MainScene::drawBackground(QPainter* painter, const QRectF& rect)
 std::vector<std::vector<std::vector<QPointF> > > MainScene::getMicrosaccadesGazeData(Trial* trial)
 {
     std::vector<std::vector<std::vector<QPointF> > > microsaccadeGazeData;
+    TimeLimit limit = trial->timeLimit();
     for (int i = 0; i < trial->fixationsCount(); ++i)
     {
         std::vector<std::vector<QPointF> > microsaccadeGazeDataInFixation;
-        if (!trial->outsideTimeLimitIfActivated(trial->getFixationAt(i)->getStartIndex(),
-                                                trial->getFixationAt(i)->getEndIndex()))
+        if (!limit.outside(trial->getFixationAt(i)->getStartIndex(),
+                           trial->getFixationAt(i)->getEndIndex()))
         {
             for (size_t k = 0; k < trial->getFixationAt(i)->getMicrosaccadesCount(trial->msFromInputFile()); ++k)
             {
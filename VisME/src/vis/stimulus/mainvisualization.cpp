@@ -48,6 +48,7 @@ void MainVisualization::updateVisibility()
     }
 
     Trial* trial = m_settings->m_currentTrials[0];
+    TimeLimit limit = trial->timeLimit();
 
     if (m_settings->m_showNeighboringFixations)
     {
@@ -56,8 +57,8 @@ void MainVisualization::updateVisibility()
         if ((m_settings->m_currentFixationIndex > -1 &&
              i <= size_t(m_settings->m_currentFixationIndex + m_settings->m_followingFixationsCount) &&
              i >= size_t(m_settings->m_currentFixationIndex - m_settings->m_previousFixationsCount)) &&
-             (!trial->outsideTimeLimitIfActivated(trial->getFixationAt(int(i))->getStartIndex(),
-                                                                 trial->getFixationAt(int(i))->getEndIndex())))
+             (!limit.outside(trial->getFixationAt(int(i))->getStartIndex(),
+                             trial->getFixationAt(int(i))->getEndIndex())))
             {
                 m_fixationData[i]->setVisible(m_settings->m_showScanpath);
             }
@@ -71,8 +72,8 @@ void MainVisualization::updateVisibility()
     {
         for (size_t i = 0; i < m_fixationData.size(); ++i)
         {
-            if (!trial->outsideTimeLimitIfActivated(trial->getFixationAt(int(i))->getStartIndex(),
-                                                    trial->getFixationAt(int(i))->getEndIndex()))
+            if (!limit.outside(trial->getFixationAt(int(i))->getStartIndex(),
+                               trial->getFixationAt(int(i))->getEndIndex()))
             {
                 m_fixationData[i]->setVisible(m_settings->m_showScanpath);
             }
@@ -71,7 +71,7 @@ void TimelineScene::drawBackground(QPainter* painter, const QRectF& rect)
         const GazeData* previousGazeData = nullptr;
         int previousGazeDataIndex = -1;
 
-        QMapIterator<int, GazeData> i(gazeData);
+        TimeLimit limit = trial->timeLimit();
         qreal max = 0;
         qreal min = 1000;
         std::vector<qreal> values;
@@ -79,43 +79,39 @@ void TimelineScene::drawBackground(QPainter* painter, const QRectF& rect)
         std::vector<std::vector<QPointF>> velocities;
         std::vector<QPointF> velocitySection;
 
-        // velocities
-        while (i.hasNext())
+        // velocities (samples inside the time range)
+        for (QMap<int, GazeData>::const_iterator it = limit.begin(gazeData);
+             it != limit.end(gazeData); ++it)
         {
-            i.next();
+            const GazeData* currentGazeData = &it.value();
+            int currentGazeDataIndex = it.key() - gazeData.firstKey();
 
-            const GazeData* currentGazeData = &i.value();
-            int currentGazeDataIndex = i.key() - gazeData.firstKey();
-
-            if (!trial->outsideTimeLimitIfActivated(i.key(), i.key()))
+            if (previousGazeData != nullptr && currentGazeData != nullptr && currentGazeDataIndex - previousGazeDataIndex == 1)
             {
-                if (previousGazeData != nullptr && currentGazeData != nullptr && currentGazeDataIndex - previousGazeDataIndex == 1)
-                {
 
-                    if (m_settings->m_showVelocityValuesInTimeline)
-                    {
-                        // velocity
-                        int diff = currentGazeDataIndex - previousGazeDataIndex;
-
-                        qreal velX = (currentGazeData->getXPosition() - previousGazeData->getXPosition());
-                        qreal velY = (currentGazeData->getYPosition() - previousGazeData->getYPosition());
-
-                        // plot velocity value in the middle between two data points
-                        qreal height = -sqrt(velX * velX + velY * velY) / diff;
-                        velocitySection.push_back(QPointF(currentGazeDataIndex - 0.5, height));
-                        max = std::max(max, fabs(height));
-                        min = std::min(min, fabs(height));
-                        values.push_back(fabs(height));
-                    }
-                }
-                else
+                if (m_settings->m_showVelocityValuesInTimeline)
                 {
-                    velocities.push_back(velocitySection);
-                    velocitySection.clear();
+                    // velocity
+                    int diff = currentGazeDataIndex - previousGazeDataIndex;
+
+                    qreal velX = (currentGazeData->getXPosition() - previousGazeData->getXPosition());
+                    qreal velY = (currentGazeData->getYPosition() - previousGazeData->getYPosition());
+
+                    // plot velocity value in the middle between two data points
+                    qreal height = -sqrt(velX * velX + velY * velY) / diff;
+                    velocitySection.push_back(QPointF(currentGazeDataIndex - 0.5, height));
+                    max = std::max(max, fabs(height));
+                    min = std::min(min, fabs(height));
+                    values.push_back(fabs(height));
                 }
-                previousGazeData = currentGazeData;
-                previousGazeDataIndex = currentGazeDataIndex;
             }
+            else
+            {
+                velocities.push_back(velocitySection);
+                velocitySection.clear();
+            }
+            previousGazeData = currentGazeData;
+            previousGazeDataIndex = currentGazeDataIndex;
         }
         velocities.push_back(velocitySection);
 
@@ -143,63 +139,92 @@ void TimelineScene::drawBackground(QPainter* painter, const QRectF& rect)
         }
 
         // x and y
-        i = QMapIterator<int, GazeData>(gazeData);
         previousGazeData = nullptr;
         previousGazeDataIndex = -1;
-        while (i.hasNext())
+        for (QMap<int, GazeData>::const_iterator it = limit.begin(gazeData);
+             it != limit.end(gazeData); ++it)
         {
-            i.next();
-            if (!trial->outsideTimeLimitIfActivated(i.key(), i.key()))
+            const GazeData* currentGazeData = &it.value();
+            int currentGazeDataIndex = it.key() - gazeData.firstKey();
+
+            if (previousGazeData != nullptr)
             {
-                const GazeData* currentGazeData = &i.value();
-                int currentGazeDataIndex = i.key() - gazeData.firstKey();
+                qreal yHeight = trial->maxY() - trial->minY();
 
-                if (previousGazeData != nullptr)
+                if (m_settings->m_showXValuesInTimeline)
                 {
-                    qreal yHeight = trial->maxY() - trial->minY();
-
-                    if (m_settings->m_showXValuesInTimeline)
+                    if (currentGazeDataIndex - previousGazeDataIndex == 1)
                     {
-                        if (currentGazeDataIndex - previousGazeDataIndex == 1)
-                        {
-                            painter->setPen(QPen(*(m_settings->m_colors.xValueColor), 0));
-                        }
-                        else
-                        {
-                            painter->setPen(QPen(*(m_settings->m_colors.missingDataColor), 0, Qt::DotLine));
-                        }
-
-                        painter->drawLine(QPointF(previousGazeDataIndex, -previousGazeData->getXPosition()),
-                                QPointF(currentGazeDataIndex, -currentGazeData->getXPosition()));
-
-
                         painter->setPen(QPen(*(m_settings->m_colors.xValueColor), 0));
-                        painter->drawEllipse(QPointF(previousGazeDataIndex, -previousGazeData->getXPosition()),
-                                             1.0 / views()[0]->transform().m11() * 0.5,
-                                             1.0 / views()[0]->transform().m22() * 0.5);
                     }
-                    if (m_settings->m_showYValuesInTimeline)
+                    else
                     {
-                        if (currentGazeDataIndex - previousGazeDataIndex == 1)
-                        {
-                            painter->setPen(QPen(*(m_settings->m_colors.yValueColor), 0));
-                        }
-                        else
-                        {
-                            painter->setPen(QPen(*(m_settings->m_colors.missingDataColor), 0, Qt::DotLine));
-                        }
-                        painter->drawLine(QPointF(previousGazeDataIndex, -(yHeight - previousGazeData->getYPosition())),
-                            QPointF(currentGazeDataIndex, -(yHeight - currentGazeData->getYPosition())));
+                        painter->setPen(QPen(*(m_settings->m_colors.missingDataColor), 0, Qt::DotLine));
+                    }
 
+                    painter->drawLine(QPointF(previousGazeDataIndex, -previousGazeData->getXPosition()),
+                            QPointF(currentGazeDataIndex, -currentGazeData->getXPosition()));
+
+
+                    painter->setPen(QPen(*(m_settings->m_colors.xValueColor), 0));
+                    painter->drawEllipse(QPointF(previousGazeDataIndex, -previousGazeData->getXPosition()),
+                                         1.0 / views()[0]->transform().m11() * 0.5,
+                                         1.0 / views()[0]->transform().m22() * 0.5);
+                }
+                if (m_settings->m_showYValuesInTimeline)
+                {
+                    if (currentGazeDataIndex - previousGazeDataIndex == 1)
+                    {
                         painter->setPen(QPen(*(m_settings->m_colors.yValueColor), 0));
-                        painter->setBrush(*(m_settings->m_colors.yValueColor));
-                        painter->drawEllipse(QPointF(previousGazeDataIndex, -(yHeight - previousGazeData->getYPosition())),
-                                             1.0 / views()[0]->transform().m11() * 0.5,
-                                             1.0 / views()[0]->transform().m22() * 0.5);
                     }
+                    else
+                    {
+                        painter->setPen(QPen(*(m_settings->m_colors.missingDataColor), 0, Qt::DotLine));
+                    }
+                    painter->drawLine(QPointF(previousGazeDataIndex, -(yHeight - previousGazeData->getYPosition())),
+                        QPointF(currentGazeDataIndex, -(yHeight - currentGazeData->getYPosition())));
+
+                    painter->setPen(QPen(*(m_settings->m_colors.yValueColor), 0));
+                    painter->setBrush(*(m_settings->m_colors.yValueColor));
+                    painter->drawEllipse(QPointF(previousGazeDataIndex, -(yHeight - previousGazeData->getYPosition())),
+                                         1.0 / views()[0]->transform().m11() * 0.5,
+                                         1.0 / views()[0]->transform().m22() * 0.5);
+                }
+            }
+            previousGazeData = currentGazeData;
+            previousGazeDataIndex = currentGazeDataIndex;
+        }
+
+        // samples interpolated for the microsaccade detection (gap interpolation)
+        if (trial->getMsFilterSettings() != nullptr)
+        {
+            const GazeRuns* runs = trial->gazeRuns(GazeType::GT_Unset,
+                                                   *trial->getMsFilterSettings());
+            qreal yHeight = trial->maxY() - trial->minY();
+            painter->setPen(QPen(*(m_settings->m_colors.missingDataColor), 0));
+            painter->setBrush(*(m_settings->m_colors.missingDataColor));
+            for (size_t j = 0; j < runs->m_interpolated.size(); ++j)
+            {
+                int index = runs->m_index[j];
+                if (!runs->m_interpolated[j] || limit.outside(index, index))
+                {
+                    continue;
+                }
+
+                qreal x = runs->m_x[j] * runs->m_pixelsPerDegree;
+                qreal y = runs->m_y[j] * runs->m_pixelsPerDegree;
+                if (m_settings->m_showXValuesInTimeline)
+                {
+                    painter->drawEllipse(QPointF(index - gazeData.firstKey(), -x),
+                                         1.0 / views()[0]->transform().m11() * 0.5,
+                                         1.0 / views()[0]->transform().m22() * 0.5);
+                }
+                if (m_settings->m_showYValuesInTimeline)
+                {
+                    painter->drawEllipse(QPointF(index - gazeData.firstKey(), -(yHeight - y)),
+                                         1.0 / views()[0]->transform().m11() * 0.5,
+                                         1.0 / views()[0]->transform().m22() * 0.5);
                 }
-                previousGazeData = currentGazeData;
-                previousGazeDataIndex = currentGazeDataIndex;
             }
         }
     }
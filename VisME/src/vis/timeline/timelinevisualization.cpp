@@ -102,6 +102,8 @@ void TimelineVisualization::updateVisibility()
 
     // fixations
     Trial* trial = m_settings->m_currentTrials[0];
+    TimeLimit limit = trial->timeLimit();
+
     if (m_settings->m_showNeighboringFixations && m_settings->m_showFixationsInTimeline)
     {
         for (size_t i = 0; i < m_fixationData.size(); ++i)
@@ -117,8 +119,8 @@ void TimelineVisualization::updateVisibility()
                 m_fixationData[i]->setVisible(false);
             }
 
-            if (trial->outsideTimeLimitIfActivated(trial->getFixationAt(int(i))->getStartIndex(),
-                                                   trial->getFixationAt(int(i))->getEndIndex()))
+            if (limit.outside(trial->getFixationAt(int(i))->getStartIndex(),
+                              trial->getFixationAt(int(i))->getEndIndex()))
             {
                 m_fixationData[i]->setVisible(false);
             }
@@ -130,8 +132,8 @@ void TimelineVisualization::updateVisibility()
         {
             m_fixationData[i]->setVisible(m_settings->m_showFixationsInTimeline);
 
-            if (trial->outsideTimeLimitIfActivated(trial->getFixationAt(int(i))->getStartIndex(),
-                                                   trial->getFixationAt(int(i))->getEndIndex()))
+            if (limit.outside(trial->getFixationAt(int(i))->getStartIndex(),
+                              trial->getFixationAt(int(i))->getEndIndex()))
             {
                 m_fixationData[i]->setVisible(false);
             }
@@ -141,8 +143,8 @@ void TimelineVisualization::updateVisibility()
     // microsaccades
     for (size_t i = 0; i < m_microsaccadeData.size(); ++i)
     {
-        if (!trial->outsideTimeLimitIfActivated(m_microsaccadeData[i]->fixation()->getStartIndex(),
-                                                m_microsaccadeData[i]->fixation()->getEndIndex()))
+        if (!limit.outside(m_microsaccadeData[i]->fixation()->getStartIndex(),
+                           m_microsaccadeData[i]->fixation()->getEndIndex()))
         {
             m_microsaccadeData[i]->setVisible(m_settings->m_showMicrosaccadesInTimeline);
         }
@@ -155,8 +157,8 @@ void TimelineVisualization::updateVisibility()
     // show all events
     for (size_t i = 0; i < m_eventData.size(); ++i)
     {
-        if (!trial->outsideTimeLimitIfActivated(m_eventData[i]->event()->getStartIndex(),
-                                                m_eventData[i]->event()->getEndIndex()))
+        if (!limit.outside(m_eventData[i]->event()->getStartIndex(),
+                           m_eventData[i]->event()->getEndIndex()))
         {
             m_eventData[i]->setVisible(m_settings->m_showEventsInTimeline);
         }
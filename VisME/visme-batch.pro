@@ -0,0 +1,57 @@
+#-------------------------------------------------
+#
+# Command line tool for the batch processing of eye tracking data (no display required)
+#
+#-------------------------------------------------
+
+QT       += core gui concurrent
+QT       -= widgets
+
+TARGET = visme-batch
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += include \
+               include/IO \
+               include/batch \
+               include/saccadeProcessing \
+               include/vis \
+               include/eyeTrackingData
+
+SOURCES+= $$PWD/src/mathhelpfunctions.cpp \
+          $$PWD/src/IO/aggregatedstatistics.cpp \
+          $$PWD/src/IO/arrowdatawriter.cpp \
+          $$PWD/src/IO/arrowtable.cpp \
+          $$PWD/src/IO/eyedatareader.cpp \
+          $$PWD/src/IO/eyedatawriter.cpp \
+          $$PWD/src/IO/outputbuffer.cpp \
+          $$PWD/src/IO/sessionfile.cpp \
+          $$PWD/src/IO/settingsreader.cpp \
+          $$PWD/src/quantilesketch.cpp \
+          $$PWD/src/saccadeProcessing/*.cpp \
+          $$PWD/src/eyeTrackingData/*.cpp \
+          $$PWD/src/batch/*.cpp
+
+HEADERS+= $$PWD/include/cancellationtoken.h \
+          $$PWD/include/enums.h \
+          $$PWD/include/fileextensions.h \
+          $$PWD/include/mathhelpfunctions.h \
+          $$PWD/include/quantilesketch.h \
+          $$PWD/include/saccadefiltersettings.h \
+          $$PWD/include/settings.h \
+          $$PWD/include/settingssnapshot.h \
+          $$PWD/include/vis/colors.h \
+          $$PWD/include/IO/aggregatedstatistics.h \
+          $$PWD/include/IO/arrowdatawriter.h \
+          $$PWD/include/IO/arrowtable.h \
+          $$PWD/include/IO/eyedatareader.h \
+          $$PWD/include/IO/eyedatawriter.h \
+          $$PWD/include/IO/outputbuffer.h \
+          $$PWD/include/IO/sessionfile.h \
+          $$PWD/include/IO/settingsreader.h \
+          $$PWD/include/saccadeProcessing/*.h \
+          $$PWD/include/eyeTrackingData/*.h \
+          $$PWD/include/batch/*.h